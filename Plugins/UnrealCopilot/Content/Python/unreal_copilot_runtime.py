@@ -0,0 +1,411 @@
+# Copyright Epic Games, Inc. All Rights Reserved.
+
+"""
+Runtime support for UnrealCopilot script execution.
+
+The plugin imports this module from its Content/Python folder, which the Python
+Script Plugin adds to sys.path. It is not meant to be used directly.
+
+Scripts arrive as str objects passed through the Python C API, so they are never
+escaped into another program's source. run_source() parses a script once,
+reports syntax errors as data and executes the code object it compiled.
+Compiled code objects are kept in an LRU cache keyed by the hash of the
+normalized source the plugin computes, so scripts that run again skip parsing.
+
+Asynchronous jobs run a script as a generator so the editor can execute it in
+time slices on the game thread: every loop iteration and every top-level
+statement yields back to step_job(), which returns once its time budget is
+spent. Functions and classes defined by the script are left untouched, so only
+loops written directly in the script are sliced.
+
+The plugin warms the interpreter at startup by importing this module and the
+modules scripts commonly use, so the first script does not pay for them.
+Scripts normally run in a fresh namespace; a session keeps one namespace alive
+between scripts until it is reset, so variables and imports carry over.
+"""
+
+import ast
+import builtins
+import collections
+import importlib
+import json
+import sys
+import time
+import traceback
+
+JOB_RUNNING = 0
+JOB_DONE = 1
+JOB_ERROR = 2
+
+RUN_OK = 0
+RUN_SYNTAX_ERROR = 1
+RUN_ERROR = 2
+
+SCRIPT_FILENAME = '<unreal_copilot>'
+ERROR_REPORT_MARKER = '__unreal_copilot_error__ '
+_ENTRY_POINT = '__unreal_copilot_main__'
+
+
+class _Job:
+    def __init__(self, generator, total_statements):
+        self.generator = generator
+        self.total_statements = total_statements
+        self.statements_done = 0
+        self.steps = 0
+
+
+_jobs = {}
+_sessions = {}
+
+
+class _CodeCache:
+    """LRU cache of compiled scripts keyed by the plugin's normalized-source hash."""
+
+    def __init__(self, capacity):
+        self.entries = collections.OrderedDict()
+        self.capacity = capacity
+        self.hits = 0
+        self.misses = 0
+
+    def get(self, key):
+        entry = self.entries.get(key)
+        if entry is None:
+            self.misses += 1
+            return None
+        self.entries.move_to_end(key)
+        self.hits += 1
+        return entry
+
+    def put(self, key, entry):
+        self.entries[key] = entry
+        self.entries.move_to_end(key)
+        self._trim()
+
+    def resize(self, capacity):
+        self.capacity = max(capacity, 0)
+        self._trim()
+
+    def _trim(self):
+        while len(self.entries) > self.capacity:
+            self.entries.popitem(last=False)
+
+
+_code_cache = _CodeCache(128)
+
+
+class _BoundNameCollector(ast.NodeVisitor):
+    """Collects the names a statement list binds in its own scope."""
+
+    def __init__(self):
+        self.names = set()
+
+    def visit_Name(self, node):
+        if isinstance(node.ctx, (ast.Store, ast.Del)):
+            self.names.add(node.id)
+
+    def visit_FunctionDef(self, node):
+        # Decorators and defaults are evaluated in the enclosing scope, the body is not
+        for child in node.decorator_list + node.args.defaults + node.args.kw_defaults:
+            if child is not None:
+                self.visit(child)
+        self.names.add(node.name)
+
+    visit_AsyncFunctionDef = visit_FunctionDef
+
+    def visit_ClassDef(self, node):
+        for child in node.decorator_list + node.bases + node.keywords:
+            self.visit(child)
+        self.names.add(node.name)
+
+    def visit_Lambda(self, node):
+        for child in node.args.defaults + node.args.kw_defaults:
+            if child is not None:
+                self.visit(child)
+
+    def _visit_comprehension(self, node):
+        # Only the first iterable is evaluated in the enclosing scope, but assignment expressions bind there too
+        self.visit(node.generators[0].iter)
+        for child in ast.walk(node):
+            if isinstance(child, ast.NamedExpr) and isinstance(child.target, ast.Name):
+                self.names.add(child.target.id)
+
+    visit_ListComp = visit_SetComp = visit_DictComp = visit_GeneratorExp = _visit_comprehension
+
+    def visit_Import(self, node):
+        for alias in node.names:
+            self.names.add(alias.asname or alias.name.split('.')[0])
+
+    def visit_ImportFrom(self, node):
+        for alias in node.names:
+            self.names.add(alias.asname or alias.name)
+
+    def visit_Global(self, node):
+        self.names.update(node.names)
+
+    def visit_ExceptHandler(self, node):
+        if node.name:
+            self.names.add(node.name)
+        self.generic_visit(node)
+
+    def visit_MatchAs(self, node):
+        if node.name:
+            self.names.add(node.name)
+        self.generic_visit(node)
+
+    def visit_MatchStar(self, node):
+        if node.name:
+            self.names.add(node.name)
+
+    def visit_MatchMapping(self, node):
+        if node.rest:
+            self.names.add(node.rest)
+        self.generic_visit(node)
+
+
+class _LoopYieldInserter(ast.NodeTransformer):
+    """Makes every loop in the script's own scope yield at the start of each iteration."""
+
+    def _skip(self, node):
+        return node
+
+    visit_FunctionDef = visit_AsyncFunctionDef = visit_ClassDef = visit_Lambda = _skip
+
+    def _visit_loop(self, node):
+        self.generic_visit(node)
+        node.body.insert(0, ast.Expr(ast.Yield(None)))
+        return node
+
+    visit_For = visit_While = _visit_loop
+
+    def visit_Global(self, node):
+        # Every bound name is declared global by the entry point already
+        return ast.Pass()
+
+
+def _build_sliced_code(module):
+    """
+    Wrap a module in a generator function that yields between statements and loop iterations.
+    Returns None when the script cannot run inside a function.
+    """
+    if any(isinstance(node, ast.ImportFrom) and any(alias.name == '*' for alias in node.names) for node in module.body):
+        return None
+
+    collector = _BoundNameCollector()
+    for statement in module.body:
+        collector.visit(statement)
+
+    inserter = _LoopYieldInserter()
+    body = []
+    if collector.names:
+        body.append(ast.Global(names=sorted(collector.names)))
+    for index, statement in enumerate(module.body):
+        body.append(inserter.visit(statement))
+        body.append(ast.Expr(ast.Yield(ast.Constant(index + 1))))
+
+    entry_point = ast.FunctionDef(
+        name=_ENTRY_POINT,
+        args=ast.arguments(posonlyargs=[], args=[], vararg=None, kwonlyargs=[], kw_defaults=[], kwarg=None, defaults=[]),
+        body=body,
+        decorator_list=[],
+        returns=None,
+        type_comment=None)
+    wrapper = ast.Module(body=[entry_point], type_ignores=[])
+    ast.copy_location(entry_point, module.body[0])
+    ast.fix_missing_locations(wrapper)
+
+    try:
+        return compile(wrapper, SCRIPT_FILENAME, 'exec')
+    except SyntaxError:
+        return None
+
+
+def report_exception():
+    """
+    Print the exception being handled as a traceback, followed by a one-line
+    summary the plugin parses into the execution result.
+    """
+    exc_type, exc, tb = sys.exc_info()
+    if exc_type is None:
+        return
+    traceback.print_exc()
+
+    # The innermost frame inside the script is where the user should look
+    line = -1
+    if isinstance(exc, SyntaxError) and exc.filename == SCRIPT_FILENAME and exc.lineno:
+        line = exc.lineno
+    for frame in traceback.extract_tb(tb):
+        if frame.filename == SCRIPT_FILENAME:
+            line = frame.lineno
+
+    summary = {
+        'type': exc_type.__name__,
+        'message': str(exc),
+        'line': line,
+        'stack_trace': '||'.join(''.join(traceback.format_exception(exc_type, exc, tb)).splitlines()),
+    }
+    print(ERROR_REPORT_MARKER + json.dumps(summary), file=sys.stderr)
+
+
+def _run_whole(code, namespace):
+    exec(code, namespace)
+    yield 1
+
+
+def _new_namespace():
+    return {'__name__': '__main__', '__builtins__': builtins}
+
+
+def _get_namespace(session_id):
+    """Return the namespace of a session, creating it on first use; session 0 gets a fresh namespace."""
+    if session_id <= 0:
+        return _new_namespace()
+    namespace = _sessions.get(session_id)
+    if namespace is None:
+        namespace = _sessions[session_id] = _new_namespace()
+    return namespace
+
+
+def reset_session(session_id):
+    """Drop the variables of a session; its next script starts from a fresh namespace."""
+    return _sessions.pop(session_id, None) is not None
+
+
+def warm_up(module_names):
+    """
+    Import modules ahead of the first script, so importing them from a script is a sys.modules lookup.
+    Returns (seconds taken, comma-separated names that failed to import).
+    """
+    start = time.perf_counter()
+    failed = []
+    for name in module_names:
+        try:
+            importlib.import_module(name)
+        except Exception:
+            failed.append(name)
+    return (time.perf_counter() - start, ','.join(failed))
+
+
+def _compile_module(module):
+    """Compile a parsed script. A lone expression is compiled like console input so its value is printed."""
+    if len(module.body) == 1 and isinstance(module.body[0], ast.Expr):
+        return compile(ast.Interactive(body=module.body), SCRIPT_FILENAME, 'single')
+    return compile(module, SCRIPT_FILENAME, 'exec')
+
+
+def configure_code_cache(capacity):
+    """Set how many compiled scripts are kept; 0 disables the cache."""
+    _code_cache.resize(capacity)
+
+
+def get_code_cache_stats():
+    """Return (hits, misses, entries, capacity) of the compiled code cache."""
+    return (_code_cache.hits, _code_cache.misses, len(_code_cache.entries), _code_cache.capacity)
+
+
+def run_source(source, key='', session_id=0):
+    """
+    Compile and run a script in a fresh namespace, or in the namespace of a session when session_id is positive.
+    A non-empty key looks the compiled script up in the code cache.
+    Returns (status, line, column, message); line, column and message describe a syntax error.
+    Exceptions raised by the script are reported through report_exception().
+    """
+    code = _code_cache.get(('run', key)) if key else None
+    if code is None:
+        try:
+            code = _compile_module(ast.parse(source, SCRIPT_FILENAME))
+        except SyntaxError as exc:
+            return (RUN_SYNTAX_ERROR, exc.lineno or 0, exc.offset or 0, exc.msg)
+        if key:
+            _code_cache.put(('run', key), code)
+
+    try:
+        exec(code, _get_namespace(session_id))
+    except KeyboardInterrupt:
+        # Interrupts come from the plugin's watchdog, which reports them itself
+        raise
+    except BaseException:
+        # SystemExit included, so exit() or sys.exit() in a script fails the script instead of closing the editor
+        report_exception()
+        return (RUN_ERROR, 0, 0, '')
+    return (RUN_OK, 0, 0, '')
+
+
+def _compile_job(source):
+    """Return (sliced code or None, whole-script code or None, total statements) for a job."""
+    module = ast.parse(source, SCRIPT_FILENAME)
+    sliced_code = _build_sliced_code(module) if module.body else None
+    if sliced_code is not None:
+        return (sliced_code, None, len(module.body))
+    # Scripts that cannot be wrapped run in a single step
+    return (None, _compile_module(module), 1)
+
+
+def start_job(job_id, source, key='', session_id=0):
+    """
+    Prepare a script for time-sliced execution and return its number of top-level statements.
+    A non-empty key looks the compiled script up in the code cache; a positive session_id runs it in that session.
+    """
+    compiled = _code_cache.get(('job', key)) if key else None
+    if compiled is None:
+        compiled = _compile_job(source)
+        if key:
+            _code_cache.put(('job', key), compiled)
+
+    sliced_code, whole_code, total_statements = compiled
+    namespace = _get_namespace(session_id)
+    if sliced_code is not None:
+        exec(sliced_code, namespace)
+        generator = namespace.pop(_ENTRY_POINT)()
+    else:
+        generator = _run_whole(whole_code, namespace)
+
+    _jobs[job_id] = _Job(generator, total_statements)
+    return total_statements
+
+
+def step_job(job_id, budget_seconds):
+    """
+    Run a job until it finishes or its time budget is spent.
+    Returns (state, statements done, total statements, steps done); errors are reported through report_exception().
+    """
+    job = _jobs.get(job_id)
+    if job is None:
+        return (JOB_ERROR, 0, 0, 0)
+
+    # Whatever ends the step other than the budget running out ends the job, including a KeyboardInterrupt
+    # raised outside the script, so the job is never left behind
+    still_running = False
+    try:
+        deadline = time.perf_counter() + budget_seconds
+        while True:
+            value = next(job.generator)
+            job.steps += 1
+            if value is not None:
+                job.statements_done = value
+            if time.perf_counter() >= deadline:
+                still_running = True
+                return (JOB_RUNNING, job.statements_done, job.total_statements, job.steps)
+    except StopIteration:
+        return (JOB_DONE, job.total_statements, job.total_statements, job.steps)
+    except KeyboardInterrupt:
+        # The watchdog interrupted the job; the plugin reports it as a timeout or cancellation
+        raise
+    except BaseException:
+        report_exception()
+        return (JOB_ERROR, job.statements_done, job.total_statements, job.steps)
+    finally:
+        if not still_running:
+            _jobs.pop(job_id, None)
+
+
+def cancel_job(job_id):
+    """Stop a job, running its pending finally blocks and context manager exits."""
+    job = _jobs.pop(job_id, None)
+    if job is None:
+        return False
+    try:
+        job.generator.close()
+    except BaseException:
+        # The script swallowed GeneratorExit or failed while unwinding; the job is dropped either way
+        pass
+    return True
@@ -2,6 +2,7 @@
 
 #include "UnrealCopilot.h"
 #include "UnrealCopilotExecutionManager.h"
+#include "UnrealCopilotSettings.h"
 #include "IPythonScriptPlugin.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
@@ -14,10 +15,21 @@ void FUnrealCopilotModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	UE_LOG(LogUnrealCopilot, Log, TEXT("UnrealCopilot module started"));
-	
-	// Initialize the execution manager
-	UUnrealCopilotExecutionManager::GetInstance();
-	UE_LOG(LogUnrealCopilot, Log, TEXT("UnrealCopilot execution manager initialized"));
+
+	// Warming up creates the execution manager, but its history is only loaded once the panel or a history call needs it
+
+	// Warm the Python environment as soon as the interpreter is ready, so the first script starts quickly
+	if (IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get())
+	{
+		if (PythonPlugin->IsPythonInitialized())
+		{
+			OnPythonInitialized();
+		}
+		else
+		{
+			PythonInitializedHandle = PythonPlugin->OnPythonInitialized().AddStatic(&FUnrealCopilotModule::OnPythonInitialized);
+		}
+	}
 }
 
 void FUnrealCopilotModule::ShutdownModule()
@@ -25,6 +37,23 @@ void FUnrealCopilotModule::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 	UE_LOG(LogUnrealCopilot, Log, TEXT("UnrealCopilot module shutdown"));
+
+	if (PythonInitializedHandle.IsValid())
+	{
+		if (IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get())
+		{
+			PythonPlugin->OnPythonInitialized().Remove(PythonInitializedHandle);
+		}
+		PythonInitializedHandle.Reset();
+	}
+}
+
+void FUnrealCopilotModule::OnPythonInitialized()
+{
+	if (UUnrealCopilotSettings::Get()->bWarmUpPythonOnStartup)
+	{
+		UUnrealCopilotExecutionManager::GetInstance()->WarmUpPythonEnvironment();
+	}
 }
 
 bool UUnrealCopilotBlueprintLibrary::ExecutePythonString(const FString& PythonCode, FString& OutResult)
@@ -44,7 +73,7 @@ bool UUnrealCopilotBlueprintLibrary::ExecutePythonString(const FString& PythonCo
 	return Result.bSuccess;
 }
 
-FPythonExecutionResult UUnrealCopilotBlueprintLibrary::ExecutePythonCodeEnhanced(const FString& PythonCode)
+FPythonExecutionResult UUnrealCopilotBlueprintLibrary::ExecutePythonCodeEnhanced(const FString& PythonCode, bool bAsync, EPythonExecutionPriority Priority)
 {
 	UUnrealCopilotExecutionManager* ExecutionManager = GetExecutionManager();
 	if (!ExecutionManager)
@@ -56,7 +85,7 @@ FPythonExecutionResult UUnrealCopilotBlueprintLibrary::ExecutePythonCodeEnhanced
 		return ErrorResult;
 	}
 	
-	return ExecutionManager->ExecutePythonCode(PythonCode, false);
+	return ExecutionManager->ExecutePythonCode(PythonCode, bAsync, 0, Priority);
 }
 
 bool UUnrealCopilotBlueprintLibrary::ValidatePythonSyntax(const FString& PythonCode, FString& OutErrorMessage)
@@ -0,0 +1,442 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotBatchCommandlet.h"
+#include "UnrealCopilotSettings.h"
+#include "HttpModule.h"
+#include "HttpManager.h"
+#include "Containers/Ticker.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CoreDelegates.h"
+#include "Algo/Count.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUnrealCopilotBatch, Log, All);
+
+namespace UnrealCopilotBatchCommandlet
+{
+	/** Concurrent LLM requests when the command line does not say */
+	static constexpr int32 DefaultConcurrency = 4;
+	static constexpr int32 MaxConcurrency = 32;
+
+	/** Time to sleep between network updates when no script is waiting to run */
+	static constexpr float IdleSleepSeconds = 0.01f;
+
+	static TSharedRef<FJsonObject> MakeGenerationJson(const FCodeGenerationResult& Generation)
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetBoolField(TEXT("success"), Generation.bSuccess);
+		Json->SetStringField(TEXT("code"), Generation.GeneratedCode);
+		Json->SetStringField(TEXT("explanation"), Generation.Explanation);
+		Json->SetStringField(TEXT("error"), Generation.ErrorMessage);
+		Json->SetNumberField(TEXT("seconds"), Generation.GenerationTimeSeconds);
+		Json->SetNumberField(TEXT("tokensUsed"), Generation.TokensUsed);
+		Json->SetNumberField(TEXT("promptTokens"), Generation.PromptTokens);
+		Json->SetNumberField(TEXT("responseCode"), Generation.ResponseCode);
+
+		TArray<TSharedPtr<FJsonValue>> TouchedAssets;
+		for (const FString& AssetPath : Generation.TouchedAssets)
+		{
+			TouchedAssets.Add(MakeShared<FJsonValueString>(AssetPath));
+		}
+		Json->SetArrayField(TEXT("touchedAssets"), TouchedAssets);
+		return Json;
+	}
+
+	static TSharedRef<FJsonObject> MakeExecutionJson(const FPythonExecutionResult& Execution)
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetBoolField(TEXT("success"), Execution.bSuccess);
+		Json->SetStringField(TEXT("output"), Execution.Output);
+		Json->SetStringField(TEXT("error"), Execution.ErrorMessage);
+		Json->SetStringField(TEXT("errorType"), StaticEnum<EPythonExecutionError>()->GetNameStringByValue(static_cast<int64>(Execution.ErrorType)));
+		Json->SetNumberField(TEXT("errorLine"), Execution.ErrorLineNumber);
+		Json->SetNumberField(TEXT("seconds"), Execution.ExecutionTimeSeconds);
+		return Json;
+	}
+}
+
+const TCHAR* const UUnrealCopilotBatchCommandlet::StreamedResultPrefix = TEXT("UnrealCopilotBatchResult: ");
+
+bool FUnrealCopilotBatchItem::Succeeded() const
+{
+	if (!Error.IsEmpty())
+	{
+		return false;
+	}
+	if (IsPrompt() && !(bGenerated && Generation.bSuccess))
+	{
+		return false;
+	}
+	return !bExecute || (bExecuted && Execution.bSuccess);
+}
+
+UUnrealCopilotBatchCommandlet::UUnrealCopilotBatchCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("Generate code from prompts and run scripts listed in a manifest, writing the results as JSON");
+	HelpUsage = TEXT("-run=UnrealCopilotBatch -Manifest=<path> [-Output=<path>] [-Concurrency=<requests>] [-StreamResults] [-NoHistory] [-ScriptTimeout=<seconds>]");
+	HelpParamNames = { TEXT("Manifest"), TEXT("Output"), TEXT("Concurrency"), TEXT("StreamResults"), TEXT("NoHistory"), TEXT("ScriptTimeout") };
+	HelpParamDescriptions = {
+		TEXT("JSON manifest of prompts and scripts"),
+		TEXT("Where to write the results; defaults to Saved/UnrealCopilot/Batch/<manifest>.results.json"),
+		TEXT("Most LLM requests in flight at once (default 4)"),
+		TEXT("Log each item's result as one line of JSON when it finishes"),
+		TEXT("Leave the project's execution and prompt history alone, for batches running alongside other editors"),
+		TEXT("Seconds a script may run before it is interrupted, or 0 for no limit (default the interactive timeout)")
+	};
+}
+
+int32 UUnrealCopilotBatchCommandlet::Main(const FString& Params)
+{
+	using namespace UnrealCopilotBatchCommandlet;
+
+	FString ManifestPath;
+	if (!FParse::Value(*Params, TEXT("Manifest="), ManifestPath))
+	{
+		UE_LOG(LogUnrealCopilotBatch, Error, TEXT("Usage: %s"), *HelpUsage);
+		return 1;
+	}
+	ManifestPath = FPaths::ConvertRelativePathToFull(ManifestPath);
+
+	FString ManifestJson;
+	if (!FFileHelper::LoadFileToString(ManifestJson, *ManifestPath))
+	{
+		UE_LOG(LogUnrealCopilotBatch, Error, TEXT("Could not read manifest %s"), *ManifestPath);
+		return 1;
+	}
+
+	FString ManifestError;
+	if (!ParseManifest(ManifestJson, FPaths::GetPath(ManifestPath), Items, ManifestError))
+	{
+		UE_LOG(LogUnrealCopilotBatch, Error, TEXT("Invalid manifest %s: %s"), *ManifestPath, *ManifestError);
+		return 1;
+	}
+
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("UnrealCopilot") / TEXT("Batch") / FPaths::GetBaseFilename(ManifestPath) + TEXT(".results.json");
+	}
+
+	int32 Concurrency = DefaultConcurrency;
+	FParse::Value(*Params, TEXT("Concurrency="), Concurrency);
+	Concurrency = FMath::Clamp(Concurrency, 1, MaxConcurrency);
+	bStreamResults = FParse::Param(*Params, TEXT("StreamResults"));
+	if (FParse::Param(*Params, TEXT("NoHistory")))
+	{
+		UUnrealCopilotExecutionManager::DisableHistory();
+	}
+
+	// The interactive timeout is meant for the editor; bulk passes may run for hours
+	float ScriptTimeoutSeconds = 0.0f;
+	if (FParse::Value(*Params, TEXT("ScriptTimeout="), ScriptTimeoutSeconds))
+	{
+		UUnrealCopilotExecutionManager::GetInstance()->SetExecutionTimeout(ScriptTimeoutSeconds);
+	}
+
+	BatchStartTime = FPlatformTime::Seconds();
+	for (int32 ItemIndex = 0; ItemIndex < Items.Num(); ++ItemIndex)
+	{
+		const FUnrealCopilotBatchItem& Item = Items[ItemIndex];
+		if (!Item.Error.IsEmpty())
+		{
+			FinishItem(ItemIndex);
+		}
+		else
+		{
+			(Item.IsPrompt() ? PendingPrompts : PendingScripts).Add(ItemIndex);
+		}
+	}
+
+	// Each manager handles one request at a time, so concurrency comes from running several
+	const int32 ManagerCount = FMath::Min(Concurrency, PendingPrompts.Num());
+	for (int32 ManagerIndex = 0; ManagerIndex < ManagerCount; ++ManagerIndex)
+	{
+		LLMManagers.Add(NewObject<UUnrealCopilotLLMManager>(this));
+	}
+	ActiveItems.Init(INDEX_NONE, ManagerCount);
+
+	UE_LOG(LogUnrealCopilotBatch, Display, TEXT("Running %d prompts and %d scripts from %s with up to %d concurrent requests"),
+		PendingPrompts.Num(), PendingScripts.Num(), *ManifestPath, ManagerCount);
+
+	// There is no engine loop in a commandlet, so HTTP responses, tickers and game thread tasks are pumped here
+	double LastTickTime = FPlatformTime::Seconds();
+	const auto HasWork = [this]()
+	{
+		return PendingPrompts.Num() > 0 || PendingScripts.Num() > 0
+			|| ActiveItems.ContainsByPredicate([](int32 ItemIndex) { return ItemIndex != INDEX_NONE; });
+	};
+	while (HasWork() && !IsEngineExitRequested())
+	{
+		DispatchPrompts();
+		ExecuteNextScript();
+
+		const double Now = FPlatformTime::Seconds();
+		const float DeltaTime = static_cast<float>(Now - LastTickTime);
+		LastTickTime = Now;
+
+		FHttpModule::Get().GetHttpManager().Tick(DeltaTime);
+		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+		if (PendingScripts.Num() == 0)
+		{
+			FPlatformProcess::Sleep(IdleSleepSeconds);
+		}
+	}
+
+	const double TotalSeconds = GetBatchSeconds();
+	FString ReportString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+	FJsonSerializer::Serialize(MakeReport(Items, TotalSeconds), Writer);
+	if (!FFileHelper::SaveStringToFile(ReportString, *OutputPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogUnrealCopilotBatch, Error, TEXT("Could not write results to %s"), *OutputPath);
+		return 1;
+	}
+
+	const int32 SucceededCount = Algo::CountIf(Items, [](const FUnrealCopilotBatchItem& Item) { return Item.Succeeded(); });
+	UE_LOG(LogUnrealCopilotBatch, Display, TEXT("%d of %d items succeeded in %.1f s; results written to %s"),
+		SucceededCount, Items.Num(), TotalSeconds, *OutputPath);
+	return SucceededCount == Items.Num() ? 0 : 1;
+}
+
+bool UUnrealCopilotBatchCommandlet::ParseManifest(const FString& ManifestJson, const FString& ManifestDirectory, TArray<FUnrealCopilotBatchItem>& OutItems, FString& OutError)
+{
+	OutItems.Reset();
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ManifestJson);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	{
+		OutError = TEXT("Manifest is not a JSON object");
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* ItemValues = nullptr;
+	if (!Root->TryGetArrayField(TEXT("items"), ItemValues))
+	{
+		OutError = TEXT("Manifest has no \"items\" array");
+		return false;
+	}
+
+	bool bExecutePrompts = false;
+	Root->TryGetBoolField(TEXT("execute"), bExecutePrompts);
+
+	for (int32 ValueIndex = 0; ValueIndex < ItemValues->Num(); ++ValueIndex)
+	{
+		const TSharedPtr<FJsonObject>* ItemObject = nullptr;
+		if (!(*ItemValues)[ValueIndex]->TryGetObject(ItemObject))
+		{
+			OutError = FString::Printf(TEXT("Item %d is not an object"), ValueIndex);
+			return false;
+		}
+
+		FUnrealCopilotBatchItem& Item = OutItems.AddDefaulted_GetRef();
+		if (!(*ItemObject)->TryGetStringField(TEXT("id"), Item.Id) || Item.Id.IsEmpty())
+		{
+			Item.Id = FString::Printf(TEXT("item%d"), ValueIndex);
+		}
+
+		FString ScriptFile;
+		(*ItemObject)->TryGetStringField(TEXT("prompt"), Item.Prompt);
+		(*ItemObject)->TryGetStringField(TEXT("script"), Item.Script);
+		(*ItemObject)->TryGetStringField(TEXT("scriptFile"), ScriptFile);
+
+		const int32 SourceCount = !Item.Prompt.IsEmpty() + !Item.Script.IsEmpty() + !ScriptFile.IsEmpty();
+		if (SourceCount != 1)
+		{
+			OutError = FString::Printf(TEXT("Item '%s' needs exactly one of \"prompt\", \"script\" or \"scriptFile\""), *Item.Id);
+			return false;
+		}
+
+		if (!ScriptFile.IsEmpty())
+		{
+			const FString ScriptPath = FPaths::IsRelative(ScriptFile) ? ManifestDirectory / ScriptFile : ScriptFile;
+			if (!FFileHelper::LoadFileToString(Item.Script, *ScriptPath))
+			{
+				Item.Error = FString::Printf(TEXT("Could not read script file %s"), *ScriptPath);
+			}
+		}
+
+		Item.bExecute = true;
+		if (Item.IsPrompt() && !(*ItemObject)->TryGetBoolField(TEXT("execute"), Item.bExecute))
+		{
+			Item.bExecute = bExecutePrompts;
+		}
+	}
+	return true;
+}
+
+TSharedRef<FJsonObject> UUnrealCopilotBatchCommandlet::MakeReport(const TArray<FUnrealCopilotBatchItem>& Items, double TotalSeconds)
+{
+	int32 SucceededCount = 0;
+	TArray<TSharedPtr<FJsonValue>> ItemValues;
+	for (const FUnrealCopilotBatchItem& Item : Items)
+	{
+		SucceededCount += Item.Succeeded();
+		ItemValues.Add(MakeShared<FJsonValueObject>(MakeItemReport(Item)));
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("totalSeconds"), TotalSeconds);
+	Report->SetNumberField(TEXT("succeeded"), SucceededCount);
+	Report->SetNumberField(TEXT("failed"), Items.Num() - SucceededCount);
+	Report->SetArrayField(TEXT("items"), ItemValues);
+	return Report;
+}
+
+TSharedRef<FJsonObject> UUnrealCopilotBatchCommandlet::MakeItemReport(const FUnrealCopilotBatchItem& Item)
+{
+	using namespace UnrealCopilotBatchCommandlet;
+
+	TSharedRef<FJsonObject> ItemJson = MakeShared<FJsonObject>();
+	ItemJson->SetStringField(TEXT("id"), Item.Id);
+	ItemJson->SetStringField(TEXT("kind"), Item.IsPrompt() ? TEXT("prompt") : TEXT("script"));
+	ItemJson->SetBoolField(TEXT("success"), Item.Succeeded());
+	ItemJson->SetNumberField(TEXT("startSeconds"), Item.StartSeconds);
+	ItemJson->SetNumberField(TEXT("endSeconds"), Item.EndSeconds);
+	if (!Item.Error.IsEmpty())
+	{
+		ItemJson->SetStringField(TEXT("error"), Item.Error);
+	}
+	if (Item.IsPrompt())
+	{
+		ItemJson->SetStringField(TEXT("prompt"), Item.Prompt);
+		if (Item.bGenerated)
+		{
+			ItemJson->SetObjectField(TEXT("generation"), MakeGenerationJson(Item.Generation));
+		}
+	}
+	if (Item.bExecuted)
+	{
+		ItemJson->SetObjectField(TEXT("execution"), MakeExecutionJson(Item.Execution));
+	}
+	return ItemJson;
+}
+
+void UUnrealCopilotBatchCommandlet::DispatchPrompts()
+{
+	const int32 MaxRequestsPerMinute = UUnrealCopilotSettings::Get()->MaxRequestsPerMinute;
+	for (int32 ManagerIndex = 0; ManagerIndex < LLMManagers.Num() && PendingPrompts.Num() > 0; ++ManagerIndex)
+	{
+		if (ActiveItems[ManagerIndex] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		// Every manager counts only its own requests, so the batch keeps the configured rate across all of them
+		const bool bNewMinute = FPlatformTime::Seconds() - UsageTracker.MinuteResetTime >= 60.0;
+		if (!bNewMinute && !UsageTracker.CanMakeRequest(MaxRequestsPerMinute))
+		{
+			return;
+		}
+		UsageTracker.UpdateUsage();
+
+		const int32 ItemIndex = PendingPrompts[0];
+		PendingPrompts.RemoveAt(0);
+		ActiveItems[ManagerIndex] = ItemIndex;
+
+		FUnrealCopilotBatchItem& Item = Items[ItemIndex];
+		Item.StartSeconds = GetBatchSeconds();
+		UE_LOG(LogUnrealCopilotBatch, Log, TEXT("Generating code for '%s'"), *Item.Id);
+
+		// Completion may be reported before this returns, for example when the prompt fails validation
+		LLMManagers[ManagerIndex]->ProcessNaturalLanguagePrompt(Item.Prompt,
+			FOnCodeGenerationComplete::CreateUObject(this, &UUnrealCopilotBatchCommandlet::OnGenerationComplete, ManagerIndex, ItemIndex));
+	}
+}
+
+void UUnrealCopilotBatchCommandlet::ExecuteNextScript()
+{
+	if (PendingScripts.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 ItemIndex = PendingScripts[0];
+	PendingScripts.RemoveAt(0);
+
+	FUnrealCopilotBatchItem& Item = Items[ItemIndex];
+	if (!Item.IsPrompt())
+	{
+		Item.StartSeconds = GetBatchSeconds();
+	}
+
+	Item.Execution = UUnrealCopilotExecutionManager::GetInstance()->ExecutePythonCode(Item.Script);
+	if (Item.Execution.bQueued)
+	{
+		// A queued script has not run yet, and its result would arrive after the item was reported
+		Item.Execution.bSuccess = false;
+		Item.Execution.ErrorMessage = TEXT("Script was queued behind another execution instead of running");
+		Item.Execution.ErrorType = EPythonExecutionError::SystemError;
+	}
+	Item.bExecuted = true;
+	FinishItem(ItemIndex);
+
+	if (Item.Execution.bSuccess)
+	{
+		UE_LOG(LogUnrealCopilotBatch, Log, TEXT("Ran '%s' in %.2f s"), *Item.Id, Item.Execution.ExecutionTimeSeconds);
+	}
+	else
+	{
+		UE_LOG(LogUnrealCopilotBatch, Warning, TEXT("Script of '%s' failed: %s"), *Item.Id, *Item.Execution.ErrorMessage);
+	}
+}
+
+void UUnrealCopilotBatchCommandlet::OnGenerationComplete(const FCodeGenerationResult& Result, int32 ManagerIndex, int32 ItemIndex)
+{
+	ActiveItems[ManagerIndex] = INDEX_NONE;
+
+	FUnrealCopilotBatchItem& Item = Items[ItemIndex];
+	Item.Generation = Result;
+	Item.bGenerated = true;
+
+	if (!Result.bSuccess)
+	{
+		UE_LOG(LogUnrealCopilotBatch, Warning, TEXT("Code generation for '%s' failed: %s"), *Item.Id, *Result.ErrorMessage);
+		FinishItem(ItemIndex);
+		return;
+	}
+
+	UE_LOG(LogUnrealCopilotBatch, Log, TEXT("Generated code for '%s' in %.2f s"), *Item.Id, Result.GenerationTimeSeconds);
+	if (Item.bExecute)
+	{
+		Item.Script = Result.GeneratedCode;
+		PendingScripts.Add(ItemIndex);
+	}
+	else
+	{
+		FinishItem(ItemIndex);
+	}
+}
+
+void UUnrealCopilotBatchCommandlet::FinishItem(int32 ItemIndex)
+{
+	FUnrealCopilotBatchItem& Item = Items[ItemIndex];
+	Item.EndSeconds = GetBatchSeconds();
+
+	if (bStreamResults)
+	{
+		FString ItemString;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&ItemString);
+		FJsonSerializer::Serialize(MakeItemReport(Item), Writer);
+		UE_LOG(LogUnrealCopilotBatch, Display, TEXT("%s%s"), StreamedResultPrefix, *ItemString);
+	}
+}
+
+double UUnrealCopilotBatchCommandlet::GetBatchSeconds() const
+{
+	return FPlatformTime::Seconds() - BatchStartTime;
+}
@@ -0,0 +1,240 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotCodeBlockExtractor.h"
+
+namespace UnrealCopilotCodeBlockExtractor
+{
+	static FStringView TrimView(FStringView Text)
+	{
+		int32 Start = 0;
+		int32 End = Text.Len();
+		while (Start < End && FChar::IsWhitespace(Text[Start]))
+		{
+			++Start;
+		}
+		while (End > Start && FChar::IsWhitespace(Text[End - 1]))
+		{
+			--End;
+		}
+		return Text.Mid(Start, End - Start);
+	}
+
+	static int32 CountLeadingBackticks(FStringView Text)
+	{
+		int32 Count = 0;
+		while (Count < Text.Len() && Text[Count] == TEXT('`'))
+		{
+			++Count;
+		}
+		return Count;
+	}
+}
+
+void FUnrealCopilotCodeBlockExtractor::AppendText(FStringView Chunk)
+{
+	int32 LineStart = 0;
+	for (int32 Index = 0; Index < Chunk.Len(); ++Index)
+	{
+		if (Chunk[Index] != TEXT('\n'))
+		{
+			continue;
+		}
+
+		const FStringView LineEnd = Chunk.Mid(LineStart, Index - LineStart);
+		if (PendingLine.IsEmpty())
+		{
+			ProcessLine(LineEnd);
+		}
+		else
+		{
+			PendingLine.Append(LineEnd);
+			ProcessLine(PendingLine);
+			PendingLine.Reset();
+		}
+		LineStart = Index + 1;
+	}
+
+	PendingLine.Append(Chunk.Mid(LineStart));
+}
+
+void FUnrealCopilotCodeBlockExtractor::Finish()
+{
+	if (!PendingLine.IsEmpty())
+	{
+		ProcessLine(PendingLine);
+		PendingLine.Reset();
+	}
+}
+
+void FUnrealCopilotCodeBlockExtractor::Reset()
+{
+	Blocks.Reset();
+	PendingLine.Reset();
+	OpenFenceLength = 0;
+}
+
+void FUnrealCopilotCodeBlockExtractor::ProcessLine(FStringView Line)
+{
+	using namespace UnrealCopilotCodeBlockExtractor;
+
+	if (Line.EndsWith(TEXT('\r')))
+	{
+		Line.LeftChopInline(1);
+	}
+
+	int32 FenceLength = 0;
+	FStringView Info;
+
+	if (OpenFenceLength == 0)
+	{
+		if (ParseFence(Line, FenceLength, Info))
+		{
+			FUnrealCopilotCodeBlock& Block = Blocks.AddDefaulted_GetRef();
+			int32 LanguageEnd = 0;
+			while (LanguageEnd < Info.Len() && !FChar::IsWhitespace(Info[LanguageEnd]))
+			{
+				++LanguageEnd;
+			}
+			Block.Language = FString(Info.Left(LanguageEnd)).ToLower();
+			OpenFenceLength = FenceLength;
+		}
+		return;
+	}
+
+	FUnrealCopilotCodeBlock& Block = Blocks.Last();
+
+	// A closing fence is a line of at least as many backticks as the opening one
+	const FStringView Trimmed = TrimView(Line);
+	if (ParseFence(Trimmed, FenceLength, Info) && Info.IsEmpty() && FenceLength >= OpenFenceLength)
+	{
+		Block.bClosed = true;
+		OpenFenceLength = 0;
+		return;
+	}
+
+	// Models sometimes close the block at the end of the last code line
+	int32 TrailingBackticks = 0;
+	while (TrailingBackticks < Trimmed.Len() && Trimmed[Trimmed.Len() - 1 - TrailingBackticks] == TEXT('`'))
+	{
+		++TrailingBackticks;
+	}
+	if (TrailingBackticks >= OpenFenceLength && TrailingBackticks < Trimmed.Len())
+	{
+		const int32 TrimmedStart = (int32)(Trimmed.GetData() - Line.GetData());
+		const int32 CodeLength = TrimmedStart + Trimmed.Len() - TrailingBackticks;
+		Block.Code.Append(Line.Left(CodeLength));
+		Block.Code.AppendChar(TEXT('\n'));
+		Block.bClosed = true;
+		OpenFenceLength = 0;
+		return;
+	}
+
+	Block.Code.Append(Line);
+	Block.Code.AppendChar(TEXT('\n'));
+}
+
+bool FUnrealCopilotCodeBlockExtractor::ParseFence(FStringView Line, int32& OutFenceLength, FStringView& OutInfo)
+{
+	using namespace UnrealCopilotCodeBlockExtractor;
+
+	const FStringView Trimmed = TrimView(Line);
+	OutFenceLength = CountLeadingBackticks(Trimmed);
+	if (OutFenceLength < 3)
+	{
+		return false;
+	}
+
+	// Backticks in the info string mean inline code such as ```x```, not a fence
+	OutInfo = TrimView(Trimmed.Mid(OutFenceLength));
+	int32 BacktickIndex = INDEX_NONE;
+	return !OutInfo.FindChar(TEXT('`'), BacktickIndex);
+}
+
+bool FUnrealCopilotCodeBlockExtractor::IsPythonLanguage(const FString& Language)
+{
+	return Language.IsEmpty() || Language == TEXT("python") || Language == TEXT("py") || Language == TEXT("python3");
+}
+
+FString FUnrealCopilotCodeBlockExtractor::GetCode(EUnrealCopilotCodeBlockSelection Selection) const
+{
+	return SelectCode(Selection, false);
+}
+
+FString FUnrealCopilotCodeBlockExtractor::GetPreviewCode(EUnrealCopilotCodeBlockSelection Selection) const
+{
+	return SelectCode(Selection, true);
+}
+
+FString FUnrealCopilotCodeBlockExtractor::SelectCode(EUnrealCopilotCodeBlockSelection Selection, bool bIncludePendingLine) const
+{
+	using namespace UnrealCopilotCodeBlockExtractor;
+
+	// The partial line of an open block is shown unless it may be the start of the closing fence
+	const bool bAppendPendingLine = bIncludePendingLine && OpenFenceLength > 0 && !PendingLine.IsEmpty() &&
+		!TrimView(PendingLine).StartsWith(TEXT('`'));
+
+	auto GetBlockCode = [this, bAppendPendingLine](int32 BlockIndex)
+	{
+		const FUnrealCopilotCodeBlock& Block = Blocks[BlockIndex];
+		if (bAppendPendingLine && BlockIndex == Blocks.Num() - 1)
+		{
+			return Block.Code + PendingLine;
+		}
+		return Block.Code;
+	};
+
+	TArray<int32, TInlineAllocator<8>> PythonBlocks;
+	for (int32 BlockIndex = 0; BlockIndex < Blocks.Num(); ++BlockIndex)
+	{
+		if (IsPythonLanguage(Blocks[BlockIndex].Language))
+		{
+			PythonBlocks.Add(BlockIndex);
+		}
+	}
+
+	if (PythonBlocks.Num() == 0)
+	{
+		return FString();
+	}
+
+	FString Code;
+	switch (Selection)
+	{
+	case EUnrealCopilotCodeBlockSelection::First:
+		Code = GetBlockCode(PythonBlocks[0]);
+		break;
+
+	case EUnrealCopilotCodeBlockSelection::Last:
+		Code = GetBlockCode(PythonBlocks.Last());
+		break;
+
+	case EUnrealCopilotCodeBlockSelection::Longest:
+	{
+		int32 LongestBlock = PythonBlocks[0];
+		for (int32 BlockIndex : PythonBlocks)
+		{
+			if (Blocks[BlockIndex].Code.Len() > Blocks[LongestBlock].Code.Len())
+			{
+				LongestBlock = BlockIndex;
+			}
+		}
+		Code = GetBlockCode(LongestBlock);
+		break;
+	}
+
+	case EUnrealCopilotCodeBlockSelection::Concatenate:
+	default:
+		for (int32 BlockIndex : PythonBlocks)
+		{
+			if (!Code.IsEmpty())
+			{
+				Code += TEXT("\n");
+			}
+			Code += GetBlockCode(BlockIndex);
+		}
+		break;
+	}
+
+	Code.TrimStartAndEndInline();
+	return Code;
+}
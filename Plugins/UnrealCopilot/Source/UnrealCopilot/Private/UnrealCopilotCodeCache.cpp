@@ -0,0 +1,120 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotCodeCache.h"
+#include "Containers/LruCache.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+
+namespace UnrealCopilotCodeCache
+{
+	static constexpr int32 DefaultCapacity = 128;
+
+	static FCriticalSection CacheLock;
+	static TLruCache<FString, FPythonCodeVerdict> SyntaxVerdicts(DefaultCapacity);
+	static TLruCache<FString, FPythonCodeVerdict> SafetyVerdicts(DefaultCapacity);
+	static int32 Hits = 0;
+	static int32 Misses = 0;
+
+	static TLruCache<FString, FPythonCodeVerdict>& GetVerdicts(EPythonVerdictKind Kind)
+	{
+		return Kind == EPythonVerdictKind::Syntax ? SyntaxVerdicts : SafetyVerdicts;
+	}
+}
+
+FString FUnrealCopilotCodeCache::NormalizeSource(FStringView Source)
+{
+	static constexpr TCHAR ByteOrderMark = 0xFEFF;
+	if (Source.Len() > 0 && Source[0] == ByteOrderMark)
+	{
+		Source.RightChopInline(1);
+	}
+
+	FString Normalized;
+	Normalized.Reserve(Source.Len());
+	for (int32 Index = 0; Index < Source.Len(); ++Index)
+	{
+		const TCHAR Char = Source[Index];
+		if (Char == TEXT('\r'))
+		{
+			// "\r\n" and a lone "\r" both end a line
+			Normalized.AppendChar(TEXT('\n'));
+			if (Index + 1 < Source.Len() && Source[Index + 1] == TEXT('\n'))
+			{
+				++Index;
+			}
+			continue;
+		}
+		Normalized.AppendChar(Char);
+	}
+
+	Normalized.TrimEndInline();
+	return Normalized;
+}
+
+FString FUnrealCopilotCodeCache::HashSource(FStringView NormalizedSource)
+{
+	const FTCHARToUTF8 Utf8Source(NormalizedSource.GetData(), NormalizedSource.Len());
+	FSHAHash Hash;
+	FSHA1::HashBuffer(Utf8Source.Get(), Utf8Source.Length(), Hash.Hash);
+	return Hash.ToString();
+}
+
+bool FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind Kind, const FString& SourceHash, FPythonCodeVerdict& OutVerdict)
+{
+	using namespace UnrealCopilotCodeCache;
+
+	FScopeLock Lock(&CacheLock);
+	if (const FPythonCodeVerdict* Verdict = GetVerdicts(Kind).FindAndTouch(SourceHash))
+	{
+		OutVerdict = *Verdict;
+		++Hits;
+		return true;
+	}
+
+	++Misses;
+	return false;
+}
+
+void FUnrealCopilotCodeCache::AddVerdict(EPythonVerdictKind Kind, const FString& SourceHash, const FPythonCodeVerdict& Verdict)
+{
+	using namespace UnrealCopilotCodeCache;
+
+	FScopeLock Lock(&CacheLock);
+	GetVerdicts(Kind).Add(SourceHash, Verdict);
+}
+
+void FUnrealCopilotCodeCache::InvalidateVerdicts(EPythonVerdictKind Kind)
+{
+	using namespace UnrealCopilotCodeCache;
+
+	FScopeLock Lock(&CacheLock);
+	TLruCache<FString, FPythonCodeVerdict>& Verdicts = GetVerdicts(Kind);
+	Verdicts.Empty(Verdicts.Max());
+}
+
+void FUnrealCopilotCodeCache::SetCapacity(int32 Capacity)
+{
+	using namespace UnrealCopilotCodeCache;
+
+	Capacity = FMath::Max(Capacity, 1);
+
+	FScopeLock Lock(&CacheLock);
+	if (SyntaxVerdicts.Max() != Capacity)
+	{
+		SyntaxVerdicts.Empty(Capacity);
+		SafetyVerdicts.Empty(Capacity);
+	}
+}
+
+FPythonCodeCacheStats FUnrealCopilotCodeCache::GetVerdictStats()
+{
+	using namespace UnrealCopilotCodeCache;
+
+	FScopeLock Lock(&CacheLock);
+	FPythonCodeCacheStats Stats;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Entries = SyntaxVerdicts.Num() + SafetyVerdicts.Num();
+	Stats.Capacity = SyntaxVerdicts.Max() + SafetyVerdicts.Max();
+	return Stats;
+}
@@ -0,0 +1,602 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotEditorTools.h"
+#include "UnrealCopilotLevelCensusSubsystem.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetRegistry/ARFilter.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Tasks/Task.h"
+#include "UObject/UObjectIterator.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#include "Selection.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogUnrealCopilotTools, Log, All);
+
+namespace UnrealCopilotEditorTools
+{
+	/** Tool output is truncated past this length to keep follow-up requests bounded */
+	static constexpr int32 MaxToolOutputLength = 8000;
+
+	/** Description of one tool argument */
+	struct FToolParameter
+	{
+		const TCHAR* Name;
+		const TCHAR* Type;
+		const TCHAR* Description;
+		bool bRequired;
+	};
+
+	static TSharedPtr<FJsonObject> MakeParametersSchema(std::initializer_list<FToolParameter> Parameters)
+	{
+		TSharedPtr<FJsonObject> Schema = MakeShareable(new FJsonObject);
+		Schema->SetStringField(TEXT("type"), TEXT("object"));
+
+		TSharedPtr<FJsonObject> Properties = MakeShareable(new FJsonObject);
+		TArray<TSharedPtr<FJsonValue>> Required;
+		for (const FToolParameter& Parameter : Parameters)
+		{
+			TSharedPtr<FJsonObject> Property = MakeShareable(new FJsonObject);
+			Property->SetStringField(TEXT("type"), Parameter.Type);
+			Property->SetStringField(TEXT("description"), Parameter.Description);
+			Properties->SetObjectField(Parameter.Name, Property);
+
+			if (Parameter.bRequired)
+			{
+				Required.Add(MakeShareable(new FJsonValueString(Parameter.Name)));
+			}
+		}
+
+		Schema->SetObjectField(TEXT("properties"), Properties);
+		Schema->SetArrayField(TEXT("required"), Required);
+		return Schema;
+	}
+
+	static int32 GetMaxResults(const FJsonObject& Arguments, int32 DefaultValue)
+	{
+		int32 MaxResults = DefaultValue;
+		Arguments.TryGetNumberField(TEXT("max_results"), MaxResults);
+		return FMath::Clamp(MaxResults, 1, 100);
+	}
+
+	static bool GetBoolArgument(const FJsonObject& Arguments, const TCHAR* Name)
+	{
+		bool bValue = false;
+		Arguments.TryGetBoolField(Name, bValue);
+		return bValue;
+	}
+
+	static FString FormatVector(const FVector& Vector)
+	{
+		return FString::Printf(TEXT("(%.0f, %.0f, %.0f)"), Vector.X, Vector.Y, Vector.Z);
+	}
+
+	/** Approximate the snake_case name the Python API exposes for a reflected name */
+	static FString PythonizeName(const FString& Name, bool bIsBoolProperty = false)
+	{
+		FString Source = Name;
+		if (bIsBoolProperty && Source.Len() > 1 && Source[0] == TEXT('b') && FChar::IsUpper(Source[1]))
+		{
+			Source.RightChopInline(1);
+		}
+
+		FString Result;
+		Result.Reserve(Source.Len() + 8);
+		for (int32 Index = 0; Index < Source.Len(); ++Index)
+		{
+			const TCHAR Char = Source[Index];
+			if (FChar::IsUpper(Char) && Index > 0)
+			{
+				const TCHAR Previous = Source[Index - 1];
+				const bool bNextIsLower = Index + 1 < Source.Len() && FChar::IsLower(Source[Index + 1]);
+				if (FChar::IsLower(Previous) || FChar::IsDigit(Previous) || (FChar::IsUpper(Previous) && bNextIsLower))
+				{
+					Result += TEXT('_');
+				}
+			}
+			Result += FChar::ToLower(Char);
+		}
+		return Result;
+	}
+
+	/** Normalize a name so Python and reflected spellings compare equal */
+	static FString NormalizeName(const FString& Name)
+	{
+		return Name.Replace(TEXT("_"), TEXT("")).ToLower();
+	}
+
+	static FString GetScriptName(const UField* Field, bool bIsBoolProperty = false)
+	{
+#if WITH_EDITORONLY_DATA
+		const FString& ScriptName = Field->GetMetaData(TEXT("ScriptName"));
+		if (!ScriptName.IsEmpty())
+		{
+			return PythonizeName(ScriptName);
+		}
+#endif
+		return PythonizeName(Field->GetName(), bIsBoolProperty);
+	}
+
+	static FString FormatFunctionSignature(const UFunction* Function)
+	{
+		FString Parameters;
+		FString ReturnType;
+		for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+			{
+				ReturnType = It->GetCPPType();
+				continue;
+			}
+
+			Parameters += Parameters.IsEmpty() ? TEXT("") : TEXT(", ");
+			Parameters += FString::Printf(TEXT("%s: %s%s"),
+				*PythonizeName(It->GetName(), It->IsA<FBoolProperty>()),
+				*It->GetCPPType(),
+				(It->HasAnyPropertyFlags(CPF_OutParm) && !It->HasAnyPropertyFlags(CPF_ConstParm | CPF_ReferenceParm)) ? TEXT(" [out]") : TEXT(""));
+		}
+
+		FString Signature = FString::Printf(TEXT("%s%s(%s)"),
+			Function->HasAnyFunctionFlags(FUNC_Static) ? TEXT("static ") : TEXT(""),
+			*GetScriptName(Function),
+			*Parameters);
+		if (!ReturnType.IsEmpty())
+		{
+			Signature += TEXT(" -> ") + ReturnType;
+		}
+		return Signature;
+	}
+
+	static bool IsScriptCallable(const UFunction* Function)
+	{
+		return Function->HasAnyFunctionFlags(FUNC_BlueprintCallable | FUNC_BlueprintPure);
+	}
+
+	static FString SearchAssets(const FJsonObject& Arguments)
+	{
+		FString Query;
+		FString ClassName;
+		FString Path = TEXT("/Game");
+		Arguments.TryGetStringField(TEXT("query"), Query);
+		Arguments.TryGetStringField(TEXT("class_name"), ClassName);
+		Arguments.TryGetStringField(TEXT("path"), Path);
+		const int32 MaxResults = GetMaxResults(Arguments, 25);
+
+		// On-disk data only, so the registry can be queried from a worker thread
+		FARFilter Filter;
+		Filter.PackagePaths.Add(FName(*Path));
+		Filter.bRecursivePaths = true;
+		Filter.bIncludeOnlyOnDiskAssets = true;
+
+		TArray<FString> Lines;
+		int32 TotalMatches = 0;
+		IAssetRegistry::GetChecked().EnumerateAssets(Filter, [&](const FAssetData& AssetData)
+		{
+			const FString AssetClass = AssetData.AssetClassPath.GetAssetName().ToString();
+			if ((!ClassName.IsEmpty() && !AssetClass.Equals(ClassName, ESearchCase::IgnoreCase)) ||
+				(!Query.IsEmpty() && !AssetData.AssetName.ToString().Contains(Query)))
+			{
+				return true;
+			}
+
+			++TotalMatches;
+			if (Lines.Num() < MaxResults)
+			{
+				Lines.Add(FString::Printf(TEXT("%s (%s)"), *AssetData.GetObjectPathString(), *AssetClass));
+			}
+			return true;
+		});
+
+		if (TotalMatches == 0)
+		{
+			return FString::Printf(TEXT("No assets found under %s."), *Path);
+		}
+
+		Lines.Sort();
+		FString Output = FString::Printf(TEXT("%d matching assets under %s"), TotalMatches, *Path);
+		Output += TotalMatches > Lines.Num() ? FString::Printf(TEXT(" (showing %d):"), Lines.Num()) : TEXT(":");
+		for (const FString& Line : Lines)
+		{
+			Output += TEXT("\n- ") + Line;
+		}
+		return Output;
+	}
+
+	static FString FindActors(const FJsonObject& Arguments)
+	{
+#if WITH_EDITOR
+		FString Name;
+		FString ClassName;
+		FString Folder;
+		Arguments.TryGetStringField(TEXT("name"), Name);
+		Arguments.TryGetStringField(TEXT("class_name"), ClassName);
+		Arguments.TryGetStringField(TEXT("folder"), Folder);
+		const bool bSelectedOnly = GetBoolArgument(Arguments, TEXT("selected_only"));
+		const bool bNearViewport = GetBoolArgument(Arguments, TEXT("near_viewport"));
+		const int32 MaxResults = GetMaxResults(Arguments, 25);
+
+		UWorld* World = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+		if (!World)
+		{
+			return TEXT("Error: no editor world is loaded.");
+		}
+
+		// Candidate set: nearest actors to the camera, the selection, or the whole world
+		TArray<AActor*> Candidates;
+		if (bNearViewport)
+		{
+			if (UUnrealCopilotLevelCensusSubsystem* LevelCensus = UUnrealCopilotLevelCensusSubsystem::Get())
+			{
+				Candidates = LevelCensus->GetActorsNearViewport(100, 0.0f, false);
+			}
+		}
+		else if (bSelectedOnly)
+		{
+			GEditor->GetSelectedActors()->GetSelectedObjects<AActor>(Candidates);
+		}
+		else
+		{
+			for (TActorIterator<AActor> It(World); It; ++It)
+			{
+				Candidates.Add(*It);
+			}
+		}
+
+		FString Output;
+		int32 TotalMatches = 0;
+		for (AActor* Actor : Candidates)
+		{
+			if (!IsValid(Actor) ||
+				(!Name.IsEmpty() && !Actor->GetActorLabel().Contains(Name) && !Actor->GetName().Contains(Name)) ||
+				(!ClassName.IsEmpty() && !Actor->GetClass()->GetName().Equals(ClassName, ESearchCase::IgnoreCase)) ||
+				(!Folder.IsEmpty() && !Actor->GetFolderPath().ToString().StartsWith(Folder)))
+			{
+				continue;
+			}
+
+			++TotalMatches;
+			if (TotalMatches <= MaxResults)
+			{
+				Output += FString::Printf(TEXT("\n- %s [%s] (%s) Location=%s Folder=%s"),
+					*Actor->GetActorLabel(),
+					*Actor->GetName(),
+					*Actor->GetClass()->GetName(),
+					*FormatVector(Actor->GetActorLocation()),
+					Actor->GetFolderPath().IsNone() ? TEXT("(none)") : *Actor->GetFolderPath().ToString());
+			}
+		}
+
+		if (TotalMatches == 0)
+		{
+			return TEXT("No matching actors found.");
+		}
+
+		FString Header = FString::Printf(TEXT("%d matching actors"), TotalMatches);
+		Header += TotalMatches > MaxResults ? FString::Printf(TEXT(" (showing %d):"), MaxResults) : TEXT(":");
+		return Header + Output;
+#else
+		return TEXT("Error: actor lookup is only available in the editor.");
+#endif
+	}
+
+	static FString GetAPISignature(const FJsonObject& Arguments)
+	{
+		FString Name;
+		if (!Arguments.TryGetStringField(TEXT("name"), Name) || Name.IsEmpty())
+		{
+			return TEXT("Error: 'name' is required.");
+		}
+
+		Name.RemoveFromStart(TEXT("unreal."));
+		FString TypeName = Name;
+		FString MemberName;
+		Name.Split(TEXT("."), &TypeName, &MemberName);
+
+		if (const UEnum* Enum = FindFirstObject<UEnum>(*TypeName, EFindFirstObjectOptions::NativeFirst))
+		{
+			FString Output = FString::Printf(TEXT("enum unreal.%s:"), *Enum->GetName());
+			const int32 NumValues = Enum->NumEnums() - (Enum->ContainsExistingMax() ? 1 : 0);
+			for (int32 Index = 0; Index < NumValues; ++Index)
+			{
+				Output += FString::Printf(TEXT("\n- %s"), *PythonizeName(Enum->GetNameStringByIndex(Index)).ToUpper());
+			}
+			return Output;
+		}
+
+		const UStruct* Type = FindFirstObject<UClass>(*TypeName, EFindFirstObjectOptions::NativeFirst);
+		if (!Type)
+		{
+			Type = FindFirstObject<UScriptStruct>(*TypeName, EFindFirstObjectOptions::NativeFirst);
+		}
+		if (!Type)
+		{
+			return FString::Printf(TEXT("Error: no class, struct, or enum named '%s' was found."), *TypeName);
+		}
+
+		const FString NormalizedMember = NormalizeName(MemberName);
+		FString Output;
+
+		// Functions (classes only)
+		if (const UClass* Class = Cast<UClass>(Type))
+		{
+			int32 NumFunctions = 0;
+			for (TFieldIterator<UFunction> It(Class, EFieldIteratorFlags::IncludeSuper); It; ++It)
+			{
+				if (!IsScriptCallable(*It) ||
+					(!NormalizedMember.IsEmpty() && NormalizeName(GetScriptName(*It)) != NormalizedMember))
+				{
+					continue;
+				}
+
+				if (++NumFunctions <= 40)
+				{
+					Output += TEXT("\n- ") + FormatFunctionSignature(*It);
+				}
+			}
+			if (NumFunctions > 40)
+			{
+				Output += FString::Printf(TEXT("\n- ... %d more functions"), NumFunctions - 40);
+			}
+			if (NumFunctions > 0)
+			{
+				Output = TEXT("\nFunctions:") + Output;
+			}
+		}
+
+		// Editor properties
+		FString PropertiesOutput;
+		int32 NumProperties = 0;
+		for (TFieldIterator<FProperty> It(Type, EFieldIteratorFlags::IncludeSuper); It; ++It)
+		{
+			if (!It->HasAnyPropertyFlags(CPF_Edit | CPF_BlueprintVisible) ||
+				(!NormalizedMember.IsEmpty() && NormalizeName(It->GetName()) != NormalizedMember &&
+					NormalizeName(PythonizeName(It->GetName(), It->IsA<FBoolProperty>())) != NormalizedMember))
+			{
+				continue;
+			}
+
+			if (++NumProperties <= 30)
+			{
+				PropertiesOutput += FString::Printf(TEXT("\n- %s: %s"), *PythonizeName(It->GetName(), It->IsA<FBoolProperty>()), *It->GetCPPType());
+			}
+		}
+		if (NumProperties > 30)
+		{
+			PropertiesOutput += FString::Printf(TEXT("\n- ... %d more properties"), NumProperties - 30);
+		}
+		if (NumProperties > 0)
+		{
+			Output += TEXT("\nProperties (get_editor_property / set_editor_property):") + PropertiesOutput;
+		}
+
+		if (Output.IsEmpty())
+		{
+			return NormalizedMember.IsEmpty()
+				? FString::Printf(TEXT("unreal.%s has no script-callable functions or editor properties."), *Type->GetName())
+				: FString::Printf(TEXT("Error: unreal.%s has no function or property named '%s'."), *Type->GetName(), *MemberName);
+		}
+
+		const UStruct* SuperType = Type->GetSuperStruct();
+		return FString::Printf(TEXT("%s unreal.%s%s:%s"),
+			Type->IsA<UClass>() ? TEXT("class") : TEXT("struct"),
+			*Type->GetName(),
+			SuperType ? *FString::Printf(TEXT("(%s)"), *SuperType->GetName()) : TEXT(""),
+			*Output);
+	}
+
+	static FString GetLevelCensus(const FJsonObject& Arguments)
+	{
+		UUnrealCopilotLevelCensusSubsystem* LevelCensus = UUnrealCopilotLevelCensusSubsystem::Get();
+		if (!LevelCensus)
+		{
+			return TEXT("Error: the level census is only available in the editor.");
+		}
+
+		FString Output = TEXT("Level Contents:") + LevelCensus->GetLevelSummary();
+		if (GetBoolArgument(Arguments, TEXT("include_nearby_actors")))
+		{
+			const FString NearbyActors = LevelCensus->GetNearbyActorsSummary(GetMaxResults(Arguments, 15), 0.0f, GetBoolArgument(Arguments, TEXT("in_view_only")));
+			if (!NearbyActors.IsEmpty())
+			{
+				Output += TEXT("\n\nActors Near The Viewport Camera:") + NearbyActors;
+			}
+		}
+		return Output;
+	}
+}
+
+FUnrealCopilotEditorTools& FUnrealCopilotEditorTools::Get()
+{
+	static FUnrealCopilotEditorTools Instance;
+	return Instance;
+}
+
+FUnrealCopilotEditorTools::FUnrealCopilotEditorTools()
+{
+	RegisterBuiltinTools();
+}
+
+void FUnrealCopilotEditorTools::RegisterTool(const FUnrealCopilotToolDefinition& Definition)
+{
+	check(IsInGameThread());
+
+	Tools.RemoveAll([&Definition](const FUnrealCopilotToolDefinition& Tool)
+	{
+		return Tool.Name == Definition.Name;
+	});
+	Tools.Add(Definition);
+}
+
+const FUnrealCopilotToolDefinition* FUnrealCopilotEditorTools::FindTool(const FString& Name) const
+{
+	return Tools.FindByPredicate([&Name](const FUnrealCopilotToolDefinition& Tool)
+	{
+		return Tool.Name == Name;
+	});
+}
+
+TArray<TSharedPtr<FJsonValue>> FUnrealCopilotEditorTools::CreateChatCompletionsToolsJson() const
+{
+	TArray<TSharedPtr<FJsonValue>> ToolsJson;
+	for (const FUnrealCopilotToolDefinition& Tool : Tools)
+	{
+		TSharedPtr<FJsonObject> Function = MakeShareable(new FJsonObject);
+		Function->SetStringField(TEXT("name"), Tool.Name);
+		Function->SetStringField(TEXT("description"), Tool.Description);
+		Function->SetObjectField(TEXT("parameters"), Tool.Parameters);
+
+		TSharedPtr<FJsonObject> ToolObj = MakeShareable(new FJsonObject);
+		ToolObj->SetStringField(TEXT("type"), TEXT("function"));
+		ToolObj->SetObjectField(TEXT("function"), Function);
+		ToolsJson.Add(MakeShareable(new FJsonValueObject(ToolObj)));
+	}
+	return ToolsJson;
+}
+
+TArray<TSharedPtr<FJsonValue>> FUnrealCopilotEditorTools::CreateResponsesToolsJson() const
+{
+	TArray<TSharedPtr<FJsonValue>> ToolsJson;
+	for (const FUnrealCopilotToolDefinition& Tool : Tools)
+	{
+		TSharedPtr<FJsonObject> ToolObj = MakeShareable(new FJsonObject);
+		ToolObj->SetStringField(TEXT("type"), TEXT("function"));
+		ToolObj->SetStringField(TEXT("name"), Tool.Name);
+		ToolObj->SetStringField(TEXT("description"), Tool.Description);
+		ToolObj->SetObjectField(TEXT("parameters"), Tool.Parameters);
+		ToolsJson.Add(MakeShareable(new FJsonValueObject(ToolObj)));
+	}
+	return ToolsJson;
+}
+
+TArray<FUnrealCopilotToolResult> FUnrealCopilotEditorTools::ExecuteToolCalls(const TArray<FUnrealCopilotToolCall>& Calls) const
+{
+	check(IsInGameThread());
+
+	TArray<FUnrealCopilotToolResult> Results;
+	Results.SetNum(Calls.Num());
+
+	// Launch thread-safe tools first so they overlap with the game-thread ones
+	TArray<UE::Tasks::FTask> Tasks;
+	for (int32 Index = 0; Index < Calls.Num(); ++Index)
+	{
+		const FUnrealCopilotToolDefinition* Tool = FindTool(Calls[Index].Name);
+		if (Tool && Tool->bThreadSafe)
+		{
+			Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [Tool, &Call = Calls[Index], &Result = Results[Index]]()
+			{
+				Result = ExecuteToolCall(Tool, Call);
+			}));
+		}
+	}
+
+	for (int32 Index = 0; Index < Calls.Num(); ++Index)
+	{
+		const FUnrealCopilotToolDefinition* Tool = FindTool(Calls[Index].Name);
+		if (!Tool || !Tool->bThreadSafe)
+		{
+			Results[Index] = ExecuteToolCall(Tool, Calls[Index]);
+		}
+	}
+
+	UE::Tasks::Wait(Tasks);
+	return Results;
+}
+
+FUnrealCopilotToolResult FUnrealCopilotEditorTools::ExecuteToolCall(const FUnrealCopilotToolDefinition* Tool, const FUnrealCopilotToolCall& Call)
+{
+	FUnrealCopilotToolResult Result;
+	Result.CallId = Call.CallId;
+
+	if (!Tool)
+	{
+		Result.Output = FString::Printf(TEXT("Error: unknown tool '%s'."), *Call.Name);
+		return Result;
+	}
+
+	TSharedPtr<FJsonObject> Arguments = MakeShareable(new FJsonObject);
+	if (!Call.Arguments.TrimStartAndEnd().IsEmpty())
+	{
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Call.Arguments);
+		if (!FJsonSerializer::Deserialize(Reader, Arguments) || !Arguments.IsValid())
+		{
+			Result.Output = FString::Printf(TEXT("Error: arguments for '%s' are not a valid JSON object."), *Call.Name);
+			return Result;
+		}
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	Result.Output = Tool->Handler(*Arguments);
+	Result.bSuccess = !Result.Output.StartsWith(TEXT("Error:"));
+
+	if (Result.Output.Len() > UnrealCopilotEditorTools::MaxToolOutputLength)
+	{
+		Result.Output.LeftInline(UnrealCopilotEditorTools::MaxToolOutputLength);
+		Result.Output += TEXT("\n... (output truncated; narrow the query)");
+	}
+
+	UE_LOG(LogUnrealCopilotTools, Verbose, TEXT("Tool %s(%s) ran in %.2f ms"),
+		*Call.Name, *Call.Arguments, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return Result;
+}
+
+void FUnrealCopilotEditorTools::RegisterBuiltinTools()
+{
+	using namespace UnrealCopilotEditorTools;
+
+	FUnrealCopilotToolDefinition SearchAssetsTool;
+	SearchAssetsTool.Name = TEXT("search_assets");
+	SearchAssetsTool.Description = TEXT("Search saved assets in the project by name, class, and content path. Returns object paths usable with unreal.EditorAssetLibrary.load_asset.");
+	SearchAssetsTool.Parameters = MakeParametersSchema({
+		{ TEXT("query"), TEXT("string"), TEXT("Substring of the asset name (case-insensitive)"), false },
+		{ TEXT("class_name"), TEXT("string"), TEXT("Asset class name, e.g. StaticMesh, Material, Texture2D"), false },
+		{ TEXT("path"), TEXT("string"), TEXT("Content path to search recursively (default /Game)"), false },
+		{ TEXT("max_results"), TEXT("integer"), TEXT("Maximum number of assets to list (default 25)"), false }
+	});
+	SearchAssetsTool.bThreadSafe = true;
+	SearchAssetsTool.Handler = &SearchAssets;
+	Tools.Add(SearchAssetsTool);
+
+	FUnrealCopilotToolDefinition FindActorsTool;
+	FindActorsTool.Name = TEXT("find_actors");
+	FindActorsTool.Description = TEXT("Look up actors in the current level by label, class, or outliner folder. Can be limited to the selection or to actors near the viewport camera.");
+	FindActorsTool.Parameters = MakeParametersSchema({
+		{ TEXT("name"), TEXT("string"), TEXT("Substring of the actor label or name"), false },
+		{ TEXT("class_name"), TEXT("string"), TEXT("Exact actor class name, e.g. StaticMeshActor, PointLight"), false },
+		{ TEXT("folder"), TEXT("string"), TEXT("Outliner folder path prefix"), false },
+		{ TEXT("selected_only"), TEXT("boolean"), TEXT("Only consider selected actors"), false },
+		{ TEXT("near_viewport"), TEXT("boolean"), TEXT("Only consider the actors closest to the viewport camera, nearest first"), false },
+		{ TEXT("max_results"), TEXT("integer"), TEXT("Maximum number of actors to list (default 25)"), false }
+	});
+	FindActorsTool.bThreadSafe = false;
+	FindActorsTool.Handler = &FindActors;
+	Tools.Add(FindActorsTool);
+
+	FUnrealCopilotToolDefinition APISignatureTool;
+	APISignatureTool.Name = TEXT("get_api_signature");
+	APISignatureTool.Description = TEXT("Look up the Python API of an unreal class, struct, or enum, or of one of its functions or properties, e.g. 'EditorActorSubsystem' or 'unreal.EditorAssetLibrary.rename_asset'.");
+	APISignatureTool.Parameters = MakeParametersSchema({
+		{ TEXT("name"), TEXT("string"), TEXT("Type name, optionally followed by '.member'"), true }
+	});
+	APISignatureTool.bThreadSafe = false;
+	APISignatureTool.Handler = &GetAPISignature;
+	Tools.Add(APISignatureTool);
+
+	FUnrealCopilotToolDefinition LevelCensusTool;
+	LevelCensusTool.Name = TEXT("get_level_census");
+	LevelCensusTool.Description = TEXT("Summarize the current level: actor counts by class, outliner folders, bounds, streaming levels, and data layers. Optionally lists the actors nearest the viewport camera.");
+	LevelCensusTool.Parameters = MakeParametersSchema({
+		{ TEXT("include_nearby_actors"), TEXT("boolean"), TEXT("Also list the actors nearest the viewport camera"), false },
+		{ TEXT("in_view_only"), TEXT("boolean"), TEXT("Only list nearby actors inside the camera's view"), false },
+		{ TEXT("max_results"), TEXT("integer"), TEXT("Maximum number of nearby actors to list (default 15)"), false }
+	});
+	LevelCensusTool.bThreadSafe = false;
+	LevelCensusTool.Handler = &GetLevelCensus;
+	Tools.Add(LevelCensusTool);
+}
@@ -1,36 +1,80 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "UnrealCopilotExecutionManager.h"
+#include "UnrealCopilotPythonParser.h"
+#include "UnrealCopilotSettings.h"
+#include "UnrealCopilotExecutionWatchdog.h"
+#include "UnrealCopilotPythonBridge.h"
+#include "UnrealCopilotCodeCache.h"
+#include "UnrealCopilotHistoryStore.h"
+#include "UnrealCopilotHistorySearchIndex.h"
+#include "Misc/ScopeExit.h"
 #include "IPythonScriptPlugin.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
 #include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "Misc/DateTime.h"
 #include "Engine/Engine.h"
 #include "HAL/PlatformProcess.h"
 #include "Async/AsyncWork.h"
+#include "Async/Async.h"
+#include "Algo/BinarySearch.h"
 #include "Json.h"
 
 DEFINE_LOG_CATEGORY(LogUnrealCopilotExecution);
 
+namespace UnrealCopilotExecutionManager
+{
+	/** Read an entry saved as a JSON object by an earlier version */
+	static FPythonExecutionHistoryEntry ReadLegacyEntry(const FJsonObject& EntryObject)
+	{
+		FPythonExecutionHistoryEntry Entry;
+		EntryObject.TryGetStringField(TEXT("Code"), Entry.Code);
+		EntryObject.TryGetBoolField(TEXT("Success"), Entry.bWasSuccessful);
+		EntryObject.TryGetStringField(TEXT("Summary"), Entry.ResultSummary);
+
+		FString TimestampString;
+		if (EntryObject.TryGetStringField(TEXT("Timestamp"), TimestampString))
+		{
+			FDateTime::Parse(TimestampString, Entry.Timestamp);
+		}
+		return Entry;
+	}
+}
+
 // Singleton instance
 UUnrealCopilotExecutionManager* UUnrealCopilotExecutionManager::Instance = nullptr;
+bool UUnrealCopilotExecutionManager::bHistoryDisabled = false;
 
 UUnrealCopilotExecutionManager::UUnrealCopilotExecutionManager()
 	: CurrentState(EPythonExecutionState::Idle)
 	, ExecutionTimeoutSeconds(30.0f)
-	, MaxHistoryEntries(50)
+	, MaxHistoryEntries(100000)
 	, ExecutionStartTime(0.0)
 	, bExecutionCancelled(false)
 {
-	// Load execution history from disk
-	LoadHistoryFromDisk();
+	OutputCapture.OnLineCaptured.AddLambda([this](const FPythonOutputLine& Line)
+	{
+		OnExecutionOutput.Broadcast(Line);
+	});
+
+	// The history is loaded on first use, so creating a manager never touches the disk
 }
 
 UUnrealCopilotExecutionManager::~UUnrealCopilotExecutionManager()
 {
-	// Save history before destruction
-	SaveHistoryToDisk();
+	if (AsyncTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(AsyncTickerHandle);
+	}
+
+	// The stores write their queued entries before they are destroyed
+	WaitForHistory();
+	HistoryStore.Reset();
+	PromptHistoryStore.Reset();
 }
 
 UUnrealCopilotExecutionManager* UUnrealCopilotExecutionManager::GetInstance()
@@ -43,16 +87,68 @@ UUnrealCopilotExecutionManager* UUnrealCopilotExecutionManager::GetInstance()
 	return Instance;
 }
 
-FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCode(const FString& PythonCode, bool bAsync)
+bool UUnrealCopilotExecutionManager::IsHistoryLoaded() const
+{
+	FScopeLock PendingLock(&PendingHistoryCriticalSection);
+	return bHistoryOpen;
+}
+
+void UUnrealCopilotExecutionManager::BeginLoadHistory()
 {
 	FScopeLock Lock(&ExecutionCriticalSection);
+	if (HistoryLoadedFuture.IsValid() || IsHistoryLoaded() || IsHistoryDisabled() || HasAnyFlags(RF_ClassDefaultObject))
+	{
+		return;
+	}
 
-	// Check if we're already executing
-	if (CurrentState == EPythonExecutionState::Executing)
+	// Opening the stores merges the last session's journals, may compact them and indexes every entry for search,
+	// which takes time proportional to the history, so it runs on a worker thread and only once something needs it
+	TWeakObjectPtr<UUnrealCopilotExecutionManager> WeakThis(this);
+	HistoryLoadedFuture = Async(EAsyncExecution::ThreadPool,
+		[this]()
+		{
+			ReadHistoryFromDisk();
+		},
+		[WeakThis]()
+		{
+			AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+			{
+				if (WeakThis.IsValid())
+				{
+					WeakThis->OnHistoryLoaded.Broadcast();
+				}
+			});
+		}).Share();
+}
+
+void UUnrealCopilotExecutionManager::WaitForHistory() const
+{
+	if (HistoryLoadedFuture.IsValid() && !HistoryLoadedFuture.IsReady())
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		HistoryLoadedFuture.Wait();
+		UE_LOG(LogUnrealCopilotExecution, Verbose, TEXT("Waited %.1f ms for the history to load"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+}
+
+void UUnrealCopilotExecutionManager::LoadHistoryIfNeeded() const
+{
+	// Reads are const, but the stores they read are only opened on first use
+	const_cast<UUnrealCopilotExecutionManager*>(this)->BeginLoadHistory();
+	WaitForHistory();
+}
+
+FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCode(const FString& PythonCode, bool bAsync, int32 SessionId, EPythonExecutionPriority Priority)
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+
+	// A synchronous caller expects its script to have run on return, so one arriving while others run fails rather than queues
+	const bool bAlreadyExecuting = CurrentState == EPythonExecutionState::Executing;
+	if (bAlreadyExecuting && !bAsync)
 	{
 		FPythonExecutionResult BusyResult;
 		BusyResult.bSuccess = false;
-		BusyResult.ErrorMessage = TEXT("Python execution is already in progress. Please wait for current execution to complete.");
+		BusyResult.ErrorMessage = TEXT("Another Python script is running; execute asynchronously to queue this one");
 		BusyResult.ErrorType = EPythonExecutionError::SystemError;
 		return BusyResult;
 	}
@@ -61,26 +157,55 @@ FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCode(const F
 	bExecutionCancelled = false;
 
 	// Validate syntax first
-	SetExecutionState(EPythonExecutionState::Validating);
+	if (!bAlreadyExecuting)
+	{
+		SetExecutionState(EPythonExecutionState::Validating);
+	}
 	
+	// Scripts are identified by their normalized source, which also keys the cached verdicts and compiled code
+	const FString NormalizedCode = FUnrealCopilotCodeCache::NormalizeSource(PythonCode);
+	const FString CodeHash = FUnrealCopilotCodeCache::HashSource(NormalizedCode);
+
 	FString ValidationError;
-	if (!ValidatePythonSyntax(PythonCode, ValidationError))
+	int32 ValidationErrorLine = -1;
+	CheckSyntax(NormalizedCode, CodeHash, ValidationError, ValidationErrorLine);
+
+	if (!ValidationError.IsEmpty())
 	{
 		FPythonExecutionResult ValidationResult;
 		ValidationResult.bSuccess = false;
 		ValidationResult.ErrorMessage = ValidationError;
 		ValidationResult.ErrorType = EPythonExecutionError::SyntaxError;
-		SetExecutionState(EPythonExecutionState::Error);
+		ValidationResult.ErrorLineNumber = ValidationErrorLine;
+		if (!bAlreadyExecuting)
+		{
+			SetExecutionState(EPythonExecutionState::Error);
+		}
 		
 		// Add to history
 		AddToHistory(PythonCode, false, FString::Printf(TEXT("Syntax Error: %s"), *ValidationError));
+
+		// Asynchronous callers only hear about results through the delegate
+		if (bAsync)
+		{
+			OnExecutionCompleted.Broadcast(ValidationResult);
+		}
 		
 		return ValidationResult;
 	}
 
-	// Execute the code (currently only synchronous)
+	if (bAsync)
+	{
+		FPythonExecutionResult QueuedResult;
+		QueuedResult.bSuccess = true;
+		QueuedResult.bQueued = true;
+		QueuedResult.ExecutionId = QueueAsyncExecution(NormalizedCode, CodeHash, SessionId, Priority);
+		QueuedResult.Output = TEXT("Python execution queued");
+		return QueuedResult;
+	}
+
 	SetExecutionState(EPythonExecutionState::Executing);
-	FPythonExecutionResult Result = ExecutePythonCodeSynchronous(PythonCode);
+	FPythonExecutionResult Result = ExecutePythonCodeSynchronous(NormalizedCode, CodeHash, SessionId);
 
 	// Update state based on result
 	if (Result.bSuccess)
@@ -104,180 +229,735 @@ FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCode(const F
 
 bool UUnrealCopilotExecutionManager::ValidatePythonSyntax(const FString& PythonCode, FString& OutErrorMessage)
 {
-	if (PythonCode.IsEmpty())
+	const FString NormalizedCode = FUnrealCopilotCodeCache::NormalizeSource(PythonCode);
+	int32 ErrorLine = -1;
+	return CheckSyntax(NormalizedCode, FUnrealCopilotCodeCache::HashSource(NormalizedCode), OutErrorMessage, ErrorLine);
+}
+
+bool UUnrealCopilotExecutionManager::CheckSyntax(const FString& NormalizedCode, const FString& CodeHash, FString& OutErrorMessage, int32& OutErrorLine) const
+{
+	if (NormalizedCode.IsEmpty())
 	{
 		OutErrorMessage = TEXT("Python code is empty");
+		OutErrorLine = -1;
 		return false;
 	}
 
-	// Check if PythonScriptPlugin is available
+	FPythonCodeVerdict Verdict;
+	if (!FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind::Syntax, CodeHash, Verdict))
+	{
+		// Parsed natively so validation neither needs nor blocks the interpreter
+		FPythonAst Ast;
+		FPythonSyntaxError Error;
+		Verdict.bValid = FUnrealCopilotPythonParser::Parse(NormalizedCode, Ast, Error);
+		if (!Verdict.bValid)
+		{
+			Verdict.ErrorMessage = Error.ToString();
+			Verdict.ErrorLine = Error.Line;
+		}
+		FUnrealCopilotCodeCache::AddVerdict(EPythonVerdictKind::Syntax, CodeHash, Verdict);
+	}
+
+	OutErrorMessage = Verdict.ErrorMessage;
+	OutErrorLine = Verdict.ErrorLine;
+	return Verdict.bValid;
+}
+
+void UUnrealCopilotExecutionManager::GetCodeCacheStats(FPythonCodeCacheStats& OutCompiledCode, FPythonCodeCacheStats& OutValidation) const
+{
+	OutCompiledCode = FPythonCodeCacheStats();
+	FUnrealCopilotPythonBridge::GetCodeCacheStats(OutCompiledCode);
+	OutValidation = FUnrealCopilotCodeCache::GetVerdictStats();
+}
+
+void UUnrealCopilotExecutionManager::ApplyCodeCacheSettings()
+{
+	const int32 CodeCacheSize = UUnrealCopilotSettings::Get()->CodeCacheSize;
+	if (CodeCacheSize != AppliedCodeCacheSize)
+	{
+		FUnrealCopilotCodeCache::SetCapacity(CodeCacheSize);
+		FUnrealCopilotPythonBridge::ConfigureCodeCache(CodeCacheSize);
+		AppliedCodeCacheSize = CodeCacheSize;
+	}
+}
+
+bool UUnrealCopilotExecutionManager::WarmUpPythonEnvironment()
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+
+	if (bPythonWarmUpAttempted)
+	{
+		return bPythonEnvironmentWarm;
+	}
+
 	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
 	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
 	{
-		OutErrorMessage = TEXT("Python is not available");
 		return false;
 	}
 
-	// Use Python's compile function to validate syntax
-	FString ValidationCode = FString::Printf(TEXT(
-		"try:\n"
-		"    compile(r'''%s''', '<string>', 'exec')\n"
-		"    print('SYNTAX_VALID')\n"
-		"except SyntaxError as e:\n"
-		"    print(f'SYNTAX_ERROR: Line {e.lineno}: {e.msg}')\n"
-		"except Exception as e:\n"
-		"    print(f'VALIDATION_ERROR: {str(e)}')\n"
-	), *PythonCode.Replace(TEXT("'''"), TEXT("\\'\\'\\'")));
-
-	// Execute validation code using ExecuteFile mode for multi-statement support
-	FPythonCommandEx ValidationCommand;
-	ValidationCommand.Command = ValidationCode;
-	ValidationCommand.ExecutionMode = EPythonCommandExecutionMode::ExecuteFile;
-
-	// Capture output (this is a simplified approach - in a real implementation,
-	// we would need to capture stdout properly)
-	bool bValidationSuccess = PythonPlugin->ExecPythonCommandEx(ValidationCommand);
-	
-	if (!bValidationSuccess)
+	bPythonWarmUpAttempted = true;
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Configuring the code cache imports the runtime module, which loads the modules it depends on
+	ApplyCodeCacheSettings();
+
+	const TArray<FString>& PreloadedModules = UUnrealCopilotSettings::Get()->PreloadedPythonModules;
+	double ImportSeconds = 0.0;
+	TArray<FString> FailedModules;
+	if (FUnrealCopilotPythonBridge::WarmUp(PreloadedModules, ImportSeconds, FailedModules) != EPythonBridgeStatus::Succeeded)
 	{
-		OutErrorMessage = TEXT("Failed to validate Python syntax");
+		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to warm up the Python environment; scripts will load modules on first use"));
 		return false;
 	}
 
-	// For now, we'll assume syntax is valid if the validation command executed
-	// In a more complete implementation, we would capture and parse the output
-	OutErrorMessage.Empty();
+	for (const FString& FailedModule : FailedModules)
+	{
+		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Could not preload Python module '%s'"), *FailedModule);
+	}
+
+	bPythonEnvironmentWarm = true;
+	PythonWarmUpSeconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Python environment warmed up in %.1f ms (%.1f ms importing %d preloaded modules)"),
+		PythonWarmUpSeconds * 1000.0f, ImportSeconds * 1000.0, PreloadedModules.Num() - FailedModules.Num());
 	return true;
 }
 
+void UUnrealCopilotExecutionManager::ResetExecutionSession(int32 SessionId)
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+
+	// A script of the session that is still running keeps the old namespace until it finishes
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (SessionId > 0 && PythonPlugin && PythonPlugin->IsPythonAvailable())
+	{
+		FUnrealCopilotPythonBridge::ResetSession(SessionId);
+		UE_LOG(LogUnrealCopilotExecution, Verbose, TEXT("Execution session %d reset"), SessionId);
+	}
+}
+
 void UUnrealCopilotExecutionManager::CancelExecution()
 {
+	// A script that is running right now holds the lock, so interrupt it first
+	if (Watchdog.IsValid())
+	{
+		Watchdog->RequestCancel();
+	}
+
 	FScopeLock Lock(&ExecutionCriticalSection);
 	
 	if (CurrentState == EPythonExecutionState::Executing)
 	{
 		bExecutionCancelled = true;
+
+		// Queued scripts never started; they are dropped, but their callers still hear that they will not run
+		TArray<FAsyncExecution> CancelledExecutions = MoveTemp(PendingAsyncExecutions);
+		PendingAsyncExecutions.Reset();
+
+		if (ActiveAsyncExecution.IsSet())
+		{
+			CancelActiveAsyncExecution();
+
+			FPythonExecutionResult Result;
+			Result.bSuccess = false;
+			Result.Output = GetCapturedOutput();
+			Result.ErrorMessage = TEXT("Python execution cancelled by user");
+			Result.ErrorType = EPythonExecutionError::SystemError;
+			FinishAsyncExecution(Result);
+		}
+
+		for (const FAsyncExecution& CancelledExecution : CancelledExecutions)
+		{
+			FPythonExecutionResult Result;
+			Result.bSuccess = false;
+			Result.ErrorMessage = TEXT("Python execution cancelled by user before it started");
+			Result.ErrorType = EPythonExecutionError::SystemError;
+			Result.ExecutionId = CancelledExecution.JobId;
+			OnExecutionCompleted.Broadcast(Result);
+		}
+
 		SetExecutionState(EPythonExecutionState::Idle);
 		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Python execution cancelled by user"));
 	}
 }
 
+FPythonExecutionQueueStats UUnrealCopilotExecutionManager::GetExecutionQueueStats() const
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+
+	FPythonExecutionQueueStats Stats;
+	const double Now = FPlatformTime::Seconds();
+	for (const FAsyncExecution& Execution : PendingAsyncExecutions)
+	{
+		++(Execution.Priority == EPythonExecutionPriority::Interactive ? Stats.QueuedInteractive : Stats.QueuedBatch);
+		Stats.OldestWaitSeconds = FMath::Max(Stats.OldestWaitSeconds, static_cast<float>(Now - Execution.QueueTime));
+	}
+
+	const FQueueWaitStats& Interactive = QueueWaitStats[static_cast<int32>(EPythonExecutionPriority::Interactive)];
+	Stats.StartedInteractive = Interactive.Started;
+	Stats.AverageInteractiveWaitSeconds = Interactive.Started > 0 ? static_cast<float>(Interactive.TotalWaitSeconds / Interactive.Started) : 0.0f;
+	Stats.MaxInteractiveWaitSeconds = static_cast<float>(Interactive.MaxWaitSeconds);
+
+	const FQueueWaitStats& Batch = QueueWaitStats[static_cast<int32>(EPythonExecutionPriority::Batch)];
+	Stats.StartedBatch = Batch.Started;
+	Stats.AverageBatchWaitSeconds = Batch.Started > 0 ? static_cast<float>(Batch.TotalWaitSeconds / Batch.Started) : 0.0f;
+	Stats.MaxBatchWaitSeconds = static_cast<float>(Batch.MaxWaitSeconds);
+
+	Stats.LastFrameExecutionMs = static_cast<float>(LastFrameExecutionSeconds * 1000.0);
+	return Stats;
+}
+
+int32 UUnrealCopilotExecutionManager::QueueAsyncExecution(const FString& PythonCode, const FString& CodeHash, int32 SessionId, EPythonExecutionPriority Priority)
+{
+	// Scripts of a priority keep their order, behind every script of a higher one
+	const int32 InsertIndex = Algo::UpperBoundBy(PendingAsyncExecutions, Priority, &FAsyncExecution::Priority);
+	FAsyncExecution& Execution = PendingAsyncExecutions.InsertDefaulted_GetRef(InsertIndex);
+	Execution.JobId = NextAsyncJobId++;
+	Execution.Code = PythonCode;
+	Execution.CodeHash = CodeHash;
+	Execution.SessionId = SessionId;
+	Execution.Priority = Priority;
+	Execution.QueueTime = FPlatformTime::Seconds();
+
+	SetExecutionState(EPythonExecutionState::Executing);
+
+	if (!AsyncTickerHandle.IsValid())
+	{
+		AsyncTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UUnrealCopilotExecutionManager::TickAsyncExecution));
+	}
+	return Execution.JobId;
+}
+
+bool UUnrealCopilotExecutionManager::TickAsyncExecution(float DeltaTime)
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+
+	// Interactive scripts are queued ahead of batch ones, so they spend the frame budget first and batch scripts run
+	// in what is left; scripts that finish early hand the rest of the budget to the next one
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+	const double FrameBudgetSeconds = Settings->ScriptFrameBudgetMs / 1000.0;
+	const double TimeSliceSeconds = Settings->AsyncExecutionTimeSliceMs / 1000.0;
+	const double TickStartTime = FPlatformTime::Seconds();
+
+	double RemainingSeconds = FrameBudgetSeconds;
+	while (RemainingSeconds > 0.0)
+	{
+		if (!ActiveAsyncExecution.IsSet())
+		{
+			while (PendingAsyncExecutions.Num() > 0 && !StartNextAsyncExecution())
+			{
+			}
+
+			if (!ActiveAsyncExecution.IsSet())
+			{
+				break;
+			}
+		}
+
+		StepActiveAsyncExecution(FMath::Min(TimeSliceSeconds, RemainingSeconds));
+		RemainingSeconds = FrameBudgetSeconds - (FPlatformTime::Seconds() - TickStartTime);
+	}
+	LastFrameExecutionSeconds = FPlatformTime::Seconds() - TickStartTime;
+
+	if (ActiveAsyncExecution.IsSet())
+	{
+		ActiveAsyncExecution->Progress.QueuedExecutions = PendingAsyncExecutions.Num();
+		OnExecutionProgress.Broadcast(ActiveAsyncExecution->Progress);
+		return true;
+	}
+
+	if (PendingAsyncExecutions.Num() > 0)
+	{
+		return true;
+	}
+
+	// Nothing left to run; the ticker is registered again by the next queued script
+	AsyncTickerHandle.Reset();
+	return false;
+}
+
+void UUnrealCopilotExecutionManager::StepActiveAsyncExecution(double TimeSliceSeconds)
+{
+	FAsyncExecution& Execution = ActiveAsyncExecution.GetValue();
+
+	FUnrealCopilotExecutionWatchdog& ExecutionWatchdog = GetWatchdog();
+	FPythonJobStep Step;
+	EPythonBridgeStatus StepStatus = EPythonBridgeStatus::Unavailable;
+	{
+		FUnrealCopilotOutputCapture::FScope CaptureScope(OutputCapture);
+		ExecutionWatchdog.EnterPython();
+		StepStatus = FUnrealCopilotPythonBridge::StepJob(Execution.JobId, TimeSliceSeconds, Step);
+		ExecutionWatchdog.LeavePython();
+	}
+
+	if (StepStatus == EPythonBridgeStatus::Succeeded)
+	{
+		Execution.Progress.StatementsCompleted = Step.StatementsCompleted;
+		Execution.Progress.TotalStatements = Step.TotalStatements;
+		Execution.Progress.StepsCompleted = Step.StepsCompleted;
+	}
+	Execution.Progress.ElapsedSeconds = FPlatformTime::Seconds() - Execution.StartTime;
+
+	// The watchdog interrupts a slice that overruns the timeout; a timeout between slices is caught here
+	const EExecutionInterruptReason InterruptReason = ExecutionWatchdog.GetInterruptReason();
+	if (InterruptReason != EExecutionInterruptReason::None)
+	{
+		// An interrupted step reports no state, so the job is cancelled whether or not it is still alive; cancelling a
+		// job the runtime already dropped does nothing
+		CancelActiveAsyncExecution();
+
+		FPythonExecutionResult Result;
+		MakeInterruptedResult(InterruptReason, GetCapturedOutput(), Execution.Progress.ElapsedSeconds, Result);
+		FinishAsyncExecution(Result);
+		return;
+	}
+
+	if (Step.State == EPythonJobState::Running)
+	{
+		return;
+	}
+
+	FPythonExecutionResult Result;
+	FillResultFromCapture(Step.State == EPythonJobState::Done,
+		StepStatus == EPythonBridgeStatus::Unavailable ? TEXT("Python is not available or not initialized") : FString(), Result);
+	FinishAsyncExecution(Result);
+}
+
+bool UUnrealCopilotExecutionManager::StartNextAsyncExecution()
+{
+	FAsyncExecution Execution = PendingAsyncExecutions[0];
+	PendingAsyncExecutions.RemoveAt(0);
+	Execution.StartTime = FPlatformTime::Seconds();
+
+	const double WaitSeconds = Execution.StartTime - Execution.QueueTime;
+	FQueueWaitStats& WaitStats = QueueWaitStats[static_cast<int32>(Execution.Priority)];
+	++WaitStats.Started;
+	WaitStats.TotalWaitSeconds += WaitSeconds;
+	WaitStats.MaxWaitSeconds = FMath::Max(WaitStats.MaxWaitSeconds, WaitSeconds);
+
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	FString StartError;
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		StartError = TEXT("Python is not available or not initialized");
+	}
+	else
+	{
+		WarmUpPythonEnvironment();
+		OutputCapture.Reset(UUnrealCopilotSettings::Get()->MaxCapturedOutputLines);
+		ApplyCodeCacheSettings();
+
+		EPythonBridgeStatus StartStatus = EPythonBridgeStatus::Unavailable;
+		{
+			FUnrealCopilotOutputCapture::FScope CaptureScope(OutputCapture);
+			StartStatus = FUnrealCopilotPythonBridge::StartJob(Execution.JobId, Execution.Code, Execution.CodeHash, Execution.SessionId, Execution.Progress.TotalStatements);
+		}
+
+		if (StartStatus == EPythonBridgeStatus::Succeeded)
+		{
+			ActiveAsyncExecution = MoveTemp(Execution);
+			GetWatchdog().Arm(ExecutionTimeoutSeconds);
+			return true;
+		}
+
+		StartError = OutputCapture.GetText(EPythonOutputStream::Stderr);
+		if (StartError.IsEmpty())
+		{
+			StartError = TEXT("Failed to start asynchronous Python execution");
+		}
+	}
+
+	ActiveAsyncExecution = MoveTemp(Execution);
+
+	FPythonExecutionResult Result;
+	Result.bSuccess = false;
+	Result.ErrorMessage = StartError;
+	Result.ErrorType = EPythonExecutionError::SystemError;
+	FinishAsyncExecution(Result);
+	return false;
+}
+
+void UUnrealCopilotExecutionManager::CancelActiveAsyncExecution()
+{
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (ActiveAsyncExecution.IsSet() && PythonPlugin && PythonPlugin->IsPythonAvailable())
+	{
+		FUnrealCopilotPythonBridge::CancelJob(ActiveAsyncExecution->JobId);
+	}
+}
+
+void UUnrealCopilotExecutionManager::FinishAsyncExecution(FPythonExecutionResult& Result)
+{
+	if (Watchdog.IsValid())
+	{
+		Watchdog->Disarm();
+	}
+
+	const FString Code = ActiveAsyncExecution->Code;
+	Result.ExecutionId = ActiveAsyncExecution->JobId;
+	Result.ExecutionTimeSeconds = FPlatformTime::Seconds() - ActiveAsyncExecution->StartTime;
+	ActiveAsyncExecution.Reset();
+
+	if (PendingAsyncExecutions.Num() == 0)
+	{
+		if (Result.ErrorType == EPythonExecutionError::TimeoutError)
+		{
+			SetExecutionState(EPythonExecutionState::Timeout);
+		}
+		else
+		{
+			SetExecutionState(Result.bSuccess ? EPythonExecutionState::Completed : EPythonExecutionState::Error);
+		}
+	}
+
+	AddToHistory(Code, Result.bSuccess, Result.bSuccess ? Result.Output : Result.ErrorMessage);
+	OnExecutionCompleted.Broadcast(Result);
+}
+
 void UUnrealCopilotExecutionManager::AddToHistory(const FString& Code, bool bSuccess, const FString& Summary)
 {
 	FScopeLock Lock(&ExecutionCriticalSection);
-	
-	ExecutionHistory.Add(FPythonExecutionHistoryEntry(Code, bSuccess, Summary));
+	AppendHistoryEntry(EHistorySearchSource::Execution, FPythonExecutionHistoryEntry(Code, bSuccess, Summary));
+}
+
+void UUnrealCopilotExecutionManager::AppendHistoryEntry(EHistorySearchSource Source, const FPythonExecutionHistoryEntry& Entry)
+{
+	BeginLoadHistory();
+	{
+		// A script finishing while the history loads must not wait for it, so its entry joins the history once loaded
+		FScopeLock PendingLock(&PendingHistoryCriticalSection);
+		if (!bHistoryOpen)
+		{
+			if (HistoryLoadedFuture.IsValid())
+			{
+				PendingHistoryEntries.Emplace(Source, Entry);
+			}
+			return;
+		}
+	}
+	AppendToHistoryStore(Source, Entry);
+}
+
+void UUnrealCopilotExecutionManager::AppendToHistoryStore(EHistorySearchSource Source, const FPythonExecutionHistoryEntry& Entry)
+{
+	FUnrealCopilotHistoryStore* Store = GetHistoryStore(Source);
+	if (!Store)
+	{
+		return;
+	}
+
+	// Only the new entry is queued for the store's writer thread, so this never waits for the disk
+	Store->Append(Entry);
+	if (HistorySearchIndex.IsValid())
+	{
+		const int64 Number = TrimmedHistoryEntries[static_cast<int32>(Source)] + Store->Num() - 1;
+		HistorySearchIndex->Add(Source, Number, Entry.Code, Entry.ResultSummary);
+	}
 	TrimHistoryIfNeeded();
-	
-	// Auto-save history periodically
-	SaveHistoryToDisk();
+}
+
+int32 UUnrealCopilotExecutionManager::GetHistoryCount() const
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
+
+	return HistoryStore.IsValid() ? HistoryStore->Num() : 0;
 }
 
 FPythonExecutionHistoryEntry UUnrealCopilotExecutionManager::GetHistoryEntry(int32 Index) const
 {
 	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
 	
-	if (Index >= 0 && Index < ExecutionHistory.Num())
+	FPythonExecutionHistoryEntry Entry;
+	if (HistoryStore.IsValid() && HistoryStore->GetEntry(Index, Entry))
 	{
-		return ExecutionHistory[Index];
+		return Entry;
 	}
 	
 	// Return empty entry if index is invalid
 	return FPythonExecutionHistoryEntry();
 }
 
+int32 UUnrealCopilotExecutionManager::GetHistoryPage(int32 FirstIndex, int32 MaxCount, TArray<FPythonExecutionHistoryEntry>& OutEntries) const
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
+
+	if (!HistoryStore.IsValid())
+	{
+		OutEntries.Reset();
+		return 0;
+	}
+	return HistoryStore->GetPage(FirstIndex, MaxCount, OutEntries);
+}
+
 void UUnrealCopilotExecutionManager::ClearHistory()
 {
 	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
 	
-	ExecutionHistory.Empty();
-	SaveHistoryToDisk();
+	if (HistoryStore.IsValid())
+	{
+		int64& TrimmedEntries = TrimmedHistoryEntries[static_cast<int32>(EHistorySearchSource::Execution)];
+		TrimmedEntries += HistoryStore->Num();
+		HistoryStore->Clear();
+		if (HistorySearchIndex.IsValid())
+		{
+			HistorySearchIndex->RemoveBefore(EHistorySearchSource::Execution, TrimmedEntries);
+		}
+	}
 	
 	UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Execution history cleared"));
 }
 
+void UUnrealCopilotExecutionManager::AddPromptToHistory(const FString& Prompt, bool bSuccess, const FString& Response)
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+	AppendHistoryEntry(EHistorySearchSource::Prompt, FPythonExecutionHistoryEntry(Prompt, bSuccess, Response));
+}
+
+int32 UUnrealCopilotExecutionManager::GetPromptHistoryCount() const
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
+
+	return PromptHistoryStore.IsValid() ? PromptHistoryStore->Num() : 0;
+}
+
+FPythonExecutionHistoryEntry UUnrealCopilotExecutionManager::GetPromptHistoryEntry(int32 Index) const
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
+
+	FPythonExecutionHistoryEntry Entry;
+	if (PromptHistoryStore.IsValid() && PromptHistoryStore->GetEntry(Index, Entry))
+	{
+		return Entry;
+	}
+	return FPythonExecutionHistoryEntry();
+}
+
+bool UUnrealCopilotExecutionManager::SearchHistory(const FString& Query, bool bRegex, int32 MaxResults, TArray<FHistorySearchResult>& OutResults)
+{
+	FScopeLock Lock(&ExecutionCriticalSection);
+	LoadHistoryIfNeeded();
+
+	OutResults.Reset();
+	if (!HistorySearchIndex.IsValid() || !FUnrealCopilotHistorySearchIndex::HasTrigrams(Query, bRegex))
+	{
+		return true;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const bool bComplete = HistorySearchIndex->Search(Query, bRegex, MaxResults,
+		[this](EHistorySearchSource Source, int64 Number, bool bPrimary)
+		{
+			FPythonExecutionHistoryEntry Entry;
+			FUnrealCopilotHistoryStore* Store = GetHistoryStore(Source);
+			const int64 Index = Number - TrimmedHistoryEntries[static_cast<int32>(Source)];
+			if (Store && Store->GetEntry(static_cast<int32>(Index), Entry))
+			{
+				return bPrimary ? Entry.Code : Entry.ResultSummary;
+			}
+			return FString();
+		},
+		OutResults);
+
+	UE_LOG(LogUnrealCopilotExecution, Verbose, TEXT("History search for '%s' found %d results in %.2f ms"),
+		*Query, OutResults.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return bComplete;
+}
+
+void UUnrealCopilotExecutionManager::BuildHistorySearchIndex()
+{
+	const double StartTime = FPlatformTime::Seconds();
+	HistorySearchIndex = MakeUnique<FUnrealCopilotHistorySearchIndex>();
+
+	constexpr int32 PageSize = 1024;
+	TArray<FPythonExecutionHistoryEntry> Page;
+	for (const EHistorySearchSource Source : { EHistorySearchSource::Execution, EHistorySearchSource::Prompt })
+	{
+		FUnrealCopilotHistoryStore* Store = GetHistoryStore(Source);
+		if (!Store)
+		{
+			continue;
+		}
+
+		const int64 FirstNumber = TrimmedHistoryEntries[static_cast<int32>(Source)];
+		HistorySearchIndex->RemoveBefore(Source, FirstNumber);
+		for (int32 FirstIndex = 0; FirstIndex < Store->Num(); FirstIndex += PageSize)
+		{
+			Store->GetPage(FirstIndex, PageSize, Page);
+			for (int32 PageIndex = 0; PageIndex < Page.Num(); ++PageIndex)
+			{
+				HistorySearchIndex->Add(Source, FirstNumber + FirstIndex + PageIndex, Page[PageIndex].Code, Page[PageIndex].ResultSummary);
+			}
+		}
+	}
+
+	UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Indexed %d history entries for search in %.0f ms (%.1f MB)"),
+		HistorySearchIndex->Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0, HistorySearchIndex->GetAllocatedSize() / (1024.0 * 1024.0));
+}
+
+FUnrealCopilotHistoryStore* UUnrealCopilotExecutionManager::GetHistoryStore(EHistorySearchSource Source) const
+{
+	return Source == EHistorySearchSource::Execution ? HistoryStore.Get() : PromptHistoryStore.Get();
+}
+
 void UUnrealCopilotExecutionManager::SaveHistoryToDisk()
 {
-	FString HistoryFilePath = GetHistoryFilePath();
-	
-	// Create JSON object for history
-	TSharedPtr<FJsonObject> HistoryJson = MakeShareable(new FJsonObject);
-	TArray<TSharedPtr<FJsonValue>> HistoryArray;
-	
-	for (const FPythonExecutionHistoryEntry& Entry : ExecutionHistory)
+	FScopeLock Lock(&ExecutionCriticalSection);
+	WaitForHistory();
+
+	if (HistoryStore.IsValid())
 	{
-		TSharedPtr<FJsonObject> EntryJson = MakeShareable(new FJsonObject);
-		EntryJson->SetStringField(TEXT("Code"), Entry.Code);
-		EntryJson->SetStringField(TEXT("Timestamp"), Entry.Timestamp.ToString());
-		EntryJson->SetBoolField(TEXT("Success"), Entry.bWasSuccessful);
-		EntryJson->SetStringField(TEXT("Summary"), Entry.ResultSummary);
-		
-		HistoryArray.Add(MakeShareable(new FJsonValueObject(EntryJson)));
+		HistoryStore->Flush();
+	}
+	if (PromptHistoryStore.IsValid())
+	{
+		PromptHistoryStore->Flush();
 	}
-	
-	HistoryJson->SetArrayField(TEXT("History"), HistoryArray);
-	
-	// Write to file
-	FString OutputString;
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-	FJsonSerializer::Serialize(HistoryJson.ToSharedRef(), Writer);
-	
-	FFileHelper::SaveStringToFile(OutputString, *HistoryFilePath);
 }
 
 void UUnrealCopilotExecutionManager::LoadHistoryFromDisk()
 {
-	FString HistoryFilePath = GetHistoryFilePath();
-	
-	FString JsonString;
-	if (!FFileHelper::LoadFileToString(JsonString, *HistoryFilePath))
+	FScopeLock Lock(&ExecutionCriticalSection);
+	WaitForHistory();
+
+	ReadHistoryFromDisk();
+}
+
+void UUnrealCopilotExecutionManager::DisableHistory()
+{
+	bHistoryDisabled = true;
+	if (Instance)
 	{
-		// File doesn't exist or can't be read - start with empty history
-		ExecutionHistory.Empty();
-		return;
+		FScopeLock Lock(&Instance->ExecutionCriticalSection);
+		Instance->WaitForHistory();
+		Instance->ReadHistoryFromDisk();
 	}
-	
-	TSharedPtr<FJsonObject> HistoryJson;
-	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
-	
-	if (!FJsonSerializer::Deserialize(Reader, HistoryJson) || !HistoryJson.IsValid())
+	UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Execution and prompt history disabled for this process"));
+}
+
+bool UUnrealCopilotExecutionManager::IsHistoryDisabled()
+{
+	// Read from the command line each time, so the flag holds even for history loads that start before any commandlet runs
+	return bHistoryDisabled || FParse::Param(FCommandLine::Get(), TEXT("NoHistory"));
+}
+
+void UUnrealCopilotExecutionManager::ReadHistoryFromDisk()
+{
 	{
-		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to parse history JSON file"));
-		ExecutionHistory.Empty();
-		return;
+		FScopeLock PendingLock(&PendingHistoryCriticalSection);
+		bHistoryOpen = false;
 	}
-	
-	const TArray<TSharedPtr<FJsonValue>>* HistoryArray;
-	if (!HistoryJson->TryGetArrayField(TEXT("History"), HistoryArray))
+
+	// Entries still queued are written before the stores are reopened
+	HistoryStore.Reset();
+	PromptHistoryStore.Reset();
+	HistorySearchIndex.Reset();
+	TrimmedHistoryEntries[0] = 0;
+	TrimmedHistoryEntries[1] = 0;
+
+	if (!IsHistoryDisabled())
 	{
-		ExecutionHistory.Empty();
-		return;
+		OpenHistoryStores();
 	}
-	
-	ExecutionHistory.Empty();
-	for (const TSharedPtr<FJsonValue>& Value : *HistoryArray)
+
+	// Entries added while loading go in after the stored ones; from here on they are added directly
+	FScopeLock PendingLock(&PendingHistoryCriticalSection);
+	for (const TPair<EHistorySearchSource, FPythonExecutionHistoryEntry>& Pending : PendingHistoryEntries)
+	{
+		AppendToHistoryStore(Pending.Key, Pending.Value);
+	}
+	PendingHistoryEntries.Reset();
+	bHistoryOpen = true;
+}
+
+void UUnrealCopilotExecutionManager::OpenHistoryStores()
+{
+	PromptHistoryStore = MakeUnique<FUnrealCopilotHistoryStore>(GetHistoryDirectory(), TEXT("PromptHistory"));
+	PromptHistoryStore->Open();
+
+	HistoryStore = MakeUnique<FUnrealCopilotHistoryStore>(GetHistoryDirectory(), TEXT("ExecutionHistory"));
+	TArray<FPythonExecutionHistoryEntry> LegacyEntries;
+	if (HistoryStore->Open())
 	{
-		const TSharedPtr<FJsonObject>* EntryObject;
-		if (!Value->TryGetObject(EntryObject))
+		TrimHistoryIfNeeded();
+		UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Opened execution history with %d entries"), HistoryStore->Num());
+	}
+	else if (LoadLegacyHistory(LegacyEntries))
+	{
+		// Earlier versions saved the history as JSON; move it into the store once
+		for (const FPythonExecutionHistoryEntry& Entry : LegacyEntries)
 		{
-			continue;
+			HistoryStore->Append(Entry);
 		}
-		
-		FPythonExecutionHistoryEntry Entry;
-		(*EntryObject)->TryGetStringField(TEXT("Code"), Entry.Code);
-		(*EntryObject)->TryGetBoolField(TEXT("Success"), Entry.bWasSuccessful);
-		(*EntryObject)->TryGetStringField(TEXT("Summary"), Entry.ResultSummary);
-		
-		FString TimestampString;
-		if ((*EntryObject)->TryGetStringField(TEXT("Timestamp"), TimestampString))
+		TrimHistoryIfNeeded();
+		HistoryStore->Flush();
+
+		IFileManager::Get().Delete(*GetLegacyHistoryFilePath());
+		IFileManager::Get().Delete(*GetLegacyHistoryJournalPath());
+		UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Migrated %d entries into execution history"), HistoryStore->Num());
+	}
+
+	// Built here, on the loading thread, so the first search does not read the whole history on the game thread
+	BuildHistorySearchIndex();
+}
+
+bool UUnrealCopilotExecutionManager::LoadLegacyHistory(TArray<FPythonExecutionHistoryEntry>& OutEntries) const
+{
+	using namespace UnrealCopilotExecutionManager;
+
+	OutEntries.Reset();
+	bool bFoundHistory = false;
+
+	// The single JSON file came first, so its entries are older than the journal's
+	FString JsonString;
+	if (FFileHelper::LoadFileToString(JsonString, *GetLegacyHistoryFilePath()))
+	{
+		bFoundHistory = true;
+
+		TSharedPtr<FJsonObject> HistoryJson;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonString);
+		const TArray<TSharedPtr<FJsonValue>>* HistoryArray;
+		if (FJsonSerializer::Deserialize(Reader, HistoryJson) && HistoryJson.IsValid() && HistoryJson->TryGetArrayField(TEXT("History"), HistoryArray))
 		{
-			FDateTime::Parse(TimestampString, Entry.Timestamp);
+			for (const TSharedPtr<FJsonValue>& Value : *HistoryArray)
+			{
+				const TSharedPtr<FJsonObject>* EntryObject;
+				if (Value->TryGetObject(EntryObject))
+				{
+					OutEntries.Add(ReadLegacyEntry(**EntryObject));
+				}
+			}
+		}
+		else
+		{
+			UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to parse history JSON file"));
 		}
-		
-		ExecutionHistory.Add(Entry);
 	}
-	
-	UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Loaded %d entries from execution history"), ExecutionHistory.Num());
+
+	// The journal holds one JSON object per line; a line torn by a crash is skipped
+	FString JournalText;
+	if (FFileHelper::LoadFileToString(JournalText, *GetLegacyHistoryJournalPath()))
+	{
+		bFoundHistory = true;
+
+		TArray<FString> Lines;
+		JournalText.ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			TSharedPtr<FJsonObject> EntryObject;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line);
+			if (FJsonSerializer::Deserialize(Reader, EntryObject) && EntryObject.IsValid())
+			{
+				OutEntries.Add(ReadLegacyEntry(*EntryObject));
+			}
+		}
+	}
+	return bFoundHistory;
 }
 
 void UUnrealCopilotExecutionManager::SetExecutionState(EPythonExecutionState NewState)
@@ -291,7 +971,7 @@ void UUnrealCopilotExecutionManager::SetExecutionState(EPythonExecutionState New
 	}
 }
 
-FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCodeSynchronous(const FString& PythonCode)
+FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCodeSynchronous(const FString& PythonCode, const FString& CodeHash, int32 SessionId)
 {
 	FPythonExecutionResult Result;
 	Result.Reset();
@@ -315,97 +995,54 @@ FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCodeSynchron
 		return Result;
 	}
 	
+	// Normally done when Python initialized; otherwise the first script pays for it once
+	WarmUpPythonEnvironment();
+	OutputCapture.Reset(UUnrealCopilotSettings::Get()->MaxCapturedOutputLines);
+	ApplyCodeCacheSettings();
+
+	// The watchdog interrupts the script from its own thread, since this call blocks the game thread until Python returns
+	FUnrealCopilotExecutionWatchdog& ExecutionWatchdog = GetWatchdog();
+	ExecutionWatchdog.Arm(ExecutionTimeoutSeconds);
+	ON_SCOPE_EXIT
+	{
+		ExecutionWatchdog.Disarm();
+	};
+	
 	try
 	{
-		// For simple cases without wrapper, try direct execution first
-		if (!PythonCode.Contains(TEXT("\n")) && !PythonCode.Contains(TEXT("import")) && PythonCode.Len() < 100)
+		// The source goes to the runtime module as a Python string, which compiles it once and runs the code object
+		FPythonSyntaxError SyntaxError;
+		EPythonBridgeStatus RunStatus = EPythonBridgeStatus::Unavailable;
 		{
-			// Simple single statement - try direct execution
-			FPythonCommandEx SimpleCommand;
-			SimpleCommand.Command = PythonCode;
-			SimpleCommand.ExecutionMode = EPythonCommandExecutionMode::ExecuteStatement;
-			
-			bool bSimpleSuccess = PythonPlugin->ExecPythonCommandEx(SimpleCommand);
-			
-			// Calculate execution time
-			double ExecutionEndTime = FPlatformTime::Seconds();
-			Result.ExecutionTimeSeconds = ExecutionEndTime - ExecutionStartTime;
-			
-			if (bSimpleSuccess)
-			{
-				Result.bSuccess = true;
-				Result.Output = TEXT("Python code executed successfully");
-				return Result;
-			}
-			// If simple execution failed, fall through to enhanced execution
+			FUnrealCopilotOutputCapture::FScope CaptureScope(OutputCapture);
+			ExecutionWatchdog.EnterPython();
+			RunStatus = FUnrealCopilotPythonBridge::RunSource(PythonCode, CodeHash, SessionId, SyntaxError);
+			ExecutionWatchdog.LeavePython();
 		}
 		
-		// Enhanced Python execution with error capture for complex code
-		FString EnhancedPythonCode = FString::Printf(TEXT(
-			"import sys\n"
-			"import traceback\n"
-			"import io\n"
-			"\n"
-			"# Capture stdout and stderr\n"
-			"old_stdout = sys.stdout\n"
-			"old_stderr = sys.stderr\n"
-			"stdout_buffer = io.StringIO()\n"
-			"stderr_buffer = io.StringIO()\n"
-			"sys.stdout = stdout_buffer\n"
-			"sys.stderr = stderr_buffer\n"
-			"\n"
-			"try:\n"
-			"    # Execute user code with proper indentation\n"
-			"    exec('''%s''')\n"
-			"    print('EXECUTION_SUCCESS', file=old_stdout)\n"
-			"    stdout_content = stdout_buffer.getvalue()\n"
-			"    if stdout_content:\n"
-			"        print(f'OUTPUT: {stdout_content}', file=old_stdout)\n"
-			"except Exception as e:\n"
-			"    print('EXECUTION_ERROR', file=old_stdout)\n"
-			"    print(f'ERROR_MESSAGE: {str(e)}', file=old_stdout)\n"
-			"    print(f'ERROR_TYPE: {type(e).__name__}', file=old_stdout)\n"
-			"    tb_lines = traceback.format_exc().splitlines()\n"
-			"    print(f'STACK_TRACE: {\"||\".join(tb_lines)}', file=old_stdout)\n"
-			"finally:\n"
-			"    # Restore stdout and stderr\n"
-			"    sys.stdout = old_stdout\n"
-			"    sys.stderr = old_stderr\n"
-		), *PythonCode.Replace(TEXT("'''"), TEXT("\\'\\'\\'")));
-		
-		// Execute enhanced Python code using ExecuteFile mode for multi-statement support
-		FPythonCommandEx PythonCommand;
-		PythonCommand.Command = EnhancedPythonCode;
-		PythonCommand.ExecutionMode = EPythonCommandExecutionMode::ExecuteFile;
-		
-		bool bExecutionSuccess = PythonPlugin->ExecPythonCommandEx(PythonCommand);
-		
 		// Calculate execution time
 		double ExecutionEndTime = FPlatformTime::Seconds();
 		Result.ExecutionTimeSeconds = ExecutionEndTime - ExecutionStartTime;
 		
-		// Check for timeout
-		if (Result.ExecutionTimeSeconds > ExecutionTimeoutSeconds)
+		// Check for timeout or cancellation
+		const EExecutionInterruptReason InterruptReason = ExecutionWatchdog.GetInterruptReason();
+		if (InterruptReason != EExecutionInterruptReason::None)
 		{
-			Result.bSuccess = false;
-			Result.ErrorMessage = FString::Printf(TEXT("Python execution timed out after %.2f seconds"), Result.ExecutionTimeSeconds);
-			Result.ErrorType = EPythonExecutionError::TimeoutError;
+			MakeInterruptedResult(InterruptReason, GetCapturedOutput(), Result.ExecutionTimeSeconds, Result);
 			return Result;
 		}
 		
-		if (bExecutionSuccess)
-		{
-			Result.bSuccess = true;
-			Result.Output = TEXT("Python code executed successfully");
-			// Note: In a complete implementation, we would capture and parse the enhanced output
-			// to extract the actual stdout content and any error details
-		}
-		else
+		if (RunStatus == EPythonBridgeStatus::SyntaxError)
 		{
 			Result.bSuccess = false;
-			Result.ErrorMessage = TEXT("Python execution failed");
-			Result.ErrorType = EPythonExecutionError::RuntimeError;
+			Result.ErrorMessage = SyntaxError.ToString();
+			Result.ErrorLineNumber = SyntaxError.Line;
+			Result.ErrorType = EPythonExecutionError::SyntaxError;
+			return Result;
 		}
+		
+		FillResultFromCapture(RunStatus == EPythonBridgeStatus::Succeeded,
+			RunStatus == EPythonBridgeStatus::Unavailable ? TEXT("Python is not available or not initialized") : FString(), Result);
 	}
 	catch (const std::exception& e)
 	{
@@ -423,10 +1060,88 @@ FPythonExecutionResult UUnrealCopilotExecutionManager::ExecutePythonCodeSynchron
 	return Result;
 }
 
+FUnrealCopilotExecutionWatchdog& UUnrealCopilotExecutionManager::GetWatchdog()
+{
+	if (!Watchdog.IsValid())
+	{
+		Watchdog = MakeUnique<FUnrealCopilotExecutionWatchdog>();
+	}
+	return *Watchdog;
+}
+
+void UUnrealCopilotExecutionManager::MakeInterruptedResult(EExecutionInterruptReason Reason, const FString& PartialOutput, double ElapsedSeconds, FPythonExecutionResult& OutResult) const
+{
+	OutResult.bSuccess = false;
+	OutResult.Output = PartialOutput;
+	if (Reason == EExecutionInterruptReason::Timeout)
+	{
+		OutResult.ErrorMessage = FString::Printf(TEXT("Python execution timed out after %.2f seconds (limit %.0f seconds)"), ElapsedSeconds, ExecutionTimeoutSeconds);
+		OutResult.ErrorType = EPythonExecutionError::TimeoutError;
+	}
+	else
+	{
+		OutResult.ErrorMessage = TEXT("Python execution cancelled by user");
+		OutResult.ErrorType = EPythonExecutionError::SystemError;
+	}
+}
+
+FString UUnrealCopilotExecutionManager::GetCapturedOutput() const
+{
+	FString Output = OutputCapture.GetText(EPythonOutputStream::Stdout);
+	const int32 DroppedLines = OutputCapture.GetDroppedLineCount();
+	if (DroppedLines > 0)
+	{
+		Output = FString::Printf(TEXT("[%d earlier lines dropped]\n%s"), DroppedLines, *Output);
+	}
+	return Output;
+}
+
+void UUnrealCopilotExecutionManager::FillResultFromCapture(bool bCommandSucceeded, const FString& CommandError, FPythonExecutionResult& OutResult)
+{
+	OutResult.Output = GetCapturedOutput();
+
+	FPythonErrorReport Report;
+	if (OutputCapture.GetErrorReport(Report))
+	{
+		OutResult.bSuccess = false;
+		OutResult.ErrorMessage = FString::Printf(TEXT("%s: %s"), *Report.Type, *Report.Message);
+		OutResult.StackTrace = FormatStackTrace(Report.StackTrace);
+		ParsePythonError(OutResult.ErrorMessage, OutResult);
+		if (Report.Line > 0)
+		{
+			OutResult.ErrorLineNumber = Report.Line;
+		}
+	}
+	else if (!bCommandSucceeded)
+	{
+		// Failed outside the script, e.g. while importing the runtime module
+		const FString Errors = OutputCapture.GetText(EPythonOutputStream::Stderr);
+		OutResult.bSuccess = false;
+		OutResult.ErrorMessage = !Errors.IsEmpty() ? Errors : (!CommandError.IsEmpty() ? CommandError : TEXT("Python execution failed"));
+		ParsePythonError(OutResult.ErrorMessage, OutResult);
+	}
+	else
+	{
+		OutResult.bSuccess = true;
+		if (OutResult.Output.IsEmpty())
+		{
+			OutResult.Output = TEXT("Python code executed successfully");
+		}
+	}
+}
+
 void UUnrealCopilotExecutionManager::ParsePythonError(const FString& ErrorMessage, FPythonExecutionResult& Result)
 {
+	// Messages from the runtime module start with the exception class name
+	FString ExceptionType;
+	ErrorMessage.Split(TEXT(":"), &ExceptionType, nullptr);
+	const bool bScriptException = (!ExceptionType.IsEmpty() && !ExceptionType.Contains(TEXT(" "))
+		&& (ExceptionType.EndsWith(TEXT("Error")) || ExceptionType.EndsWith(TEXT("Exception")))
+		&& ExceptionType != TEXT("MemoryError") && ExceptionType != TEXT("SystemError"))
+		|| ExceptionType == TEXT("SystemExit");
+
 	// Parse error message to extract line numbers and categorize errors
-	if (ErrorMessage.Contains(TEXT("SyntaxError")))
+	if (ErrorMessage.Contains(TEXT("SyntaxError")) || ExceptionType == TEXT("IndentationError") || ExceptionType == TEXT("TabError"))
 	{
 		Result.ErrorType = EPythonExecutionError::SyntaxError;
 		
@@ -452,7 +1167,7 @@ void UUnrealCopilotExecutionManager::ParsePythonError(const FString& ErrorMessag
 	{
 		Result.ErrorType = EPythonExecutionError::TimeoutError;
 	}
-	else if (ErrorMessage.Contains(TEXT("NameError")) || ErrorMessage.Contains(TEXT("AttributeError")) || 
+	else if (bScriptException || ErrorMessage.Contains(TEXT("NameError")) || ErrorMessage.Contains(TEXT("AttributeError")) || 
 			 ErrorMessage.Contains(TEXT("TypeError")) || ErrorMessage.Contains(TEXT("ValueError")))
 	{
 		Result.ErrorType = EPythonExecutionError::RuntimeError;
@@ -473,18 +1188,40 @@ FString UUnrealCopilotExecutionManager::FormatStackTrace(const FString& RawStack
 	return FormattedTrace;
 }
 
-FString UUnrealCopilotExecutionManager::GetHistoryFilePath() const
+FString UUnrealCopilotExecutionManager::GetHistoryDirectory() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("UnrealCopilot") / TEXT("History");
+}
+
+FString UUnrealCopilotExecutionManager::GetLegacyHistoryFilePath() const
 {
 	return FPaths::ProjectSavedDir() / TEXT("UnrealCopilot") / TEXT("ExecutionHistory.json");
 }
 
+FString UUnrealCopilotExecutionManager::GetLegacyHistoryJournalPath() const
+{
+	return FPaths::ProjectSavedDir() / TEXT("UnrealCopilot") / TEXT("ExecutionHistory.journal");
+}
+
 void UUnrealCopilotExecutionManager::TrimHistoryIfNeeded()
 {
-	if (ExecutionHistory.Num() > MaxHistoryEntries)
+	for (const EHistorySearchSource Source : { EHistorySearchSource::Execution, EHistorySearchSource::Prompt })
 	{
-		int32 NumToRemove = ExecutionHistory.Num() - MaxHistoryEntries;
-		ExecutionHistory.RemoveAt(0, NumToRemove);
-		
-		UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Trimmed %d entries from execution history"), NumToRemove);
+		FUnrealCopilotHistoryStore* Store = GetHistoryStore(Source);
+		const int32 NumToRemove = Store ? Store->Num() - MaxHistoryEntries : 0;
+		if (NumToRemove > 0)
+		{
+			Store->Trim(MaxHistoryEntries);
+
+			int64& TrimmedEntries = TrimmedHistoryEntries[static_cast<int32>(Source)];
+			TrimmedEntries += NumToRemove;
+			if (HistorySearchIndex.IsValid())
+			{
+				HistorySearchIndex->RemoveBefore(Source, TrimmedEntries);
+			}
+
+			UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Trimmed %d entries from %s history"), NumToRemove,
+				Source == EHistorySearchSource::Execution ? TEXT("execution") : TEXT("prompt"));
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotExecutionWatchdog.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+#if WITH_PYTHON
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+THIRD_PARTY_INCLUDES_START
+#pragma push_macro("check")
+#undef check
+#include "Python.h"
+#pragma pop_macro("check")
+THIRD_PARTY_INCLUDES_END
+#endif
+
+namespace UnrealCopilotExecutionWatchdog
+{
+	/** How often the thread checks the deadline and repeats an interrupt the script swallowed */
+	static constexpr uint32 PollIntervalMs = 100;
+}
+
+FUnrealCopilotExecutionWatchdog::FUnrealCopilotExecutionWatchdog()
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("UnrealCopilotExecutionWatchdog"), 0, TPri_BelowNormal);
+}
+
+FUnrealCopilotExecutionWatchdog::~FUnrealCopilotExecutionWatchdog()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FUnrealCopilotExecutionWatchdog::Arm(double TimeoutSeconds)
+{
+	{
+		FScopeLock Lock(&StateLock);
+		bArmed = true;
+		bInsidePython = false;
+		bInterruptInjected = false;
+		Deadline = TimeoutSeconds > 0.0 ? FPlatformTime::Seconds() + TimeoutSeconds : TNumericLimits<double>::Max();
+		InterruptReason = EExecutionInterruptReason::None;
+#if WITH_PYTHON
+		PythonThreadId = PyThread_get_thread_ident();
+#endif
+	}
+	WakeEvent->Trigger();
+}
+
+EExecutionInterruptReason FUnrealCopilotExecutionWatchdog::Disarm()
+{
+	FScopeLock Lock(&StateLock);
+	bArmed = false;
+	return InterruptReason;
+}
+
+void FUnrealCopilotExecutionWatchdog::EnterPython()
+{
+	FScopeLock Lock(&StateLock);
+	bInsidePython = true;
+	bInterruptInjected = false;
+}
+
+void FUnrealCopilotExecutionWatchdog::LeavePython()
+{
+	bool bClearInterrupt = false;
+	{
+		FScopeLock Lock(&StateLock);
+		bInsidePython = false;
+		bClearInterrupt = bInterruptInjected;
+		bInterruptInjected = false;
+	}
+
+	if (bClearInterrupt)
+	{
+		ClearPendingInterrupt();
+	}
+}
+
+void FUnrealCopilotExecutionWatchdog::RequestCancel()
+{
+	{
+		FScopeLock Lock(&StateLock);
+		if (!bArmed || InterruptReason != EExecutionInterruptReason::None)
+		{
+			return;
+		}
+		InterruptReason = EExecutionInterruptReason::Cancelled;
+	}
+	WakeEvent->Trigger();
+}
+
+EExecutionInterruptReason FUnrealCopilotExecutionWatchdog::GetInterruptReason() const
+{
+	FScopeLock Lock(&StateLock);
+	return InterruptReason;
+}
+
+uint32 FUnrealCopilotExecutionWatchdog::Run()
+{
+	using namespace UnrealCopilotExecutionWatchdog;
+
+	while (!bStopping)
+	{
+		bool bArmedNow = false;
+		bool bShouldInterrupt = false;
+		{
+			FScopeLock Lock(&StateLock);
+			bArmedNow = bArmed;
+			if (bArmed && InterruptReason == EExecutionInterruptReason::None && FPlatformTime::Seconds() >= Deadline)
+			{
+				InterruptReason = EExecutionInterruptReason::Timeout;
+			}
+			bShouldInterrupt = bArmed && bInsidePython && InterruptReason != EExecutionInterruptReason::None;
+		}
+
+		if (bShouldInterrupt)
+		{
+			InjectInterrupt();
+		}
+
+		// Sleep until armed; once armed, poll so swallowed interrupts are raised again
+		WakeEvent->Wait(bArmedNow ? PollIntervalMs : MAX_uint32);
+	}
+	return 0;
+}
+
+void FUnrealCopilotExecutionWatchdog::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FUnrealCopilotExecutionWatchdog::InjectInterrupt()
+{
+#if WITH_PYTHON
+	// The game thread gives up the GIL between bytecodes, so this only waits while it is inside native code.
+	// Lock order is GIL then state lock; the game thread never waits for the GIL while holding the state lock.
+	const PyGILState_STATE GILState = PyGILState_Ensure();
+	{
+		FScopeLock Lock(&StateLock);
+		if (bArmed && bInsidePython)
+		{
+			PyThreadState_SetAsyncExc(static_cast<unsigned long>(PythonThreadId), PyExc_KeyboardInterrupt);
+			bInterruptInjected = true;
+		}
+	}
+	PyGILState_Release(GILState);
+#endif
+}
+
+void FUnrealCopilotExecutionWatchdog::ClearPendingInterrupt()
+{
+#if WITH_PYTHON
+	// An interrupt raised just as the script finished would otherwise fire in the next unrelated Python call
+	const PyGILState_STATE GILState = PyGILState_Ensure();
+	PyThreadState_SetAsyncExc(static_cast<unsigned long>(PythonThreadId), nullptr);
+	PyGILState_Release(GILState);
+#endif
+}
@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotHistoryJournal.h"
+#include "UnrealCopilotExecutionManager.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace UnrealCopilotHistoryJournal
+{
+	/** Longest time a queued record waits before the writer writes and syncs its batch */
+	static constexpr uint32 FlushIntervalMs = 500;
+
+	/** Queued records that wake the writer before the interval ends */
+	static constexpr int64 BatchSize = 32;
+
+	/** How often Flush checks whether the writer caught up */
+	static constexpr uint32 FlushPollMs = 50;
+}
+
+FUnrealCopilotHistoryJournal::FUnrealCopilotHistoryJournal(const FString& InJournalPath, const FString& InCodeTablePath, const FString& InBlobPath, int64 InBlobFileSize)
+	: JournalPath(InJournalPath)
+	, CodeTablePath(InCodeTablePath)
+	, BlobPath(InBlobPath)
+	, WrittenBlobSize(InBlobFileSize)
+{
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	BatchWrittenEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FUnrealCopilotHistoryJournal::~FUnrealCopilotHistoryJournal()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	// Records queued while the writer was stopping
+	WritePending();
+	JournalHandle.Reset();
+	CodeTableHandle.Reset();
+	BlobHandle.Reset();
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+	FPlatformProcess::ReturnSynchEventToPool(BatchWrittenEvent);
+	BatchWrittenEvent = nullptr;
+}
+
+void FUnrealCopilotHistoryJournal::Append(TArray<uint8>&& IndexRecord, TArray<uint8>&& CodeRecord, TArray<uint8>&& BlobData)
+{
+	using namespace UnrealCopilotHistoryJournal;
+
+	{
+		FScopeLock Lock(&ThreadLock);
+		if (!Thread && !bStopping)
+		{
+			Thread = FRunnableThread::Create(this, TEXT("UnrealCopilotHistoryJournal"), 0, TPri_BelowNormal);
+		}
+	}
+
+	FCommand Command;
+	Command.IndexRecord = MoveTemp(IndexRecord);
+	Command.CodeRecord = MoveTemp(CodeRecord);
+	Command.BlobData = MoveTemp(BlobData);
+	PendingCommands.Enqueue(MoveTemp(Command));
+
+	const int64 Pending = ++QueuedCount - WrittenCount;
+	if (Pending >= BatchSize)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FUnrealCopilotHistoryJournal::Flush()
+{
+	using namespace UnrealCopilotHistoryJournal;
+
+	const int64 TargetCount = QueuedCount;
+	while (WrittenCount < TargetCount)
+	{
+		WakeEvent->Trigger();
+		BatchWrittenEvent->Wait(FlushPollMs);
+	}
+}
+
+uint32 FUnrealCopilotHistoryJournal::Run()
+{
+	using namespace UnrealCopilotHistoryJournal;
+
+	while (!bStopping)
+	{
+		WakeEvent->Wait(FlushIntervalMs);
+		WritePending();
+	}
+	return 0;
+}
+
+void FUnrealCopilotHistoryJournal::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+void FUnrealCopilotHistoryJournal::WritePending()
+{
+	TArray<FCommand> Batch;
+	FCommand Command;
+	while (PendingCommands.Dequeue(Command))
+	{
+		Batch.Add(MoveTemp(Command));
+	}
+
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	// Blobs reach the disk before the records referring to them; the store drops records whose blobs are missing
+	int64 BlobBytes = 0;
+	if (OpenForAppend(BlobHandle, BlobPath))
+	{
+		for (const FCommand& BatchCommand : Batch)
+		{
+			if (BatchCommand.BlobData.Num() > 0)
+			{
+				BlobHandle->Write(BatchCommand.BlobData.GetData(), BatchCommand.BlobData.Num());
+				BlobBytes += BatchCommand.BlobData.Num();
+			}
+		}
+		BlobHandle->Flush(/*bFullFlush*/ true);
+	}
+
+	const bool bHasCodeRecords = Batch.ContainsByPredicate([](const FCommand& BatchCommand) { return BatchCommand.CodeRecord.Num() > 0; });
+	if (bHasCodeRecords && OpenForAppend(CodeTableHandle, CodeTablePath))
+	{
+		for (const FCommand& BatchCommand : Batch)
+		{
+			if (BatchCommand.CodeRecord.Num() > 0)
+			{
+				CodeTableHandle->Write(BatchCommand.CodeRecord.GetData(), BatchCommand.CodeRecord.Num());
+			}
+		}
+		CodeTableHandle->Flush(/*bFullFlush*/ true);
+	}
+
+	if (OpenForAppend(JournalHandle, JournalPath))
+	{
+		for (const FCommand& BatchCommand : Batch)
+		{
+			JournalHandle->Write(BatchCommand.IndexRecord.GetData(), BatchCommand.IndexRecord.Num());
+		}
+		JournalHandle->Flush(/*bFullFlush*/ true);
+	}
+
+	WrittenBlobSize += BlobBytes;
+	WrittenCount += Batch.Num();
+	BatchWrittenEvent->Trigger();
+}
+
+bool FUnrealCopilotHistoryJournal::OpenForAppend(TUniquePtr<IFileHandle>& Handle, const FString& FilePath)
+{
+	if (Handle.IsValid())
+	{
+		return true;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+	// Readers of the history store keep the blob file open while it is appended to
+	Handle.Reset(PlatformFile.OpenWrite(*FilePath, /*bAppend*/ true, /*bAllowRead*/ true));
+	if (!Handle.IsValid())
+	{
+		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to open execution history file %s"), *FilePath);
+	}
+	return Handle.IsValid();
+}
@@ -0,0 +1,522 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotHistorySearchIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Internationalization/Regex.h"
+
+namespace UnrealCopilotHistorySearchIndex
+{
+	/** Characters of a summary or response that are indexed; matches further in are not found */
+	static constexpr int32 MaxIndexedSecondaryChars = 2048;
+
+	/** Texts a search reads at most, newest first; bounds searches whose trigrams match most of the history */
+	static constexpr int32 MaxTextsRead = 2000;
+
+	/** Matches counted per text for ranking */
+	static constexpr int32 MaxCountedMatches = 8;
+
+	/** Score of a match in code or a prompt, and in a summary or response */
+	static constexpr float PrimaryWeight = 2.0f;
+	static constexpr float SecondaryWeight = 1.0f;
+
+	/** Longest snippet returned with a result */
+	static constexpr int32 MaxSnippetChars = 160;
+
+	/** Get the key of three lowercase characters */
+	static uint32 MakeTrigram(TCHAR A, TCHAR B, TCHAR C)
+	{
+		// ASCII trigrams are packed exactly; others are hashed, and a collision only adds candidates that fail verification
+		if (A < 128 && B < 128 && C < 128)
+		{
+			return (static_cast<uint32>(A) << 14) | (static_cast<uint32>(B) << 7) | static_cast<uint32>(C);
+		}
+		return HashCombineFast(HashCombineFast(GetTypeHash(A), GetTypeHash(B)), GetTypeHash(C)) | 0x80000000u;
+	}
+
+	/** Add the trigrams of a lowercase text */
+	static void CollectTrigrams(const FString& LowercaseText, TSet<uint32>& OutTrigrams)
+	{
+		for (int32 Index = 0; Index + 2 < LowercaseText.Len(); ++Index)
+		{
+			OutTrigrams.Add(MakeTrigram(LowercaseText[Index], LowercaseText[Index + 1], LowercaseText[Index + 2]));
+		}
+	}
+
+	static void WriteVarInt(TArray<uint8>& Bytes, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Bytes.Add(static_cast<uint8>(Value | 0x80));
+			Value >>= 7;
+		}
+		Bytes.Add(static_cast<uint8>(Value));
+	}
+
+	/** Count the matches of the query in a text, up to MaxCountedMatches */
+	static int32 CountMatches(const FString& Text, const FString& Query, const FRegexPattern* Pattern, int32& OutFirstMatch)
+	{
+		int32 MatchCount = 0;
+		OutFirstMatch = INDEX_NONE;
+
+		if (Pattern)
+		{
+			FRegexMatcher Matcher(*Pattern, Text);
+			while (MatchCount < MaxCountedMatches && Matcher.FindNext())
+			{
+				if (MatchCount++ == 0)
+				{
+					OutFirstMatch = Matcher.GetMatchBeginning();
+				}
+			}
+			return MatchCount;
+		}
+
+		int32 SearchFrom = 0;
+		while (MatchCount < MaxCountedMatches)
+		{
+			const int32 Found = Text.Find(Query, ESearchCase::IgnoreCase, ESearchDir::FromStart, SearchFrom);
+			if (Found == INDEX_NONE)
+			{
+				break;
+			}
+			if (MatchCount++ == 0)
+			{
+				OutFirstMatch = Found;
+			}
+			SearchFrom = Found + Query.Len();
+		}
+		return MatchCount;
+	}
+
+	/** Get the line holding a match, shortened around it */
+	static FString MakeSnippet(const FString& Text, int32 MatchStart)
+	{
+		MatchStart = FMath::Clamp(MatchStart, 0, Text.Len());
+
+		int32 LineStart = MatchStart;
+		while (LineStart > 0 && Text[LineStart - 1] != TEXT('\n'))
+		{
+			--LineStart;
+		}
+		int32 LineEnd = MatchStart;
+		while (LineEnd < Text.Len() && Text[LineEnd] != TEXT('\n'))
+		{
+			++LineEnd;
+		}
+
+		const int32 Start = FMath::Max(LineStart, MatchStart - MaxSnippetChars / 2);
+		const int32 End = FMath::Min(LineEnd, Start + MaxSnippetChars);
+		FString Snippet = Text.Mid(Start, End - Start).TrimStartAndEnd();
+		if (Start > LineStart)
+		{
+			Snippet = TEXT("...") + Snippet;
+		}
+		if (End < LineEnd)
+		{
+			Snippet += TEXT("...");
+		}
+		return Snippet;
+	}
+}
+
+void FUnrealCopilotHistorySearchIndex::Add(EHistorySearchSource Source, int64 Number, const FString& PrimaryText, const FString& SecondaryText)
+{
+	using namespace UnrealCopilotHistorySearchIndex;
+
+	const int32 EntryId = Entries.Num();
+	FIndexedEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Number = Number;
+	Entry.Source = Source;
+
+	Entry.PrimaryTextId = AddText(Source, true, PrimaryText);
+	Texts[Entry.PrimaryTextId].EntryIds.Add(EntryId);
+
+	if (!SecondaryText.IsEmpty())
+	{
+		Entry.SecondaryTextId = AddText(Source, false, SecondaryText.Left(MaxIndexedSecondaryChars));
+		Texts[Entry.SecondaryTextId].EntryIds.Add(EntryId);
+	}
+}
+
+void FUnrealCopilotHistorySearchIndex::RemoveBefore(EHistorySearchSource Source, int64 FirstKeptNumber)
+{
+	int64& SourceFirstKeptNumber = FirstKeptNumbers[static_cast<int32>(Source)];
+	SourceFirstKeptNumber = FMath::Max(SourceFirstKeptNumber, FirstKeptNumber);
+}
+
+void FUnrealCopilotHistorySearchIndex::Reset()
+{
+	Entries.Empty();
+	Texts.Empty();
+	TextIds.Empty();
+	Postings.Empty();
+	FirstKeptNumbers[0] = 0;
+	FirstKeptNumbers[1] = 0;
+}
+
+SIZE_T FUnrealCopilotHistorySearchIndex::GetAllocatedSize() const
+{
+	SIZE_T Size = Entries.GetAllocatedSize() + Texts.GetAllocatedSize() + TextIds.GetAllocatedSize() + Postings.GetAllocatedSize();
+	for (const FIndexedText& Text : Texts)
+	{
+		Size += Text.EntryIds.GetAllocatedSize();
+	}
+	for (const TPair<uint32, FPostingList>& Posting : Postings)
+	{
+		Size += Posting.Value.Bytes.GetAllocatedSize();
+	}
+	return Size;
+}
+
+int32 FUnrealCopilotHistorySearchIndex::AddText(EHistorySearchSource Source, bool bPrimary, const FString& Text)
+{
+	using namespace UnrealCopilotHistorySearchIndex;
+
+	// Identical texts of different sources or fields are indexed separately so results keep their weight
+	const uint8 TextKind[2] = { static_cast<uint8>(Source), static_cast<uint8>(bPrimary) };
+	const FTCHARToUTF8 Utf8Text(*Text);
+	FSHA1 HashState;
+	HashState.Update(TextKind, sizeof(TextKind));
+	HashState.Update(reinterpret_cast<const uint8*>(Utf8Text.Get()), Utf8Text.Length());
+	HashState.Final();
+	FSHAHash TextHash;
+	HashState.GetHash(TextHash.Hash);
+
+	if (const int32* ExistingTextId = TextIds.Find(TextHash))
+	{
+		return *ExistingTextId;
+	}
+
+	const int32 TextId = Texts.AddDefaulted();
+	Texts[TextId].bPrimary = bPrimary;
+	TextIds.Add(TextHash, TextId);
+
+	TSet<uint32> Trigrams;
+	CollectTrigrams(Text.ToLower(), Trigrams);
+	for (const uint32 Trigram : Trigrams)
+	{
+		FPostingList& PostingList = Postings.FindOrAdd(Trigram);
+		WriteVarInt(PostingList.Bytes, static_cast<uint32>(TextId - PostingList.LastTextId));
+		PostingList.LastTextId = TextId;
+	}
+	return TextId;
+}
+
+bool FUnrealCopilotHistorySearchIndex::IsEntryKept(const FIndexedEntry& Entry) const
+{
+	return Entry.Number >= FirstKeptNumbers[static_cast<int32>(Entry.Source)];
+}
+
+void FUnrealCopilotHistorySearchIndex::DecodePostings(const FPostingList& PostingList, TArray<int32>& OutTextIds)
+{
+	OutTextIds.Reset();
+
+	int32 TextId = INDEX_NONE;
+	uint32 Delta = 0;
+	int32 Shift = 0;
+	for (const uint8 Byte : PostingList.Bytes)
+	{
+		Delta |= static_cast<uint32>(Byte & 0x7F) << Shift;
+		if (Byte & 0x80)
+		{
+			Shift += 7;
+			continue;
+		}
+
+		TextId += static_cast<int32>(Delta);
+		OutTextIds.Add(TextId);
+		Delta = 0;
+		Shift = 0;
+	}
+}
+
+bool FUnrealCopilotHistorySearchIndex::Search(const FString& Query, bool bRegex, int32 MaxResults, FReadText ReadText, TArray<FHistorySearchResult>& OutResults) const
+{
+	using namespace UnrealCopilotHistorySearchIndex;
+
+	OutResults.Reset();
+	if (Query.IsEmpty() || MaxResults <= 0)
+	{
+		return true;
+	}
+
+	TOptional<FRegexPattern> Pattern;
+	TArray<FString> Literals;
+	if (bRegex)
+	{
+		Pattern.Emplace(Query, ERegexPatternFlags::CaseInsensitive);
+		ExtractRequiredLiterals(Query, Literals);
+	}
+	else
+	{
+		Literals.Add(Query.ToLower());
+	}
+
+	TSet<uint32> QueryTrigrams;
+	for (const FString& Literal : Literals)
+	{
+		CollectTrigrams(Literal, QueryTrigrams);
+	}
+
+	// Candidates contain every trigram of the query; without trigrams every text is a candidate
+	const bool bAllTextsAreCandidates = QueryTrigrams.Num() == 0;
+	TArray<int32> Candidates;
+	if (!bAllTextsAreCandidates)
+	{
+		TArray<const FPostingList*> PostingLists;
+		for (const uint32 Trigram : QueryTrigrams)
+		{
+			const FPostingList* PostingList = Postings.Find(Trigram);
+			if (!PostingList)
+			{
+				return true;
+			}
+			PostingLists.Add(PostingList);
+		}
+
+		// Start from the shortest list so the intersection stays small
+		PostingLists.Sort([](const FPostingList& A, const FPostingList& B) { return A.Bytes.Num() < B.Bytes.Num(); });
+		DecodePostings(*PostingLists[0], Candidates);
+
+		TArray<int32> ListTextIds;
+		for (int32 ListIndex = 1; ListIndex < PostingLists.Num() && Candidates.Num() > 0; ++ListIndex)
+		{
+			DecodePostings(*PostingLists[ListIndex], ListTextIds);
+
+			int32 KeptCount = 0;
+			int32 ListPosition = 0;
+			for (const int32 Candidate : Candidates)
+			{
+				while (ListPosition < ListTextIds.Num() && ListTextIds[ListPosition] < Candidate)
+				{
+					++ListPosition;
+				}
+				if (ListPosition < ListTextIds.Num() && ListTextIds[ListPosition] == Candidate)
+				{
+					Candidates[KeptCount++] = Candidate;
+				}
+			}
+			Candidates.SetNum(KeptCount, EAllowShrinking::No);
+		}
+	}
+
+	/** Matches grouped by the code or prompt of their entries */
+	struct FHit
+	{
+		float Score = 0.0f;
+		int32 NewestEntryId = INDEX_NONE;
+		FString Snippet;
+		bool bPrimarySnippet = false;
+	};
+	TMap<int32, FHit> HitsByPrimaryText;
+
+	// Newest texts first, so a search stopped by the read limit returns the most recent matches
+	bool bComplete = true;
+	int32 TextsRead = 0;
+	const int32 CandidateCount = bAllTextsAreCandidates ? Texts.Num() : Candidates.Num();
+	for (int32 CandidateIndex = CandidateCount - 1; CandidateIndex >= 0; --CandidateIndex)
+	{
+		const int32 TextId = bAllTextsAreCandidates ? CandidateIndex : Candidates[CandidateIndex];
+		const FIndexedText& Text = Texts[TextId];
+
+		// Entries of a text are oldest first and trimming drops the oldest, so the newest tells whether any is kept
+		if (Text.EntryIds.Num() == 0 || !IsEntryKept(Entries[Text.EntryIds.Last()]))
+		{
+			continue;
+		}
+
+		if (TextsRead >= MaxTextsRead)
+		{
+			bComplete = false;
+			break;
+		}
+		++TextsRead;
+
+		const int32 NewestEntryId = Text.EntryIds.Last();
+		const FIndexedEntry& NewestEntry = Entries[NewestEntryId];
+		const FString Content = ReadText(NewestEntry.Source, NewestEntry.Number, Text.bPrimary);
+
+		int32 FirstMatch = INDEX_NONE;
+		const int32 MatchCount = CountMatches(Content, Query, Pattern.GetPtrOrNull(), FirstMatch);
+		if (MatchCount == 0)
+		{
+			continue;
+		}
+
+		const float TextScore = (Text.bPrimary ? PrimaryWeight : SecondaryWeight) * (1.0f + 0.25f * (MatchCount - 1));
+		if (Text.bPrimary)
+		{
+			FHit& Hit = HitsByPrimaryText.FindOrAdd(TextId);
+			Hit.Score += TextScore;
+			Hit.NewestEntryId = FMath::Max(Hit.NewestEntryId, NewestEntryId);
+			Hit.Snippet = MakeSnippet(Content, FirstMatch);
+			Hit.bPrimarySnippet = true;
+			continue;
+		}
+
+		// A summary counts once for each code or prompt it was produced by
+		TSet<int32> ScoredPrimaryTexts;
+		for (int32 EntryPosition = Text.EntryIds.Num() - 1; EntryPosition >= 0; --EntryPosition)
+		{
+			const int32 EntryId = Text.EntryIds[EntryPosition];
+			const FIndexedEntry& Entry = Entries[EntryId];
+			if (!IsEntryKept(Entry))
+			{
+				break;
+			}
+
+			bool bAlreadyScored = false;
+			ScoredPrimaryTexts.Add(Entry.PrimaryTextId, &bAlreadyScored);
+			if (bAlreadyScored)
+			{
+				continue;
+			}
+
+			FHit& Hit = HitsByPrimaryText.FindOrAdd(Entry.PrimaryTextId);
+			Hit.Score += TextScore;
+			Hit.NewestEntryId = FMath::Max(Hit.NewestEntryId, EntryId);
+			if (!Hit.bPrimarySnippet && Hit.Snippet.IsEmpty())
+			{
+				Hit.Snippet = MakeSnippet(Content, FirstMatch);
+			}
+		}
+	}
+
+	TArray<TPair<int32, FHit>> RankedHits = HitsByPrimaryText.Array();
+	RankedHits.Sort([](const TPair<int32, FHit>& A, const TPair<int32, FHit>& B)
+	{
+		return A.Value.Score != B.Value.Score ? A.Value.Score > B.Value.Score : A.Value.NewestEntryId > B.Value.NewestEntryId;
+	});
+
+	for (const TPair<int32, FHit>& RankedHit : RankedHits)
+	{
+		if (OutResults.Num() >= MaxResults)
+		{
+			break;
+		}
+
+		const FIndexedEntry& Entry = Entries[RankedHit.Value.NewestEntryId];
+		const int64 FirstKeptNumber = FirstKeptNumbers[static_cast<int32>(Entry.Source)];
+		const TArray<int32>& PrimaryEntryIds = Texts[RankedHit.Key].EntryIds;
+		const int32 FirstKeptPosition = Algo::LowerBoundBy(PrimaryEntryIds, FirstKeptNumber, [this](int32 EntryId) { return Entries[EntryId].Number; });
+
+		FHistorySearchResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Source = Entry.Source;
+		Result.Index = static_cast<int32>(Entry.Number - FirstKeptNumber);
+		Result.Score = RankedHit.Value.Score;
+		Result.Occurrences = PrimaryEntryIds.Num() - FirstKeptPosition;
+		Result.Snippet = RankedHit.Value.Snippet;
+	}
+	return bComplete;
+}
+
+bool FUnrealCopilotHistorySearchIndex::HasTrigrams(const FString& Query, bool bRegex)
+{
+	TArray<FString> Literals;
+	if (bRegex)
+	{
+		ExtractRequiredLiterals(Query, Literals);
+	}
+	else
+	{
+		Literals.Add(Query);
+	}
+	return Literals.ContainsByPredicate([](const FString& Literal) { return Literal.Len() >= 3; });
+}
+
+void FUnrealCopilotHistorySearchIndex::ExtractRequiredLiterals(const FString& Pattern, TArray<FString>& OutLiterals)
+{
+	OutLiterals.Reset();
+
+	// Alternation can make any literal optional
+	if (Pattern.Contains(TEXT("|")))
+	{
+		return;
+	}
+
+	FString Run;
+	int32 GroupDepth = 0;
+	const auto EndRun = [&Run, &OutLiterals]()
+	{
+		if (Run.Len() >= 3)
+		{
+			OutLiterals.Add(Run.ToLower());
+		}
+		Run.Reset();
+	};
+
+	for (int32 Index = 0; Index < Pattern.Len(); ++Index)
+	{
+		TCHAR Literal = Pattern[Index];
+		switch (Literal)
+		{
+		case TEXT('\\'):
+			// An escaped symbol is itself; an escaped letter or digit is a class, anchor or back reference
+			if (Index + 1 < Pattern.Len() && !FChar::IsAlnum(Pattern[Index + 1]))
+			{
+				Literal = Pattern[++Index];
+				break;
+			}
+			++Index;
+			EndRun();
+			continue;
+
+		case TEXT('['):
+			// Skip the character class
+			for (++Index; Index < Pattern.Len() && Pattern[Index] != TEXT(']'); ++Index)
+			{
+				if (Pattern[Index] == TEXT('\\'))
+				{
+					++Index;
+				}
+			}
+			EndRun();
+			continue;
+
+		case TEXT('('):
+			++GroupDepth;
+			EndRun();
+			continue;
+
+		case TEXT(')'):
+			GroupDepth = FMath::Max(GroupDepth - 1, 0);
+			EndRun();
+			continue;
+
+		case TEXT('*'):
+		case TEXT('?'):
+		case TEXT('{'):
+			// The quantified character may not appear
+			if (!Run.IsEmpty())
+			{
+				Run.LeftChopInline(1, EAllowShrinking::No);
+			}
+			EndRun();
+			if (Literal == TEXT('{'))
+			{
+				while (Index < Pattern.Len() && Pattern[Index] != TEXT('}'))
+				{
+					++Index;
+				}
+			}
+			continue;
+
+		case TEXT('+'):
+		case TEXT('.'):
+		case TEXT('^'):
+		case TEXT('$'):
+			EndRun();
+			continue;
+
+		default:
+			break;
+		}
+
+		// Groups may be optional or repeated, so only literals outside them are required
+		if (GroupDepth == 0)
+		{
+			Run.AppendChar(Literal);
+		}
+	}
+	EndRun();
+}
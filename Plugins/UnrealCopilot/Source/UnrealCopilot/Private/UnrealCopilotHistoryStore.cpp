@@ -0,0 +1,811 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotHistoryStore.h"
+#include "UnrealCopilotHistoryJournal.h"
+#include "Async/MappedFileHandle.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace UnrealCopilotHistoryStore
+{
+	static constexpr uint32 IndexMagic = 0x49484355; // "UCHI"
+	static constexpr uint32 IndexVersion = 1;
+
+	/** Record kinds */
+	static constexpr uint8 RecordKindEntry = 0;
+	static constexpr uint8 RecordKindTrim = 1;
+
+	/** Trimmed entries needed before their space is reclaimed; below this, compacting costs more than it saves */
+	static constexpr int64 MinTrimmedRecordsToCompact = 1024;
+
+	/** Unreferenced blob bytes needed before their space is reclaimed */
+	static constexpr int64 MinUnreferencedBytesToCompact = 1024 * 1024;
+
+	/** Entries whose decompressed code and summary are kept in memory */
+	static constexpr int32 TextCacheSize = 256;
+
+	/** Append UTF-8 text to a blob, compressed unless that does not make it smaller */
+	static void StoreText(const FTCHARToUTF8& Utf8Text, TArray<uint8>& Blob, uint32& OutStoredSize, uint32& OutSize)
+	{
+		const int32 Size = Utf8Text.Length();
+		OutSize = Size;
+
+		const int32 Start = Blob.Num();
+		if (Size > 0)
+		{
+			int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Size);
+			Blob.AddUninitialized(CompressedSize);
+			if (FCompression::CompressMemory(NAME_Zlib, Blob.GetData() + Start, CompressedSize, Utf8Text.Get(), Size) && CompressedSize < Size)
+			{
+				Blob.SetNum(Start + CompressedSize, EAllowShrinking::No);
+				OutStoredSize = CompressedSize;
+				return;
+			}
+			Blob.SetNum(Start, EAllowShrinking::No);
+		}
+
+		Blob.Append(reinterpret_cast<const uint8*>(Utf8Text.Get()), Size);
+		OutStoredSize = Size;
+	}
+
+	template <typename RecordType>
+	static TArray<uint8> ToBytes(const RecordType& Record)
+	{
+		TArray<uint8> Bytes;
+		Bytes.Append(reinterpret_cast<const uint8*>(&Record), sizeof(RecordType));
+		return Bytes;
+	}
+
+	static int64 GetFileSize(const FString& FilePath)
+	{
+		return FMath::Max<int64>(FPlatformFileManager::Get().GetPlatformFile().FileSize(*FilePath), 0);
+	}
+
+	/** Create an empty file and sync it to disk */
+	static bool WriteMarkerFile(const FString& FilePath)
+	{
+		TUniquePtr<IFileHandle> MarkerHandle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath));
+		return MarkerHandle.IsValid() && MarkerHandle->Flush(/*bFullFlush*/ true);
+	}
+
+	/** Copy a stored text between blob files; returns its offset in the new file */
+	static int64 CopyBlob(IFileHandle& Source, IFileHandle& Destination, int64 Offset, uint32 StoredSize, TArray<uint8>& Buffer)
+	{
+		const int64 NewOffset = Destination.Tell();
+		if (StoredSize > 0)
+		{
+			Buffer.SetNumUninitialized(StoredSize, EAllowShrinking::No);
+			if (Source.Seek(Offset) && Source.Read(Buffer.GetData(), StoredSize))
+			{
+				Destination.Write(Buffer.GetData(), StoredSize);
+			}
+		}
+		return NewOffset;
+	}
+}
+
+FUnrealCopilotHistoryStore::FUnrealCopilotHistoryStore(const FString& InDirectory, const FString& InBaseName)
+	: IndexPath(InDirectory / (InBaseName + TEXT(".idx")))
+	, JournalPath(InDirectory / (InBaseName + TEXT(".journal")))
+	, CodeTablePath(InDirectory / (InBaseName + TEXT(".codes")))
+	, BlobPath(InDirectory / (InBaseName + TEXT(".blob")))
+	, CompactCommitPath(InDirectory / (InBaseName + TEXT(".compact")))
+	, CodeCache(UnrealCopilotHistoryStore::TextCacheSize)
+	, SummaryCache(UnrealCopilotHistoryStore::TextCacheSize)
+{
+}
+
+FUnrealCopilotHistoryStore::~FUnrealCopilotHistoryStore()
+{
+	Journal.Reset();
+	BlobReader.Reset();
+	UnmapIndex();
+}
+
+bool FUnrealCopilotHistoryStore::Open()
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	Journal.Reset();
+	BlobReader.Reset();
+	UnmapIndex();
+	AddedRecords.Reset();
+	CodeCache.Empty(TextCacheSize);
+	SummaryCache.Empty(TextCacheSize);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(IndexPath));
+	if (!RecoverCompaction())
+	{
+		// The files are left for the next open to recover; until then nothing is read or recorded
+		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Execution history %s is unavailable until its compaction can be finished"), *IndexPath);
+		return true;
+	}
+	const bool bExisted = PlatformFile.FileExists(*IndexPath) || PlatformFile.FileExists(*JournalPath);
+
+	MergeJournal();
+
+	FIndexHeader Header;
+	if (!ReadHeader(Header))
+	{
+		// A missing or unreadable index starts a new history; its blobs are unreachable without it
+		PlatformFile.DeleteFile(*IndexPath);
+		PlatformFile.DeleteFile(*CodeTablePath);
+		PlatformFile.DeleteFile(*BlobPath);
+		FMemory::Memzero(Header);
+		WriteHeader(Header);
+	}
+
+	FirstKeptRecord = Header.FirstKeptRecord;
+	BlobFileSize = GetFileSize(BlobPath);
+	LoadCodeTable();
+	MapIndex();
+	CountReferences();
+
+	if (ShouldCompact())
+	{
+		UnmapIndex();
+		if (!Compact())
+		{
+			UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Execution history %s is unavailable until its compaction can be finished"), *IndexPath);
+			return bExisted;
+		}
+		ReadHeader(Header);
+
+		FirstKeptRecord = Header.FirstKeptRecord;
+		BlobFileSize = GetFileSize(BlobPath);
+		LoadCodeTable();
+		MapIndex();
+		CountReferences();
+	}
+
+	Journal = MakeUnique<FUnrealCopilotHistoryJournal>(JournalPath, CodeTablePath, BlobPath, BlobFileSize);
+	return bExisted;
+}
+
+int32 FUnrealCopilotHistoryStore::Num() const
+{
+	return static_cast<int32>(FMath::Clamp<int64>(IndexRecordCount + AddedRecords.Num() - FirstKeptRecord, 0, MAX_int32));
+}
+
+void FUnrealCopilotHistoryStore::Append(const FPythonExecutionHistoryEntry& Entry)
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	if (!Journal.IsValid())
+	{
+		return;
+	}
+
+	FIndexRecord Record;
+	FMemory::Memzero(Record);
+	Record.Kind = RecordKindEntry;
+	Record.Value = Entry.Timestamp.GetTicks();
+	Record.bSuccess = Entry.bWasSuccessful ? 1 : 0;
+
+	// Code already stored is referred to rather than stored again
+	const FTCHARToUTF8 Utf8Code(*Entry.Code);
+	FSHAHash CodeHash;
+	FSHA1::HashBuffer(Utf8Code.Get(), Utf8Code.Length(), CodeHash.Hash);
+
+	TArray<uint8> Blob;
+	TArray<uint8> CodeRecordBytes;
+	if (Utf8Code.Length() == 0)
+	{
+		// Empty code has no blob to share
+		Record.CodeOffset = BlobFileSize;
+	}
+	else if (const FCodeRecord* StoredCode = CodeBlobs.Find(CodeHash))
+	{
+		Record.CodeOffset = StoredCode->Offset;
+		Record.CodeStoredSize = StoredCode->StoredSize;
+		Record.CodeSize = StoredCode->Size;
+	}
+	else
+	{
+		FCodeRecord CodeRecord;
+		FMemory::Memzero(CodeRecord);
+		FMemory::Memcpy(CodeRecord.Hash, CodeHash.Hash, sizeof(CodeRecord.Hash));
+		CodeRecord.Offset = BlobFileSize;
+		StoreText(Utf8Code, Blob, CodeRecord.StoredSize, CodeRecord.Size);
+		CodeBlobs.Add(CodeHash, CodeRecord);
+		CodeRecordBytes = ToBytes(CodeRecord);
+
+		Record.CodeOffset = CodeRecord.Offset;
+		Record.CodeStoredSize = CodeRecord.StoredSize;
+		Record.CodeSize = CodeRecord.Size;
+	}
+
+	Record.SummaryOffset = BlobFileSize + Blob.Num();
+	StoreText(FTCHARToUTF8(*Entry.ResultSummary), Blob, Record.SummaryStoredSize, Record.SummarySize);
+	BlobFileSize += Blob.Num();
+
+	// The new entry is the one most likely to be read next, e.g. by history navigation
+	const int64 Position = IndexRecordCount + AddedRecords.Num();
+	AddedRecords.Add(Record);
+	SummaryCache.Add(Position, Entry.ResultSummary);
+
+	if (Record.CodeStoredSize > 0)
+	{
+		CodeCache.Add(Record.CodeOffset, Entry.Code);
+
+		// A trimmed blob referred to again is no longer unreferenced
+		int32& CodeReferenceCount = CodeReferences.FindOrAdd(Record.CodeOffset);
+		if (CodeReferenceCount++ == 0 && CodeRecordBytes.Num() == 0)
+		{
+			UnreferencedBlobBytes -= Record.CodeStoredSize;
+		}
+	}
+
+	Journal->Append(ToBytes(Record), MoveTemp(CodeRecordBytes), MoveTemp(Blob));
+}
+
+bool FUnrealCopilotHistoryStore::GetEntry(int32 Index, FPythonExecutionHistoryEntry& OutEntry) const
+{
+	if (Index < 0 || Index >= Num())
+	{
+		return false;
+	}
+
+	const int64 Position = FirstKeptRecord + Index;
+	const FIndexRecord& Record = GetRecord(Position);
+	OutEntry.Timestamp = FDateTime(Record.Value);
+	OutEntry.bWasSuccessful = Record.bSuccess != 0;
+
+	if (Record.CodeStoredSize == 0)
+	{
+		OutEntry.Code.Reset();
+	}
+	else if (const FString* CachedCode = CodeCache.FindAndTouch(Record.CodeOffset))
+	{
+		OutEntry.Code = *CachedCode;
+	}
+	else
+	{
+		OutEntry.Code = ReadText(Record.CodeOffset, Record.CodeStoredSize, Record.CodeSize);
+		CodeCache.Add(Record.CodeOffset, OutEntry.Code);
+	}
+
+	if (const FString* CachedSummary = SummaryCache.FindAndTouch(Position))
+	{
+		OutEntry.ResultSummary = *CachedSummary;
+	}
+	else
+	{
+		OutEntry.ResultSummary = ReadText(Record.SummaryOffset, Record.SummaryStoredSize, Record.SummarySize);
+		SummaryCache.Add(Position, OutEntry.ResultSummary);
+	}
+	return true;
+}
+
+int32 FUnrealCopilotHistoryStore::GetPage(int32 FirstIndex, int32 MaxCount, TArray<FPythonExecutionHistoryEntry>& OutEntries) const
+{
+	OutEntries.Reset();
+
+	const int32 Start = FMath::Max(FirstIndex, 0);
+	const int32 End = static_cast<int32>(FMath::Min<int64>(Num(), static_cast<int64>(Start) + FMath::Max(MaxCount, 0)));
+	if (End <= Start)
+	{
+		return 0;
+	}
+
+	OutEntries.Reserve(End - Start);
+	for (int32 Index = Start; Index < End; ++Index)
+	{
+		GetEntry(Index, OutEntries.AddDefaulted_GetRef());
+	}
+	return OutEntries.Num();
+}
+
+void FUnrealCopilotHistoryStore::Trim(int32 MaxEntries)
+{
+	const int64 RecordCount = IndexRecordCount + AddedRecords.Num();
+	const int64 NewFirstKeptRecord = RecordCount - FMath::Max(MaxEntries, 0);
+	if (NewFirstKeptRecord > FirstKeptRecord)
+	{
+		for (int64 Position = FirstKeptRecord; Position < NewFirstKeptRecord; ++Position)
+		{
+			ReleaseReferences(GetRecord(Position));
+		}
+
+		FirstKeptRecord = NewFirstKeptRecord;
+		AppendTrimRecord();
+	}
+}
+
+void FUnrealCopilotHistoryStore::Clear()
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	// The files are deleted rather than trimmed, so cleared entries do not stay on disk until the store compacts
+	Journal.Reset();
+	BlobReader.Reset();
+	UnmapIndex();
+	AddedRecords.Reset();
+	CodeBlobs.Reset();
+	CodeReferences.Reset();
+	CodeCache.Empty(TextCacheSize);
+	SummaryCache.Empty(TextCacheSize);
+	FirstKeptRecord = 0;
+	BlobFileSize = 0;
+	UnreferencedBlobBytes = 0;
+
+	// The journal goes first so its records are not merged into a new index, and the index before the blobs it refers to
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for (const FString& FilePath : { JournalPath, IndexPath, CodeTablePath, BlobPath })
+	{
+		if (PlatformFile.FileExists(*FilePath) && !PlatformFile.DeleteFile(*FilePath))
+		{
+			UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to delete cleared execution history file %s"), *FilePath);
+		}
+	}
+
+	FIndexHeader Header;
+	FMemory::Memzero(Header);
+	WriteHeader(Header);
+	Journal = MakeUnique<FUnrealCopilotHistoryJournal>(JournalPath, CodeTablePath, BlobPath, BlobFileSize);
+}
+
+void FUnrealCopilotHistoryStore::Flush()
+{
+	if (Journal.IsValid())
+	{
+		Journal->Flush();
+	}
+}
+
+void FUnrealCopilotHistoryStore::AppendTrimRecord()
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	if (!Journal.IsValid())
+	{
+		return;
+	}
+
+	FIndexRecord Record;
+	FMemory::Memzero(Record);
+	Record.Kind = RecordKindTrim;
+	Record.Value = FirstKeptRecord;
+	Journal->Append(ToBytes(Record), TArray<uint8>(), TArray<uint8>());
+}
+
+void FUnrealCopilotHistoryStore::ReleaseReferences(const FIndexRecord& Record)
+{
+	UnreferencedBlobBytes += Record.SummaryStoredSize;
+
+	// The code blob stays in the code table, so running the code again before the store compacts reuses it
+	int32* CodeReferenceCount = Record.CodeStoredSize > 0 ? CodeReferences.Find(Record.CodeOffset) : nullptr;
+	if (CodeReferenceCount && --(*CodeReferenceCount) <= 0)
+	{
+		CodeReferences.Remove(Record.CodeOffset);
+		UnreferencedBlobBytes += Record.CodeStoredSize;
+	}
+}
+
+void FUnrealCopilotHistoryStore::MergeJournal()
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TArray<uint8> JournalData;
+	if (!PlatformFile.FileExists(*JournalPath) || !FFileHelper::LoadFileToArray(JournalData, *JournalPath))
+	{
+		return;
+	}
+
+	FIndexHeader Header;
+	const bool bHadIndex = ReadHeader(Header);
+	if (!bHadIndex)
+	{
+		PlatformFile.DeleteFile(*IndexPath);
+		FMemory::Memzero(Header);
+	}
+
+	int64 RecordCount = bHadIndex ? ReadRecordCount() : 0;
+	const int64 BlobSize = GetFileSize(BlobPath);
+
+	// A record torn by a crash mid-write is dropped, as is any entry whose blob did not reach the disk
+	TArray<uint8> MergedRecords;
+	const int32 JournalRecordCount = JournalData.Num() / sizeof(FIndexRecord);
+	for (int32 JournalIndex = 0; JournalIndex < JournalRecordCount; ++JournalIndex)
+	{
+		FIndexRecord Record;
+		FMemory::Memcpy(&Record, JournalData.GetData() + JournalIndex * sizeof(FIndexRecord), sizeof(FIndexRecord));
+
+		if (Record.Kind == RecordKindTrim)
+		{
+			Header.FirstKeptRecord = FMath::Max(Header.FirstKeptRecord, FMath::Min(Record.Value, RecordCount));
+			continue;
+		}
+
+		if (Record.Kind != RecordKindEntry
+			|| Record.CodeOffset + Record.CodeStoredSize > BlobSize
+			|| Record.SummaryOffset + Record.SummaryStoredSize > BlobSize)
+		{
+			// Later records were positioned after this one, so they cannot be kept either
+			break;
+		}
+
+		MergedRecords.Append(reinterpret_cast<const uint8*>(&Record), sizeof(FIndexRecord));
+		++RecordCount;
+	}
+
+	{
+		TUniquePtr<IFileHandle> IndexHandle(PlatformFile.OpenWrite(*IndexPath, /*bAppend*/ true));
+		if (!IndexHandle.IsValid())
+		{
+			UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to merge execution history journal into %s"), *IndexPath);
+			return;
+		}
+
+		if (!bHadIndex)
+		{
+			Header.Magic = IndexMagic;
+			Header.Version = IndexVersion;
+			Header.RecordSize = sizeof(FIndexRecord);
+			IndexHandle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(FIndexHeader));
+		}
+		IndexHandle->Write(MergedRecords.GetData(), MergedRecords.Num());
+		IndexHandle->Flush(/*bFullFlush*/ true);
+	}
+
+	WriteHeader(Header);
+	PlatformFile.DeleteFile(*JournalPath);
+}
+
+void FUnrealCopilotHistoryStore::LoadCodeTable()
+{
+	CodeBlobs.Reset();
+
+	TArray<uint8> CodeTableData;
+	if (!FFileHelper::LoadFileToArray(CodeTableData, *CodeTablePath, FILEREAD_Silent))
+	{
+		return;
+	}
+
+	// Code records are written after their blobs, so a record past the end of the blob file was torn by a crash
+	const int32 CodeRecordCount = CodeTableData.Num() / sizeof(FCodeRecord);
+	int32 ValidRecordCount = 0;
+	for (; ValidRecordCount < CodeRecordCount; ++ValidRecordCount)
+	{
+		FCodeRecord CodeRecord;
+		FMemory::Memcpy(&CodeRecord, CodeTableData.GetData() + ValidRecordCount * sizeof(FCodeRecord), sizeof(FCodeRecord));
+		if (CodeRecord.Offset + CodeRecord.StoredSize > BlobFileSize)
+		{
+			break;
+		}
+
+		FSHAHash CodeHash;
+		FMemory::Memcpy(CodeHash.Hash, CodeRecord.Hash, sizeof(CodeHash.Hash));
+		CodeBlobs.Add(CodeHash, CodeRecord);
+	}
+
+	// Records appended later must start on a record boundary
+	const int64 ValidSize = static_cast<int64>(ValidRecordCount) * sizeof(FCodeRecord);
+	if (ValidSize != CodeTableData.Num())
+	{
+		FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(CodeTableData.GetData(), ValidSize), *CodeTablePath);
+	}
+}
+
+void FUnrealCopilotHistoryStore::CountReferences()
+{
+	CodeReferences.Reset();
+
+	int64 ReferencedBlobBytes = 0;
+	for (int64 Position = FirstKeptRecord; Position < IndexRecordCount; ++Position)
+	{
+		const FIndexRecord& Record = IndexRecords[Position];
+		if (Record.CodeStoredSize > 0 && CodeReferences.FindOrAdd(Record.CodeOffset)++ == 0)
+		{
+			ReferencedBlobBytes += Record.CodeStoredSize;
+		}
+		ReferencedBlobBytes += Record.SummaryStoredSize;
+	}
+	UnreferencedBlobBytes = FMath::Max<int64>(BlobFileSize - ReferencedBlobBytes, 0);
+}
+
+bool FUnrealCopilotHistoryStore::ShouldCompact() const
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	const int64 KeptRecordCount = IndexRecordCount - FirstKeptRecord;
+	const bool bMostlyTrimmedRecords = FirstKeptRecord >= MinTrimmedRecordsToCompact && FirstKeptRecord > KeptRecordCount;
+	const bool bMostlyUnreferencedBlobs = UnreferencedBlobBytes >= MinUnreferencedBytesToCompact && UnreferencedBlobBytes > BlobFileSize - UnreferencedBlobBytes;
+	return bMostlyTrimmedRecords || bMostlyUnreferencedBlobs;
+}
+
+bool FUnrealCopilotHistoryStore::Compact()
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	FIndexHeader Header;
+	if (!ReadHeader(Header))
+	{
+		return true;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempIndexPath = IndexPath + TEXT(".tmp");
+	const FString TempCodeTablePath = CodeTablePath + TEXT(".tmp");
+	const FString TempBlobPath = BlobPath + TEXT(".tmp");
+	const int64 RecordCount = ReadRecordCount();
+
+	TMap<int64, const FCodeRecord*> CodeRecordsByOffset;
+	CodeRecordsByOffset.Reserve(CodeBlobs.Num());
+	for (const TPair<FSHAHash, FCodeRecord>& CodeBlob : CodeBlobs)
+	{
+		CodeRecordsByOffset.Add(CodeBlob.Value.Offset, &CodeBlob.Value);
+	}
+
+	bool bCopied = false;
+	{
+		TUniquePtr<IFileHandle> OldIndex(PlatformFile.OpenRead(*IndexPath));
+		TUniquePtr<IFileHandle> OldBlobs(PlatformFile.OpenRead(*BlobPath));
+		TUniquePtr<IFileHandle> NewIndex(PlatformFile.OpenWrite(*TempIndexPath));
+		TUniquePtr<IFileHandle> NewCodeTable(PlatformFile.OpenWrite(*TempCodeTablePath));
+		TUniquePtr<IFileHandle> NewBlobs(PlatformFile.OpenWrite(*TempBlobPath));
+		if (!OldIndex.IsValid() || !OldBlobs.IsValid() || !NewIndex.IsValid() || !NewCodeTable.IsValid() || !NewBlobs.IsValid())
+		{
+			// Copies left behind are deleted by the next open, since no marker commits them
+			UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to compact execution history %s"), *IndexPath);
+			return true;
+		}
+
+		FIndexHeader NewHeader = Header;
+		NewHeader.FirstKeptRecord = 0;
+		NewIndex->Write(reinterpret_cast<const uint8*>(&NewHeader), sizeof(FIndexHeader));
+
+		OldIndex->Seek(sizeof(FIndexHeader) + Header.FirstKeptRecord * sizeof(FIndexRecord));
+		// Code shared by several kept entries is copied once; code no kept entry refers to is not copied
+		TArray<uint8> Buffer;
+		TMap<int64, int64> CopiedCodeOffsets;
+		for (int64 Position = Header.FirstKeptRecord; Position < RecordCount; ++Position)
+		{
+			FIndexRecord Record;
+			if (!OldIndex->Read(reinterpret_cast<uint8*>(&Record), sizeof(FIndexRecord)))
+			{
+				break;
+			}
+
+			const int64* CopiedCodeOffset = Record.CodeStoredSize > 0 ? CopiedCodeOffsets.Find(Record.CodeOffset) : nullptr;
+			if (CopiedCodeOffset)
+			{
+				Record.CodeOffset = *CopiedCodeOffset;
+			}
+			else
+			{
+				const int64 OldCodeOffset = Record.CodeOffset;
+				Record.CodeOffset = CopyBlob(*OldBlobs, *NewBlobs, OldCodeOffset, Record.CodeStoredSize, Buffer);
+
+				// Empty code owns no blob; its offset is wherever the blob file ended, which may be the next entry's code
+				if (Record.CodeStoredSize > 0)
+				{
+					CopiedCodeOffsets.Add(OldCodeOffset, Record.CodeOffset);
+
+					if (const FCodeRecord* const* OldCodeRecord = CodeRecordsByOffset.Find(OldCodeOffset))
+					{
+						FCodeRecord CodeRecord = **OldCodeRecord;
+						CodeRecord.Offset = Record.CodeOffset;
+						NewCodeTable->Write(reinterpret_cast<const uint8*>(&CodeRecord), sizeof(FCodeRecord));
+					}
+				}
+			}
+
+			Record.SummaryOffset = CopyBlob(*OldBlobs, *NewBlobs, Record.SummaryOffset, Record.SummaryStoredSize, Buffer);
+			NewIndex->Write(reinterpret_cast<const uint8*>(&Record), sizeof(FIndexRecord));
+		}
+
+		bCopied = NewBlobs->Flush(/*bFullFlush*/ true) && NewCodeTable->Flush(/*bFullFlush*/ true) && NewIndex->Flush(/*bFullFlush*/ true);
+	}
+
+	// The marker commits the copies only once they are all on disk; from then on an open finishes the replacement
+	if (!bCopied || !WriteMarkerFile(CompactCommitPath))
+	{
+		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to compact execution history %s"), *IndexPath);
+		PlatformFile.DeleteFile(*CompactCommitPath);
+		RecoverCompaction();
+		return true;
+	}
+
+	if (!FinishCompaction())
+	{
+		return false;
+	}
+
+	UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Compacted execution history, reclaiming %lld trimmed entries and %lld unreferenced bytes"),
+		Header.FirstKeptRecord, UnreferencedBlobBytes);
+	return true;
+}
+
+TArray<FString> FUnrealCopilotHistoryStore::GetCompactedFilePaths() const
+{
+	// The blob file is replaced first: an old index or code table over new blobs would point at the wrong text
+	return { BlobPath, CodeTablePath, IndexPath };
+}
+
+bool FUnrealCopilotHistoryStore::FinishCompaction() const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+	// Every copy was on disk before the marker was written, so a missing copy was already moved into place
+	for (const FString& FilePath : GetCompactedFilePaths())
+	{
+		const FString TempPath = FilePath + TEXT(".tmp");
+		if (!PlatformFile.FileExists(*TempPath))
+		{
+			continue;
+		}
+
+		PlatformFile.DeleteFile(*FilePath);
+		if (!PlatformFile.MoveFile(*FilePath, *TempPath))
+		{
+			UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to replace %s with its compacted copy"), *FilePath);
+			return false;
+		}
+	}
+
+	// A marker left behind would commit the partial copies of a later compaction interrupted before its own marker
+	if (!PlatformFile.DeleteFile(*CompactCommitPath))
+	{
+		UE_LOG(LogUnrealCopilotExecution, Warning, TEXT("Failed to delete %s"), *CompactCommitPath);
+		return false;
+	}
+	return true;
+}
+
+bool FUnrealCopilotHistoryStore::RecoverCompaction() const
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*CompactCommitPath))
+	{
+		UE_LOG(LogUnrealCopilotExecution, Log, TEXT("Finishing interrupted compaction of execution history %s"), *IndexPath);
+		return FinishCompaction();
+	}
+
+	// Copies without a marker may be incomplete; the files they were copied from are intact
+	for (const FString& FilePath : GetCompactedFilePaths())
+	{
+		const FString TempPath = FilePath + TEXT(".tmp");
+		if (PlatformFile.FileExists(*TempPath))
+		{
+			PlatformFile.DeleteFile(*TempPath);
+		}
+	}
+	return true;
+}
+
+void FUnrealCopilotHistoryStore::MapIndex()
+{
+	UnmapIndex();
+
+	const int64 RecordCount = ReadRecordCount();
+	if (RecordCount <= 0)
+	{
+		return;
+	}
+
+	const int64 MappedSize = static_cast<int64>(sizeof(FIndexHeader)) + RecordCount * static_cast<int64>(sizeof(FIndexRecord));
+	MappedIndexFile.Reset(IPlatformFile::GetPlatformPhysical().OpenMapped(*IndexPath));
+	if (MappedIndexFile.IsValid())
+	{
+		MappedIndexRegion.Reset(MappedIndexFile->MapRegion(0, MappedSize));
+	}
+
+	if (MappedIndexRegion.IsValid())
+	{
+		IndexRecords = reinterpret_cast<const FIndexRecord*>(MappedIndexRegion->GetMappedPtr() + sizeof(FIndexHeader));
+	}
+	else
+	{
+		MappedIndexFile.Reset();
+		if (!FFileHelper::LoadFileToArray(IndexFallback, *IndexPath) || IndexFallback.Num() < MappedSize)
+		{
+			IndexFallback.Empty();
+			return;
+		}
+		IndexRecords = reinterpret_cast<const FIndexRecord*>(IndexFallback.GetData() + sizeof(FIndexHeader));
+	}
+	IndexRecordCount = RecordCount;
+}
+
+void FUnrealCopilotHistoryStore::UnmapIndex()
+{
+	MappedIndexRegion.Reset();
+	MappedIndexFile.Reset();
+	IndexFallback.Empty();
+	IndexRecords = nullptr;
+	IndexRecordCount = 0;
+}
+
+const FUnrealCopilotHistoryStore::FIndexRecord& FUnrealCopilotHistoryStore::GetRecord(int64 Position) const
+{
+	return Position < IndexRecordCount ? IndexRecords[Position] : AddedRecords[Position - IndexRecordCount];
+}
+
+FString FUnrealCopilotHistoryStore::ReadText(int64 Offset, uint32 StoredSize, uint32 Size) const
+{
+	if (Size == 0)
+	{
+		return FString();
+	}
+
+	// Blobs of recent entries may still be queued
+	if (Journal.IsValid() && Offset + StoredSize > Journal->GetWrittenBlobSize())
+	{
+		Journal->Flush();
+	}
+
+	if (!BlobReader.IsValid())
+	{
+		BlobReader.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*BlobPath, /*bAllowWrite*/ true));
+	}
+
+	TArray<uint8> Stored;
+	Stored.SetNumUninitialized(StoredSize);
+	if (!BlobReader.IsValid() || !BlobReader->Seek(Offset) || !BlobReader->Read(Stored.GetData(), StoredSize))
+	{
+		return FString();
+	}
+
+	TArray<uint8> Text;
+	if (StoredSize == Size)
+	{
+		Text = MoveTemp(Stored);
+	}
+	else
+	{
+		Text.SetNumUninitialized(Size);
+		if (!FCompression::UncompressMemory(NAME_Zlib, Text.GetData(), Size, Stored.GetData(), StoredSize))
+		{
+			return FString();
+		}
+	}
+
+	const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Text.GetData()), Text.Num());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+int64 FUnrealCopilotHistoryStore::ReadRecordCount() const
+{
+	// A record torn by a crash mid-write is not counted
+	const int64 RecordBytes = UnrealCopilotHistoryStore::GetFileSize(IndexPath) - static_cast<int64>(sizeof(FIndexHeader));
+	return FMath::Max<int64>(RecordBytes, 0) / static_cast<int64>(sizeof(FIndexRecord));
+}
+
+bool FUnrealCopilotHistoryStore::ReadHeader(FIndexHeader& OutHeader) const
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	TUniquePtr<IFileHandle> IndexHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*IndexPath));
+	if (!IndexHandle.IsValid() || !IndexHandle->Read(reinterpret_cast<uint8*>(&OutHeader), sizeof(FIndexHeader)))
+	{
+		return false;
+	}
+	return OutHeader.Magic == IndexMagic && OutHeader.Version == IndexVersion && OutHeader.RecordSize == sizeof(FIndexRecord);
+}
+
+bool FUnrealCopilotHistoryStore::WriteHeader(const FIndexHeader& Header) const
+{
+	using namespace UnrealCopilotHistoryStore;
+
+	FIndexHeader CompleteHeader = Header;
+	CompleteHeader.Magic = IndexMagic;
+	CompleteHeader.Version = IndexVersion;
+	CompleteHeader.RecordSize = sizeof(FIndexRecord);
+
+	// Opened for appending so the records after the header are kept
+	TUniquePtr<IFileHandle> IndexHandle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*IndexPath, /*bAppend*/ true));
+	if (!IndexHandle.IsValid() || !IndexHandle->Seek(0))
+	{
+		return false;
+	}
+
+	IndexHandle->Write(reinterpret_cast<const uint8*>(&CompleteHeader), sizeof(FIndexHeader));
+	IndexHandle->Flush(/*bFullFlush*/ true);
+	return true;
+}
@@ -2,6 +2,11 @@
 
 #include "UnrealCopilotLLMManager.h"
 #include "UnrealCopilotSettings.h"
+#include "UnrealCopilotEditorTools.h"
+#include "UnrealCopilotPatternScanner.h"
+#include "UnrealCopilotPythonParser.h"
+#include "UnrealCopilotCodeCache.h"
+#include "UnrealCopilotExecutionManager.h"
 #include "Http.h"
 #include "HttpModule.h"
 #include "Dom/JsonObject.h"
@@ -10,6 +15,8 @@
 #include "Serialization/JsonWriter.h"
 #include "Misc/DateTime.h"
 #include "Engine/Engine.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogUnrealCopilotLLM, Log, All);
 
@@ -48,7 +55,7 @@ UUnrealCopilotLLMManager* UUnrealCopilotLLMManager::GetInstance()
 void UUnrealCopilotLLMManager::ProcessNaturalLanguagePrompt(const FString& Prompt, const FOnCodeGenerationComplete& OnComplete)
 {
 	// Check if already processing
-	if (CurrentState == ECodeGenerationState::Processing)
+	if (CurrentState == ECodeGenerationState::Processing || CurrentState == ECodeGenerationState::Validating)
 	{
 		FCodeGenerationResult ErrorResult;
 		ErrorResult.bSuccess = false;
@@ -108,14 +115,20 @@ void UUnrealCopilotLLMManager::ProcessNaturalLanguagePrompt(const FString& Promp
 	// Store delegate for later use
 	ActiveDelegates.Add(OnComplete);
 
-	// Process prompt with context
-	FPromptContext Context = PromptProcessor->GatherCurrentContext();
+	// Process prompt with context narrowed to the detected workflow
+	FPromptContext Context = PromptProcessor->GatherContextForPrompt(Prompt);
 	FString ProcessedPrompt = PromptProcessor->ProcessPrompt(Prompt, Context);
 
+	if (Settings->bEnableAPILogging)
+	{
+		UE_LOG(LogUnrealCopilotLLM, Log, TEXT("Prompt classified as workflow %s (confidence %.2f)"),
+			*UEnum::GetValueAsString(Context.WorkflowType), Context.WorkflowConfidence);
+	}
+
 	// Send to appropriate provider
 	if (Settings->CurrentProvider == ELLMProvider::OpenAI)
 	{
-		SendOpenAIRequest(ProcessedPrompt, OnComplete);
+		SendOpenAIRequest(Prompt, ProcessedPrompt, Context, OnComplete);
 	}
 	else
 	{
@@ -171,43 +184,50 @@ bool UUnrealCopilotLLMManager::ValidateGeneratedCode(const FString& PythonCode,
 		return true; // Safety validation disabled
 	}
 
-	// Check for blocked operations
-	for (const FString& BlockedOp : Settings->BlockedOperations)
+	// Scripts already judged under the current rules are not checked again
+	const FString CodeHash = FUnrealCopilotCodeCache::HashSource(FUnrealCopilotCodeCache::NormalizeSource(PythonCode));
+	FPythonCodeVerdict Verdict;
+	if (!FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind::Safety, CodeHash, Verdict))
 	{
-		if (PythonCode.Contains(BlockedOp))
-		{
-			OutErrorMessage = FString::Printf(TEXT("Generated code contains blocked operation: %s"), *BlockedOp);
-			return false;
-		}
+		Verdict.bValid = CheckGeneratedCodeSafety(PythonCode, Verdict.ErrorMessage);
+		FUnrealCopilotCodeCache::AddVerdict(EPythonVerdictKind::Safety, CodeHash, Verdict);
 	}
 
-	// Check for common dangerous patterns
-	TArray<FString> DangerousPatterns = {
-		TEXT("__import__"),
-		TEXT("eval("),
-		TEXT("exec("),
-		TEXT("compile("),
-		TEXT("globals()"),
-		TEXT("locals()"),
-		TEXT("getattr("),
-		TEXT("setattr("),
-		TEXT("delattr("),
-		TEXT("hasattr(")
-	};
+	OutErrorMessage = Verdict.ErrorMessage;
+	return Verdict.bValid;
+}
+
+bool UUnrealCopilotLLMManager::CheckGeneratedCodeSafety(const FString& PythonCode, FString& OutErrorMessage)
+{
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
 
-	for (const FString& Pattern : DangerousPatterns)
+	// Structural checks on the syntax tree: imports, dangerous builtins and introspection attributes
+	FPythonAst Ast;
+	FPythonSyntaxError SyntaxError;
+	if (!FUnrealCopilotPythonParser::Parse(PythonCode, Ast, SyntaxError))
 	{
-		if (PythonCode.Contains(Pattern))
-		{
-			OutErrorMessage = FString::Printf(TEXT("Generated code contains potentially unsafe pattern: %s"), *Pattern);
-			return false;
-		}
+		OutErrorMessage = TEXT("Generated code has a syntax error: ") + SyntaxError.ToString();
+		return false;
 	}
 
-	// Check for file system access if not explicitly allowed
-	if (PythonCode.Contains(TEXT("open(")) || PythonCode.Contains(TEXT("file(")))
+	FPythonSafetyPolicy Policy = FPythonSafetyPolicy::MakeDefault();
+	Policy.AllowedImports.Append(Settings->AllowedPythonImports);
+
+	TArray<FPythonSafetyViolation> Violations;
+	FUnrealCopilotPythonParser::CheckSafety(Ast, Policy, Violations);
+	if (Violations.Num() > 0)
 	{
-		OutErrorMessage = TEXT("Generated code contains file system access which is not allowed");
+		OutErrorMessage = FString::JoinBy(Violations, TEXT("\n"), [](const FPythonSafetyViolation& Violation) { return Violation.ToString(); });
+		return false;
+	}
+
+	// One pass over the code for configured blocked operations, ignoring comments and string literals
+	const TSharedRef<const FUnrealCopilotPatternScanner> Scanner = FUnrealCopilotSafetyScanners::GetCodeScanner();
+	TArray<FPatternScanHit> Hits;
+	Scanner->Scan(PythonCode, EPatternScanMode::PythonCode, Hits);
+	if (Hits.Num() > 0)
+	{
+		OutErrorMessage = Scanner->DescribeHits(Hits);
 		return false;
 	}
 
@@ -216,6 +236,9 @@ bool UUnrealCopilotLLMManager::ValidateGeneratedCode(const FString& PythonCode,
 
 void UUnrealCopilotLLMManager::CancelGeneration()
 {
+	// Forget the conversation first so the cancelled request's completion is ignored
+	CurrentConversation.Reset();
+
 	if (CurrentRequest.IsValid())
 	{
 		CurrentRequest->CancelRequest();
@@ -251,7 +274,63 @@ void UUnrealCopilotLLMManager::ClearUsageStatistics()
 	UsageTracker = FAPIUsageTracker();
 }
 
-void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& ProcessedPrompt, const FOnCodeGenerationComplete& OnComplete)
+void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& UserPrompt, const FString& ProcessedPrompt, const FPromptContext& Context, const FOnCodeGenerationComplete& OnComplete)
+{
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+
+	TSharedRef<FUnrealCopilotLLMConversation> Conversation = MakeShared<FUnrealCopilotLLMConversation>();
+	Conversation->UserPrompt = UserPrompt;
+	Conversation->OnComplete = OnComplete;
+	Conversation->bResponsesAPI = Settings->OpenAIModel == EOpenAIModel::GPT5;
+	Conversation->bToolsEnabled = Context.bToolCallingEnabled;
+	Conversation->bStreaming = Settings->ShouldStreamResponses() && !Conversation->bResponsesAPI && !Conversation->bToolsEnabled;
+	
+	// Create request payload - different format for GPT-5 (Responses API)
+	if (Conversation->bResponsesAPI)
+	{
+		Conversation->Payload = PromptProcessor->CreateGPT5ResponsesPayload(ProcessedPrompt, Context);
+	}
+	else
+	{
+		FString SystemPrompt = PromptProcessor->BuildSystemPrompt(Context);
+		Conversation->Payload = PromptProcessor->CreateOpenAIRequestPayload(SystemPrompt, ProcessedPrompt);
+	}
+
+	// Stream the answer so the code preview fills in while the model is still writing
+	if (Conversation->bStreaming)
+	{
+		Conversation->Payload->SetBoolField(TEXT("stream"), true);
+
+		TSharedPtr<FJsonObject> StreamOptions = MakeShareable(new FJsonObject);
+		StreamOptions->SetBoolField(TEXT("include_usage"), true);
+		Conversation->Payload->SetObjectField(TEXT("stream_options"), StreamOptions);
+	}
+
+	const FPromptCompressionStats& CompressionStats = PromptProcessor->GetLastCompressionStats();
+	Conversation->PromptTokensBeforeCompression = CompressionStats.OriginalTokens;
+	Conversation->PromptTokens = CompressionStats.CompressedTokens;
+	if (Settings->bEnableAPILogging)
+	{
+		UE_LOG(LogUnrealCopilotLLM, Log, TEXT("Prompt compressed: %d -> %d tokens (%.0f%%) in %.2f ms (%d duplicate, %d code, %d dropped lines, %d path aliases)"),
+			CompressionStats.OriginalTokens, CompressionStats.CompressedTokens,
+			CompressionStats.OriginalTokens > 0 ? 100.0 * CompressionStats.CompressedTokens / CompressionStats.OriginalTokens : 100.0,
+			CompressionStats.ElapsedMilliseconds, CompressionStats.DuplicateLines, CompressionStats.StrippedCodeLines,
+			CompressionStats.DroppedLines, CompressionStats.FactoredPathPrefixes);
+	}
+
+	// Offer the read-only editor tools so the model can pull context on demand
+	if (Conversation->bToolsEnabled)
+	{
+		const FUnrealCopilotEditorTools& EditorTools = FUnrealCopilotEditorTools::Get();
+		Conversation->Payload->SetArrayField(TEXT("tools"), Conversation->bResponsesAPI
+			? EditorTools.CreateResponsesToolsJson()
+			: EditorTools.CreateChatCompletionsToolsJson());
+	}
+
+	SendConversationRequest(Conversation);
+}
+
+void UUnrealCopilotLLMManager::SendConversationRequest(const TSharedRef<FUnrealCopilotLLMConversation>& Conversation)
 {
 	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
 	
@@ -262,7 +341,7 @@ void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& ProcessedPrompt,
 	FString URL;
 	if (Settings->CustomEndpointURL.IsEmpty())
 	{
-		if (Settings->OpenAIModel == EOpenAIModel::GPT5)
+		if (Conversation->bResponsesAPI)
 		{
 			// GPT-5 uses the responses endpoint
 			URL = TEXT("https://api.openai.com/v1/responses");
@@ -285,29 +364,16 @@ void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& ProcessedPrompt,
 	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
 	Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *Settings->GetOpenAIAPIKey()));
 	
-	// Create request payload - different format for GPT-5 (Responses API)
-	TSharedPtr<FJsonObject> PayloadJson;
-	if (Settings->OpenAIModel == EOpenAIModel::GPT5)
-	{
-		PayloadJson = PromptProcessor->CreateGPT5ResponsesPayload(ProcessedPrompt);
-	}
-	else
-	{
-		FPromptContext Context = PromptProcessor->GatherCurrentContext();
-		FString SystemPrompt = PromptProcessor->BuildSystemPrompt(Context);
-		PayloadJson = PromptProcessor->CreateOpenAIRequestPayload(SystemPrompt, ProcessedPrompt);
-	}
-	
 	// Serialize JSON
 	FString PayloadString;
 	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&PayloadString);
-	FJsonSerializer::Serialize(PayloadJson.ToSharedRef(), Writer);
+	FJsonSerializer::Serialize(Conversation->Payload.ToSharedRef(), Writer);
 	
 	Request->SetContentAsString(PayloadString);
 	
 	// Set timeout - use longer timeout for GPT-5 models due to increased processing time
 	float TimeoutSeconds = Settings->RequestTimeoutSeconds;
-	if (Settings->OpenAIModel == EOpenAIModel::GPT5)
+	if (Conversation->bResponsesAPI)
 	{
 		// GPT-5 typically takes longer, use at least 120 seconds or user setting, whichever is higher
 		TimeoutSeconds = FMath::Max(TimeoutSeconds, 120.0f);
@@ -318,12 +384,26 @@ void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& ProcessedPrompt,
 	// Log timeout setting for debugging
 	if (Settings->bEnableAPILogging)
 	{
-		UE_LOG(LogUnrealCopilotLLM, Log, TEXT("Setting HTTP timeout to %.1f seconds for model: %s (endpoint: %s)"), 
-			TimeoutSeconds, *Settings->GetModelNameForAPI(), *URL);
+		UE_LOG(LogUnrealCopilotLLM, Log, TEXT("Setting HTTP timeout to %.1f seconds for model: %s (endpoint: %s, tool round %d)"), 
+			TimeoutSeconds, *Settings->GetModelNameForAPI(), *URL, Conversation->ToolRound);
 	}
 	
 	// Bind response handler
-	Request->OnProcessRequestComplete().BindUObject(this, &UUnrealCopilotLLMManager::OnOpenAIResponse, OnComplete);
+	Request->OnProcessRequestComplete().BindUObject(this, &UUnrealCopilotLLMManager::OnOpenAIResponse, Conversation);
+	if (Conversation->bStreaming)
+	{
+		// The body arrives on the HTTP thread and is only buffered there; progress updates parse it on the game thread
+		Request->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2::CreateLambda(
+			[WeakConversation = TWeakPtr<FUnrealCopilotLLMConversation>(Conversation)](void* Data, int64& Length)
+			{
+				if (TSharedPtr<FUnrealCopilotLLMConversation> StreamConversation = WeakConversation.Pin())
+				{
+					FScopeLock StreamLock(&StreamConversation->StreamCriticalSection);
+					StreamConversation->ReceivedBody.Append(static_cast<const uint8*>(Data), Length);
+				}
+			}));
+		Request->OnRequestProgress64().BindUObject(this, &UUnrealCopilotLLMManager::OnOpenAIStreamProgress, Conversation);
+	}
 	
 	// Update usage tracking
 	UsageTracker.UpdateUsage();
@@ -336,17 +416,19 @@ void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& ProcessedPrompt,
 	
 	// Store request reference and send
 	CurrentRequest = Request;
+	CurrentConversation = Conversation;
 	if (!Request->ProcessRequest())
 	{
 		FCodeGenerationResult ErrorResult;
 		ErrorResult.bSuccess = false;
 		ErrorResult.ErrorMessage = TEXT("Failed to send HTTP request");
 		SetGenerationState(ECodeGenerationState::Error);
-		if (OnComplete.IsBound())
+		if (Conversation->OnComplete.IsBound())
 		{
-			OnComplete.Execute(ErrorResult);
+			Conversation->OnComplete.Execute(ErrorResult);
 		}
 		CurrentRequest.Reset();
+		CurrentConversation.Reset();
 	}
 	else
 	{
@@ -359,12 +441,26 @@ void UUnrealCopilotLLMManager::SendOpenAIRequest(const FString& ProcessedPrompt,
 	}
 }
 
-void UUnrealCopilotLLMManager::OnOpenAIResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FOnCodeGenerationComplete OnComplete)
+void UUnrealCopilotLLMManager::OnOpenAIResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedRef<FUnrealCopilotLLMConversation> Conversation)
 {
+	// Ignore responses for conversations that were cancelled or superseded
+	if (CurrentConversation != Conversation)
+	{
+		return;
+	}
+
 	CurrentRequest.Reset();
+
+	// The rest of the stream is parsed with the response, so no late progress update may touch it meanwhile
+	if (Request.IsValid())
+	{
+		Request->OnRequestProgress64().Unbind();
+	}
 	
 	FCodeGenerationResult Result;
 	Result.GenerationTimeSeconds = FPlatformTime::Seconds() - GenerationStartTime;
+	Result.PromptTokensBeforeCompression = Conversation->PromptTokensBeforeCompression;
+	Result.PromptTokens = Conversation->PromptTokens;
 	
 	// Log response timing for debugging
 	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
@@ -378,94 +474,434 @@ void UUnrealCopilotLLMManager::OnOpenAIResponse(FHttpRequestPtr Request, FHttpRe
 	
 	if (bWasSuccessful && Response.IsValid())
 	{
-		Result.ResponseCode = Response->GetResponseCode();
+		// Decoding, parsing, extraction, and validation run on a worker; only the finished result comes back
+		SetGenerationState(ECodeGenerationState::Validating);
+
+		TWeakObjectPtr<UUnrealCopilotLLMManager> WeakThis(this);
+		UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Response, Conversation, Result]() mutable
+		{
+			UUnrealCopilotLLMManager* Manager = WeakThis.Get();
+			if (!Manager)
+			{
+				return;
+			}
+
+			TSharedPtr<FUnrealCopilotToolRound> ToolRound = Manager->ProcessResponse(Response, Conversation.Get(), Result);
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Conversation, Result = MoveTemp(Result), ToolRound]()
+			{
+				if (UUnrealCopilotLLMManager* GameThreadManager = WeakThis.Get())
+				{
+					GameThreadManager->OnResponseProcessed(Conversation, Result, ToolRound);
+				}
+			});
+		});
+		return;
+	}
+
+	Result.bSuccess = false;
+	
+	// Enhanced timeout error messaging
+	if (!bWasSuccessful && Result.GenerationTimeSeconds >= (Settings->RequestTimeoutSeconds - 1.0f))
+	{
+		// Likely a timeout
+		Result.ErrorMessage = FString::Printf(TEXT("Request timed out after %.1f seconds. GPT-5 requests may take longer - consider increasing the timeout in settings to 180+ seconds."), 
+			Result.GenerationTimeSeconds);
+	}
+	else
+	{
+		Result.ErrorMessage = TEXT("HTTP request failed or network error occurred");
+	}
+	
+	// Additional timeout logging
+	if (Settings->bEnableAPILogging)
+	{
+		UE_LOG(LogUnrealCopilotLLM, Warning, TEXT("Request failed - Time: %.2fs, Configured Timeout: %.1fs, Model: %s"), 
+			Result.GenerationTimeSeconds, 
+			Settings->RequestTimeoutSeconds,
+			*Settings->GetModelNameForAPI());
+	}
+
+	CompleteGeneration(Conversation, Result);
+}
+
+TSharedPtr<FUnrealCopilotToolRound> UUnrealCopilotLLMManager::ProcessResponse(FHttpResponsePtr Response, FUnrealCopilotLLMConversation& Conversation, FCodeGenerationResult& Result)
+{
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+
+	Result.ResponseCode = Response->GetResponseCode();
+	if (Conversation.bStreaming)
+	{
+		// A streamed body is only kept in the conversation's buffer
+		FScopeLock StreamLock(&Conversation.StreamCriticalSection);
+		FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Conversation.ReceivedBody.GetData()), Conversation.ReceivedBody.Num());
+		Result.RawResponse = FString(Converter.Length(), Converter.Get());
+	}
+	else
+	{
 		Result.RawResponse = Response->GetContentAsString();
-		
-		// Log response if enabled
-		if (Settings->bEnableAPILogging)
+	}
+	
+	// Log response if enabled
+	if (Settings->bEnableAPILogging)
+	{
+		LogAPIInteraction(TEXT(""), Result.RawResponse, Response->GetResponseCode() == 200);
+	}
+	
+	if (Response->GetResponseCode() != 200)
+	{
+		Result.bSuccess = false;
+		Result.ErrorMessage = FString::Printf(TEXT("HTTP Error %d: %s"), 
+			Response->GetResponseCode(), *Result.RawResponse);
+		return nullptr;
+	}
+
+	// The model asked for editor context: the tools run on the game thread before the next round
+	if (Conversation.bToolsEnabled)
+	{
+		TSharedPtr<FUnrealCopilotToolRound> ToolRound = MakeShared<FUnrealCopilotToolRound>();
+		if (ParseToolCalls(Result.RawResponse, Conversation.bResponsesAPI, *ToolRound))
 		{
-			LogAPIInteraction(TEXT(""), Result.RawResponse, Response->GetResponseCode() == 200);
+			return ToolRound;
 		}
-		
-		if (Response->GetResponseCode() == 200)
+	}
+
+	// Parse response based on model type and API endpoint
+	if (Conversation.bStreaming)
+	{
+		ParseStreamedResponse(Conversation, Result);
+	}
+	else if (Conversation.bResponsesAPI)
+	{
+		ParseGPT5ResponsesAPI(Result.RawResponse, Result);
+	}
+	else
+	{
+		ParseOpenAIResponse(Result.RawResponse, Result);
+	}
+	Result.TokensUsed += Conversation.TokensUsed;
+	
+	if (Result.bSuccess)
+	{
+		// Validate generated code
+		FString ValidationError;
+		if (!ValidateGeneratedCode(Result.GeneratedCode, ValidationError))
 		{
-			// Parse response based on model type and API endpoint
-			if (Settings->OpenAIModel == EOpenAIModel::GPT5)
-			{
-				ParseGPT5ResponsesAPI(Result.RawResponse, Result);
-			}
-			else
+			Result.bSuccess = false;
+			Result.ErrorMessage = ValidationError;
+		}
+	}
+
+	return nullptr;
+}
+
+void UUnrealCopilotLLMManager::OnResponseProcessed(const TSharedRef<FUnrealCopilotLLMConversation>& Conversation, const FCodeGenerationResult& Result, TSharedPtr<FUnrealCopilotToolRound> ToolRound)
+{
+	// Cancelled while the response was being processed
+	if (CurrentConversation != Conversation)
+	{
+		return;
+	}
+
+	if (ToolRound.IsValid())
+	{
+		SetGenerationState(ECodeGenerationState::Processing);
+		ContinueWithToolCalls(*ToolRound, Conversation);
+		return;
+	}
+
+	CompleteGeneration(Conversation, Result);
+}
+
+void UUnrealCopilotLLMManager::CompleteGeneration(const TSharedRef<FUnrealCopilotLLMConversation>& Conversation, const FCodeGenerationResult& Result)
+{
+	CurrentConversation.Reset();
+	SetGenerationState(Result.bSuccess ? ECodeGenerationState::Completed : ECodeGenerationState::Error);
+
+	// Keep the prompt searchable alongside the scripts it produced
+	if (!Conversation->UserPrompt.IsEmpty())
+	{
+		UUnrealCopilotExecutionManager::GetInstance()->AddPromptToHistory(Conversation->UserPrompt, Result.bSuccess,
+			Result.bSuccess ? Result.GeneratedCode : Result.ErrorMessage);
+	}
+	
+	// Execute completion delegate
+	if (Conversation->OnComplete.IsBound())
+	{
+		Conversation->OnComplete.Execute(Result);
+	}
+	
+	// Execute multicast delegates
+	OnCodeGenerationComplete.Broadcast(Result);
+	
+	// Clear active delegates
+	ActiveDelegates.Empty();
+}
+
+void UUnrealCopilotLLMManager::OnOpenAIStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived, TSharedRef<FUnrealCopilotLLMConversation> Conversation)
+{
+	if (CurrentConversation != Conversation || !Request.IsValid())
+	{
+		return;
+	}
+
+	FHttpResponsePtr Response = Request->GetResponse();
+	if (!Response.IsValid() || Response->GetResponseCode() != 200)
+	{
+		return;
+	}
+
+	// Only the bytes received since the last progress update are parsed
+	if (ConsumeStreamedResponse(*Conversation, false) && Conversation->StreamExtractor.HasBlocks())
+	{
+		UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+		OnCodePreviewUpdated.Broadcast(Conversation->StreamExtractor.GetPreviewCode(Settings->CodeBlockSelection));
+	}
+}
+
+bool UUnrealCopilotLLMManager::ConsumeStreamedResponse(FUnrealCopilotLLMConversation& Conversation, bool bFinal)
+{
+	// Copy out what arrived after the last complete line, so the HTTP thread is only held up for the copy
+	TArray<uint8> Content;
+	{
+		FScopeLock StreamLock(&Conversation.StreamCriticalSection);
+		Content.Append(Conversation.ReceivedBody.GetData() + Conversation.StreamedBytes, Conversation.ReceivedBody.Num() - Conversation.StreamedBytes);
+	}
+
+	bool bTextAdded = false;
+
+	auto ConsumeLine = [&Content, &Conversation, &bTextAdded](int32 Start, int32 End)
+	{
+		// Newlines never occur inside multi-byte UTF-8 sequences, so each line converts on its own
+		FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Content.GetData() + Start), End - Start);
+		FString Line(Converter.Length(), Converter.Get());
+		Line.TrimEndInline();
+		if (!Line.StartsWith(TEXT("data:")))
+		{
+			return;
+		}
+
+		const FString Data = Line.Mid(5).TrimStart();
+		Conversation.bReceivedStreamEvent = true;
+		if (Data == TEXT("[DONE]"))
+		{
+			return;
+		}
+
+		TSharedPtr<FJsonObject> EventObject;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Data);
+		if (!FJsonSerializer::Deserialize(Reader, EventObject) || !EventObject.IsValid())
+		{
+			return;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* ChoicesArray;
+		if (EventObject->TryGetArrayField(TEXT("choices"), ChoicesArray) && ChoicesArray->Num() > 0)
+		{
+			const TSharedPtr<FJsonObject>* Delta;
+			FString DeltaText;
+			TSharedPtr<FJsonObject> FirstChoice = (*ChoicesArray)[0]->AsObject();
+			if (FirstChoice.IsValid() && FirstChoice->TryGetObjectField(TEXT("delta"), Delta) &&
+				(*Delta)->TryGetStringField(TEXT("content"), DeltaText) && !DeltaText.IsEmpty())
 			{
-				ParseOpenAIResponse(Result.RawResponse, Result);
+				Conversation.StreamedText += DeltaText;
+				Conversation.StreamExtractor.AppendText(DeltaText);
+				bTextAdded = true;
 			}
-			
-			if (Result.bSuccess)
+		}
+
+		// The last event carries usage when stream_options.include_usage is set
+		const TSharedPtr<FJsonObject>* UsageObject;
+		if (EventObject->TryGetObjectField(TEXT("usage"), UsageObject))
+		{
+			Conversation.TokensUsed += (*UsageObject)->GetIntegerField(TEXT("total_tokens"));
+		}
+	};
+
+	int32 LineStart = 0;
+	for (int32 Index = LineStart; Index < Content.Num(); ++Index)
+	{
+		if (Content[Index] == '\n')
+		{
+			ConsumeLine(LineStart, Index);
+			LineStart = Index + 1;
+		}
+	}
+
+	if (bFinal && LineStart < Content.Num())
+	{
+		ConsumeLine(LineStart, Content.Num());
+		LineStart = Content.Num();
+	}
+
+	Conversation.StreamedBytes += LineStart;
+	return bTextAdded;
+}
+
+void UUnrealCopilotLLMManager::ParseStreamedResponse(FUnrealCopilotLLMConversation& Conversation, FCodeGenerationResult& OutResult)
+{
+	ConsumeStreamedResponse(Conversation, true);
+
+	// Endpoints that ignore the stream flag answer with a regular completion
+	if (!Conversation.bReceivedStreamEvent)
+	{
+		ParseOpenAIResponse(OutResult.RawResponse, OutResult);
+		return;
+	}
+
+	Conversation.StreamExtractor.Finish();
+	if (Conversation.StreamExtractor.HasBlocks())
+	{
+		UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+		OutResult.GeneratedCode = Conversation.StreamExtractor.GetCode(Settings->CodeBlockSelection);
+		if (OutResult.GeneratedCode.IsEmpty())
+		{
+			OutResult.GeneratedCode = Conversation.StreamExtractor.GetBlocks()[0].Code.TrimStartAndEnd();
+		}
+	}
+	else
+	{
+		OutResult.GeneratedCode = Conversation.StreamedText.TrimStartAndEnd();
+	}
+
+	OutResult.bSuccess = !OutResult.GeneratedCode.IsEmpty();
+	if (!OutResult.bSuccess)
+	{
+		OutResult.ErrorMessage = TEXT("No Python code found in LLM response");
+	}
+}
+
+bool UUnrealCopilotLLMManager::ParseToolCalls(const FString& ResponseJSON, bool bResponsesAPI, FUnrealCopilotToolRound& OutToolRound)
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseJSON);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		return false;
+	}
+
+	TArray<FUnrealCopilotToolCall>& ToolCalls = OutToolRound.Calls;
+
+	if (bResponsesAPI)
+	{
+		// Responses API: function_call items in the output array; echo every output item (including reasoning) back as input
+		const TArray<TSharedPtr<FJsonValue>>* OutputArray;
+		if (JsonObject->TryGetArrayField(TEXT("output"), OutputArray))
+		{
+			for (const TSharedPtr<FJsonValue>& OutputValue : *OutputArray)
 			{
-				// Validate generated code
-				FString ValidationError;
-				if (ValidateGeneratedCode(Result.GeneratedCode, ValidationError))
+				TSharedPtr<FJsonObject> OutputItem = OutputValue->AsObject();
+				if (OutputItem.IsValid() && OutputItem->GetStringField(TEXT("type")) == TEXT("function_call"))
 				{
-					SetGenerationState(ECodeGenerationState::Completed);
-				}
-				else
-				{
-					Result.bSuccess = false;
-					Result.ErrorMessage = ValidationError;
-					SetGenerationState(ECodeGenerationState::Error);
+					FUnrealCopilotToolCall& Call = ToolCalls.AddDefaulted_GetRef();
+					Call.CallId = OutputItem->GetStringField(TEXT("call_id"));
+					Call.Name = OutputItem->GetStringField(TEXT("name"));
+					Call.Arguments = OutputItem->GetStringField(TEXT("arguments"));
 				}
 			}
-			else
+
+			if (ToolCalls.Num() > 0)
 			{
-				SetGenerationState(ECodeGenerationState::Error);
+				OutToolRound.EchoItems.Append(*OutputArray);
 			}
 		}
-		else
+	}
+	else
+	{
+		// Chat Completions: tool_calls on the assistant message, which must precede the tool messages
+		const TArray<TSharedPtr<FJsonValue>>* ChoicesArray;
+		if (JsonObject->TryGetArrayField(TEXT("choices"), ChoicesArray) && ChoicesArray->Num() > 0)
 		{
-			Result.bSuccess = false;
-			Result.ErrorMessage = FString::Printf(TEXT("HTTP Error %d: %s"), 
-				Response->GetResponseCode(), *Response->GetContentAsString());
-			SetGenerationState(ECodeGenerationState::Error);
+			TSharedPtr<FJsonObject> FirstChoice = (*ChoicesArray)[0]->AsObject();
+			const TSharedPtr<FJsonObject>* Message;
+			const TArray<TSharedPtr<FJsonValue>>* ToolCallsArray;
+			if (FirstChoice.IsValid() && FirstChoice->TryGetObjectField(TEXT("message"), Message) &&
+				(*Message)->TryGetArrayField(TEXT("tool_calls"), ToolCallsArray) && ToolCallsArray->Num() > 0)
+			{
+				for (const TSharedPtr<FJsonValue>& ToolCallValue : *ToolCallsArray)
+				{
+					TSharedPtr<FJsonObject> ToolCallObj = ToolCallValue->AsObject();
+					const TSharedPtr<FJsonObject>* Function;
+					if (ToolCallObj.IsValid() && ToolCallObj->TryGetObjectField(TEXT("function"), Function))
+					{
+						FUnrealCopilotToolCall& Call = ToolCalls.AddDefaulted_GetRef();
+						Call.CallId = ToolCallObj->GetStringField(TEXT("id"));
+						Call.Name = (*Function)->GetStringField(TEXT("name"));
+						Call.Arguments = (*Function)->GetStringField(TEXT("arguments"));
+					}
+				}
+
+				OutToolRound.EchoItems.Add(MakeShareable(new FJsonValueObject(*Message)));
+			}
 		}
 	}
-	else
+
+	if (ToolCalls.Num() == 0)
 	{
-		Result.bSuccess = false;
-		
-		// Enhanced timeout error messaging
-		if (!bWasSuccessful && Result.GenerationTimeSeconds >= (Settings->RequestTimeoutSeconds - 1.0f))
+		return false;
+	}
+
+	const TSharedPtr<FJsonObject>* UsageObject;
+	if (JsonObject->TryGetObjectField(TEXT("usage"), UsageObject))
+	{
+		(*UsageObject)->TryGetNumberField(TEXT("total_tokens"), OutToolRound.TokensUsed);
+	}
+
+	return true;
+}
+
+void UUnrealCopilotLLMManager::ContinueWithToolCalls(const FUnrealCopilotToolRound& ToolRound, const TSharedRef<FUnrealCopilotLLMConversation>& Conversation)
+{
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+	const TArray<FUnrealCopilotToolCall>& ToolCalls = ToolRound.Calls;
+	const double ToolStartTime = FPlatformTime::Seconds();
+
+	const TCHAR* ConversationField = Conversation->bResponsesAPI ? TEXT("input") : TEXT("messages");
+	TArray<TSharedPtr<FJsonValue>> ConversationItems = Conversation->Payload->GetArrayField(ConversationField);
+	ConversationItems.Append(ToolRound.EchoItems);
+
+	// Calls from one turn run together; thread-safe tools run in parallel
+	TArray<FUnrealCopilotToolResult> ToolResults = FUnrealCopilotEditorTools::Get().ExecuteToolCalls(ToolCalls);
+
+	if (Settings->bEnableAPILogging)
+	{
+		for (const FUnrealCopilotToolCall& Call : ToolCalls)
 		{
-			// Likely a timeout
-			Result.ErrorMessage = FString::Printf(TEXT("Request timed out after %.1f seconds. GPT-5 requests may take longer - consider increasing the timeout in settings to 180+ seconds."), 
-				Result.GenerationTimeSeconds);
+			UE_LOG(LogUnrealCopilotLLM, Log, TEXT("Tool call %s(%s)"), *Call.Name, *Call.Arguments);
 		}
-		else
+		UE_LOG(LogUnrealCopilotLLM, Log, TEXT("Ran %d tool calls in %.2f ms (round %d)"),
+			ToolCalls.Num(), (FPlatformTime::Seconds() - ToolStartTime) * 1000.0, Conversation->ToolRound + 1);
+	}
+
+	for (const FUnrealCopilotToolResult& ToolResult : ToolResults)
+	{
+		TSharedPtr<FJsonObject> ResultObj = MakeShareable(new FJsonObject);
+		if (Conversation->bResponsesAPI)
 		{
-			Result.ErrorMessage = TEXT("HTTP request failed or network error occurred");
+			ResultObj->SetStringField(TEXT("type"), TEXT("function_call_output"));
+			ResultObj->SetStringField(TEXT("call_id"), ToolResult.CallId);
+			ResultObj->SetStringField(TEXT("output"), ToolResult.Output);
 		}
-		
-		SetGenerationState(ECodeGenerationState::Error);
-		
-		// Additional timeout logging
-		if (Settings->bEnableAPILogging)
+		else
 		{
-			UE_LOG(LogUnrealCopilotLLM, Warning, TEXT("Request failed - Time: %.2fs, Configured Timeout: %.1fs, Model: %s"), 
-				Result.GenerationTimeSeconds, 
-				Settings->RequestTimeoutSeconds,
-				*Settings->GetModelNameForAPI());
+			ResultObj->SetStringField(TEXT("role"), TEXT("tool"));
+			ResultObj->SetStringField(TEXT("tool_call_id"), ToolResult.CallId);
+			ResultObj->SetStringField(TEXT("content"), ToolResult.Output);
 		}
+		ConversationItems.Add(MakeShareable(new FJsonValueObject(ResultObj)));
 	}
-	
-	// Execute completion delegate
-	if (OnComplete.IsBound())
+
+	Conversation->Payload->SetArrayField(ConversationField, ConversationItems);
+	++Conversation->ToolRound;
+	Conversation->TokensUsed += ToolRound.TokensUsed;
+
+	// Out of rounds: the model has to answer with what it has
+	if (Conversation->ToolRound >= Settings->MaxToolRounds)
 	{
-		OnComplete.Execute(Result);
+		Conversation->Payload->SetStringField(TEXT("tool_choice"), TEXT("none"));
 	}
-	
-	// Execute multicast delegates
-	OnCodeGenerationComplete.Broadcast(Result);
-	
-	// Clear active delegates
-	ActiveDelegates.Empty();
+
+	SendConversationRequest(Conversation);
 }
 
 void UUnrealCopilotLLMManager::ParseOpenAIResponse(const FString& ResponseJSON, FCodeGenerationResult& OutResult)
@@ -494,10 +930,20 @@ void UUnrealCopilotLLMManager::ParseOpenAIResponse(const FString& ResponseJSON,
 				TSharedPtr<FJsonObject> Message = FirstChoice->GetObjectField(TEXT("message"));
 				if (Message.IsValid())
 				{
-					FString Content = Message->GetStringField(TEXT("content"));
+					// Structured output reports refusals in their own field instead of the content
+					FString Refusal;
+					if (Message->TryGetStringField(TEXT("refusal"), Refusal) && !Refusal.IsEmpty())
+					{
+						OutResult.bSuccess = false;
+						OutResult.ErrorMessage = FString::Printf(TEXT("Request refused by model: %s"), *Refusal);
+						return;
+					}
+
+					FString Content;
+					Message->TryGetStringField(TEXT("content"), Content);
 					
 					// Extract Python code from the response
-					OutResult.GeneratedCode = PromptProcessor->ExtractPythonCode(Content);
+					ExtractCodeFromContent(Content, OutResult);
 					OutResult.bSuccess = !OutResult.GeneratedCode.IsEmpty();
 					
 					if (!OutResult.bSuccess)
@@ -537,13 +983,54 @@ void UUnrealCopilotLLMManager::ParseGPT5ResponsesAPI(const FString& ResponseJSON
 			return;
 		}
 
+		// The Responses API returns an "output" array of items; text lives in message items as output_text parts
+		bool bFoundOutput = false;
+		FString GeneratedText;
+		const TArray<TSharedPtr<FJsonValue>>* OutputArray;
+		if (JsonObject->TryGetArrayField(TEXT("output"), OutputArray))
+		{
+			for (const TSharedPtr<FJsonValue>& OutputValue : *OutputArray)
+			{
+				TSharedPtr<FJsonObject> OutputItem = OutputValue->AsObject();
+				const TArray<TSharedPtr<FJsonValue>>* ContentArray;
+				if (!OutputItem.IsValid() || OutputItem->GetStringField(TEXT("type")) != TEXT("message") ||
+					!OutputItem->TryGetArrayField(TEXT("content"), ContentArray))
+				{
+					continue;
+				}
+
+				bFoundOutput = true;
+				for (const TSharedPtr<FJsonValue>& ContentValue : *ContentArray)
+				{
+					TSharedPtr<FJsonObject> ContentPart = ContentValue->AsObject();
+					if (!ContentPart.IsValid())
+					{
+						continue;
+					}
+
+					const FString PartType = ContentPart->GetStringField(TEXT("type"));
+					if (PartType == TEXT("output_text"))
+					{
+						GeneratedText += ContentPart->GetStringField(TEXT("text"));
+					}
+					else if (PartType == TEXT("refusal"))
+					{
+						OutResult.bSuccess = false;
+						OutResult.ErrorMessage = FString::Printf(TEXT("Request refused by model: %s"), *ContentPart->GetStringField(TEXT("refusal")));
+						return;
+					}
+				}
+			}
+		}
+
+		// Fall back to the older choices-style layout some compatible endpoints still return
 		const TArray<TSharedPtr<FJsonValue>>* ChoicesArray;
-		if (JsonObject->TryGetArrayField(TEXT("choices"), ChoicesArray) && ChoicesArray->Num() > 0)
+		if (!bFoundOutput && JsonObject->TryGetArrayField(TEXT("choices"), ChoicesArray) && ChoicesArray->Num() > 0)
 		{
 			TSharedPtr<FJsonObject> FirstChoice = (*ChoicesArray)[0]->AsObject();
 			if (FirstChoice.IsValid())
 			{
-				FString GeneratedText;
+				bFoundOutput = true;
 				if (FirstChoice->HasField(TEXT("text")))
 				{
 					GeneratedText = FirstChoice->GetStringField(TEXT("text"));
@@ -557,28 +1044,31 @@ void UUnrealCopilotLLMManager::ParseGPT5ResponsesAPI(const FString& ResponseJSON
 						GeneratedText = MessageObj->GetStringField(TEXT("content"));
 					}
 				}
+			}
+		}
 
-				OutResult.GeneratedCode = PromptProcessor->ExtractPythonCode(GeneratedText);
-				if (OutResult.GeneratedCode.IsEmpty() && !GeneratedText.IsEmpty())
+		if (bFoundOutput)
+		{
+			ExtractCodeFromContent(GeneratedText, OutResult);
+			if (OutResult.GeneratedCode.IsEmpty() && !GeneratedText.IsEmpty())
+			{
+				FString Trimmed = GeneratedText.TrimStartAndEnd();
+				if (Trimmed.Contains(TEXT("unreal.")) || Trimmed.Contains(TEXT("import ")) || Trimmed.Contains(TEXT("def ")))
 				{
-					FString Trimmed = GeneratedText.TrimStartAndEnd();
-					if (Trimmed.Contains(TEXT("unreal.")) || Trimmed.Contains(TEXT("import ")) || Trimmed.Contains(TEXT("def ")))
-					{
-						OutResult.GeneratedCode = Trimmed;
-					}
+					OutResult.GeneratedCode = Trimmed;
 				}
+			}
 
-				OutResult.bSuccess = !OutResult.GeneratedCode.IsEmpty();
-				if (!OutResult.bSuccess)
-				{
-					OutResult.ErrorMessage = TEXT("No Python code found in GPT-5 Responses API response");
-				}
+			OutResult.bSuccess = !OutResult.GeneratedCode.IsEmpty();
+			if (!OutResult.bSuccess)
+			{
+				OutResult.ErrorMessage = TEXT("No Python code found in GPT-5 Responses API response");
 			}
 		}
 		else
 		{
 			OutResult.bSuccess = false;
-			OutResult.ErrorMessage = TEXT("No choices found in GPT-5 Responses API response");
+			OutResult.ErrorMessage = TEXT("No output found in GPT-5 Responses API response");
 		}
 
 		if (JsonObject->HasField(TEXT("usage")))
@@ -605,6 +1095,25 @@ void UUnrealCopilotLLMManager::ParseGPT5ResponsesAPI(const FString& ResponseJSON
 	}
 }
 
+void UUnrealCopilotLLMManager::ExtractCodeFromContent(const FString& Content, FCodeGenerationResult& OutResult)
+{
+	if (PromptProcessor->GetStructuredOutputFormat() != EStructuredOutputFormat::None)
+	{
+		FUnrealCopilotCodeResponse CodeResponse;
+		if (PromptProcessor->ParseStructuredCodeResponse(Content, CodeResponse))
+		{
+			OutResult.GeneratedCode = MoveTemp(CodeResponse.Code);
+			OutResult.Explanation = MoveTemp(CodeResponse.Explanation);
+			OutResult.TouchedAssets = MoveTemp(CodeResponse.TouchedAssets);
+			return;
+		}
+
+		UE_LOG(LogUnrealCopilotLLM, Warning, TEXT("Structured response could not be parsed, falling back to code block extraction"));
+	}
+
+	OutResult.GeneratedCode = PromptProcessor->ExtractPythonCode(Content);
+}
+
 FString UUnrealCopilotLLMManager::BuildSystemPrompt() const
 {
 	if (PromptProcessor)
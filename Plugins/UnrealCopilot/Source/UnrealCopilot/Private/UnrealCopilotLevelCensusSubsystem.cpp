@@ -0,0 +1,698 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotLevelCensusSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/Actor.h"
+#include "WorldPartition/DataLayer/DataLayerInstance.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeLock.h"
+#include "ConvexVolume.h"
+#include "SceneManagement.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#include "LevelEditorViewport.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogUnrealCopilotLevelCensus, Log, All);
+
+namespace UnrealCopilotLevelCensus
+{
+	/** Maximum number of entries listed per group in the summary */
+	static constexpr int32 MaxSummaryGroups = 10;
+
+	/** Maximum number of subfolders listed under each top-level folder */
+	static constexpr int32 MaxSummarySubfolders = 4;
+
+	static FString FormatVector(const FVector& Vector)
+	{
+		return FString::Printf(TEXT("(%.0f, %.0f, %.0f)"), Vector.X, Vector.Y, Vector.Z);
+	}
+
+	static void IncrementCount(TMap<FName, int32>& Counts, FName Key)
+	{
+		++Counts.FindOrAdd(Key);
+	}
+
+	static void DecrementCount(TMap<FName, int32>& Counts, FName Key)
+	{
+		if (int32* Count = Counts.Find(Key))
+		{
+			if (--(*Count) <= 0)
+			{
+				Counts.Remove(Key);
+			}
+		}
+	}
+
+	/** Sort count entries by descending count, then name, so the summary is stable */
+	static TArray<TPair<FString, int32>> SortCounts(const TMap<FName, int32>& Counts)
+	{
+		TArray<TPair<FString, int32>> Sorted;
+		Sorted.Reserve(Counts.Num());
+		for (const TPair<FName, int32>& Pair : Counts)
+		{
+			Sorted.Emplace(Pair.Key.IsNone() ? FString(TEXT("(none)")) : Pair.Key.ToString(), Pair.Value);
+		}
+		Sorted.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B)
+		{
+			return A.Value != B.Value ? A.Value > B.Value : A.Key < B.Key;
+		});
+		return Sorted;
+	}
+
+	/** Format the largest groups as "Key xCount" entries */
+	static FString FormatTopGroups(const TArray<TPair<FString, int32>>& Sorted, int32 MaxGroups)
+	{
+		FString Result;
+		int32 Remaining = 0;
+		for (int32 Index = 0; Index < Sorted.Num(); ++Index)
+		{
+			if (Index < MaxGroups)
+			{
+				Result += Index > 0 ? TEXT(", ") : TEXT("");
+				Result += FString::Printf(TEXT("%s x%d"), *Sorted[Index].Key, Sorted[Index].Value);
+			}
+			else
+			{
+				Remaining += Sorted[Index].Value;
+			}
+		}
+		if (Remaining > 0)
+		{
+			Result += FString::Printf(TEXT(", %d more in %d other groups"), Remaining, Sorted.Num() - MaxGroups);
+		}
+		return Result;
+	}
+
+	/** Format the folder hierarchy as top-level folders with totals and their largest subfolders */
+	static FString FormatFolderHierarchy(const TMap<FName, int32>& FolderCounts)
+	{
+		// Roll leaf counts up into each top-level folder and its direct children
+		TMap<FName, int32> TopLevelTotals;
+		TMap<FName, TMap<FName, int32>> SubfolderTotals;
+		for (const TPair<FName, int32>& Pair : FolderCounts)
+		{
+			if (Pair.Key.IsNone())
+			{
+				continue;
+			}
+
+			TArray<FString> Parts;
+			Pair.Key.ToString().ParseIntoArray(Parts, TEXT("/"));
+			if (Parts.Num() == 0)
+			{
+				continue;
+			}
+
+			const FName TopLevel(*Parts[0]);
+			TopLevelTotals.FindOrAdd(TopLevel) += Pair.Value;
+			if (Parts.Num() > 1)
+			{
+				SubfolderTotals.FindOrAdd(TopLevel).FindOrAdd(FName(*Parts[1])) += Pair.Value;
+			}
+		}
+
+		const TArray<TPair<FString, int32>> SortedTopLevel = SortCounts(TopLevelTotals);
+		FString Result;
+		int32 Remaining = 0;
+		for (int32 Index = 0; Index < SortedTopLevel.Num(); ++Index)
+		{
+			if (Index >= MaxSummaryGroups)
+			{
+				Remaining += SortedTopLevel[Index].Value;
+				continue;
+			}
+
+			Result += FString::Printf(TEXT("\n- %s x%d"), *SortedTopLevel[Index].Key, SortedTopLevel[Index].Value);
+			if (const TMap<FName, int32>* Subfolders = SubfolderTotals.Find(FName(*SortedTopLevel[Index].Key)))
+			{
+				Result += FString::Printf(TEXT(" (%s)"), *FormatTopGroups(SortCounts(*Subfolders), MaxSummarySubfolders));
+			}
+		}
+		if (Remaining > 0)
+		{
+			Result += FString::Printf(TEXT("\n- %d more in %d other folders"), Remaining, SortedTopLevel.Num() - MaxSummaryGroups);
+		}
+		return Result;
+	}
+
+#if WITH_EDITOR
+	/** Get the active perspective level viewport, falling back to the first one available */
+	static FLevelEditorViewportClient* GetLevelViewportClient()
+	{
+		if (GCurrentLevelEditingViewportClient && GCurrentLevelEditingViewportClient->IsPerspective())
+		{
+			return GCurrentLevelEditingViewportClient;
+		}
+
+		if (GEditor)
+		{
+			for (FLevelEditorViewportClient* ViewportClient : GEditor->GetLevelViewportClients())
+			{
+				if (ViewportClient && ViewportClient->IsPerspective())
+				{
+					return ViewportClient;
+				}
+			}
+		}
+
+		return GCurrentLevelEditingViewportClient;
+	}
+
+	/** Build the view frustum of a perspective viewport, without a far plane */
+	static bool GetViewportFrustum(const FLevelEditorViewportClient& ViewportClient, FConvexVolume& OutFrustum)
+	{
+		if (!ViewportClient.IsPerspective() || !ViewportClient.Viewport)
+		{
+			return false;
+		}
+
+		const FIntPoint ViewportSize = ViewportClient.Viewport->GetSizeXY();
+		if (ViewportSize.X <= 0 || ViewportSize.Y <= 0)
+		{
+			return false;
+		}
+
+		// Same conventions the renderer uses: world to view, then swap axes so the camera looks down +Z
+		const FMatrix ViewMatrix = FTranslationMatrix(-ViewportClient.GetViewLocation())
+			* FInverseRotationMatrix(ViewportClient.GetViewRotation())
+			* FMatrix(FPlane(0, 0, 1, 0), FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 0, 1));
+		const float HalfFOVRadians = FMath::DegreesToRadians(ViewportClient.ViewFOV) * 0.5f;
+		const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(HalfFOVRadians, ViewportSize.X, ViewportSize.Y, GNearClippingPlane);
+
+		GetViewFrustumBounds(OutFrustum, ViewMatrix * ProjectionMatrix, /*bUseNearPlane*/ false);
+		return true;
+	}
+#endif
+}
+
+void UUnrealCopilotLevelCensusSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+#if WITH_EDITOR
+	if (GEngine)
+	{
+		ActorAddedHandle = GEngine->OnLevelActorAdded().AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnActorAdded);
+		ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnActorDeleted);
+		ActorMovedHandle = GEngine->OnActorMoved().AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnActorMoved);
+		ActorFolderChangedHandle = GEngine->OnLevelActorFolderChanged().AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnActorFolderChanged);
+	}
+
+	MapChangeHandle = FEditorDelegates::MapChange.AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnMapChange);
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UUnrealCopilotLevelCensusSubsystem::OnLevelRemovedFromWorld);
+#endif
+}
+
+void UUnrealCopilotLevelCensusSubsystem::Deinitialize()
+{
+#if WITH_EDITOR
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().Remove(ActorAddedHandle);
+		GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+		GEngine->OnActorMoved().Remove(ActorMovedHandle);
+		GEngine->OnLevelActorFolderChanged().Remove(ActorFolderChangedHandle);
+	}
+
+	FEditorDelegates::MapChange.Remove(MapChangeHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+#endif
+
+	{
+		FScopeLock Lock(&CensusCriticalSection);
+		Records.Empty();
+		ClassCounts.Empty();
+		FolderCounts.Empty();
+		LevelCounts.Empty();
+		DataLayerCounts.Empty();
+		SpatialIndex.Reset();
+		bCensusBuilt = false;
+	}
+
+	Super::Deinitialize();
+}
+
+UUnrealCopilotLevelCensusSubsystem* UUnrealCopilotLevelCensusSubsystem::Get()
+{
+#if WITH_EDITOR
+	return GEditor ? GEditor->GetEditorSubsystem<UUnrealCopilotLevelCensusSubsystem>() : nullptr;
+#else
+	return nullptr;
+#endif
+}
+
+FString UUnrealCopilotLevelCensusSubsystem::GetLevelSummary()
+{
+	EnsureCensusBuilt();
+
+	FScopeLock Lock(&CensusCriticalSection);
+	if (bSummaryDirty)
+	{
+		RebuildSummary();
+	}
+	return CachedSummary;
+}
+
+int32 UUnrealCopilotLevelCensusSubsystem::GetTotalActorCount() const
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	return Records.Num();
+}
+
+TMap<FName, int32> UUnrealCopilotLevelCensusSubsystem::GetClassCounts() const
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	return ClassCounts;
+}
+
+void UUnrealCopilotLevelCensusSubsystem::FindNearestActors(const FVector& Origin, int32 MaxResults, double MaxDistance, TArray<FSpatialIndexHit>& OutHits)
+{
+	EnsureCensusBuilt();
+
+	FScopeLock Lock(&CensusCriticalSection);
+	SpatialIndex.FindNearest(Origin, MaxResults, MaxDistance, OutHits);
+}
+
+TArray<AActor*> UUnrealCopilotLevelCensusSubsystem::GetActorsNearViewport(int32 MaxResults, float MaxDistance, bool bInViewFrustumOnly)
+{
+	TArray<AActor*> Actors;
+
+	FVector CameraLocation;
+	TArray<FSpatialIndexHit> Hits;
+	if (FindActorsNearViewport(MaxResults, MaxDistance, bInViewFrustumOnly, CameraLocation, Hits))
+	{
+		for (const FSpatialIndexHit& Hit : Hits)
+		{
+			if (AActor* Actor = Cast<AActor>(Hit.Key.ResolveObjectPtr()))
+			{
+				Actors.Add(Actor);
+			}
+		}
+	}
+
+	return Actors;
+}
+
+FString UUnrealCopilotLevelCensusSubsystem::GetNearbyActorsSummary(int32 MaxResults, float MaxDistance, bool bInViewFrustumOnly)
+{
+	FVector CameraLocation;
+	TArray<FSpatialIndexHit> Hits;
+	if (!FindActorsNearViewport(MaxResults, MaxDistance, bInViewFrustumOnly, CameraLocation, Hits))
+	{
+		return FString();
+	}
+
+	FString Summary = FString::Printf(TEXT("\nCamera Location: %s"), *UnrealCopilotLevelCensus::FormatVector(CameraLocation));
+	if (Hits.Num() == 0)
+	{
+		Summary += bInViewFrustumOnly ? TEXT("\nNo actors in view.") : TEXT("\nNo actors nearby.");
+		return Summary;
+	}
+
+	for (const FSpatialIndexHit& Hit : Hits)
+	{
+		const AActor* Actor = Cast<AActor>(Hit.Key.ResolveObjectPtr());
+		if (!Actor)
+		{
+			continue;
+		}
+
+#if WITH_EDITOR
+		const FString ActorName = Actor->GetActorLabel();
+#else
+		const FString ActorName = Actor->GetName();
+#endif
+		Summary += FString::Printf(TEXT("\n- %s (%s) at %s, %.0f m"),
+			*ActorName,
+			*Actor->GetClass()->GetName(),
+			*UnrealCopilotLevelCensus::FormatVector(Actor->GetActorLocation()),
+			FMath::Sqrt(Hit.DistanceSquared) / 100.0);
+	}
+
+	return Summary;
+}
+
+void UUnrealCopilotLevelCensusSubsystem::RebuildCensus()
+{
+	check(IsInGameThread());
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FScopeLock Lock(&CensusCriticalSection);
+	Records.Empty();
+	ClassCounts.Empty();
+	FolderCounts.Empty();
+	LevelCounts.Empty();
+	DataLayerCounts.Empty();
+	SpatialIndex.Reset();
+	LevelBounds = FBox(ForceInit);
+	bBoundsDirty = false;
+	bSummaryDirty = true;
+
+#if WITH_EDITOR
+	UWorld* EditorWorld = GEditor ? GEditor->GetEditorWorldContext().World() : nullptr;
+	if (EditorWorld)
+	{
+		for (ULevel* Level : EditorWorld->GetLevels())
+		{
+			if (!Level)
+			{
+				continue;
+			}
+
+			for (AActor* Actor : Level->Actors)
+			{
+				if (ShouldTrackActor(Actor))
+				{
+					AddOrUpdateActor(Actor);
+				}
+			}
+		}
+	}
+#endif
+
+	bCensusBuilt = true;
+
+	UE_LOG(LogUnrealCopilotLevelCensus, Log, TEXT("Level census built: %d actors in %.2f ms"),
+		Records.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnActorAdded(AActor* Actor)
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	if (bCensusBuilt && ShouldTrackActor(Actor))
+	{
+		AddOrUpdateActor(Actor);
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnActorDeleted(AActor* Actor)
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	if (bCensusBuilt && Actor)
+	{
+		RemoveActor(Actor);
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnActorMoved(AActor* Actor)
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	if (bCensusBuilt && Records.Contains(FObjectKey(Actor)))
+	{
+		AddOrUpdateActor(Actor);
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnActorFolderChanged(const AActor* Actor, FName OldPath)
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	if (bCensusBuilt && Records.Contains(FObjectKey(Actor)))
+	{
+		AddOrUpdateActor(Actor);
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnMapChange(uint32 MapChangeFlags)
+{
+	// Defer the scan until the summary is next requested, so loading a map pays nothing extra
+	FScopeLock Lock(&CensusCriticalSection);
+	bCensusBuilt = false;
+	bSummaryDirty = true;
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	if (!bCensusBuilt || !Level)
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (ShouldTrackActor(Actor))
+		{
+			AddOrUpdateActor(Actor);
+		}
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	FScopeLock Lock(&CensusCriticalSection);
+	if (!bCensusBuilt)
+	{
+		return;
+	}
+
+	// A null level means every level was removed from the world
+	if (!Level)
+	{
+		bCensusBuilt = false;
+		bSummaryDirty = true;
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (Actor)
+		{
+			RemoveActor(Actor);
+		}
+	}
+}
+
+bool UUnrealCopilotLevelCensusSubsystem::FindActorsNearViewport(int32 MaxResults, double MaxDistance, bool bInViewFrustumOnly, FVector& OutCameraLocation, TArray<FSpatialIndexHit>& OutHits)
+{
+	OutHits.Reset();
+
+#if WITH_EDITOR
+	check(IsInGameThread());
+
+	const FLevelEditorViewportClient* ViewportClient = UnrealCopilotLevelCensus::GetLevelViewportClient();
+	if (!ViewportClient)
+	{
+		return false;
+	}
+
+	EnsureCensusBuilt();
+	OutCameraLocation = ViewportClient->GetViewLocation();
+
+	FConvexVolume Frustum;
+	const bool bUseFrustum = bInViewFrustumOnly && UnrealCopilotLevelCensus::GetViewportFrustum(*ViewportClient, Frustum);
+
+	FScopeLock Lock(&CensusCriticalSection);
+	if (bUseFrustum)
+	{
+		SpatialIndex.FindInFrustum(Frustum, OutCameraLocation, MaxResults, MaxDistance, OutHits);
+	}
+	else
+	{
+		SpatialIndex.FindNearest(OutCameraLocation, MaxResults, MaxDistance, OutHits);
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool UUnrealCopilotLevelCensusSubsystem::ShouldTrackActor(const AActor* Actor) const
+{
+#if WITH_EDITOR
+	if (!IsValid(Actor) || Actor->IsTemplate() || Actor->HasAnyFlags(RF_Transient))
+	{
+		return false;
+	}
+
+	// Only count actors in the editor world, not PIE or asset editor preview worlds
+	return GEditor && Actor->GetWorld() == GEditor->GetEditorWorldContext().World();
+#else
+	return false;
+#endif
+}
+
+FActorCensusRecord UUnrealCopilotLevelCensusSubsystem::MakeRecord(const AActor* Actor)
+{
+	FActorCensusRecord Record;
+	Record.ClassName = Actor->GetClass()->GetFName();
+
+#if WITH_EDITOR
+	Record.FolderPath = Actor->GetFolderPath();
+
+	for (const UDataLayerInstance* DataLayer : Actor->GetDataLayerInstances())
+	{
+		if (DataLayer)
+		{
+			Record.DataLayers.Add(FName(*DataLayer->GetDataLayerShortName()));
+		}
+	}
+#endif
+
+	if (const ULevel* Level = Actor->GetLevel())
+	{
+		Record.LevelName = FName(*FPackageName::GetShortName(Level->GetOutermost()->GetName()));
+	}
+
+	const FBox ActorBounds = Actor->GetComponentsBoundingBox(/*bNonColliding*/ true);
+	if (ActorBounds.IsValid)
+	{
+		Record.Bounds = ActorBounds;
+	}
+	else
+	{
+		Record.Bounds = FBox(Actor->GetActorLocation(), Actor->GetActorLocation());
+	}
+
+	return Record;
+}
+
+void UUnrealCopilotLevelCensusSubsystem::AddRecordCounts(const FActorCensusRecord& Record)
+{
+	UnrealCopilotLevelCensus::IncrementCount(ClassCounts, Record.ClassName);
+	UnrealCopilotLevelCensus::IncrementCount(FolderCounts, Record.FolderPath);
+	UnrealCopilotLevelCensus::IncrementCount(LevelCounts, Record.LevelName);
+	for (const FName& DataLayer : Record.DataLayers)
+	{
+		UnrealCopilotLevelCensus::IncrementCount(DataLayerCounts, DataLayer);
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::RemoveRecordCounts(const FActorCensusRecord& Record)
+{
+	UnrealCopilotLevelCensus::DecrementCount(ClassCounts, Record.ClassName);
+	UnrealCopilotLevelCensus::DecrementCount(FolderCounts, Record.FolderPath);
+	UnrealCopilotLevelCensus::DecrementCount(LevelCounts, Record.LevelName);
+	for (const FName& DataLayer : Record.DataLayers)
+	{
+		UnrealCopilotLevelCensus::DecrementCount(DataLayerCounts, DataLayer);
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::AddOrUpdateActor(const AActor* Actor)
+{
+	FActorCensusRecord NewRecord = MakeRecord(Actor);
+
+	if (FActorCensusRecord* ExistingRecord = Records.Find(FObjectKey(Actor)))
+	{
+		RemoveRecordCounts(*ExistingRecord);
+
+		// Moving an actor can only shrink the level bounds if it touched their edge
+		if (!bBoundsDirty && !LevelBounds.IsInside(ExistingRecord->Bounds))
+		{
+			bBoundsDirty = true;
+		}
+
+		*ExistingRecord = MoveTemp(NewRecord);
+		AddRecordCounts(*ExistingRecord);
+		SpatialIndex.AddOrUpdate(FObjectKey(Actor), ExistingRecord->Bounds);
+		if (!bBoundsDirty)
+		{
+			LevelBounds += ExistingRecord->Bounds;
+		}
+	}
+	else
+	{
+		AddRecordCounts(NewRecord);
+		SpatialIndex.AddOrUpdate(FObjectKey(Actor), NewRecord.Bounds);
+		if (!bBoundsDirty)
+		{
+			LevelBounds += NewRecord.Bounds;
+		}
+		Records.Add(FObjectKey(Actor), MoveTemp(NewRecord));
+	}
+
+	bSummaryDirty = true;
+}
+
+void UUnrealCopilotLevelCensusSubsystem::RemoveActor(const AActor* Actor)
+{
+	FActorCensusRecord Record;
+	if (Records.RemoveAndCopyValue(FObjectKey(Actor), Record))
+	{
+		RemoveRecordCounts(Record);
+		SpatialIndex.Remove(FObjectKey(Actor));
+		bBoundsDirty |= !LevelBounds.IsInside(Record.Bounds);
+		bSummaryDirty = true;
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::EnsureCensusBuilt()
+{
+	bool bNeedsRebuild = false;
+	{
+		FScopeLock Lock(&CensusCriticalSection);
+		bNeedsRebuild = !bCensusBuilt;
+	}
+
+	// Worker threads get whatever census is available rather than scanning the world themselves
+	if (bNeedsRebuild && IsInGameThread())
+	{
+		RebuildCensus();
+	}
+}
+
+void UUnrealCopilotLevelCensusSubsystem::RecomputeBounds()
+{
+	LevelBounds = FBox(ForceInit);
+	for (const TPair<FObjectKey, FActorCensusRecord>& Pair : Records)
+	{
+		LevelBounds += Pair.Value.Bounds;
+	}
+	bBoundsDirty = false;
+}
+
+void UUnrealCopilotLevelCensusSubsystem::RebuildSummary()
+{
+	using namespace UnrealCopilotLevelCensus;
+
+	if (bBoundsDirty)
+	{
+		RecomputeBounds();
+	}
+
+	CachedSummary.Reset();
+	if (Records.Num() == 0)
+	{
+		CachedSummary = TEXT("\nThe level contains no actors.");
+		bSummaryDirty = false;
+		return;
+	}
+
+	CachedSummary += FString::Printf(TEXT("\n%d loaded actors"), Records.Num());
+
+	if (LevelBounds.IsValid)
+	{
+		CachedSummary += FString::Printf(TEXT("\nBounds: Min=%s Max=%s Size=%s"),
+			*FormatVector(LevelBounds.Min),
+			*FormatVector(LevelBounds.Max),
+			*FormatVector(LevelBounds.GetSize()));
+	}
+
+	CachedSummary += TEXT("\nClasses: ") + FormatTopGroups(SortCounts(ClassCounts), MaxSummaryGroups);
+
+	const FString FolderHierarchy = FormatFolderHierarchy(FolderCounts);
+	if (!FolderHierarchy.IsEmpty())
+	{
+		CachedSummary += TEXT("\nFolders:") + FolderHierarchy;
+	}
+
+	// Only list levels when sublevels are loaded; a single persistent level is already named in the prompt
+	if (LevelCounts.Num() > 1)
+	{
+		CachedSummary += TEXT("\nLevels: ") + FormatTopGroups(SortCounts(LevelCounts), MaxSummaryGroups);
+	}
+
+	if (DataLayerCounts.Num() > 0)
+	{
+		CachedSummary += TEXT("\nData Layers: ") + FormatTopGroups(SortCounts(DataLayerCounts), MaxSummaryGroups);
+	}
+
+	bSummaryDirty = false;
+}
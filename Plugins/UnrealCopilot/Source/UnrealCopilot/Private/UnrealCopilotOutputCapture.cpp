@@ -0,0 +1,191 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotOutputCapture.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Misc/ScopeLock.h"
+#include "Json.h"
+
+namespace UnrealCopilotOutputCapture
+{
+	static const FName PythonLogCategory(TEXT("LogPython"));
+
+	/** Prefix of the one-line JSON error report printed by unreal_copilot_runtime.report_exception */
+	static const TCHAR* ErrorReportMarker = TEXT("__unreal_copilot_error__ ");
+
+	static bool ParseErrorReport(const FString& Json, FPythonErrorReport& OutReport)
+	{
+		TSharedPtr<FJsonObject> JsonObject;
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+		if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+		{
+			return false;
+		}
+
+		OutReport.Type = JsonObject->GetStringField(TEXT("type"));
+		OutReport.Message = JsonObject->GetStringField(TEXT("message"));
+		OutReport.Line = JsonObject->GetIntegerField(TEXT("line"));
+		OutReport.StackTrace = JsonObject->GetStringField(TEXT("stack_trace"));
+		return true;
+	}
+}
+
+FPythonOutputRingBuffer::FPythonOutputRingBuffer(int32 InCapacity)
+{
+	Reset(InCapacity);
+}
+
+void FPythonOutputRingBuffer::Reset(int32 InCapacity)
+{
+	Lines.Reset();
+	Head = 0;
+	Capacity = FMath::Max(InCapacity, 1);
+	DroppedCount = 0;
+}
+
+void FPythonOutputRingBuffer::Add(FPythonOutputLine&& Line)
+{
+	if (Lines.Num() < Capacity)
+	{
+		Lines.Add(MoveTemp(Line));
+		return;
+	}
+
+	Lines[Head] = MoveTemp(Line);
+	Head = (Head + 1) % Capacity;
+	++DroppedCount;
+}
+
+const FPythonOutputLine& FPythonOutputRingBuffer::operator[](int32 Index) const
+{
+	return Lines[(Head + Index) % Lines.Num()];
+}
+
+FString FPythonOutputRingBuffer::Join(EPythonOutputStream Stream) const
+{
+	FString Text;
+	for (int32 Index = 0; Index < Lines.Num(); ++Index)
+	{
+		const FPythonOutputLine& Line = (*this)[Index];
+		if (Line.Stream != Stream)
+		{
+			continue;
+		}
+
+		if (!Text.IsEmpty())
+		{
+			Text += TEXT("\n");
+		}
+		Text += Line.Text;
+	}
+	return Text;
+}
+
+FUnrealCopilotOutputCapture::FScope::FScope(FUnrealCopilotOutputCapture& InCapture)
+	: Capture(InCapture)
+{
+	GLog->AddOutputDevice(&Capture);
+}
+
+FUnrealCopilotOutputCapture::FScope::~FScope()
+{
+	GLog->RemoveOutputDevice(&Capture);
+}
+
+FUnrealCopilotOutputCapture::FUnrealCopilotOutputCapture(int32 InMaxLines)
+	: Lines(InMaxLines)
+{
+}
+
+FUnrealCopilotOutputCapture::~FUnrealCopilotOutputCapture()
+{
+	if (GLog)
+	{
+		GLog->RemoveOutputDevice(this);
+	}
+}
+
+void FUnrealCopilotOutputCapture::Reset(int32 InMaxLines)
+{
+	FScopeLock Lock(&CaptureLock);
+	Lines.Reset(InMaxLines);
+	ErrorReport.Reset();
+}
+
+FString FUnrealCopilotOutputCapture::GetText(EPythonOutputStream Stream) const
+{
+	FScopeLock Lock(&CaptureLock);
+	return Lines.Join(Stream);
+}
+
+int32 FUnrealCopilotOutputCapture::GetDroppedLineCount() const
+{
+	FScopeLock Lock(&CaptureLock);
+	return Lines.GetDroppedCount();
+}
+
+bool FUnrealCopilotOutputCapture::GetErrorReport(FPythonErrorReport& OutReport) const
+{
+	FScopeLock Lock(&CaptureLock);
+	if (!ErrorReport.IsSet())
+	{
+		return false;
+	}
+	OutReport = ErrorReport.GetValue();
+	return true;
+}
+
+void FUnrealCopilotOutputCapture::Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category)
+{
+	using namespace UnrealCopilotOutputCapture;
+
+	if (Category != PythonLogCategory)
+	{
+		return;
+	}
+
+	// The plugin logs stdout at Log or Display verbosity and stderr as warnings or errors
+	const ELogVerbosity::Type BaseVerbosity = static_cast<ELogVerbosity::Type>(Verbosity & ELogVerbosity::VerbosityMask);
+	const EPythonOutputStream Stream = BaseVerbosity <= ELogVerbosity::Warning ? EPythonOutputStream::Stderr : EPythonOutputStream::Stdout;
+
+	FString Text(V);
+	while (Text.EndsWith(TEXT("\n")) || Text.EndsWith(TEXT("\r")))
+	{
+		Text.LeftChopInline(1);
+	}
+
+	TArray<FString> TextLines;
+	Text.ParseIntoArrayLines(TextLines, /*InCullEmpty*/ false);
+
+	const bool bBroadcast = IsInGameThread();
+	TArray<FPythonOutputLine> NewLines;
+	{
+		FScopeLock Lock(&CaptureLock);
+		for (FString& TextLine : TextLines)
+		{
+			if (TextLine.StartsWith(ErrorReportMarker, ESearchCase::CaseSensitive))
+			{
+				FPythonErrorReport Report;
+				if (ParseErrorReport(TextLine.RightChop(FCString::Strlen(ErrorReportMarker)), Report))
+				{
+					ErrorReport = MoveTemp(Report);
+				}
+				continue;
+			}
+
+			FPythonOutputLine Line;
+			Line.Stream = Stream;
+			Line.Text = MoveTemp(TextLine);
+			if (bBroadcast)
+			{
+				NewLines.Add(Line);
+			}
+			Lines.Add(MoveTemp(Line));
+		}
+	}
+
+	// Broadcast outside the lock so subscribers may read the capture
+	for (const FPythonOutputLine& Line : NewLines)
+	{
+		OnLineCaptured.Broadcast(Line);
+	}
+}
@@ -0,0 +1,323 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotPatternScanner.h"
+#include "UnrealCopilotSettings.h"
+#include "Misc/ScopeLock.h"
+
+namespace UnrealCopilotPatternScanner
+{
+	static bool IsIdentifierChar(TCHAR Char)
+	{
+		return FChar::IsAlnum(Char) || Char == TEXT('_');
+	}
+
+	/** Whether the letters before a quote form a string prefix that makes it an f-string */
+	static bool IsFormatStringPrefix(FStringView Text, int32 QuoteIndex)
+	{
+		int32 PrefixStart = QuoteIndex;
+		while (PrefixStart > 0 && QuoteIndex - PrefixStart < 2 && FChar::IsAlpha(Text[PrefixStart - 1]))
+		{
+			--PrefixStart;
+		}
+
+		if (PrefixStart == QuoteIndex || (PrefixStart > 0 && IsIdentifierChar(Text[PrefixStart - 1])))
+		{
+			return false;
+		}
+
+		bool bFormat = false;
+		for (int32 Index = PrefixStart; Index < QuoteIndex; ++Index)
+		{
+			const TCHAR Letter = FChar::ToLower(Text[Index]);
+			if (Letter != TEXT('r') && Letter != TEXT('b') && Letter != TEXT('u') && Letter != TEXT('f'))
+			{
+				return false;
+			}
+			bFormat |= Letter == TEXT('f');
+		}
+		return bFormat;
+	}
+
+	static FCriticalSection ScannerLock;
+	static TSharedPtr<const FUnrealCopilotPatternScanner> CodeScanner;
+	static TSharedPtr<const FUnrealCopilotPatternScanner> PromptScanner;
+}
+
+FUnrealCopilotPatternScanner::FUnrealCopilotPatternScanner(const TArray<FPatternScanRule>& InRules, bool bInCaseSensitive)
+	: bCaseSensitive(bInCaseSensitive)
+{
+	Nodes.AddDefaulted();
+
+	// Build the trie
+	TSet<FString> SeenPatterns;
+	for (const FPatternScanRule& Rule : InRules)
+	{
+		const FString Key = bCaseSensitive ? Rule.Pattern : Rule.Pattern.ToUpper();
+		bool bAlreadySeen = false;
+		SeenPatterns.Add(Key, &bAlreadySeen);
+		if (Key.IsEmpty() || bAlreadySeen)
+		{
+			continue;
+		}
+
+		const int32 RuleIndex = Rules.Add(Rule);
+		int32 State = 0;
+		for (const TCHAR Char : Key)
+		{
+			if (const int32* NextState = Nodes[State].Next.Find(Char))
+			{
+				State = *NextState;
+				continue;
+			}
+
+			const int32 NewState = Nodes.AddDefaulted();
+			Nodes[State].Next.Add(Char, NewState);
+			State = NewState;
+		}
+		Nodes[State].RuleIndex = RuleIndex;
+	}
+
+	// Breadth-first pass to link each node to its longest suffix that is also in the trie
+	TArray<int32> Queue;
+	Queue.Reserve(Nodes.Num());
+	for (const TPair<TCHAR, int32>& Child : Nodes[0].Next)
+	{
+		Queue.Add(Child.Value);
+	}
+
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		const int32 State = Queue[Head];
+		for (const TPair<TCHAR, int32>& Child : Nodes[State].Next)
+		{
+			int32 Fallback = Nodes[State].Fail;
+			while (Fallback != 0 && !Nodes[Fallback].Next.Contains(Child.Key))
+			{
+				Fallback = Nodes[Fallback].Fail;
+			}
+
+			const int32* FallbackNext = Nodes[Fallback].Next.Find(Child.Key);
+			FNode& ChildNode = Nodes[Child.Value];
+			ChildNode.Fail = (FallbackNext && *FallbackNext != Child.Value) ? *FallbackNext : 0;
+			ChildNode.OutputLink = Nodes[ChildNode.Fail].RuleIndex != INDEX_NONE ? ChildNode.Fail : Nodes[ChildNode.Fail].OutputLink;
+			Queue.Add(Child.Value);
+		}
+	}
+}
+
+int32 FUnrealCopilotPatternScanner::Step(int32 State, TCHAR Char) const
+{
+	for (;;)
+	{
+		if (const int32* NextState = Nodes[State].Next.Find(Char))
+		{
+			return *NextState;
+		}
+		if (State == 0)
+		{
+			return 0;
+		}
+		State = Nodes[State].Fail;
+	}
+}
+
+void FUnrealCopilotPatternScanner::Scan(FStringView Text, EPatternScanMode Mode, TArray<FPatternScanHit>& OutHits, int32 MaxHits) const
+{
+	using namespace UnrealCopilotPatternScanner;
+
+	OutHits.Reset();
+	if (Rules.Num() == 0 || MaxHits <= 0)
+	{
+		return;
+	}
+
+	const int32 Length = Text.Len();
+	int32 State = 0;
+	int32 Line = 1;
+	int32 LineStart = 0;
+
+	// Python lexer state
+	bool bInComment = false;
+	TCHAR Quote = 0;
+	bool bTripleQuoted = false;
+	bool bScanStringContents = false;
+	bool bEscaped = false;
+
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const TCHAR Char = Text[Index];
+		bool bMatchChar = true;
+
+		if (Mode == EPatternScanMode::PythonCode)
+		{
+			if (bInComment)
+			{
+				bInComment = Char != TEXT('\n');
+				bMatchChar = false;
+			}
+			else if (Quote != 0)
+			{
+				bool bClosed = false;
+				if (bEscaped)
+				{
+					bEscaped = false;
+				}
+				else if (Char == TEXT('\\'))
+				{
+					bEscaped = true;
+				}
+				else if (Char == Quote)
+				{
+					if (!bTripleQuoted)
+					{
+						bClosed = true;
+					}
+					else if (Index + 2 < Length && Text[Index + 1] == Quote && Text[Index + 2] == Quote)
+					{
+						bClosed = true;
+						Index += 2;
+					}
+				}
+				else if (Char == TEXT('\n') && !bTripleQuoted)
+				{
+					// Unterminated single-line string
+					bClosed = true;
+				}
+
+				if (bClosed)
+				{
+					Quote = 0;
+				}
+				bMatchChar = !bClosed && bScanStringContents;
+			}
+			else if (Char == TEXT('#'))
+			{
+				bInComment = true;
+				bMatchChar = false;
+			}
+			else if (Char == TEXT('"') || Char == TEXT('\''))
+			{
+				// f-string replacement fields are code, so their contents stay visible to the scanner
+				bScanStringContents = IsFormatStringPrefix(Text, Index);
+				Quote = Char;
+				bTripleQuoted = Index + 2 < Length && Text[Index + 1] == Char && Text[Index + 2] == Char;
+				if (bTripleQuoted)
+				{
+					Index += 2;
+				}
+				bMatchChar = false;
+			}
+		}
+
+		if (!bMatchChar)
+		{
+			// Matches never span skipped text
+			State = 0;
+		}
+		else
+		{
+			State = Step(State, Fold(Char));
+
+			for (int32 OutputState = Nodes[State].RuleIndex != INDEX_NONE ? State : Nodes[State].OutputLink;
+				OutputState != INDEX_NONE;
+				OutputState = Nodes[OutputState].OutputLink)
+			{
+				const int32 RuleIndex = Nodes[OutputState].RuleIndex;
+				const FString& Pattern = Rules[RuleIndex].Pattern;
+				const int32 Start = Index - Pattern.Len() + 1;
+
+				if (IsIdentifierChar(Pattern[0]) && Start > 0 && IsIdentifierChar(Text[Start - 1]))
+				{
+					continue;
+				}
+
+				FPatternScanHit& Hit = OutHits.AddDefaulted_GetRef();
+				Hit.RuleIndex = RuleIndex;
+				Hit.Offset = Start;
+				Hit.Line = Line;
+				Hit.Column = FMath::Max(Start - LineStart, 0) + 1;
+
+				if (OutHits.Num() >= MaxHits)
+				{
+					return;
+				}
+			}
+		}
+
+		if (Char == TEXT('\n'))
+		{
+			++Line;
+			LineStart = Index + 1;
+		}
+	}
+}
+
+FString FUnrealCopilotPatternScanner::DescribeHits(const TArray<FPatternScanHit>& Hits) const
+{
+	FString Description;
+	for (const FPatternScanHit& Hit : Hits)
+	{
+		const FPatternScanRule& Rule = Rules[Hit.RuleIndex];
+		if (!Description.IsEmpty())
+		{
+			Description += TEXT("\n");
+		}
+		Description += FString::Printf(TEXT("%s: %s (line %d, column %d)"), *Rule.Reason, *Rule.Pattern, Hit.Line, Hit.Column);
+	}
+	return Description;
+}
+
+TSharedRef<const FUnrealCopilotPatternScanner> FUnrealCopilotSafetyScanners::GetCodeScanner()
+{
+	using namespace UnrealCopilotPatternScanner;
+
+	FScopeLock Lock(&ScannerLock);
+	if (!CodeScanner.IsValid())
+	{
+		TArray<FPatternScanRule> Rules;
+
+		UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+		for (const FString& BlockedOp : Settings->BlockedOperations)
+		{
+			Rules.Add({ BlockedOp, TEXT("Generated code contains blocked operation") });
+		}
+
+		CodeScanner = MakeShared<const FUnrealCopilotPatternScanner>(Rules, /*bInCaseSensitive*/ true);
+	}
+	return CodeScanner.ToSharedRef();
+}
+
+TSharedRef<const FUnrealCopilotPatternScanner> FUnrealCopilotSafetyScanners::GetPromptScanner()
+{
+	using namespace UnrealCopilotPatternScanner;
+
+	FScopeLock Lock(&ScannerLock);
+	if (!PromptScanner.IsValid())
+	{
+		TArray<FPatternScanRule> Rules;
+		const TCHAR* ProhibitedPatterns[] = {
+			TEXT("DELETE"),
+			TEXT("DROP TABLE"),
+			TEXT("TRUNCATE"),
+			TEXT("format C:"),
+			TEXT("rm -rf"),
+			TEXT("del /f")
+		};
+		for (const TCHAR* Pattern : ProhibitedPatterns)
+		{
+			Rules.Add({ Pattern, TEXT("Prompt contains prohibited pattern") });
+		}
+
+		PromptScanner = MakeShared<const FUnrealCopilotPatternScanner>(Rules, /*bInCaseSensitive*/ false);
+	}
+	return PromptScanner.ToSharedRef();
+}
+
+void FUnrealCopilotSafetyScanners::Invalidate()
+{
+	using namespace UnrealCopilotPatternScanner;
+
+	FScopeLock Lock(&ScannerLock);
+	CodeScanner.Reset();
+	PromptScanner.Reset();
+}
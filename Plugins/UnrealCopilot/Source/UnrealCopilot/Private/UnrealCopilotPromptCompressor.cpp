@@ -0,0 +1,607 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotPromptCompressor.h"
+
+namespace UnrealCopilotPromptCompressor
+{
+	/** Text lines shorter than this are never treated as duplicates (list markers, braces, ...) */
+	static constexpr int32 MinDeduplicatedLineLength = 4;
+
+	/** Shortest directory worth replacing with an alias */
+	static constexpr int32 MinFactoredDirectoryLength = 10;
+
+	/** Maximum number of path aliases in the legend */
+	static constexpr int32 MaxPathAliases = 20;
+
+	/** Estimated cost of an "(N lines omitted)" marker line */
+	static constexpr int32 OmittedMarkerTokens = 8;
+
+	enum class ELineKind : uint8
+	{
+		Text,
+		Fence,
+		Code
+	};
+
+	struct FLine
+	{
+		FString Text;
+		ELineKind Kind = ELineKind::Text;
+		bool bProtected = false;
+		bool bRemoved = false;
+	};
+
+	/** A line that may be dropped to meet the token budget */
+	struct FDropCandidate
+	{
+		int32 Segment;
+		int32 Line;
+		int32 Section;
+		float Score;
+	};
+
+	static bool IsPathCharacter(TCHAR Char)
+	{
+		return FChar::IsAlnum(Char) || Char == TEXT('_') || Char == TEXT('/') || Char == TEXT('.') || Char == TEXT('-');
+	}
+
+	/** Call Visitor(Start, Length, DirectoryLength) for each content path like /Game/Dir/Asset in Text */
+	template <typename VisitorType>
+	static void ForEachPath(const FString& Text, VisitorType&& Visitor)
+	{
+		const int32 Length = Text.Len();
+		int32 Index = 0;
+		while (Index < Length)
+		{
+			const bool bPathStart = Text[Index] == TEXT('/') &&
+				(Index == 0 || !IsPathCharacter(Text[Index - 1])) &&
+				Index + 1 < Length && FChar::IsAlpha(Text[Index + 1]);
+			if (!bPathStart)
+			{
+				++Index;
+				continue;
+			}
+
+			int32 End = Index + 1;
+			int32 LastSlash = Index;
+			int32 NumSlashes = 1;
+			while (End < Length && IsPathCharacter(Text[End]))
+			{
+				if (Text[End] == TEXT('/'))
+				{
+					LastSlash = End;
+					++NumSlashes;
+				}
+				++End;
+			}
+
+			// Root, at least one directory, and a name
+			if (NumSlashes >= 3 && LastSlash < End - 1)
+			{
+				Visitor(Index, End - Index, LastSlash - Index);
+			}
+			Index = End;
+		}
+	}
+
+	static bool IsFenceLine(const FString& Line)
+	{
+		return Line.TrimStart().StartsWith(TEXT("```"));
+	}
+
+	static TArray<FLine> SplitLines(const FString& Segment)
+	{
+		TArray<FString> RawLines;
+		Segment.ParseIntoArray(RawLines, TEXT("\n"), /*InCullEmpty*/ false);
+
+		TArray<FLine> Lines;
+		Lines.Reserve(RawLines.Num());
+		bool bInCode = false;
+		for (FString& RawLine : RawLines)
+		{
+			FLine& Line = Lines.AddDefaulted_GetRef();
+			Line.Text = MoveTemp(RawLine);
+			if (IsFenceLine(Line.Text))
+			{
+				Line.Kind = ELineKind::Fence;
+				bInCode = !bInCode;
+			}
+			else
+			{
+				Line.Kind = bInCode ? ELineKind::Code : ELineKind::Text;
+			}
+		}
+		return Lines;
+	}
+
+	/** Replace each run of code lines with its stripped form */
+	static void StripCodeLines(TArray<FLine>& Lines, FPromptCompressionStats& Stats)
+	{
+		TArray<FLine> Result;
+		Result.Reserve(Lines.Num());
+
+		int32 Index = 0;
+		while (Index < Lines.Num())
+		{
+			if (Lines[Index].Kind != ELineKind::Code)
+			{
+				Result.Add(MoveTemp(Lines[Index++]));
+				continue;
+			}
+
+			FString Code;
+			int32 NumCodeLines = 0;
+			for (; Index < Lines.Num() && Lines[Index].Kind == ELineKind::Code; ++Index, ++NumCodeLines)
+			{
+				Code += NumCodeLines > 0 ? TEXT("\n") : TEXT("");
+				Code += Lines[Index].Text;
+			}
+
+			TArray<FString> StrippedLines;
+			FUnrealCopilotPromptCompressor::StripPythonCode(Code).ParseIntoArray(StrippedLines, TEXT("\n"), /*InCullEmpty*/ false);
+			Stats.StrippedCodeLines += FMath::Max(0, NumCodeLines - StrippedLines.Num());
+			for (FString& StrippedLine : StrippedLines)
+			{
+				FLine& Line = Result.AddDefaulted_GetRef();
+				Line.Text = MoveTemp(StrippedLine);
+				Line.Kind = ELineKind::Code;
+			}
+		}
+
+		Lines = MoveTemp(Result);
+	}
+
+	/** Give frequently repeated path directories short aliases and rewrite every line to use them */
+	static void FactorPathPrefixes(TArray<TArray<FLine>>& Segments, int32 MinOccurrences, FPromptCompressionStats& Stats)
+	{
+		TMap<FString, int32> DirectoryCounts;
+		for (const TArray<FLine>& Lines : Segments)
+		{
+			for (const FLine& Line : Lines)
+			{
+				if (Line.bRemoved || Line.Kind == ELineKind::Fence)
+				{
+					continue;
+				}
+				ForEachPath(Line.Text, [&](int32 Start, int32 Length, int32 DirectoryLength)
+				{
+					if (DirectoryLength >= MinFactoredDirectoryLength)
+					{
+						++DirectoryCounts.FindOrAdd(Line.Text.Mid(Start, DirectoryLength));
+					}
+				});
+			}
+		}
+
+		TArray<TPair<FString, int32>> Candidates;
+		for (const TPair<FString, int32>& Pair : DirectoryCounts)
+		{
+			if (Pair.Value >= MinOccurrences)
+			{
+				Candidates.Emplace(Pair.Key, Pair.Value);
+			}
+		}
+		Candidates.Sort([](const TPair<FString, int32>& A, const TPair<FString, int32>& B)
+		{
+			const int64 SavingsA = (int64)A.Value * A.Key.Len();
+			const int64 SavingsB = (int64)B.Value * B.Key.Len();
+			return SavingsA != SavingsB ? SavingsA > SavingsB : A.Key < B.Key;
+		});
+
+		TMap<FString, FString> Aliases;
+		FString Legend;
+		for (const TPair<FString, int32>& Candidate : Candidates)
+		{
+			if (Aliases.Num() >= MaxPathAliases)
+			{
+				break;
+			}
+
+			// Only worth it if the replacements save more than the legend entry costs
+			const FString Alias = FString::Printf(TEXT("~%d"), Aliases.Num() + 1);
+			if (Candidate.Value * (Candidate.Key.Len() - Alias.Len()) <= Candidate.Key.Len() + Alias.Len() + 3)
+			{
+				continue;
+			}
+
+			Legend += FString::Printf(TEXT("%s%s=%s"), Aliases.Num() > 0 ? TEXT(", ") : TEXT(""), *Alias, *Candidate.Key);
+			Aliases.Add(Candidate.Key, Alias);
+		}
+
+		if (Aliases.Num() == 0)
+		{
+			return;
+		}
+
+		for (TArray<FLine>& Lines : Segments)
+		{
+			for (FLine& Line : Lines)
+			{
+				if (Line.bRemoved || Line.Kind == ELineKind::Fence)
+				{
+					continue;
+				}
+
+				FString Rewritten;
+				int32 Copied = 0;
+				ForEachPath(Line.Text, [&](int32 Start, int32 Length, int32 DirectoryLength)
+				{
+					if (const FString* Alias = Aliases.Find(Line.Text.Mid(Start, DirectoryLength)))
+					{
+						Rewritten += Line.Text.Mid(Copied, Start - Copied);
+						Rewritten += *Alias;
+						Copied = Start + DirectoryLength;
+					}
+				});
+
+				if (Copied > 0)
+				{
+					Rewritten += Line.Text.Mid(Copied);
+					Line.Text = MoveTemp(Rewritten);
+				}
+			}
+		}
+
+		if (Segments.Num() > 0)
+		{
+			FLine& Separator = Segments[0].AddDefaulted_GetRef();
+			Separator.bProtected = true;
+
+			FLine& LegendLine = Segments[0].AddDefaulted_GetRef();
+			LegendLine.Text = TEXT("Path aliases (expand to full paths in code): ") + Legend;
+			LegendLine.bProtected = true;
+		}
+
+		Stats.FactoredPathPrefixes = Aliases.Num();
+	}
+
+	/** Drop the lowest scoring lines of trimmable sections until the estimated size fits the budget */
+	static void TrimToBudget(TArray<TArray<FLine>>& Segments, const FPromptCompressionOptions& Options, FPromptCompressionStats& Stats)
+	{
+		TArray<TArray<int32>> LineTokens;
+		int32 TotalTokens = 0;
+		for (const TArray<FLine>& Lines : Segments)
+		{
+			TArray<int32>& Tokens = LineTokens.AddDefaulted_GetRef();
+			Tokens.Reserve(Lines.Num());
+			for (const FLine& Line : Lines)
+			{
+				const int32 Cost = Line.bRemoved ? 0 : FUnrealCopilotPromptCompressor::EstimateTokens(Line.Text) + 1;
+				Tokens.Add(Cost);
+				TotalTokens += Cost;
+			}
+		}
+
+		if (TotalTokens <= Options.TokenBudget)
+		{
+			return;
+		}
+
+		// Assign lines to sections by header; lines outside any known section are never trimmed
+		struct FSectionLines
+		{
+			const FPromptSectionPolicy* Policy = nullptr;
+			int32 Segment = 0;
+			TArray<int32> Lines;
+			int32 LastLine = 0;
+			int32 NumDropped = 0;
+		};
+		TArray<FSectionLines> Sections;
+
+		for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+		{
+			const FPromptSectionPolicy* CurrentPolicy = nullptr;
+			for (int32 LineIndex = 0; LineIndex < Segments[SegmentIndex].Num(); ++LineIndex)
+			{
+				const FLine& Line = Segments[SegmentIndex][LineIndex];
+				if (Line.bRemoved)
+				{
+					continue;
+				}
+
+				if (Line.Kind == ELineKind::Text)
+				{
+					const FString Trimmed = Line.Text.TrimStart();
+					const FPromptSectionPolicy* HeaderPolicy = Options.SectionPolicies.FindByPredicate([&Trimmed](const FPromptSectionPolicy& Policy)
+					{
+						return Trimmed.StartsWith(Policy.HeaderPrefix);
+					});
+					if (HeaderPolicy)
+					{
+						CurrentPolicy = HeaderPolicy;
+						FSectionLines& Section = Sections.AddDefaulted_GetRef();
+						Section.Policy = HeaderPolicy;
+						Section.Segment = SegmentIndex;
+						Section.LastLine = LineIndex;
+						continue;
+					}
+				}
+
+				if (CurrentPolicy && CurrentPolicy->Importance < 1.0f)
+				{
+					Sections.Last().LastLine = LineIndex;
+					if (!Line.bProtected && Line.Kind != ELineKind::Fence)
+					{
+						Sections.Last().Lines.Add(LineIndex);
+					}
+				}
+			}
+		}
+
+		TArray<FDropCandidate> Candidates;
+		for (int32 SectionIndex = 0; SectionIndex < Sections.Num(); ++SectionIndex)
+		{
+			const FSectionLines& Section = Sections[SectionIndex];
+			const int32 NumLines = Section.Lines.Num();
+			for (int32 Position = 0; Position < NumLines; ++Position)
+			{
+				const float Recency = (float)(Position + 1) / NumLines;
+				const float PositionWeight = Section.Policy->bPreferRecent ? 0.5f + 0.5f * Recency : 1.0f - 0.5f * ((float)Position / NumLines);
+				Candidates.Add({ Section.Segment, Section.Lines[Position], SectionIndex, Section.Policy->Importance * PositionWeight });
+			}
+		}
+
+		Candidates.Sort([](const FDropCandidate& A, const FDropCandidate& B)
+		{
+			if (A.Score != B.Score)
+			{
+				return A.Score < B.Score;
+			}
+			return A.Segment != B.Segment ? A.Segment < B.Segment : A.Line > B.Line;
+		});
+
+		for (const FDropCandidate& Candidate : Candidates)
+		{
+			if (TotalTokens <= Options.TokenBudget)
+			{
+				break;
+			}
+
+			FLine& Line = Segments[Candidate.Segment][Candidate.Line];
+			Line.bRemoved = true;
+			TotalTokens -= LineTokens[Candidate.Segment][Candidate.Line];
+			if (Sections[Candidate.Section].NumDropped++ == 0)
+			{
+				TotalTokens += OmittedMarkerTokens;
+			}
+			++Stats.DroppedLines;
+		}
+
+		// Mark trimmed sections so the model knows content is missing; insert from the back to keep indices valid
+		for (int32 SectionIndex = Sections.Num() - 1; SectionIndex >= 0; --SectionIndex)
+		{
+			const FSectionLines& Section = Sections[SectionIndex];
+			if (Section.NumDropped > 0)
+			{
+				FLine Marker;
+				Marker.Text = FString::Printf(TEXT("(%d lines omitted)"), Section.NumDropped);
+				Marker.bProtected = true;
+				Segments[Section.Segment].Insert(MoveTemp(Marker), Section.LastLine + 1);
+			}
+		}
+	}
+
+	static FString JoinLines(const TArray<FLine>& Lines)
+	{
+		FString Result;
+		bool bLastWasBlank = true;
+		for (const FLine& Line : Lines)
+		{
+			if (Line.bRemoved)
+			{
+				continue;
+			}
+
+			// Collapse runs of blank text lines
+			const bool bBlank = Line.Kind == ELineKind::Text && Line.Text.IsEmpty();
+			if (bBlank && bLastWasBlank)
+			{
+				continue;
+			}
+
+			if (!Result.IsEmpty())
+			{
+				Result += TEXT("\n");
+			}
+			Result += Line.Text;
+			bLastWasBlank = bBlank;
+		}
+
+		Result.TrimEndInline();
+		return Result;
+	}
+}
+
+FPromptCompressionStats FUnrealCopilotPromptCompressor::Compress(TArrayView<FString> Segments, const FPromptCompressionOptions& Options)
+{
+	using namespace UnrealCopilotPromptCompressor;
+
+	const double StartTime = FPlatformTime::Seconds();
+	FPromptCompressionStats Stats;
+
+	TArray<TArray<FLine>> SegmentLines;
+	SegmentLines.Reserve(Segments.Num());
+	for (const FString& Segment : Segments)
+	{
+		Stats.OriginalTokens += EstimateTokens(Segment);
+		SegmentLines.Add(SplitLines(Segment));
+	}
+
+	// Code: comments and blank lines carry no meaning for the model
+	if (Options.bStripCode)
+	{
+		for (TArray<FLine>& Lines : SegmentLines)
+		{
+			StripCodeLines(Lines, Stats);
+		}
+	}
+
+	// Text: trailing whitespace and lines already sent earlier in the prompt
+	TSet<FString> SeenLines;
+	for (TArray<FLine>& Lines : SegmentLines)
+	{
+		for (FLine& Line : Lines)
+		{
+			if (Line.Kind != ELineKind::Text)
+			{
+				continue;
+			}
+
+			Line.Text.TrimEndInline();
+			if (!Options.bDeduplicateLines)
+			{
+				continue;
+			}
+
+			const FString Trimmed = Line.Text.TrimStart();
+			if (Trimmed.Len() >= MinDeduplicatedLineLength)
+			{
+				bool bAlreadySeen = false;
+				SeenLines.Add(Trimmed, &bAlreadySeen);
+				if (bAlreadySeen)
+				{
+					Line.bRemoved = true;
+					++Stats.DuplicateLines;
+				}
+			}
+		}
+	}
+
+	if (Options.bFactorPathPrefixes)
+	{
+		FactorPathPrefixes(SegmentLines, FMath::Max(Options.MinPathPrefixOccurrences, 2), Stats);
+	}
+
+	if (Options.TokenBudget > 0)
+	{
+		TrimToBudget(SegmentLines, Options, Stats);
+	}
+
+	for (int32 Index = 0; Index < Segments.Num(); ++Index)
+	{
+		Segments[Index] = JoinLines(SegmentLines[Index]);
+		Stats.CompressedTokens += EstimateTokens(Segments[Index]);
+	}
+
+	Stats.ElapsedMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	return Stats;
+}
+
+int32 FUnrealCopilotPromptCompressor::EstimateTokens(FStringView Text)
+{
+	int32 Tokens = 0;
+	int32 RunLength = 0;
+	for (const TCHAR Char : Text)
+	{
+		if (FChar::IsAlnum(Char))
+		{
+			++RunLength;
+			continue;
+		}
+
+		if (RunLength > 0)
+		{
+			Tokens += (RunLength + 3) / 4;
+			RunLength = 0;
+		}
+
+		// Spaces merge into the following word; newlines and punctuation are tokens of their own
+		if (Char == TEXT('\n') || !FChar::IsWhitespace(Char))
+		{
+			++Tokens;
+		}
+	}
+
+	return Tokens + (RunLength + 3) / 4;
+}
+
+FString FUnrealCopilotPromptCompressor::StripPythonCode(FStringView Code)
+{
+	FString Result;
+	Result.Reserve(Code.Len());
+
+	// Current logical line; spans physical lines while inside a triple-quoted string
+	FString Line;
+	TCHAR OpenQuote = 0;
+	bool bTripleQuoted = false;
+
+	auto CommitLine = [&Result, &Line]()
+	{
+		Line.TrimEndInline();
+		if (!Line.TrimStart().IsEmpty())
+		{
+			if (!Result.IsEmpty())
+			{
+				Result += TEXT("\n");
+			}
+			Result += Line;
+		}
+		Line.Reset();
+	};
+
+	const int32 Length = Code.Len();
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const TCHAR Char = Code[Index];
+
+		if (OpenQuote != 0)
+		{
+			Line += Char;
+			if (Char == TEXT('\\') && Index + 1 < Length)
+			{
+				Line += Code[++Index];
+			}
+			else if (Char == OpenQuote)
+			{
+				if (!bTripleQuoted)
+				{
+					OpenQuote = 0;
+				}
+				else if (Index + 2 < Length && Code[Index + 1] == OpenQuote && Code[Index + 2] == OpenQuote)
+				{
+					Line += Code[++Index];
+					Line += Code[++Index];
+					OpenQuote = 0;
+				}
+			}
+			else if (Char == TEXT('\n') && !bTripleQuoted)
+			{
+				// Unterminated single-line string
+				OpenQuote = 0;
+				Line.LeftChopInline(1);
+				CommitLine();
+			}
+			continue;
+		}
+
+		if (Char == TEXT('#'))
+		{
+			while (Index + 1 < Length && Code[Index + 1] != TEXT('\n'))
+			{
+				++Index;
+			}
+			continue;
+		}
+
+		if (Char == TEXT('\n'))
+		{
+			CommitLine();
+			continue;
+		}
+
+		Line += Char;
+		if (Char == TEXT('"') || Char == TEXT('\''))
+		{
+			OpenQuote = Char;
+			bTripleQuoted = Index + 2 < Length && Code[Index + 1] == Char && Code[Index + 2] == Char;
+			if (bTripleQuoted)
+			{
+				Line += Code[++Index];
+				Line += Code[++Index];
+			}
+		}
+	}
+
+	CommitLine();
+	return Result;
+}
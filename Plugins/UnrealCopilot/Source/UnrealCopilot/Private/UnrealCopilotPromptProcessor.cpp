@@ -2,9 +2,16 @@
 
 #include "UnrealCopilotPromptProcessor.h"
 #include "UnrealCopilotSettings.h"
+#include "UnrealCopilotWorkflowClassifier.h"
+#include "UnrealCopilotSelectionSummarizer.h"
+#include "UnrealCopilotLevelCensusSubsystem.h"
+#include "UnrealCopilotExecutionManager.h"
+#include "UnrealCopilotCodeBlockExtractor.h"
+#include "UnrealCopilotPatternScanner.h"
 #include "Engine/Engine.h"
 #include "Engine/World.h"
 #include "Engine/Level.h"
+#include "GameFramework/Actor.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
@@ -74,8 +81,39 @@ FString UUnrealCopilotPromptProcessor::BuildSystemPrompt(const FPromptContext& C
 		SystemPrompt += FString::Printf(TEXT("\nCurrent Level: %s"), *Context.CurrentLevel);
 	}
 
+	// Only pack the context sources relevant to the workflow; with tools the model fetches them on demand
+	const EPromptContextSource ContextSources = Context.bToolCallingEnabled ? EPromptContextSource::None : GetContextSourcesForWorkflow(Context.WorkflowType);
+
+	if (Context.bToolCallingEnabled)
+	{
+		if (Context.SelectedActorCount > 0)
+		{
+			SystemPrompt += FString::Printf(TEXT("\n%d actors are selected."), Context.SelectedActorCount);
+		}
+		SystemPrompt += TEXT("\n\nEditor context is not included up front. When the task depends on it, call the provided tools to search assets, look up actors, check Python API signatures, or summarize the level before writing code.");
+	}
+
+	// Add level census context
+	if (EnumHasAnyFlags(ContextSources, EPromptContextSource::LevelCensus) && !Context.LevelSummary.IsEmpty())
+	{
+		SystemPrompt += TEXT("\n\nLevel Contents:");
+		SystemPrompt += Context.LevelSummary;
+	}
+
+	// Add actors around the editor camera
+	if (EnumHasAnyFlags(ContextSources, EPromptContextSource::NearbyActors) && !Context.NearbyActorsSummary.IsEmpty())
+	{
+		SystemPrompt += TEXT("\n\nActors Near The Viewport Camera:");
+		SystemPrompt += Context.NearbyActorsSummary;
+	}
+
 	// Add selected actors context
-	if (Context.SelectedActors.Num() > 0)
+	if (EnumHasAnyFlags(ContextSources, EPromptContextSource::SelectedActors) && !Context.SelectionSummary.IsEmpty())
+	{
+		SystemPrompt += FString::Printf(TEXT("\n\nCurrently Selected Actors (%d):"), Context.SelectedActorCount);
+		SystemPrompt += Context.SelectionSummary;
+	}
+	else if (EnumHasAnyFlags(ContextSources, EPromptContextSource::SelectedActors) && Context.SelectedActors.Num() > 0)
 	{
 		SystemPrompt += TEXT("\n\nCurrently Selected Actors:");
 		for (const FString& Actor : Context.SelectedActors)
@@ -85,7 +123,8 @@ FString UUnrealCopilotPromptProcessor::BuildSystemPrompt(const FPromptContext& C
 	}
 
 	// Add available assets context
-	if (Context.AvailableAssets.Num() > 0 && Context.AvailableAssets.Num() <= 20) // Limit to avoid token overflow
+	if (EnumHasAnyFlags(ContextSources, EPromptContextSource::AvailableAssets) &&
+		Context.AvailableAssets.Num() > 0 && Context.AvailableAssets.Num() <= 20) // Limit to avoid token overflow
 	{
 		SystemPrompt += TEXT("\n\nAvailable Assets:");
 		for (int32 i = 0; i < FMath::Min(Context.AvailableAssets.Num(), 20); ++i)
@@ -97,6 +136,13 @@ FString UUnrealCopilotPromptProcessor::BuildSystemPrompt(const FPromptContext& C
 	// Add workflow-specific context
 	SystemPrompt += GetWorkflowSpecificContext(Context.WorkflowType);
 
+	// Structured output replaces the fenced-code answer format of the template
+	if (GetStructuredOutputFormat() != EStructuredOutputFormat::None)
+	{
+		SystemPrompt += TEXT("\n\nRespond with a JSON object instead of a code block: put the executable Python script, without markdown fences, in \"code\", ")
+			TEXT("a one or two sentence summary of what it does in \"explanation\", and the asset paths it creates or modifies in \"touched_assets\".");
+	}
+
 	return SystemPrompt;
 }
 
@@ -116,12 +162,34 @@ FPromptContext UUnrealCopilotPromptProcessor::GatherCurrentContext()
 	
 	// Gather level info
 	Context.CurrentLevel = GetCurrentLevelInfo();
+
+	// Level census is maintained incrementally by its subsystem, so this only reads a cached summary
+	if (UUnrealCopilotLevelCensusSubsystem* LevelCensus = UUnrealCopilotLevelCensusSubsystem::Get())
+	{
+		Context.LevelSummary = LevelCensus->GetLevelSummary();
+
+		UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+		if (Settings->NearbyActorCount > 0)
+		{
+			Context.NearbyActorsSummary = LevelCensus->GetNearbyActorsSummary(Settings->NearbyActorCount, Settings->NearbyActorMaxDistance, Settings->bNearbyActorsInViewOnly);
+		}
+	}
 	
 	// Gather available assets
 	Context.AvailableAssets = GetAvailableAssets();
 	
-	// Gather selected actors
-	Context.SelectedActors = GetSelectedActors();
+	// Gather selected actors, aggregating large selections so the prompt stays bounded
+	TArray<AActor*> SelectedActorObjects = GetSelectedActors();
+	if (SelectedActorObjects.Num() > 0)
+	{
+		UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+		FSelectionSummaryOptions SummaryOptions;
+		SummaryOptions.MaxDetailedActors = Settings->MaxDetailedSelectedActors;
+		SummaryOptions.MaxSampleActors = Settings->SelectionSampleSize;
+
+		Context.SelectedActorCount = SelectedActorObjects.Num();
+		Context.SelectionSummary = FUnrealCopilotSelectionSummarizer::Summarize(SelectedActorObjects, SummaryOptions, &Context.SelectedActors);
+	}
 
 	// Default workflow type
 	Context.WorkflowType = EUnrealCopilotWorkflowType::General;
@@ -133,6 +201,58 @@ FPromptContext UUnrealCopilotPromptProcessor::GatherCurrentContext()
 	return Context;
 }
 
+FPromptContext UUnrealCopilotPromptProcessor::GatherContextForPrompt(const FString& UserPrompt)
+{
+	FPromptContext Context = GatherCurrentContext();
+
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+	Context.bToolCallingEnabled = Settings->bEnableToolCalling;
+
+	if (Settings->bAutoDetectWorkflowType)
+	{
+		float Confidence = 0.0f;
+		EUnrealCopilotWorkflowType WorkflowType = ClassifyWorkflow(UserPrompt, Confidence);
+
+		// Fall back to General when the classifier is unsure, so no relevant context is dropped
+		Context.WorkflowType = Confidence >= Settings->WorkflowClassificationThreshold ? WorkflowType : EUnrealCopilotWorkflowType::General;
+		Context.WorkflowConfidence = Confidence;
+	}
+
+	return Context;
+}
+
+EUnrealCopilotWorkflowType UUnrealCopilotPromptProcessor::ClassifyWorkflow(const FString& UserPrompt, float& OutConfidence)
+{
+	FWorkflowClassification Classification = GetWorkflowClassifier().Classify(UserPrompt);
+	OutConfidence = Classification.Confidence;
+	return Classification.WorkflowType;
+}
+
+EPromptContextSource UUnrealCopilotPromptProcessor::GetContextSourcesForWorkflow(EUnrealCopilotWorkflowType WorkflowType)
+{
+	switch (WorkflowType)
+	{
+	case EUnrealCopilotWorkflowType::MaterialCreation:
+		return EPromptContextSource::AvailableAssets | EPromptContextSource::SelectedActors;
+
+	case EUnrealCopilotWorkflowType::LevelEditing:
+		return EPromptContextSource::SelectedActors | EPromptContextSource::LevelCensus | EPromptContextSource::NearbyActors;
+
+	case EUnrealCopilotWorkflowType::AssetManagement:
+		return EPromptContextSource::AvailableAssets;
+
+	case EUnrealCopilotWorkflowType::Animation:
+		return EPromptContextSource::SelectedActors | EPromptContextSource::AvailableAssets;
+
+	case EUnrealCopilotWorkflowType::VFX:
+		return EPromptContextSource::SelectedActors | EPromptContextSource::AvailableAssets | EPromptContextSource::NearbyActors;
+
+	case EUnrealCopilotWorkflowType::General:
+	default:
+		return EPromptContextSource::All;
+	}
+}
+
 bool UUnrealCopilotPromptProcessor::ValidateUserPrompt(const FString& UserPrompt, FString& OutErrorMessage)
 {
 	// Check for empty prompt
@@ -150,23 +270,13 @@ bool UUnrealCopilotPromptProcessor::ValidateUserPrompt(const FString& UserPrompt
 	}
 
 	// Check for potentially harmful content patterns
-	TArray<FString> ProhibitedPatterns = {
-		TEXT("DELETE"),
-		TEXT("DROP TABLE"),
-		TEXT("TRUNCATE"),
-		TEXT("format C:"),
-		TEXT("rm -rf"),
-		TEXT("del /f")
-	};
-
-	FString UpperPrompt = UserPrompt.ToUpper();
-	for (const FString& Pattern : ProhibitedPatterns)
+	const TSharedRef<const FUnrealCopilotPatternScanner> Scanner = FUnrealCopilotSafetyScanners::GetPromptScanner();
+	TArray<FPatternScanHit> Hits;
+	Scanner->Scan(UserPrompt, EPatternScanMode::PlainText, Hits, 1);
+	if (Hits.Num() > 0)
 	{
-		if (UpperPrompt.Contains(Pattern))
-		{
-			OutErrorMessage = FString::Printf(TEXT("Prompt contains prohibited pattern: %s"), *Pattern);
-			return false;
-		}
+		OutErrorMessage = FString::Printf(TEXT("%s: %s"), *Scanner->GetRule(Hits[0].RuleIndex).Reason, *Scanner->GetRule(Hits[0].RuleIndex).Pattern);
+		return false;
 	}
 
 	return true;
@@ -174,54 +284,98 @@ bool UUnrealCopilotPromptProcessor::ValidateUserPrompt(const FString& UserPrompt
 
 FString UUnrealCopilotPromptProcessor::ExtractPythonCode(const FString& LLMResponse)
 {
-	FString PythonCode;
-	
-	// Look for Python code blocks
-	FString SearchString = TEXT("```python");
-	int32 StartIndex = LLMResponse.Find(SearchString, ESearchCase::IgnoreCase);
-	
-	if (StartIndex != INDEX_NONE)
+	FUnrealCopilotCodeBlockExtractor Extractor;
+	Extractor.AppendText(LLMResponse);
+	Extractor.Finish();
+
+	// Assume the entire response is code if no code blocks found
+	if (!Extractor.HasBlocks())
 	{
-		StartIndex += SearchString.Len();
-		
-		// Find the end of the code block
-		int32 EndIndex = LLMResponse.Find(TEXT("```"), ESearchCase::IgnoreCase, ESearchDir::FromStart, StartIndex);
-		
-		if (EndIndex != INDEX_NONE)
-		{
-			PythonCode = LLMResponse.Mid(StartIndex, EndIndex - StartIndex);
-		}
-		else
+		return LLMResponse.TrimStartAndEnd();
+	}
+
+	FString PythonCode = Extractor.GetCode(UUnrealCopilotSettings::Get()->CodeBlockSelection);
+	if (PythonCode.IsEmpty())
+	{
+		// Only blocks tagged with another language; the first one is the best guess
+		PythonCode = Extractor.GetBlocks()[0].Code.TrimStartAndEnd();
+	}
+
+	return PythonCode;
+}
+
+EStructuredOutputFormat UUnrealCopilotPromptProcessor::GetStructuredOutputFormat() const
+{
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+	if (!Settings->bUseStructuredOutput || Settings->ShouldStreamResponses())
+	{
+		return EStructuredOutputFormat::None;
+	}
+
+	// Strict schemas need a recent model; the older Turbo models only have JSON mode and GPT-4 has neither
+	switch (Settings->OpenAIModel)
+	{
+	case EOpenAIModel::GPT5:
+		return EStructuredOutputFormat::JsonSchema;
+	case EOpenAIModel::GPT4Turbo:
+	case EOpenAIModel::GPT35Turbo:
+		return EStructuredOutputFormat::JsonObject;
+	default:
+		return EStructuredOutputFormat::None;
+	}
+}
+
+bool UUnrealCopilotPromptProcessor::ParseStructuredCodeResponse(const FString& Content, FUnrealCopilotCodeResponse& OutResponse)
+{
+	FString Json = Content.TrimStartAndEnd();
+
+	// JSON mode occasionally still wraps the object in a fence
+	if (Json.StartsWith(TEXT("```")))
+	{
+		int32 FirstLineEnd = INDEX_NONE;
+		Json.FindChar(TEXT('\n'), FirstLineEnd);
+		const int32 ClosingFence = Json.Find(TEXT("```"), ESearchCase::CaseSensitive, ESearchDir::FromEnd);
+		if (FirstLineEnd == INDEX_NONE || ClosingFence <= FirstLineEnd)
 		{
-			// No closing ```, take everything after the opening
-			PythonCode = LLMResponse.Mid(StartIndex);
+			return false;
 		}
+		Json = Json.Mid(FirstLineEnd + 1, ClosingFence - FirstLineEnd - 1);
 	}
-	else
+
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		return false;
+	}
+
+	FString Code;
+	if (!JsonObject->TryGetStringField(TEXT("code"), Code))
+	{
+		return false;
+	}
+
+	// Models sometimes fence the code field despite the instructions
+	OutResponse.Code = Code.Contains(TEXT("```")) ? ExtractPythonCode(Code) : Code.TrimStartAndEnd();
+
+	OutResponse.Explanation.Empty();
+	JsonObject->TryGetStringField(TEXT("explanation"), OutResponse.Explanation);
+
+	OutResponse.TouchedAssets.Reset();
+	const TArray<TSharedPtr<FJsonValue>>* TouchedAssetsArray;
+	if (JsonObject->TryGetArrayField(TEXT("touched_assets"), TouchedAssetsArray))
 	{
-		// Try alternative patterns
-		SearchString = TEXT("```");
-		StartIndex = LLMResponse.Find(SearchString);
-		if (StartIndex != INDEX_NONE)
+		for (const TSharedPtr<FJsonValue>& AssetValue : *TouchedAssetsArray)
 		{
-			StartIndex += SearchString.Len();
-			int32 EndIndex = LLMResponse.Find(TEXT("```"), ESearchCase::IgnoreCase, ESearchDir::FromStart, StartIndex);
-			if (EndIndex != INDEX_NONE)
+			FString AssetPath;
+			if (AssetValue.IsValid() && AssetValue->TryGetString(AssetPath) && !AssetPath.IsEmpty())
 			{
-				PythonCode = LLMResponse.Mid(StartIndex, EndIndex - StartIndex);
+				OutResponse.TouchedAssets.Add(AssetPath);
 			}
 		}
-		else
-		{
-			// Assume the entire response is code if no code blocks found
-			PythonCode = LLMResponse;
-		}
 	}
 
-	// Clean up the extracted code
-	PythonCode = PythonCode.TrimStartAndEnd();
-	
-	return PythonCode;
+	return true;
 }
 
 void UUnrealCopilotPromptProcessor::AddToConversationHistory(const FString& UserPrompt, const FString& LLMResponse)
@@ -231,6 +385,13 @@ void UUnrealCopilotPromptProcessor::AddToConversationHistory(const FString& User
 		*LLMResponse.Left(500));
 	
 	ConversationHistory.Add(HistoryEntry);
+
+	// Learn from the exchange: label the prompt by the editor APIs the response used
+	EUnrealCopilotWorkflowType InferredWorkflow = FUnrealCopilotWorkflowClassifier::InferWorkflowFromCode(LLMResponse);
+	if (InferredWorkflow != EUnrealCopilotWorkflowType::General)
+	{
+		GetWorkflowClassifier().AddTrainingExample(UserPrompt, InferredWorkflow);
+	}
 	
 	// Trim history if it exceeds max entries
 	while (ConversationHistory.Num() > MaxConversationHistory)
@@ -298,27 +459,87 @@ TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateOpenAIRequestPayloa
 	}
 	// For GPT-5, omit temperature parameter to use default (1.0)
 	
+	// Compress both messages together so context repeated in the user message is sent once
+	FString SystemContent = SystemPrompt;
+	FString UserContent = UserPrompt;
+	CompressPrompt(SystemContent, UserContent);
+
 	// Create messages array
 	TArray<TSharedPtr<FJsonValue>> Messages;
 	
 	// Add system message
 	TSharedPtr<FJsonObject> SystemMessage = MakeShareable(new FJsonObject);
 	SystemMessage->SetStringField(TEXT("role"), TEXT("system"));
-	SystemMessage->SetStringField(TEXT("content"), SystemPrompt);
+	SystemMessage->SetStringField(TEXT("content"), SystemContent);
 	Messages.Add(MakeShareable(new FJsonValueObject(SystemMessage)));
 	
 	// Add user message
 	TSharedPtr<FJsonObject> UserMessage = MakeShareable(new FJsonObject);
 	UserMessage->SetStringField(TEXT("role"), TEXT("user"));
-	UserMessage->SetStringField(TEXT("content"), UserPrompt);
+	UserMessage->SetStringField(TEXT("content"), UserContent);
 	Messages.Add(MakeShareable(new FJsonValueObject(UserMessage)));
 	
 	JsonObject->SetArrayField(TEXT("messages"), Messages);
+
+	// Ask for {code, explanation, touched_assets} so the code never has to be dug out of free text
+	const EStructuredOutputFormat OutputFormat = GetStructuredOutputFormat();
+	if (OutputFormat == EStructuredOutputFormat::JsonSchema)
+	{
+		TSharedPtr<FJsonObject> SchemaObj = MakeShareable(new FJsonObject);
+		SchemaObj->SetStringField(TEXT("name"), TEXT("unreal_python_script"));
+		SchemaObj->SetBoolField(TEXT("strict"), true);
+		SchemaObj->SetObjectField(TEXT("schema"), CreateCodeResponseSchema());
+
+		TSharedPtr<FJsonObject> ResponseFormatObj = MakeShareable(new FJsonObject);
+		ResponseFormatObj->SetStringField(TEXT("type"), TEXT("json_schema"));
+		ResponseFormatObj->SetObjectField(TEXT("json_schema"), SchemaObj);
+		JsonObject->SetObjectField(TEXT("response_format"), ResponseFormatObj);
+	}
+	else if (OutputFormat == EStructuredOutputFormat::JsonObject)
+	{
+		TSharedPtr<FJsonObject> ResponseFormatObj = MakeShareable(new FJsonObject);
+		ResponseFormatObj->SetStringField(TEXT("type"), TEXT("json_object"));
+		JsonObject->SetObjectField(TEXT("response_format"), ResponseFormatObj);
+	}
 	
 	return JsonObject;
 }
 
-TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateGPT5ResponsesPayload(const FString& UserPrompt)
+TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateCodeResponseSchema()
+{
+	auto MakeProperty = [](const TCHAR* Type, const TCHAR* Description)
+	{
+		TSharedPtr<FJsonObject> Property = MakeShareable(new FJsonObject);
+		Property->SetStringField(TEXT("type"), Type);
+		Property->SetStringField(TEXT("description"), Description);
+		return Property;
+	};
+
+	TSharedPtr<FJsonObject> TouchedAssets = MakeProperty(TEXT("array"), TEXT("Asset paths the script creates or modifies, e.g. /Game/Materials/M_Rock"));
+	TSharedPtr<FJsonObject> AssetPathItem = MakeShareable(new FJsonObject);
+	AssetPathItem->SetStringField(TEXT("type"), TEXT("string"));
+	TouchedAssets->SetObjectField(TEXT("items"), AssetPathItem);
+
+	TSharedPtr<FJsonObject> Properties = MakeShareable(new FJsonObject);
+	Properties->SetObjectField(TEXT("code"), MakeProperty(TEXT("string"), TEXT("Executable Unreal Engine Python script without markdown fences")));
+	Properties->SetObjectField(TEXT("explanation"), MakeProperty(TEXT("string"), TEXT("One or two sentence summary of what the script does")));
+	Properties->SetObjectField(TEXT("touched_assets"), TouchedAssets);
+
+	// Strict mode requires every property to be listed as required and no extra properties
+	TArray<TSharedPtr<FJsonValue>> Required;
+	Required.Add(MakeShareable(new FJsonValueString(TEXT("code"))));
+	Required.Add(MakeShareable(new FJsonValueString(TEXT("explanation"))));
+	Required.Add(MakeShareable(new FJsonValueString(TEXT("touched_assets"))));
+
+	TSharedPtr<FJsonObject> Schema = MakeShareable(new FJsonObject);
+	Schema->SetStringField(TEXT("type"), TEXT("object"));
+	Schema->SetObjectField(TEXT("properties"), Properties);
+	Schema->SetArrayField(TEXT("required"), Required);
+	Schema->SetBoolField(TEXT("additionalProperties"), false);
+	return Schema;
+}
+
+TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateGPT5ResponsesPayload(const FString& UserPrompt, const FPromptContext& Context)
 {
 	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
 	
@@ -328,8 +549,9 @@ TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateGPT5ResponsesPayloa
 	JsonObject->SetStringField(TEXT("model"), Settings->GetModelNameForAPI());
 	
 	// Build context + user messages (Responses API expects structured input rather than raw string prompt)
-	FPromptContext Context = GatherCurrentContext();
 	FString SystemPrompt = BuildSystemPrompt(Context);
+	FString UserContent = UserPrompt;
+	CompressPrompt(SystemPrompt, UserContent);
 
 	// Construct input array: [{role: system, content: ...}, {role: user, content: ...}]
 	TArray<TSharedPtr<FJsonValue>> InputArray;
@@ -342,7 +564,7 @@ TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateGPT5ResponsesPayloa
 	{
 		TSharedPtr<FJsonObject> UserObj = MakeShareable(new FJsonObject);
 		UserObj->SetStringField(TEXT("role"), TEXT("user"));
-		UserObj->SetStringField(TEXT("content"), UserPrompt);
+		UserObj->SetStringField(TEXT("content"), UserContent);
 		InputArray.Add(MakeShareable(new FJsonValueObject(UserObj)));
 	}
 	JsonObject->SetArrayField(TEXT("input"), InputArray);
@@ -369,29 +591,99 @@ TSharedPtr<FJsonObject> UUnrealCopilotPromptProcessor::CreateGPT5ResponsesPayloa
 	case EGPT5Verbosity::Medium: TextObj->SetStringField(TEXT("verbosity"), TEXT("medium")); break;
 	case EGPT5Verbosity::High: TextObj->SetStringField(TEXT("verbosity"), TEXT("high")); break;
 	}
+	// Structured output format lives next to verbosity in the text object
+	if (GetStructuredOutputFormat() == EStructuredOutputFormat::JsonSchema)
+	{
+		TSharedPtr<FJsonObject> FormatObj = MakeShareable(new FJsonObject);
+		FormatObj->SetStringField(TEXT("type"), TEXT("json_schema"));
+		FormatObj->SetStringField(TEXT("name"), TEXT("unreal_python_script"));
+		FormatObj->SetBoolField(TEXT("strict"), true);
+		FormatObj->SetObjectField(TEXT("schema"), CreateCodeResponseSchema());
+		TextObj->SetObjectField(TEXT("format"), FormatObj);
+	}
 	JsonObject->SetObjectField(TEXT("text"), TextObj);
 
 	return JsonObject;
 }
 
+void UUnrealCopilotPromptProcessor::CompressPrompt(FString& SystemPrompt, FString& UserPrompt)
+{
+	UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
+	if (!Settings->bEnablePromptCompression)
+	{
+		LastCompressionStats = FPromptCompressionStats();
+		LastCompressionStats.OriginalTokens = FUnrealCopilotPromptCompressor::EstimateTokens(SystemPrompt) + FUnrealCopilotPromptCompressor::EstimateTokens(UserPrompt);
+		LastCompressionStats.CompressedTokens = LastCompressionStats.OriginalTokens;
+		return;
+	}
+
+	FPromptCompressionOptions Options;
+	Options.TokenBudget = Settings->PromptTokenBudget;
+
+	// Older history and bulk context go first when over budget; the request itself is never trimmed
+	Options.SectionPolicies = {
+		{ TEXT("User Request:"), 1.0f, false },
+		{ TEXT("Previous Conversation:"), 0.3f, true },
+		{ TEXT("Available Assets:"), 0.5f, false },
+		{ TEXT("Actors Near The Viewport Camera:"), 0.5f, false },
+		{ TEXT("Level Contents:"), 0.6f, false },
+		{ TEXT("Relevant API:"), 0.7f, false },
+		{ TEXT("Currently Selected Actors"), 0.8f, false }
+	};
+
+	FString Segments[] = { MoveTemp(SystemPrompt), MoveTemp(UserPrompt) };
+	LastCompressionStats = FUnrealCopilotPromptCompressor::Compress(Segments, Options);
+	SystemPrompt = MoveTemp(Segments[0]);
+	UserPrompt = MoveTemp(Segments[1]);
+}
+
 FString UUnrealCopilotPromptProcessor::GetWorkflowSpecificContext(EUnrealCopilotWorkflowType WorkflowType) const
 {
 	switch (WorkflowType)
 	{
 	case EUnrealCopilotWorkflowType::MaterialCreation:
-		return TEXT("\n\nFocus on material creation workflows using unreal.MaterialEditingLibrary and related classes.");
+		return TEXT("\n\nFocus on material creation workflows using unreal.MaterialEditingLibrary and related classes.")
+			TEXT("\nRelevant API:")
+			TEXT("\n- unreal.AssetToolsHelpers.get_asset_tools().create_asset(asset_name, package_path, asset_class, factory)")
+			TEXT("\n- unreal.MaterialEditingLibrary.create_material_expression(material, expression_class, node_pos_x=0, node_pos_y=0)")
+			TEXT("\n- unreal.MaterialEditingLibrary.connect_material_property(from_expression, from_output_name, property)")
+			TEXT("\n- unreal.MaterialEditingLibrary.connect_material_expressions(from_expression, from_output_name, to_expression, to_input_name)")
+			TEXT("\n- unreal.MaterialEditingLibrary.set_material_instance_scalar_parameter_value(instance, parameter_name, value)")
+			TEXT("\n- unreal.MaterialEditingLibrary.recompile_material(material)");
 		
 	case EUnrealCopilotWorkflowType::LevelEditing:
-		return TEXT("\n\nFocus on level editing operations using unreal.EditorLevelLibrary and actor manipulation.");
+		return TEXT("\n\nFocus on level editing operations using unreal.EditorLevelLibrary and actor manipulation.")
+			TEXT("\nRelevant API:")
+			TEXT("\n- unreal.get_editor_subsystem(unreal.EditorActorSubsystem)")
+			TEXT("\n- EditorActorSubsystem.spawn_actor_from_class(actor_class, location, rotation=[0.0, 0.0, 0.0], transient=False)")
+			TEXT("\n- EditorActorSubsystem.get_selected_level_actors() / get_all_level_actors() / destroy_actor(actor_to_destroy)")
+			TEXT("\n- Actor.set_actor_location(new_location, sweep, teleport) / set_actor_rotation(new_rotation, teleport_physics)")
+			TEXT("\n- Actor.set_folder_path(new_folder_path)");
 		
 	case EUnrealCopilotWorkflowType::AssetManagement:
-		return TEXT("\n\nFocus on asset management using unreal.EditorAssetLibrary and content browser operations.");
+		return TEXT("\n\nFocus on asset management using unreal.EditorAssetLibrary and content browser operations.")
+			TEXT("\nRelevant API:")
+			TEXT("\n- unreal.EditorAssetLibrary.list_assets(directory_path, recursive=True, include_folder=False)")
+			TEXT("\n- unreal.EditorAssetLibrary.load_asset(asset_path) / does_asset_exist(asset_path)")
+			TEXT("\n- unreal.EditorAssetLibrary.rename_asset(source_asset_path, destination_asset_path)")
+			TEXT("\n- unreal.EditorAssetLibrary.duplicate_asset(source_asset_path, destination_asset_path)")
+			TEXT("\n- unreal.EditorAssetLibrary.save_asset(asset_to_save, only_if_is_dirty=True)")
+			TEXT("\n- unreal.AssetRegistryHelpers.get_asset_registry().get_assets_by_path(package_path, recursive=False)");
 		
 	case EUnrealCopilotWorkflowType::Animation:
-		return TEXT("\n\nFocus on animation workflows including skeletal mesh, animation blueprints, and sequences.");
+		return TEXT("\n\nFocus on animation workflows including skeletal mesh, animation blueprints, and sequences.")
+			TEXT("\nRelevant API:")
+			TEXT("\n- SkeletalMeshComponent.play_animation(new_anim_to_play, looping) / set_animation(new_anim_to_play)")
+			TEXT("\n- unreal.LevelSequenceEditorBlueprintLibrary.get_current_level_sequence()")
+			TEXT("\n- unreal.MovieSceneSequenceExtensions.add_possessable(sequence, object_to_possess)")
+			TEXT("\n- unreal.MovieSceneBindingExtensions.add_track(binding, track_type)");
 		
 	case EUnrealCopilotWorkflowType::VFX:
-		return TEXT("\n\nFocus on visual effects including particle systems, Niagara, and material effects.");
+		return TEXT("\n\nFocus on visual effects including particle systems, Niagara, and material effects.")
+			TEXT("\nRelevant API:")
+			TEXT("\n- unreal.get_editor_subsystem(unreal.EditorActorSubsystem).spawn_actor_from_class(unreal.NiagaraActor, location)")
+			TEXT("\n- NiagaraComponent.set_asset(asset)")
+			TEXT("\n- NiagaraComponent.set_variable_float(variable_name, value) / set_variable_linear_color(variable_name, value)");
 		
 	case EUnrealCopilotWorkflowType::General:
 	default:
@@ -462,9 +754,27 @@ TArray<FString> UUnrealCopilotPromptProcessor::GetAvailableAssets() const
 	return Assets;
 }
 
-TArray<FString> UUnrealCopilotPromptProcessor::GetSelectedActors() const
+FUnrealCopilotWorkflowClassifier& UUnrealCopilotPromptProcessor::GetWorkflowClassifier()
+{
+	if (!WorkflowClassifier.IsValid())
+	{
+		WorkflowClassifier = MakeShared<FUnrealCopilotWorkflowClassifier>();
+
+		// Refine the bundled model with the scripts this project ran most recently
+		if (UUnrealCopilotExecutionManager* ExecutionManager = UUnrealCopilotExecutionManager::GetInstance())
+		{
+			constexpr int32 MaxTrainingEntries = 1000;
+			TArray<FPythonExecutionHistoryEntry> RecentHistory;
+			ExecutionManager->GetHistoryPage(ExecutionManager->GetHistoryCount() - MaxTrainingEntries, MaxTrainingEntries, RecentHistory);
+			WorkflowClassifier->TrainFromExecutionHistory(RecentHistory);
+		}
+	}
+	return *WorkflowClassifier;
+}
+
+TArray<AActor*> UUnrealCopilotPromptProcessor::GetSelectedActors() const
 {
-	TArray<FString> SelectedActorNames;
+	TArray<AActor*> SelectedActors;
 	
 	#if WITH_EDITOR
 	if (GEditor)
@@ -472,16 +782,10 @@ TArray<FString> UUnrealCopilotPromptProcessor::GetSelectedActors() const
 		USelection* Selection = GEditor->GetSelectedActors();
 		if (Selection)
 		{
-			for (FSelectionIterator Iter(*Selection); Iter; ++Iter)
-			{
-				if (AActor* Actor = Cast<AActor>(*Iter))
-				{
-					SelectedActorNames.Add(Actor->GetName());
-				}
-			}
+			Selection->GetSelectedObjects<AActor>(SelectedActors);
 		}
 	}
 	#endif
 	
-	return SelectedActorNames;
+	return SelectedActors;
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotPythonBridge.h"
+
+#if WITH_PYTHON
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+THIRD_PARTY_INCLUDES_START
+#pragma push_macro("check")
+#undef check
+#include "Python.h"
+#pragma pop_macro("check")
+THIRD_PARTY_INCLUDES_END
+#endif
+
+#if WITH_PYTHON
+namespace UnrealCopilotPythonBridge
+{
+	static const char* RuntimeModuleName = "unreal_copilot_runtime";
+
+	/** run_source statuses */
+	static constexpr long RuntimeRunOk = 0;
+	static constexpr long RuntimeRunSyntaxError = 1;
+
+	/** Releases a new reference when it goes out of scope */
+	struct FPyObjectPtr
+	{
+		explicit FPyObjectPtr(PyObject* InObject)
+			: Object(InObject)
+		{
+		}
+
+		~FPyObjectPtr()
+		{
+			Py_XDECREF(Object);
+		}
+
+		FPyObjectPtr(const FPyObjectPtr&) = delete;
+		FPyObjectPtr& operator=(const FPyObjectPtr&) = delete;
+
+		PyObject* Object;
+	};
+
+	/** Holds the GIL for the lifetime of the scope */
+	struct FScopedGIL
+	{
+		FScopedGIL()
+			: State(PyGILState_Ensure())
+		{
+		}
+
+		~FScopedGIL()
+		{
+			PyGILState_Release(State);
+		}
+
+		PyGILState_STATE State;
+	};
+
+	static PyObject* NewString(const FString& Text)
+	{
+		const FTCHARToUTF8 Utf8Text(*Text);
+		return PyUnicode_FromStringAndSize(Utf8Text.Get(), Utf8Text.Length());
+	}
+
+	static FString ToString(PyObject* Object)
+	{
+		const char* Utf8Text = Object ? PyUnicode_AsUTF8(Object) : nullptr;
+		return Utf8Text ? FString(UTF8_TO_TCHAR(Utf8Text)) : FString();
+	}
+
+	static int32 GetTupleInt(PyObject* Tuple, Py_ssize_t Index)
+	{
+		return static_cast<int32>(PyLong_AsLong(PyTuple_GetItem(Tuple, Index)));
+	}
+
+	/** Clear the pending Python error, printing it to stderr unless it is an interrupt */
+	static EPythonBridgeStatus HandleError()
+	{
+		if (PyErr_ExceptionMatches(PyExc_KeyboardInterrupt))
+		{
+			PyErr_Clear();
+			return EPythonBridgeStatus::Interrupted;
+		}
+
+		// PyErr_Print exits the process on SystemExit, so it is reported by hand
+		if (PyErr_ExceptionMatches(PyExc_SystemExit))
+		{
+			PyObject* Type = nullptr;
+			PyObject* Value = nullptr;
+			PyObject* Traceback = nullptr;
+			PyErr_Fetch(&Type, &Value, &Traceback);
+			PySys_FormatStderr("SystemExit: %S\n", Value ? Value : Py_None);
+			Py_XDECREF(Type);
+			Py_XDECREF(Value);
+			Py_XDECREF(Traceback);
+			return EPythonBridgeStatus::Failed;
+		}
+
+		PyErr_Print();
+		return EPythonBridgeStatus::Failed;
+	}
+
+	/**
+	 * Call a function of the runtime module
+	 * @param OutResult - New reference to the return value, or null if the call raised
+	 */
+	static EPythonBridgeStatus CallRuntime(const char* FunctionName, PyObject* Args, PyObject*& OutResult)
+	{
+		OutResult = nullptr;
+		if (!Args)
+		{
+			return HandleError();
+		}
+
+		FPyObjectPtr Module(PyImport_ImportModule(RuntimeModuleName));
+		if (!Module.Object)
+		{
+			return HandleError();
+		}
+
+		FPyObjectPtr Function(PyObject_GetAttrString(Module.Object, FunctionName));
+		if (!Function.Object)
+		{
+			return HandleError();
+		}
+
+		OutResult = PyObject_CallObject(Function.Object, Args);
+		return OutResult ? EPythonBridgeStatus::Succeeded : HandleError();
+	}
+}
+#endif
+
+EPythonBridgeStatus FUnrealCopilotPythonBridge::RunSource(const FString& Source, const FString& CacheKey, int32 SessionId, FPythonSyntaxError& OutSyntaxError)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return EPythonBridgeStatus::Unavailable;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(Py_BuildValue("(NNi)", NewString(Source), NewString(CacheKey), SessionId));
+	PyObject* ReturnValue = nullptr;
+	const EPythonBridgeStatus CallStatus = CallRuntime("run_source", Args.Object, ReturnValue);
+	FPyObjectPtr Result(ReturnValue);
+	if (CallStatus != EPythonBridgeStatus::Succeeded)
+	{
+		return CallStatus;
+	}
+
+	// run_source returns (status, line, column, message)
+	const long RunStatus = PyLong_AsLong(PyTuple_GetItem(Result.Object, 0));
+	if (RunStatus == RuntimeRunSyntaxError)
+	{
+		OutSyntaxError.Line = GetTupleInt(Result.Object, 1);
+		OutSyntaxError.Column = GetTupleInt(Result.Object, 2);
+		OutSyntaxError.Message = ToString(PyTuple_GetItem(Result.Object, 3));
+		return EPythonBridgeStatus::SyntaxError;
+	}
+	return RunStatus == RuntimeRunOk ? EPythonBridgeStatus::Succeeded : EPythonBridgeStatus::Failed;
+#else
+	return EPythonBridgeStatus::Unavailable;
+#endif
+}
+
+EPythonBridgeStatus FUnrealCopilotPythonBridge::StartJob(int32 JobId, const FString& Source, const FString& CacheKey, int32 SessionId, int32& OutTotalStatements)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return EPythonBridgeStatus::Unavailable;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(Py_BuildValue("(iNNi)", JobId, NewString(Source), NewString(CacheKey), SessionId));
+	PyObject* ReturnValue = nullptr;
+	const EPythonBridgeStatus CallStatus = CallRuntime("start_job", Args.Object, ReturnValue);
+	FPyObjectPtr Result(ReturnValue);
+	if (CallStatus == EPythonBridgeStatus::Succeeded)
+	{
+		OutTotalStatements = static_cast<int32>(PyLong_AsLong(Result.Object));
+	}
+	return CallStatus;
+#else
+	return EPythonBridgeStatus::Unavailable;
+#endif
+}
+
+EPythonBridgeStatus FUnrealCopilotPythonBridge::StepJob(int32 JobId, double BudgetSeconds, FPythonJobStep& OutStep)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return EPythonBridgeStatus::Unavailable;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(Py_BuildValue("(id)", JobId, BudgetSeconds));
+	PyObject* ReturnValue = nullptr;
+	const EPythonBridgeStatus CallStatus = CallRuntime("step_job", Args.Object, ReturnValue);
+	FPyObjectPtr Result(ReturnValue);
+	if (CallStatus != EPythonBridgeStatus::Succeeded)
+	{
+		OutStep.State = EPythonJobState::Error;
+		return CallStatus;
+	}
+
+	// step_job returns (state, statements done, total statements, steps done) using the same values as EPythonJobState
+	OutStep.State = static_cast<EPythonJobState>(FMath::Clamp(GetTupleInt(Result.Object, 0), 0, static_cast<int32>(EPythonJobState::Error)));
+	OutStep.StatementsCompleted = GetTupleInt(Result.Object, 1);
+	OutStep.TotalStatements = GetTupleInt(Result.Object, 2);
+	OutStep.StepsCompleted = GetTupleInt(Result.Object, 3);
+	return CallStatus;
+#else
+	return EPythonBridgeStatus::Unavailable;
+#endif
+}
+
+void FUnrealCopilotPythonBridge::CancelJob(int32 JobId)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(Py_BuildValue("(i)", JobId));
+	PyObject* ReturnValue = nullptr;
+	CallRuntime("cancel_job", Args.Object, ReturnValue);
+	Py_XDECREF(ReturnValue);
+#endif
+}
+
+void FUnrealCopilotPythonBridge::ConfigureCodeCache(int32 Capacity)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(Py_BuildValue("(i)", FMath::Max(Capacity, 0)));
+	PyObject* ReturnValue = nullptr;
+	CallRuntime("configure_code_cache", Args.Object, ReturnValue);
+	Py_XDECREF(ReturnValue);
+#endif
+}
+
+bool FUnrealCopilotPythonBridge::GetCodeCacheStats(FPythonCodeCacheStats& OutStats)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return false;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(PyTuple_New(0));
+	PyObject* ReturnValue = nullptr;
+	const EPythonBridgeStatus CallStatus = CallRuntime("get_code_cache_stats", Args.Object, ReturnValue);
+	FPyObjectPtr Result(ReturnValue);
+	if (CallStatus != EPythonBridgeStatus::Succeeded)
+	{
+		return false;
+	}
+
+	// get_code_cache_stats returns (hits, misses, entries, capacity)
+	OutStats.Hits = GetTupleInt(Result.Object, 0);
+	OutStats.Misses = GetTupleInt(Result.Object, 1);
+	OutStats.Entries = GetTupleInt(Result.Object, 2);
+	OutStats.Capacity = GetTupleInt(Result.Object, 3);
+	return true;
+#else
+	return false;
+#endif
+}
+
+EPythonBridgeStatus FUnrealCopilotPythonBridge::WarmUp(const TArray<FString>& ModuleNames, double& OutSeconds, TArray<FString>& OutFailedModules)
+{
+	OutSeconds = 0.0;
+	OutFailedModules.Reset();
+
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return EPythonBridgeStatus::Unavailable;
+	}
+
+	FScopedGIL GIL;
+	PyObject* NameList = PyList_New(0);
+	if (!NameList)
+	{
+		return HandleError();
+	}
+	for (const FString& ModuleName : ModuleNames)
+	{
+		FPyObjectPtr Name(NewString(ModuleName));
+		if (Name.Object)
+		{
+			PyList_Append(NameList, Name.Object);
+		}
+	}
+
+	// Importing the runtime module to call warm_up is itself the main part of the warm-up
+	FPyObjectPtr Args(Py_BuildValue("(N)", NameList));
+	PyObject* ReturnValue = nullptr;
+	const EPythonBridgeStatus CallStatus = CallRuntime("warm_up", Args.Object, ReturnValue);
+	FPyObjectPtr Result(ReturnValue);
+	if (CallStatus != EPythonBridgeStatus::Succeeded)
+	{
+		return CallStatus;
+	}
+
+	// warm_up returns (seconds, comma-separated failed modules)
+	OutSeconds = PyFloat_AsDouble(PyTuple_GetItem(Result.Object, 0));
+	ToString(PyTuple_GetItem(Result.Object, 1)).ParseIntoArray(OutFailedModules, TEXT(","));
+	return CallStatus;
+#else
+	return EPythonBridgeStatus::Unavailable;
+#endif
+}
+
+void FUnrealCopilotPythonBridge::ResetSession(int32 SessionId)
+{
+#if WITH_PYTHON
+	using namespace UnrealCopilotPythonBridge;
+
+	if (!Py_IsInitialized())
+	{
+		return;
+	}
+
+	FScopedGIL GIL;
+	FPyObjectPtr Args(Py_BuildValue("(i)", SessionId));
+	PyObject* ReturnValue = nullptr;
+	CallRuntime("reset_session", Args.Object, ReturnValue);
+	Py_XDECREF(ReturnValue);
+#endif
+}
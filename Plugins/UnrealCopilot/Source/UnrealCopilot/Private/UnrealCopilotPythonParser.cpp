@@ -0,0 +1,3130 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotPythonParser.h"
+#include "Misc/ScopeExit.h"
+
+namespace UnrealCopilotPythonParser
+{
+	/** Deepest nesting of expressions and blocks before parsing gives up, keeping recursion well inside worker thread stacks */
+	static constexpr int32 MaxNestingDepth = 64;
+
+	static const TCHAR* const ReservedKeywords[] = {
+		TEXT("False"), TEXT("None"), TEXT("True"), TEXT("and"), TEXT("as"), TEXT("assert"), TEXT("async"), TEXT("await"),
+		TEXT("break"), TEXT("class"), TEXT("continue"), TEXT("def"), TEXT("del"), TEXT("elif"), TEXT("else"), TEXT("except"),
+		TEXT("finally"), TEXT("for"), TEXT("from"), TEXT("global"), TEXT("if"), TEXT("import"), TEXT("in"), TEXT("is"),
+		TEXT("lambda"), TEXT("nonlocal"), TEXT("not"), TEXT("or"), TEXT("pass"), TEXT("raise"), TEXT("return"), TEXT("try"),
+		TEXT("while"), TEXT("with"), TEXT("yield")
+	};
+
+	/** Operators, longest first so the first match is the longest */
+	static const TCHAR* const Operators[] = {
+		TEXT("**="), TEXT("//="), TEXT(">>="), TEXT("<<="), TEXT("..."),
+		TEXT("!="), TEXT("%="), TEXT("&="), TEXT("**"), TEXT("*="), TEXT("+="), TEXT("-="), TEXT("->"), TEXT("//"), TEXT("/="),
+		TEXT(":="), TEXT("<<"), TEXT("<="), TEXT("=="), TEXT(">="), TEXT(">>"), TEXT("@="), TEXT("^="), TEXT("|="),
+		TEXT("("), TEXT(")"), TEXT("["), TEXT("]"), TEXT("{"), TEXT("}"), TEXT(","), TEXT(":"), TEXT("."), TEXT(";"),
+		TEXT("@"), TEXT("="), TEXT("+"), TEXT("-"), TEXT("*"), TEXT("/"), TEXT("%"), TEXT("&"), TEXT("|"), TEXT("^"),
+		TEXT("~"), TEXT("<"), TEXT(">")
+	};
+
+	static const TCHAR* const AugmentedAssignmentOperators[] = {
+		TEXT("+="), TEXT("-="), TEXT("*="), TEXT("/="), TEXT("//="), TEXT("%="), TEXT("@="),
+		TEXT("&="), TEXT("|="), TEXT("^="), TEXT(">>="), TEXT("<<="), TEXT("**=")
+	};
+
+	/** Binary operators by precedence level, loosest first */
+	static const TCHAR* const BinaryOperators[][5] = {
+		{ TEXT("|") },
+		{ TEXT("^") },
+		{ TEXT("&") },
+		{ TEXT("<<"), TEXT(">>") },
+		{ TEXT("+"), TEXT("-") },
+		{ TEXT("*"), TEXT("/"), TEXT("//"), TEXT("%"), TEXT("@") }
+	};
+
+	static bool IsIdentifierStart(TCHAR Char)
+	{
+		return FChar::IsAlpha(Char) || Char == TEXT('_') || Char >= 128;
+	}
+
+	static bool IsIdentifierChar(TCHAR Char)
+	{
+		return IsIdentifierStart(Char) || FChar::IsDigit(Char);
+	}
+
+	static bool IsNewlineChar(TCHAR Char)
+	{
+		return Char == TEXT('\n') || Char == TEXT('\r');
+	}
+
+	static bool IsReservedKeyword(FStringView Text)
+	{
+		for (const TCHAR* Keyword : ReservedKeywords)
+		{
+			if (Text.Equals(Keyword, ESearchCase::CaseSensitive))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool IsStringPrefix(FStringView Text)
+	{
+		const FString Prefix = FString(Text).ToLower();
+		return Prefix == TEXT("r") || Prefix == TEXT("u") || Prefix == TEXT("b") || Prefix == TEXT("f") ||
+			Prefix == TEXT("br") || Prefix == TEXT("rb") || Prefix == TEXT("fr") || Prefix == TEXT("rf");
+	}
+
+	static TCHAR GetClosingBracket(TCHAR OpeningBracket)
+	{
+		switch (OpeningBracket)
+		{
+		case TEXT('('): return TEXT(')');
+		case TEXT('['): return TEXT(']');
+		default: return TEXT('}');
+		}
+	}
+
+	static const TCHAR* DescribeNodeType(EPythonAstNodeType Type)
+	{
+		switch (Type)
+		{
+		case EPythonAstNodeType::Call: return TEXT("function call");
+		case EPythonAstNodeType::Constant: return TEXT("literal");
+		case EPythonAstNodeType::JoinedStr: return TEXT("f-string expression");
+		case EPythonAstNodeType::Compare: return TEXT("comparison");
+		case EPythonAstNodeType::Lambda: return TEXT("lambda");
+		case EPythonAstNodeType::IfExp: return TEXT("conditional expression");
+		case EPythonAstNodeType::NamedExpr: return TEXT("named expression");
+		case EPythonAstNodeType::Await: return TEXT("await expression");
+		case EPythonAstNodeType::Yield:
+		case EPythonAstNodeType::YieldFrom: return TEXT("yield expression");
+		case EPythonAstNodeType::ListComp: return TEXT("list comprehension");
+		case EPythonAstNodeType::SetComp: return TEXT("set comprehension");
+		case EPythonAstNodeType::DictComp: return TEXT("dict comprehension");
+		case EPythonAstNodeType::GeneratorExp: return TEXT("generator expression");
+		case EPythonAstNodeType::Dict: return TEXT("dict literal");
+		case EPythonAstNodeType::Set: return TEXT("set display");
+		default: return TEXT("expression");
+		}
+	}
+
+	/**
+	 * Tokenizer over a range of the source. In expression mode (f-string replacement fields) newlines are whitespace
+	 * and no Newline, Indent or Dedent tokens are produced.
+	 */
+	class FTokenizer
+	{
+	public:
+		FTokenizer(FStringView InSource, int32 InStart, int32 InEnd, int32 InLine, int32 InLineStart, bool bInExpressionOnly)
+			: Source(InSource)
+			, Start(InStart)
+			, End(InEnd)
+			, Line(InLine)
+			, LineStart(InLineStart)
+			, bExpressionOnly(bInExpressionOnly)
+		{
+		}
+
+		bool Run(TArray<FPythonToken>& OutTokens, FPythonSyntaxError& OutError);
+
+	private:
+		void AddToken(EPythonTokenType Type, int32 Offset, int32 Length);
+		int32 ConsumeNewline(int32 Pos);
+		bool ScanNumber(int32& Pos);
+		bool ScanString(int32& Pos, int32 QuoteStart);
+		int32 MatchOperator(int32 Pos) const;
+		bool Fail(int32 Offset, const FString& Message);
+		bool FailAt(int32 Offset, int32 AtLine, int32 AtLineStart, const FString& Message);
+
+		FStringView Source;
+		int32 Start;
+		int32 End;
+		int32 Line;
+		int32 LineStart;
+		bool bExpressionOnly;
+		TArray<FPythonToken>* Tokens = nullptr;
+		FPythonSyntaxError* Error = nullptr;
+	};
+
+	bool FTokenizer::Run(TArray<FPythonToken>& OutTokens, FPythonSyntaxError& OutError)
+	{
+		Tokens = &OutTokens;
+		Error = &OutError;
+		OutTokens.Reset();
+
+		TArray<int32, TInlineAllocator<16>> Indents;
+		Indents.Add(0);
+
+		// Token indices of unclosed brackets
+		TArray<int32, TInlineAllocator<16>> OpenBrackets;
+
+		bool bAtLineStart = !bExpressionOnly;
+		int32 Pos = Start;
+
+		while (Pos < End)
+		{
+			if (bAtLineStart)
+			{
+				int32 Indent = 0;
+				while (Pos < End && (Source[Pos] == TEXT(' ') || Source[Pos] == TEXT('\t') || Source[Pos] == TEXT('\f')))
+				{
+					Indent = Source[Pos] == TEXT('\t') ? (Indent / 8 + 1) * 8 : (Source[Pos] == TEXT(' ') ? Indent + 1 : 0);
+					++Pos;
+				}
+				if (Pos >= End)
+				{
+					break;
+				}
+
+				// Blank and comment-only lines do not affect indentation
+				if (Source[Pos] == TEXT('#'))
+				{
+					while (Pos < End && !IsNewlineChar(Source[Pos]))
+					{
+						++Pos;
+					}
+					continue;
+				}
+				if (IsNewlineChar(Source[Pos]))
+				{
+					Pos = ConsumeNewline(Pos);
+					continue;
+				}
+
+				bAtLineStart = false;
+				if (Indent > Indents.Last())
+				{
+					Indents.Add(Indent);
+					AddToken(EPythonTokenType::Indent, Pos, 0);
+				}
+				else
+				{
+					while (Indent < Indents.Last())
+					{
+						Indents.Pop();
+						AddToken(EPythonTokenType::Dedent, Pos, 0);
+					}
+					if (Indent != Indents.Last())
+					{
+						return Fail(Pos, TEXT("unindent does not match any outer indentation level"));
+					}
+				}
+			}
+
+			const TCHAR Char = Source[Pos];
+			if (Char == TEXT(' ') || Char == TEXT('\t') || Char == TEXT('\f'))
+			{
+				++Pos;
+			}
+			else if (Char == TEXT('#'))
+			{
+				while (Pos < End && !IsNewlineChar(Source[Pos]))
+				{
+					++Pos;
+				}
+			}
+			else if (Char == TEXT('\\'))
+			{
+				if (Pos + 1 >= End || !IsNewlineChar(Source[Pos + 1]))
+				{
+					return Fail(Pos, TEXT("unexpected character after line continuation character"));
+				}
+				Pos = ConsumeNewline(Pos + 1);
+			}
+			else if (IsNewlineChar(Char))
+			{
+				// Newlines inside brackets are implicit line joins
+				if (OpenBrackets.Num() == 0 && !bExpressionOnly)
+				{
+					AddToken(EPythonTokenType::Newline, Pos, 0);
+					bAtLineStart = true;
+				}
+				Pos = ConsumeNewline(Pos);
+			}
+			else if (IsIdentifierStart(Char))
+			{
+				int32 TokenEnd = Pos + 1;
+				while (TokenEnd < End && IsIdentifierChar(Source[TokenEnd]))
+				{
+					++TokenEnd;
+				}
+
+				if (TokenEnd < End && (Source[TokenEnd] == TEXT('\'') || Source[TokenEnd] == TEXT('"')) && IsStringPrefix(Source.Mid(Pos, TokenEnd - Pos)))
+				{
+					if (!ScanString(Pos, TokenEnd))
+					{
+						return false;
+					}
+				}
+				else
+				{
+					AddToken(EPythonTokenType::Name, Pos, TokenEnd - Pos);
+					Pos = TokenEnd;
+				}
+			}
+			else if (FChar::IsDigit(Char) || (Char == TEXT('.') && Pos + 1 < End && FChar::IsDigit(Source[Pos + 1])))
+			{
+				if (!ScanNumber(Pos))
+				{
+					return false;
+				}
+			}
+			else if (Char == TEXT('\'') || Char == TEXT('"'))
+			{
+				if (!ScanString(Pos, Pos))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				const int32 OperatorLength = MatchOperator(Pos);
+				if (OperatorLength == 0)
+				{
+					return Fail(Pos, FString::Printf(TEXT("invalid character '%c'"), Char));
+				}
+
+				if (Char == TEXT('(') || Char == TEXT('[') || Char == TEXT('{'))
+				{
+					OpenBrackets.Add(OutTokens.Num());
+				}
+				else if (Char == TEXT(')') || Char == TEXT(']') || Char == TEXT('}'))
+				{
+					if (OpenBrackets.Num() == 0)
+					{
+						return Fail(Pos, FString::Printf(TEXT("unmatched '%c'"), Char));
+					}
+
+					const TCHAR OpeningBracket = Source[OutTokens[OpenBrackets.Last()].Offset];
+					if (GetClosingBracket(OpeningBracket) != Char)
+					{
+						return Fail(Pos, FString::Printf(TEXT("closing parenthesis '%c' does not match opening parenthesis '%c'"), Char, OpeningBracket));
+					}
+					OpenBrackets.Pop();
+				}
+
+				AddToken(EPythonTokenType::Operator, Pos, OperatorLength);
+				Pos += OperatorLength;
+			}
+		}
+
+		if (OpenBrackets.Num() > 0)
+		{
+			const FPythonToken& Opening = OutTokens[OpenBrackets.Last()];
+			OutError.Message = FString::Printf(TEXT("'%c' was never closed"), Source[Opening.Offset]);
+			OutError.Line = Opening.Line;
+			OutError.Column = Opening.Column;
+			return false;
+		}
+
+		if (!bExpressionOnly)
+		{
+			if (OutTokens.Num() > 0 && OutTokens.Last().Type != EPythonTokenType::Newline)
+			{
+				AddToken(EPythonTokenType::Newline, Pos, 0);
+			}
+			for (int32 Index = 1; Index < Indents.Num(); ++Index)
+			{
+				AddToken(EPythonTokenType::Dedent, Pos, 0);
+			}
+		}
+		AddToken(EPythonTokenType::EndOfFile, Pos, 0);
+		return true;
+	}
+
+	void FTokenizer::AddToken(EPythonTokenType Type, int32 Offset, int32 Length)
+	{
+		FPythonToken& Token = Tokens->AddDefaulted_GetRef();
+		Token.Type = Type;
+		Token.Offset = Offset;
+		Token.Length = Length;
+		Token.Line = Line;
+		Token.Column = Offset - LineStart + 1;
+	}
+
+	int32 FTokenizer::ConsumeNewline(int32 Pos)
+	{
+		if (Source[Pos] == TEXT('\r') && Pos + 1 < End && Source[Pos + 1] == TEXT('\n'))
+		{
+			++Pos;
+		}
+		++Pos;
+		++Line;
+		LineStart = Pos;
+		return Pos;
+	}
+
+	bool FTokenizer::ScanNumber(int32& Pos)
+	{
+		auto SkipDigits = [this](int32 Index)
+		{
+			while (Index < End && (FChar::IsDigit(Source[Index]) || Source[Index] == TEXT('_')))
+			{
+				++Index;
+			}
+			return Index;
+		};
+
+		int32 Index = Pos;
+		const TCHAR Radix = Index + 1 < End ? FChar::ToLower(Source[Index + 1]) : TEXT('\0');
+		if (Source[Index] == TEXT('0') && (Radix == TEXT('x') || Radix == TEXT('o') || Radix == TEXT('b')))
+		{
+			Index += 2;
+			while (Index < End && (FChar::IsHexDigit(Source[Index]) || Source[Index] == TEXT('_')))
+			{
+				++Index;
+			}
+		}
+		else
+		{
+			Index = SkipDigits(Index);
+			if (Index < End && Source[Index] == TEXT('.'))
+			{
+				Index = SkipDigits(Index + 1);
+			}
+			if (Index < End && (Source[Index] == TEXT('e') || Source[Index] == TEXT('E')))
+			{
+				int32 Exponent = Index + 1;
+				if (Exponent < End && (Source[Exponent] == TEXT('+') || Source[Exponent] == TEXT('-')))
+				{
+					++Exponent;
+				}
+				if (Exponent < End && FChar::IsDigit(Source[Exponent]))
+				{
+					Index = SkipDigits(Exponent);
+				}
+			}
+			if (Index < End && (Source[Index] == TEXT('j') || Source[Index] == TEXT('J')))
+			{
+				++Index;
+			}
+		}
+
+		if (Index < End && IsIdentifierChar(Source[Index]))
+		{
+			return Fail(Pos, TEXT("invalid decimal literal"));
+		}
+
+		AddToken(EPythonTokenType::Number, Pos, Index - Pos);
+		Pos = Index;
+		return true;
+	}
+
+	bool FTokenizer::ScanString(int32& Pos, int32 QuoteStart)
+	{
+		const int32 StartLine = Line;
+		const int32 StartLineStart = LineStart;
+
+		const TCHAR Quote = Source[QuoteStart];
+		const bool bTripleQuoted = QuoteStart + 2 < End && Source[QuoteStart + 1] == Quote && Source[QuoteStart + 2] == Quote;
+		int32 Index = QuoteStart + (bTripleQuoted ? 3 : 1);
+
+		for (;;)
+		{
+			if (Index >= End)
+			{
+				return FailAt(Pos, StartLine, StartLineStart, bTripleQuoted ? TEXT("unterminated triple-quoted string literal") : TEXT("unterminated string literal"));
+			}
+
+			const TCHAR Char = Source[Index];
+			if (Char == TEXT('\\'))
+			{
+				// Escapes are skipped lexically, even in raw strings; an escaped newline continues the string
+				++Index;
+				if (Index < End && IsNewlineChar(Source[Index]))
+				{
+					Index = ConsumeNewline(Index);
+				}
+				else
+				{
+					++Index;
+				}
+			}
+			else if (IsNewlineChar(Char))
+			{
+				if (!bTripleQuoted)
+				{
+					return FailAt(Pos, StartLine, StartLineStart, TEXT("unterminated string literal"));
+				}
+				Index = ConsumeNewline(Index);
+			}
+			else if (Char == Quote && (!bTripleQuoted || (Index + 2 < End && Source[Index + 1] == Quote && Source[Index + 2] == Quote)))
+			{
+				Index += bTripleQuoted ? 3 : 1;
+				break;
+			}
+			else
+			{
+				++Index;
+			}
+		}
+
+		FPythonToken& Token = Tokens->AddDefaulted_GetRef();
+		Token.Type = EPythonTokenType::String;
+		Token.Offset = Pos;
+		Token.Length = Index - Pos;
+		Token.Line = StartLine;
+		Token.Column = Pos - StartLineStart + 1;
+
+		Pos = Index;
+		return true;
+	}
+
+	int32 FTokenizer::MatchOperator(int32 Pos) const
+	{
+		for (const TCHAR* Operator : Operators)
+		{
+			const int32 Length = FCString::Strlen(Operator);
+			if (Pos + Length <= End && Source.Mid(Pos, Length).Equals(Operator, ESearchCase::CaseSensitive))
+			{
+				return Length;
+			}
+		}
+		return 0;
+	}
+
+	bool FTokenizer::Fail(int32 Offset, const FString& Message)
+	{
+		return FailAt(Offset, Line, LineStart, Message);
+	}
+
+	bool FTokenizer::FailAt(int32 Offset, int32 AtLine, int32 AtLineStart, const FString& Message)
+	{
+		Error->Message = Message;
+		Error->Line = AtLine;
+		Error->Column = Offset - AtLineStart + 1;
+		return false;
+	}
+
+	/**
+	 * Recursive descent parser over the token stream. Statement functions return false on error;
+	 * expression functions return the new node index, or INDEX_NONE on error.
+	 */
+	class FParser
+	{
+	public:
+		FParser(FStringView InSource, FPythonAst& InAst, FPythonSyntaxError& InError)
+			: Source(InSource)
+			, Ast(InAst)
+			, Error(InError)
+		{
+		}
+
+		bool ParseModule(TArray<FPythonToken>&& InTokens);
+
+	private:
+		// Token helpers
+		const FPythonToken& Peek(int32 Ahead = 0) const { return Tokens[FMath::Min(Pos + Ahead, Tokens.Num() - 1)]; }
+		FStringView GetText(const FPythonToken& Token) const { return Source.Mid(Token.Offset, Token.Length); }
+		bool IsOp(const TCHAR* Operator, int32 Ahead = 0) const;
+		bool IsKeyword(const TCHAR* Keyword, int32 Ahead = 0) const;
+		bool AcceptOp(const TCHAR* Operator);
+		bool AcceptKeyword(const TCHAR* Keyword);
+		bool ExpectOp(const TCHAR* Operator);
+		bool ExpectKeyword(const TCHAR* Keyword);
+		bool ExpectName(FString& OutName);
+		bool ExpectNewline();
+		bool IsExpressionStart(const FPythonToken& Token) const;
+		bool IsComprehensionStart() const;
+		bool EnterNesting();
+
+		// Errors
+		bool Fail(const FPythonToken& At, const FString& Message);
+		bool FailAtNode(int32 Node, const FString& Message);
+		bool FailAtOffset(const FPythonToken& Token, int32 Offset, const FString& Message);
+		void GetLineStart(const FPythonToken& Token, int32 Offset, int32& OutLine, int32& OutLineStart) const;
+
+		// Tree building
+		int32 AddNode(EPythonAstNodeType Type, const FPythonToken& At, FStringView Name = FStringView());
+		void AddChild(int32 Parent, int32 Child);
+		bool CheckAssignable(int32 Node, const TCHAR* Verb);
+
+		// Statements
+		bool ParseStatement(int32 Parent);
+		bool ParseSimpleStatements(int32 Parent);
+		bool ParseSimpleStatement(int32 Parent);
+		bool ParseExpressionStatement(int32 Parent);
+		bool ParseBlock(int32 Parent);
+		bool ParseIf(int32 Parent);
+		bool ParseWhile(int32 Parent);
+		bool ParseFor(int32 Parent);
+		bool ParseTry(int32 Parent);
+		bool ParseWith(int32 Parent);
+		bool ParseDecorated(int32 Parent);
+		bool ParseFunctionDef(int32 Parent, const TArray<int32>& Decorators);
+		bool ParseClassDef(int32 Parent, const TArray<int32>& Decorators);
+		bool ParseParameters(int32 Node, const TCHAR* Terminator, bool bAllowAnnotations);
+		bool ParseImport(int32 Parent);
+		bool ParseFromImport(int32 Parent);
+		bool ParseDottedName(FString& OutName);
+		bool IsMatchStatement() const;
+		bool ParseMatch(int32 Parent);
+		bool ParsePatterns(int32 Case);
+
+		// Expressions
+		int32 ParseStarExpressions();
+		int32 ParseStarred();
+		int32 ParseStarExpression();
+		int32 ParseStarNamedExpression();
+		int32 ParseNamedExpression();
+		int32 ParseExpression();
+		int32 ParseLambda();
+		int32 ParseDisjunction();
+		int32 ParseConjunction();
+		int32 ParseInversion();
+		int32 ParseComparison();
+		int32 ParseBinary(int32 Level);
+		int32 ParseFactor();
+		int32 ParsePower();
+		int32 ParsePrimary();
+		int32 ParseAtom();
+		int32 ParseParenthesized();
+		int32 ParseListDisplay();
+		int32 ParseBraceDisplay();
+		int32 ParseYield();
+		int32 ParseStarTargets();
+		int32 ParseStarTarget();
+		int32 ParseSlices();
+		int32 ParseSlice();
+		int32 ParseStrings();
+		bool ParseCallArguments(int32 Node, const TCHAR* Closing);
+		bool ParseComprehensionClauses(int32 Node);
+
+		// f-strings
+		bool ParseFormatString(int32 Node, const FPythonToken& Token);
+		bool ParseFormatStringText(int32 Node, const FPythonToken& Token, int32& Index, int32 End, bool bRaw, bool bInFormatSpec);
+		bool ParseFormatStringField(int32 Node, const FPythonToken& Token, int32& Index, int32 End, bool bRaw);
+		bool ParseFormatStringExpression(int32 Node, const FPythonToken& Token, int32 Start, int32 End);
+
+	private:
+		FStringView Source;
+		FPythonAst& Ast;
+		FPythonSyntaxError& Error;
+		TArray<FPythonToken> Tokens;
+		int32 Pos = 0;
+		bool bFailed = false;
+		int32 Depth = 0;
+		int32 FunctionDepth = 0;
+		int32 LoopDepth = 0;
+	};
+
+	bool FParser::ParseModule(TArray<FPythonToken>&& InTokens)
+	{
+		Tokens = MoveTemp(InTokens);
+		Pos = 0;
+
+		Ast.Nodes.Reset();
+		AddNode(EPythonAstNodeType::Module, Peek());
+		Ast.Nodes[0].Line = 1;
+		Ast.Nodes[0].Column = 1;
+
+		while (Peek().Type != EPythonTokenType::EndOfFile)
+		{
+			if (!ParseStatement(0))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool FParser::IsOp(const TCHAR* Operator, int32 Ahead) const
+	{
+		const FPythonToken& Token = Peek(Ahead);
+		return Token.Type == EPythonTokenType::Operator && GetText(Token).Equals(Operator, ESearchCase::CaseSensitive);
+	}
+
+	bool FParser::IsKeyword(const TCHAR* Keyword, int32 Ahead) const
+	{
+		const FPythonToken& Token = Peek(Ahead);
+		return Token.Type == EPythonTokenType::Name && GetText(Token).Equals(Keyword, ESearchCase::CaseSensitive);
+	}
+
+	bool FParser::AcceptOp(const TCHAR* Operator)
+	{
+		if (IsOp(Operator))
+		{
+			++Pos;
+			return true;
+		}
+		return false;
+	}
+
+	bool FParser::AcceptKeyword(const TCHAR* Keyword)
+	{
+		if (IsKeyword(Keyword))
+		{
+			++Pos;
+			return true;
+		}
+		return false;
+	}
+
+	bool FParser::ExpectOp(const TCHAR* Operator)
+	{
+		return AcceptOp(Operator) || Fail(Peek(), FString::Printf(TEXT("expected '%s'"), Operator));
+	}
+
+	bool FParser::ExpectKeyword(const TCHAR* Keyword)
+	{
+		return AcceptKeyword(Keyword) || Fail(Peek(), FString::Printf(TEXT("expected '%s'"), Keyword));
+	}
+
+	bool FParser::ExpectName(FString& OutName)
+	{
+		const FPythonToken& Token = Peek();
+		if (Token.Type != EPythonTokenType::Name || IsReservedKeyword(GetText(Token)))
+		{
+			return Fail(Token, TEXT("invalid syntax"));
+		}
+		OutName = FString(GetText(Token));
+		++Pos;
+		return true;
+	}
+
+	bool FParser::ExpectNewline()
+	{
+		if (Peek().Type == EPythonTokenType::Newline)
+		{
+			++Pos;
+			return true;
+		}
+		return Peek().Type == EPythonTokenType::EndOfFile || Fail(Peek(), TEXT("invalid syntax"));
+	}
+
+	bool FParser::IsExpressionStart(const FPythonToken& Token) const
+	{
+		switch (Token.Type)
+		{
+		case EPythonTokenType::Number:
+		case EPythonTokenType::String:
+			return true;
+
+		case EPythonTokenType::Name:
+		{
+			const FStringView Text = GetText(Token);
+			return !IsReservedKeyword(Text) ||
+				Text.Equals(TEXT("None"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("True"), ESearchCase::CaseSensitive) ||
+				Text.Equals(TEXT("False"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("not"), ESearchCase::CaseSensitive) ||
+				Text.Equals(TEXT("lambda"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("await"), ESearchCase::CaseSensitive);
+		}
+
+		case EPythonTokenType::Operator:
+		{
+			const FStringView Text = GetText(Token);
+			return Text.Equals(TEXT("("), ESearchCase::CaseSensitive) || Text.Equals(TEXT("["), ESearchCase::CaseSensitive) ||
+				Text.Equals(TEXT("{"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("-"), ESearchCase::CaseSensitive) ||
+				Text.Equals(TEXT("+"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("~"), ESearchCase::CaseSensitive) ||
+				Text.Equals(TEXT("..."), ESearchCase::CaseSensitive) || Text.Equals(TEXT("*"), ESearchCase::CaseSensitive);
+		}
+
+		default:
+			return false;
+		}
+	}
+
+	bool FParser::IsComprehensionStart() const
+	{
+		return IsKeyword(TEXT("for")) || (IsKeyword(TEXT("async")) && IsKeyword(TEXT("for"), 1));
+	}
+
+	bool FParser::EnterNesting()
+	{
+		if (Depth >= MaxNestingDepth)
+		{
+			return Fail(Peek(), TEXT("too many nested parentheses or blocks"));
+		}
+		++Depth;
+		return true;
+	}
+
+	bool FParser::Fail(const FPythonToken& At, const FString& Message)
+	{
+		if (!bFailed)
+		{
+			bFailed = true;
+			Error.Message = Message;
+			Error.Line = At.Line;
+			Error.Column = At.Column;
+		}
+		return false;
+	}
+
+	bool FParser::FailAtNode(int32 Node, const FString& Message)
+	{
+		FPythonToken At;
+		At.Line = Ast.Nodes[Node].Line;
+		At.Column = Ast.Nodes[Node].Column;
+		return Fail(At, Message);
+	}
+
+	bool FParser::FailAtOffset(const FPythonToken& Token, int32 Offset, const FString& Message)
+	{
+		int32 Line = 0;
+		int32 LineStart = 0;
+		GetLineStart(Token, Offset, Line, LineStart);
+
+		FPythonToken At;
+		At.Line = Line;
+		At.Column = Offset - LineStart + 1;
+		return Fail(At, Message);
+	}
+
+	void FParser::GetLineStart(const FPythonToken& Token, int32 Offset, int32& OutLine, int32& OutLineStart) const
+	{
+		OutLine = Token.Line;
+		OutLineStart = Token.Offset - (Token.Column - 1);
+		for (int32 Index = Token.Offset; Index < Offset; ++Index)
+		{
+			if (Source[Index] == TEXT('\n'))
+			{
+				++OutLine;
+				OutLineStart = Index + 1;
+			}
+		}
+	}
+
+	int32 FParser::AddNode(EPythonAstNodeType Type, const FPythonToken& At, FStringView Name)
+	{
+		const int32 Index = Ast.Nodes.AddDefaulted();
+		FPythonAstNode& Node = Ast.Nodes[Index];
+		Node.Type = Type;
+		Node.Name = FString(Name);
+		Node.Line = At.Line;
+		Node.Column = At.Column;
+		return Index;
+	}
+
+	void FParser::AddChild(int32 Parent, int32 Child)
+	{
+		if (Child != INDEX_NONE)
+		{
+			Ast.Nodes[Parent].Children.Add(Child);
+			Ast.Nodes[Child].Parent = Parent;
+		}
+	}
+
+	bool FParser::CheckAssignable(int32 Node, const TCHAR* Verb)
+	{
+		switch (Ast.Nodes[Node].Type)
+		{
+		case EPythonAstNodeType::Name:
+		case EPythonAstNodeType::Attribute:
+		case EPythonAstNodeType::Subscript:
+			return true;
+
+		case EPythonAstNodeType::Starred:
+		case EPythonAstNodeType::Tuple:
+		case EPythonAstNodeType::List:
+			for (int32 Index = 0; Index < Ast.Nodes[Node].Children.Num(); ++Index)
+			{
+				if (!CheckAssignable(Ast.Nodes[Node].Children[Index], Verb))
+				{
+					return false;
+				}
+			}
+			return true;
+
+		default:
+			return FailAtNode(Node, FString::Printf(TEXT("cannot %s %s"), Verb, DescribeNodeType(Ast.Nodes[Node].Type)));
+		}
+	}
+
+	bool FParser::ParseStatement(int32 Parent)
+	{
+		if (!EnterNesting())
+		{
+			return false;
+		}
+		ON_SCOPE_EXIT { --Depth; };
+
+		const FPythonToken& Token = Peek();
+		if (Token.Type == EPythonTokenType::Indent)
+		{
+			return Fail(Token, TEXT("unexpected indent"));
+		}
+
+		if (IsKeyword(TEXT("if")))
+		{
+			return ParseIf(Parent);
+		}
+		if (IsKeyword(TEXT("while")))
+		{
+			return ParseWhile(Parent);
+		}
+		if (IsKeyword(TEXT("for")))
+		{
+			return ParseFor(Parent);
+		}
+		if (IsKeyword(TEXT("try")))
+		{
+			return ParseTry(Parent);
+		}
+		if (IsKeyword(TEXT("with")))
+		{
+			return ParseWith(Parent);
+		}
+		if (IsKeyword(TEXT("def")))
+		{
+			return ParseFunctionDef(Parent, TArray<int32>());
+		}
+		if (IsKeyword(TEXT("class")))
+		{
+			return ParseClassDef(Parent, TArray<int32>());
+		}
+		if (IsKeyword(TEXT("async")))
+		{
+			++Pos;
+			if (IsKeyword(TEXT("def")))
+			{
+				return ParseFunctionDef(Parent, TArray<int32>());
+			}
+			if (IsKeyword(TEXT("for")))
+			{
+				return ParseFor(Parent);
+			}
+			if (IsKeyword(TEXT("with")))
+			{
+				return ParseWith(Parent);
+			}
+			return Fail(Peek(), TEXT("invalid syntax"));
+		}
+		if (IsOp(TEXT("@")))
+		{
+			return ParseDecorated(Parent);
+		}
+		if (IsKeyword(TEXT("match")) && IsMatchStatement())
+		{
+			return ParseMatch(Parent);
+		}
+
+		return ParseSimpleStatements(Parent);
+	}
+
+	bool FParser::ParseSimpleStatements(int32 Parent)
+	{
+		if (!ParseSimpleStatement(Parent))
+		{
+			return false;
+		}
+
+		while (AcceptOp(TEXT(";")))
+		{
+			if (Peek().Type == EPythonTokenType::Newline)
+			{
+				break;
+			}
+			if (!ParseSimpleStatement(Parent))
+			{
+				return false;
+			}
+		}
+
+		return ExpectNewline();
+	}
+
+
+	bool FParser::ParseSimpleStatement(int32 Parent)
+	{
+		const FPythonToken Token = Peek();
+
+		if (IsKeyword(TEXT("pass")))
+		{
+			++Pos;
+			AddChild(Parent, AddNode(EPythonAstNodeType::Pass, Token));
+			return true;
+		}
+
+		if (IsKeyword(TEXT("break")) || IsKeyword(TEXT("continue")))
+		{
+			const bool bBreak = IsKeyword(TEXT("break"));
+			if (LoopDepth == 0)
+			{
+				return Fail(Token, bBreak ? TEXT("'break' outside loop") : TEXT("'continue' not properly in loop"));
+			}
+			++Pos;
+			AddChild(Parent, AddNode(bBreak ? EPythonAstNodeType::Break : EPythonAstNodeType::Continue, Token));
+			return true;
+		}
+
+		if (IsKeyword(TEXT("return")))
+		{
+			if (FunctionDepth == 0)
+			{
+				return Fail(Token, TEXT("'return' outside function"));
+			}
+			++Pos;
+			const int32 Node = AddNode(EPythonAstNodeType::Return, Token);
+			AddChild(Parent, Node);
+			if (IsExpressionStart(Peek()))
+			{
+				const int32 Value = ParseStarExpressions();
+				if (Value == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Node, Value);
+			}
+			return true;
+		}
+
+		if (IsKeyword(TEXT("raise")))
+		{
+			++Pos;
+			const int32 Node = AddNode(EPythonAstNodeType::Raise, Token);
+			AddChild(Parent, Node);
+			if (IsExpressionStart(Peek()))
+			{
+				const int32 Exception = ParseExpression();
+				if (Exception == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Node, Exception);
+
+				if (AcceptKeyword(TEXT("from")))
+				{
+					const int32 Cause = ParseExpression();
+					if (Cause == INDEX_NONE)
+					{
+						return false;
+					}
+					AddChild(Node, Cause);
+				}
+			}
+			return true;
+		}
+
+		if (IsKeyword(TEXT("global")) || IsKeyword(TEXT("nonlocal")))
+		{
+			const bool bGlobal = IsKeyword(TEXT("global"));
+			if (!bGlobal && FunctionDepth == 0)
+			{
+				return Fail(Token, TEXT("nonlocal declaration not allowed at module level"));
+			}
+			++Pos;
+			const int32 Node = AddNode(bGlobal ? EPythonAstNodeType::Global : EPythonAstNodeType::Nonlocal, Token);
+			AddChild(Parent, Node);
+			do
+			{
+				const FPythonToken NameToken = Peek();
+				FString Name;
+				if (!ExpectName(Name))
+				{
+					return false;
+				}
+				AddChild(Node, AddNode(EPythonAstNodeType::Name, NameToken, Name));
+			}
+			while (AcceptOp(TEXT(",")));
+			return true;
+		}
+
+		if (IsKeyword(TEXT("del")))
+		{
+			++Pos;
+			const int32 Node = AddNode(EPythonAstNodeType::Delete, Token);
+			AddChild(Parent, Node);
+			const int32 Targets = ParseStarTargets();
+			if (Targets == INDEX_NONE || !CheckAssignable(Targets, TEXT("delete")))
+			{
+				return false;
+			}
+			AddChild(Node, Targets);
+			return true;
+		}
+
+		if (IsKeyword(TEXT("assert")))
+		{
+			++Pos;
+			const int32 Node = AddNode(EPythonAstNodeType::Assert, Token);
+			AddChild(Parent, Node);
+			const int32 Test = ParseExpression();
+			if (Test == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Node, Test);
+
+			if (AcceptOp(TEXT(",")))
+			{
+				const int32 Message = ParseExpression();
+				if (Message == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Node, Message);
+			}
+			return true;
+		}
+
+		if (IsKeyword(TEXT("import")))
+		{
+			return ParseImport(Parent);
+		}
+		if (IsKeyword(TEXT("from")))
+		{
+			return ParseFromImport(Parent);
+		}
+
+		return ParseExpressionStatement(Parent);
+	}
+
+	bool FParser::ParseExpressionStatement(int32 Parent)
+	{
+		const FPythonToken Start = Peek();
+		const int32 First = IsKeyword(TEXT("yield")) ? ParseYield() : ParseStarExpressions();
+		if (First == INDEX_NONE)
+		{
+			return false;
+		}
+
+		auto IsSingleTarget = [this](int32 Node)
+		{
+			const EPythonAstNodeType Type = Ast.Nodes[Node].Type;
+			return Type == EPythonAstNodeType::Name || Type == EPythonAstNodeType::Attribute || Type == EPythonAstNodeType::Subscript;
+		};
+
+		// Annotated assignment
+		if (IsOp(TEXT(":")))
+		{
+			if (!IsSingleTarget(First))
+			{
+				return FailAtNode(First, Ast.Nodes[First].Type == EPythonAstNodeType::Tuple ? TEXT("only single target (not tuple) can be annotated") : TEXT("illegal target for annotation"));
+			}
+			++Pos;
+
+			const int32 Node = AddNode(EPythonAstNodeType::AnnAssign, Start);
+			AddChild(Parent, Node);
+			AddChild(Node, First);
+
+			const int32 Annotation = ParseExpression();
+			if (Annotation == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Node, Annotation);
+
+			if (AcceptOp(TEXT("=")))
+			{
+				const int32 Value = IsKeyword(TEXT("yield")) ? ParseYield() : ParseStarExpressions();
+				if (Value == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Node, Value);
+			}
+			return true;
+		}
+
+		// Augmented assignment
+		for (const TCHAR* Operator : AugmentedAssignmentOperators)
+		{
+			if (!IsOp(Operator))
+			{
+				continue;
+			}
+
+			if (!IsSingleTarget(First))
+			{
+				return FailAtNode(First, FString::Printf(TEXT("'%s' is an illegal expression for augmented assignment"), DescribeNodeType(Ast.Nodes[First].Type)));
+			}
+			++Pos;
+
+			const int32 Node = AddNode(EPythonAstNodeType::AugAssign, Start, Operator);
+			AddChild(Parent, Node);
+			AddChild(Node, First);
+
+			const int32 Value = IsKeyword(TEXT("yield")) ? ParseYield() : ParseStarExpressions();
+			if (Value == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Node, Value);
+			return true;
+		}
+
+		// Assignment, possibly chained; the last expression is the value
+		if (IsOp(TEXT("=")))
+		{
+			const int32 Node = AddNode(EPythonAstNodeType::Assign, Start);
+			AddChild(Parent, Node);
+
+			int32 Target = First;
+			while (AcceptOp(TEXT("=")))
+			{
+				if (!CheckAssignable(Target, TEXT("assign to")))
+				{
+					return false;
+				}
+				AddChild(Node, Target);
+
+				Target = IsKeyword(TEXT("yield")) ? ParseYield() : ParseStarExpressions();
+				if (Target == INDEX_NONE)
+				{
+					return false;
+				}
+			}
+			AddChild(Node, Target);
+			return true;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::Expr, Start);
+		AddChild(Parent, Node);
+		AddChild(Node, First);
+		return true;
+	}
+
+	bool FParser::ParseBlock(int32 Parent)
+	{
+		if (Peek().Type != EPythonTokenType::Newline)
+		{
+			// Statements on the same line as the colon
+			return ParseSimpleStatements(Parent);
+		}
+		++Pos;
+
+		if (Peek().Type != EPythonTokenType::Indent)
+		{
+			return Fail(Peek(), TEXT("expected an indented block"));
+		}
+		++Pos;
+
+		while (Peek().Type != EPythonTokenType::Dedent && Peek().Type != EPythonTokenType::EndOfFile)
+		{
+			if (!ParseStatement(Parent))
+			{
+				return false;
+			}
+		}
+
+		if (Peek().Type == EPythonTokenType::Dedent)
+		{
+			++Pos;
+		}
+		return true;
+	}
+
+	bool FParser::ParseIf(int32 Parent)
+	{
+		// Also parses 'elif', which becomes a nested If
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::If, Token);
+		AddChild(Parent, Node);
+
+		const int32 Test = ParseNamedExpression();
+		if (Test == INDEX_NONE)
+		{
+			return false;
+		}
+		AddChild(Node, Test);
+
+		if (!ExpectOp(TEXT(":")) || !ParseBlock(Node))
+		{
+			return false;
+		}
+
+		if (IsKeyword(TEXT("elif")))
+		{
+			return ParseIf(Node);
+		}
+		if (AcceptKeyword(TEXT("else")))
+		{
+			return ExpectOp(TEXT(":")) && ParseBlock(Node);
+		}
+		return true;
+	}
+
+	bool FParser::ParseWhile(int32 Parent)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::While, Token);
+		AddChild(Parent, Node);
+
+		const int32 Test = ParseNamedExpression();
+		if (Test == INDEX_NONE || !ExpectOp(TEXT(":")))
+		{
+			return false;
+		}
+		AddChild(Node, Test);
+
+		++LoopDepth;
+		const bool bParsedBody = ParseBlock(Node);
+		--LoopDepth;
+		if (!bParsedBody)
+		{
+			return false;
+		}
+
+		if (AcceptKeyword(TEXT("else")))
+		{
+			return ExpectOp(TEXT(":")) && ParseBlock(Node);
+		}
+		return true;
+	}
+
+	bool FParser::ParseFor(int32 Parent)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::For, Token);
+		AddChild(Parent, Node);
+
+		const int32 Target = ParseStarTargets();
+		if (Target == INDEX_NONE || !CheckAssignable(Target, TEXT("assign to")))
+		{
+			return false;
+		}
+		AddChild(Node, Target);
+
+		if (!ExpectKeyword(TEXT("in")))
+		{
+			return false;
+		}
+
+		const int32 Iterable = ParseStarExpressions();
+		if (Iterable == INDEX_NONE || !ExpectOp(TEXT(":")))
+		{
+			return false;
+		}
+		AddChild(Node, Iterable);
+
+		++LoopDepth;
+		const bool bParsedBody = ParseBlock(Node);
+		--LoopDepth;
+		if (!bParsedBody)
+		{
+			return false;
+		}
+
+		if (AcceptKeyword(TEXT("else")))
+		{
+			return ExpectOp(TEXT(":")) && ParseBlock(Node);
+		}
+		return true;
+	}
+
+	bool FParser::ParseTry(int32 Parent)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::Try, Token);
+		AddChild(Parent, Node);
+
+		if (!ExpectOp(TEXT(":")) || !ParseBlock(Node))
+		{
+			return false;
+		}
+
+		bool bHasHandler = false;
+		while (IsKeyword(TEXT("except")))
+		{
+			const FPythonToken HandlerToken = Peek();
+			++Pos;
+
+			const int32 Handler = AddNode(EPythonAstNodeType::ExceptHandler, HandlerToken);
+			AddChild(Node, Handler);
+
+			// except* for exception groups
+			AcceptOp(TEXT("*"));
+
+			if (!IsOp(TEXT(":")))
+			{
+				const int32 ExceptionType = ParseExpression();
+				if (ExceptionType == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Handler, ExceptionType);
+
+				if (AcceptKeyword(TEXT("as")))
+				{
+					FString Name;
+					if (!ExpectName(Name))
+					{
+						return false;
+					}
+					Ast.Nodes[Handler].Name = Name;
+				}
+			}
+
+			if (!ExpectOp(TEXT(":")) || !ParseBlock(Handler))
+			{
+				return false;
+			}
+			bHasHandler = true;
+		}
+
+		if (bHasHandler && AcceptKeyword(TEXT("else")))
+		{
+			if (!ExpectOp(TEXT(":")) || !ParseBlock(Node))
+			{
+				return false;
+			}
+		}
+
+		if (AcceptKeyword(TEXT("finally")))
+		{
+			return ExpectOp(TEXT(":")) && ParseBlock(Node);
+		}
+
+		return bHasHandler || Fail(Peek(), TEXT("expected 'except' or 'finally' block"));
+	}
+
+	bool FParser::ParseWith(int32 Parent)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::With, Token);
+		AddChild(Parent, Node);
+
+		// "with (a as b, c):" groups the items in parentheses; tell it apart from a parenthesized expression by the ':' after the ')'
+		bool bParenthesized = false;
+		if (IsOp(TEXT("(")))
+		{
+			int32 Nesting = 0;
+			for (int32 Index = Pos; Index < Tokens.Num(); ++Index)
+			{
+				const FPythonToken& Candidate = Tokens[Index];
+				if (Candidate.Type != EPythonTokenType::Operator || Candidate.Length != 1)
+				{
+					continue;
+				}
+
+				const TCHAR Char = Source[Candidate.Offset];
+				if (Char == TEXT('(') || Char == TEXT('[') || Char == TEXT('{'))
+				{
+					++Nesting;
+				}
+				else if ((Char == TEXT(')') || Char == TEXT(']') || Char == TEXT('}')) && --Nesting == 0)
+				{
+					bParenthesized = IsOp(TEXT(":"), Index + 1 - Pos);
+					break;
+				}
+			}
+		}
+
+		if (bParenthesized)
+		{
+			++Pos;
+		}
+
+		do
+		{
+			if (bParenthesized && IsOp(TEXT(")")))
+			{
+				break;
+			}
+
+			const int32 Item = ParseExpression();
+			if (Item == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Node, Item);
+
+			if (AcceptKeyword(TEXT("as")))
+			{
+				const int32 Target = ParseStarTarget();
+				if (Target == INDEX_NONE || !CheckAssignable(Target, TEXT("assign to")))
+				{
+					return false;
+				}
+				AddChild(Node, Target);
+			}
+		}
+		while (AcceptOp(TEXT(",")));
+
+		if (bParenthesized && !ExpectOp(TEXT(")")))
+		{
+			return false;
+		}
+
+		return ExpectOp(TEXT(":")) && ParseBlock(Node);
+	}
+
+	bool FParser::ParseDecorated(int32 Parent)
+	{
+		TArray<int32> Decorators;
+		while (AcceptOp(TEXT("@")))
+		{
+			const int32 Decorator = ParseNamedExpression();
+			if (Decorator == INDEX_NONE || !ExpectNewline())
+			{
+				return false;
+			}
+			Decorators.Add(Decorator);
+		}
+
+		if (IsKeyword(TEXT("def")) || (IsKeyword(TEXT("async")) && IsKeyword(TEXT("def"), 1)))
+		{
+			AcceptKeyword(TEXT("async"));
+			return ParseFunctionDef(Parent, Decorators);
+		}
+		if (IsKeyword(TEXT("class")))
+		{
+			return ParseClassDef(Parent, Decorators);
+		}
+		return Fail(Peek(), TEXT("invalid syntax"));
+	}
+
+	bool FParser::ParseFunctionDef(int32 Parent, const TArray<int32>& Decorators)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		FString Name;
+		if (!ExpectName(Name))
+		{
+			return false;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::FunctionDef, Token, Name);
+		AddChild(Parent, Node);
+		for (const int32 Decorator : Decorators)
+		{
+			AddChild(Node, Decorator);
+		}
+
+		if (!ExpectOp(TEXT("(")) || !ParseParameters(Node, TEXT(")"), true) || !ExpectOp(TEXT(")")))
+		{
+			return false;
+		}
+
+		if (AcceptOp(TEXT("->")))
+		{
+			const int32 Returns = ParseExpression();
+			if (Returns == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Node, Returns);
+		}
+
+		if (!ExpectOp(TEXT(":")))
+		{
+			return false;
+		}
+
+		// Enclosing loops do not extend into the body
+		const int32 SavedLoopDepth = LoopDepth;
+		LoopDepth = 0;
+		++FunctionDepth;
+		const bool bParsedBody = ParseBlock(Node);
+		--FunctionDepth;
+		LoopDepth = SavedLoopDepth;
+		return bParsedBody;
+	}
+
+	bool FParser::ParseClassDef(int32 Parent, const TArray<int32>& Decorators)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		FString Name;
+		if (!ExpectName(Name))
+		{
+			return false;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::ClassDef, Token, Name);
+		AddChild(Parent, Node);
+		for (const int32 Decorator : Decorators)
+		{
+			AddChild(Node, Decorator);
+		}
+
+		if (AcceptOp(TEXT("(")) && (!ParseCallArguments(Node, TEXT(")")) || !ExpectOp(TEXT(")"))))
+		{
+			return false;
+		}
+
+		if (!ExpectOp(TEXT(":")))
+		{
+			return false;
+		}
+
+		// The class body is neither inside a loop nor inside a function
+		const int32 SavedLoopDepth = LoopDepth;
+		const int32 SavedFunctionDepth = FunctionDepth;
+		LoopDepth = 0;
+		FunctionDepth = 0;
+		const bool bParsedBody = ParseBlock(Node);
+		LoopDepth = SavedLoopDepth;
+		FunctionDepth = SavedFunctionDepth;
+		return bParsedBody;
+	}
+
+	bool FParser::ParseParameters(int32 Node, const TCHAR* Terminator, bool bAllowAnnotations)
+	{
+		bool bSeenDefault = false;
+		bool bSeenStar = false;
+
+		while (!IsOp(Terminator))
+		{
+			const bool bDoubleStar = AcceptOp(TEXT("**"));
+			const bool bStar = !bDoubleStar && AcceptOp(TEXT("*"));
+			bSeenStar |= bStar;
+
+			// A bare '*' starts keyword-only parameters and '/' ends positional-only ones
+			const bool bMarker = bStar ? (IsOp(TEXT(",")) || IsOp(Terminator)) : (!bDoubleStar && AcceptOp(TEXT("/")));
+			if (!bMarker)
+			{
+				const FPythonToken NameToken = Peek();
+				FString Name;
+				if (!ExpectName(Name))
+				{
+					return false;
+				}
+
+				const int32 Arg = AddNode(EPythonAstNodeType::Arg, NameToken, Name);
+				AddChild(Node, Arg);
+
+				if (bAllowAnnotations && AcceptOp(TEXT(":")))
+				{
+					const int32 Annotation = ParseExpression();
+					if (Annotation == INDEX_NONE)
+					{
+						return false;
+					}
+					AddChild(Arg, Annotation);
+				}
+
+				if (!bStar && !bDoubleStar)
+				{
+					if (AcceptOp(TEXT("=")))
+					{
+						const int32 Default = ParseExpression();
+						if (Default == INDEX_NONE)
+						{
+							return false;
+						}
+						AddChild(Arg, Default);
+						bSeenDefault = true;
+					}
+					else if (bSeenDefault && !bSeenStar)
+					{
+						return Fail(NameToken, TEXT("non-default argument follows default argument"));
+					}
+				}
+			}
+
+			if (!AcceptOp(TEXT(",")))
+			{
+				break;
+			}
+		}
+		return true;
+	}
+
+	bool FParser::ParseImport(int32 Parent)
+	{
+		++Pos;
+		do
+		{
+			const FPythonToken ModuleToken = Peek();
+			FString Module;
+			if (!ParseDottedName(Module))
+			{
+				return false;
+			}
+
+			const int32 Node = AddNode(EPythonAstNodeType::Import, ModuleToken, Module);
+			AddChild(Parent, Node);
+
+			if (AcceptKeyword(TEXT("as")))
+			{
+				const FPythonToken AliasToken = Peek();
+				FString Alias;
+				if (!ExpectName(Alias))
+				{
+					return false;
+				}
+				AddChild(Node, AddNode(EPythonAstNodeType::Alias, AliasToken, Alias));
+			}
+		}
+		while (AcceptOp(TEXT(",")));
+		return true;
+	}
+
+	bool FParser::ParseFromImport(int32 Parent)
+	{
+		++Pos;
+
+		const FPythonToken ModuleToken = Peek();
+		FString Module;
+		while (IsOp(TEXT(".")) || IsOp(TEXT("...")))
+		{
+			Module += GetText(Peek());
+			++Pos;
+		}
+		if (!IsKeyword(TEXT("import")) || Module.IsEmpty())
+		{
+			FString DottedName;
+			if (!ParseDottedName(DottedName))
+			{
+				return false;
+			}
+			Module += DottedName;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::ImportFrom, ModuleToken, Module);
+		AddChild(Parent, Node);
+
+		if (!ExpectKeyword(TEXT("import")))
+		{
+			return false;
+		}
+
+		if (IsOp(TEXT("*")))
+		{
+			AddChild(Node, AddNode(EPythonAstNodeType::Alias, Peek(), TEXT("*")));
+			++Pos;
+			return true;
+		}
+
+		const bool bParenthesized = AcceptOp(TEXT("("));
+		do
+		{
+			if (bParenthesized && IsOp(TEXT(")")))
+			{
+				break;
+			}
+
+			const FPythonToken NameToken = Peek();
+			FString Name;
+			if (!ExpectName(Name))
+			{
+				return false;
+			}
+			AddChild(Node, AddNode(EPythonAstNodeType::Alias, NameToken, Name));
+
+			FString Alias;
+			if (AcceptKeyword(TEXT("as")) && !ExpectName(Alias))
+			{
+				return false;
+			}
+		}
+		while (AcceptOp(TEXT(",")));
+
+		return !bParenthesized || ExpectOp(TEXT(")"));
+	}
+
+	bool FParser::ParseDottedName(FString& OutName)
+	{
+		if (!ExpectName(OutName))
+		{
+			return false;
+		}
+
+		while (AcceptOp(TEXT(".")))
+		{
+			FString Part;
+			if (!ExpectName(Part))
+			{
+				return false;
+			}
+			OutName += TEXT(".") + Part;
+		}
+		return true;
+	}
+
+	bool FParser::IsMatchStatement() const
+	{
+		// 'match' is a soft keyword: the line is a match statement only if it has a subject, ends with ':' and opens a block
+		for (int32 Ahead = 1; ; ++Ahead)
+		{
+			const FPythonToken& Token = Peek(Ahead);
+			if (Token.Type == EPythonTokenType::Newline)
+			{
+				return Ahead > 2 && IsOp(TEXT(":"), Ahead - 1) && Peek(Ahead + 1).Type == EPythonTokenType::Indent;
+			}
+			if (Token.Type == EPythonTokenType::EndOfFile)
+			{
+				return false;
+			}
+		}
+	}
+
+	bool FParser::ParseMatch(int32 Parent)
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::Match, Token);
+		AddChild(Parent, Node);
+
+		const int32 Subject = ParseStarExpressions();
+		if (Subject == INDEX_NONE || !ExpectOp(TEXT(":")) || !ExpectNewline())
+		{
+			return false;
+		}
+		AddChild(Node, Subject);
+
+		if (Peek().Type != EPythonTokenType::Indent)
+		{
+			return Fail(Peek(), TEXT("expected an indented block"));
+		}
+		++Pos;
+
+		while (Peek().Type != EPythonTokenType::Dedent && Peek().Type != EPythonTokenType::EndOfFile)
+		{
+			const FPythonToken CaseToken = Peek();
+			if (!AcceptKeyword(TEXT("case")))
+			{
+				return Fail(CaseToken, TEXT("expected 'case' block"));
+			}
+
+			const int32 Case = AddNode(EPythonAstNodeType::MatchCase, CaseToken);
+			AddChild(Node, Case);
+
+			if (!ParsePatterns(Case))
+			{
+				return false;
+			}
+
+			if (AcceptKeyword(TEXT("if")))
+			{
+				const int32 Guard = ParseNamedExpression();
+				if (Guard == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Case, Guard);
+			}
+
+			if (!ExpectOp(TEXT(":")) || !ParseBlock(Case))
+			{
+				return false;
+			}
+		}
+
+		if (Peek().Type == EPythonTokenType::Dedent)
+		{
+			++Pos;
+		}
+		return true;
+	}
+
+	bool FParser::ParsePatterns(int32 Case)
+	{
+		// Patterns are parsed with expression syntax, which covers literal, capture, value, sequence, mapping, class and or-patterns
+		do
+		{
+			if (Ast.Nodes[Case].Children.Num() > 0 && (IsOp(TEXT(":")) || IsKeyword(TEXT("if"))))
+			{
+				break;
+			}
+
+			const int32 Pattern = ParseStarTarget();
+			if (Pattern == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Case, Pattern);
+
+			if (AcceptKeyword(TEXT("as")))
+			{
+				const FPythonToken NameToken = Peek();
+				FString Name;
+				if (!ExpectName(Name))
+				{
+					return false;
+				}
+				AddChild(Case, AddNode(EPythonAstNodeType::Name, NameToken, Name));
+			}
+		}
+		while (AcceptOp(TEXT(",")));
+		return true;
+	}
+
+	int32 FParser::ParseStarExpressions()
+	{
+		const FPythonToken Start = Peek();
+		const int32 First = ParseStarExpression();
+		if (First == INDEX_NONE || !IsOp(TEXT(",")))
+		{
+			return First;
+		}
+
+		const int32 Tuple = AddNode(EPythonAstNodeType::Tuple, Start);
+		AddChild(Tuple, First);
+		while (AcceptOp(TEXT(",")))
+		{
+			if (!IsExpressionStart(Peek()))
+			{
+				break;
+			}
+
+			const int32 Next = ParseStarExpression();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Tuple, Next);
+		}
+		return Tuple;
+	}
+
+	int32 FParser::ParseStarred()
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Value = ParseBinary(0);
+		if (Value == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::Starred, Token);
+		AddChild(Node, Value);
+		return Node;
+	}
+
+	int32 FParser::ParseStarExpression()
+	{
+		return IsOp(TEXT("*")) ? ParseStarred() : ParseExpression();
+	}
+
+	int32 FParser::ParseStarNamedExpression()
+	{
+		return IsOp(TEXT("*")) ? ParseStarred() : ParseNamedExpression();
+	}
+
+	int32 FParser::ParseStarTarget()
+	{
+		return IsOp(TEXT("*")) ? ParseStarred() : ParseBinary(0);
+	}
+
+	int32 FParser::ParseStarTargets()
+	{
+		const FPythonToken Start = Peek();
+		const int32 First = ParseStarTarget();
+		if (First == INDEX_NONE || !IsOp(TEXT(",")))
+		{
+			return First;
+		}
+
+		const int32 Tuple = AddNode(EPythonAstNodeType::Tuple, Start);
+		AddChild(Tuple, First);
+		while (AcceptOp(TEXT(",")))
+		{
+			if (!IsExpressionStart(Peek()))
+			{
+				break;
+			}
+
+			const int32 Next = ParseStarTarget();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Tuple, Next);
+		}
+		return Tuple;
+	}
+
+	int32 FParser::ParseNamedExpression()
+	{
+		if (Peek().Type != EPythonTokenType::Name || !IsOp(TEXT(":="), 1))
+		{
+			return ParseExpression();
+		}
+
+		const FPythonToken NameToken = Peek();
+		FString Name;
+		if (!ExpectName(Name))
+		{
+			return INDEX_NONE;
+		}
+		++Pos;
+
+		const int32 Value = ParseExpression();
+		if (Value == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::NamedExpr, NameToken);
+		AddChild(Node, AddNode(EPythonAstNodeType::Name, NameToken, Name));
+		AddChild(Node, Value);
+		return Node;
+	}
+
+	int32 FParser::ParseExpression()
+	{
+		if (!EnterNesting())
+		{
+			return INDEX_NONE;
+		}
+		ON_SCOPE_EXIT { --Depth; };
+
+		if (IsKeyword(TEXT("lambda")))
+		{
+			return ParseLambda();
+		}
+
+		const FPythonToken Start = Peek();
+		const int32 Body = ParseDisjunction();
+		if (Body == INDEX_NONE || !AcceptKeyword(TEXT("if")))
+		{
+			return Body;
+		}
+
+		const int32 Test = ParseDisjunction();
+		if (Test == INDEX_NONE || !ExpectKeyword(TEXT("else")))
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 OrElse = ParseExpression();
+		if (OrElse == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::IfExp, Start);
+		AddChild(Node, Body);
+		AddChild(Node, Test);
+		AddChild(Node, OrElse);
+		return Node;
+	}
+
+	int32 FParser::ParseLambda()
+	{
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::Lambda, Token);
+		if (!ParseParameters(Node, TEXT(":"), false) || !ExpectOp(TEXT(":")))
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Body = ParseExpression();
+		if (Body == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+		AddChild(Node, Body);
+		return Node;
+	}
+
+	int32 FParser::ParseDisjunction()
+	{
+		const FPythonToken Start = Peek();
+		const int32 First = ParseConjunction();
+		if (First == INDEX_NONE || !IsKeyword(TEXT("or")))
+		{
+			return First;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::BoolOp, Start, TEXT("or"));
+		AddChild(Node, First);
+		while (AcceptKeyword(TEXT("or")))
+		{
+			const int32 Next = ParseConjunction();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Node, Next);
+		}
+		return Node;
+	}
+
+	int32 FParser::ParseConjunction()
+	{
+		const FPythonToken Start = Peek();
+		const int32 First = ParseInversion();
+		if (First == INDEX_NONE || !IsKeyword(TEXT("and")))
+		{
+			return First;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::BoolOp, Start, TEXT("and"));
+		AddChild(Node, First);
+		while (AcceptKeyword(TEXT("and")))
+		{
+			const int32 Next = ParseInversion();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Node, Next);
+		}
+		return Node;
+	}
+
+	int32 FParser::ParseInversion()
+	{
+		if (!IsKeyword(TEXT("not")))
+		{
+			return ParseComparison();
+		}
+
+		if (!EnterNesting())
+		{
+			return INDEX_NONE;
+		}
+		ON_SCOPE_EXIT { --Depth; };
+
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Operand = ParseInversion();
+		if (Operand == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::UnaryOp, Token, TEXT("not"));
+		AddChild(Node, Operand);
+		return Node;
+	}
+
+	int32 FParser::ParseComparison()
+	{
+		static const TCHAR* const ComparisonOperators[] = { TEXT("=="), TEXT("!="), TEXT("<"), TEXT(">"), TEXT("<="), TEXT(">=") };
+
+		const FPythonToken Start = Peek();
+		const int32 First = ParseBinary(0);
+		if (First == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		int32 Node = INDEX_NONE;
+		for (;;)
+		{
+			FString Operator;
+			for (const TCHAR* Candidate : ComparisonOperators)
+			{
+				if (IsOp(Candidate))
+				{
+					Operator = Candidate;
+					++Pos;
+					break;
+				}
+			}
+
+			if (Operator.IsEmpty())
+			{
+				if (AcceptKeyword(TEXT("in")))
+				{
+					Operator = TEXT("in");
+				}
+				else if (IsKeyword(TEXT("not")) && IsKeyword(TEXT("in"), 1))
+				{
+					Operator = TEXT("not in");
+					Pos += 2;
+				}
+				else if (AcceptKeyword(TEXT("is")))
+				{
+					Operator = AcceptKeyword(TEXT("not")) ? TEXT("is not") : TEXT("is");
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			// Chained comparisons share one node; Name lists the operators in order
+			if (Node == INDEX_NONE)
+			{
+				Node = AddNode(EPythonAstNodeType::Compare, Start, Operator);
+				AddChild(Node, First);
+			}
+			else
+			{
+				Ast.Nodes[Node].Name += TEXT(",") + Operator;
+			}
+
+			const int32 Next = ParseBinary(0);
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Node, Next);
+		}
+
+		return Node == INDEX_NONE ? First : Node;
+	}
+
+	int32 FParser::ParseBinary(int32 Level)
+	{
+		if (Level == UE_ARRAY_COUNT(BinaryOperators))
+		{
+			return ParseFactor();
+		}
+
+		const FPythonToken Start = Peek();
+		int32 Left = ParseBinary(Level + 1);
+		while (Left != INDEX_NONE)
+		{
+			const TCHAR* Operator = nullptr;
+			for (const TCHAR* Candidate : BinaryOperators[Level])
+			{
+				if (Candidate && IsOp(Candidate))
+				{
+					Operator = Candidate;
+					break;
+				}
+			}
+			if (!Operator)
+			{
+				break;
+			}
+			++Pos;
+
+			const int32 Right = ParseBinary(Level + 1);
+			if (Right == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+
+			const int32 Node = AddNode(EPythonAstNodeType::BinOp, Start, Operator);
+			AddChild(Node, Left);
+			AddChild(Node, Right);
+			Left = Node;
+		}
+		return Left;
+	}
+
+	int32 FParser::ParseFactor()
+	{
+		if (!IsOp(TEXT("-")) && !IsOp(TEXT("+")) && !IsOp(TEXT("~")))
+		{
+			return ParsePower();
+		}
+
+		if (!EnterNesting())
+		{
+			return INDEX_NONE;
+		}
+		ON_SCOPE_EXIT { --Depth; };
+
+		const FPythonToken Token = Peek();
+		++Pos;
+
+		const int32 Operand = ParseFactor();
+		if (Operand == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::UnaryOp, Token, GetText(Token));
+		AddChild(Node, Operand);
+		return Node;
+	}
+
+	int32 FParser::ParsePower()
+	{
+		const FPythonToken Start = Peek();
+
+		int32 Base = INDEX_NONE;
+		if (AcceptKeyword(TEXT("await")))
+		{
+			const int32 Value = ParsePrimary();
+			if (Value == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			Base = AddNode(EPythonAstNodeType::Await, Start);
+			AddChild(Base, Value);
+		}
+		else
+		{
+			Base = ParsePrimary();
+		}
+
+		if (Base == INDEX_NONE || !AcceptOp(TEXT("**")))
+		{
+			return Base;
+		}
+
+		const int32 Exponent = ParseFactor();
+		if (Exponent == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::BinOp, Start, TEXT("**"));
+		AddChild(Node, Base);
+		AddChild(Node, Exponent);
+		return Node;
+	}
+
+	int32 FParser::ParsePrimary()
+	{
+		const FPythonToken Start = Peek();
+		int32 Node = ParseAtom();
+
+		while (Node != INDEX_NONE)
+		{
+			if (AcceptOp(TEXT(".")))
+			{
+				const FPythonToken NameToken = Peek();
+				FString Name;
+				if (!ExpectName(Name))
+				{
+					return INDEX_NONE;
+				}
+
+				const int32 Attribute = AddNode(EPythonAstNodeType::Attribute, NameToken, Name);
+				AddChild(Attribute, Node);
+				Node = Attribute;
+			}
+			else if (AcceptOp(TEXT("(")))
+			{
+				const int32 Call = AddNode(EPythonAstNodeType::Call, Start);
+				AddChild(Call, Node);
+				if (!ParseCallArguments(Call, TEXT(")")) || !ExpectOp(TEXT(")")))
+				{
+					return INDEX_NONE;
+				}
+				Node = Call;
+			}
+			else if (AcceptOp(TEXT("[")))
+			{
+				const int32 Subscript = AddNode(EPythonAstNodeType::Subscript, Start);
+				AddChild(Subscript, Node);
+
+				const int32 Slices = ParseSlices();
+				if (Slices == INDEX_NONE || !ExpectOp(TEXT("]")))
+				{
+					return INDEX_NONE;
+				}
+				AddChild(Subscript, Slices);
+				Node = Subscript;
+			}
+			else
+			{
+				break;
+			}
+		}
+		return Node;
+	}
+
+	int32 FParser::ParseAtom()
+	{
+		const FPythonToken Token = Peek();
+		const FStringView Text = GetText(Token);
+
+		switch (Token.Type)
+		{
+		case EPythonTokenType::Name:
+			if (Text.Equals(TEXT("None"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("True"), ESearchCase::CaseSensitive) || Text.Equals(TEXT("False"), ESearchCase::CaseSensitive))
+			{
+				++Pos;
+				return AddNode(EPythonAstNodeType::Constant, Token, Text);
+			}
+			if (!IsReservedKeyword(Text))
+			{
+				++Pos;
+				return AddNode(EPythonAstNodeType::Name, Token, Text);
+			}
+			break;
+
+		case EPythonTokenType::Number:
+			++Pos;
+			return AddNode(EPythonAstNodeType::Constant, Token, Text);
+
+		case EPythonTokenType::String:
+			return ParseStrings();
+
+		case EPythonTokenType::Operator:
+			if (IsOp(TEXT("(")))
+			{
+				return ParseParenthesized();
+			}
+			if (IsOp(TEXT("[")))
+			{
+				return ParseListDisplay();
+			}
+			if (IsOp(TEXT("{")))
+			{
+				return ParseBraceDisplay();
+			}
+			if (IsOp(TEXT("...")))
+			{
+				++Pos;
+				return AddNode(EPythonAstNodeType::Constant, Token, Text);
+			}
+			break;
+
+		default:
+			break;
+		}
+
+		Fail(Token, TEXT("invalid syntax"));
+		return INDEX_NONE;
+	}
+
+	int32 FParser::ParseParenthesized()
+	{
+		const FPythonToken Start = Peek();
+		++Pos;
+
+		if (AcceptOp(TEXT(")")))
+		{
+			return AddNode(EPythonAstNodeType::Tuple, Start);
+		}
+
+		if (IsKeyword(TEXT("yield")))
+		{
+			const int32 Yield = ParseYield();
+			return (Yield != INDEX_NONE && ExpectOp(TEXT(")"))) ? Yield : INDEX_NONE;
+		}
+
+		const int32 First = ParseStarNamedExpression();
+		if (First == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+
+		if (IsComprehensionStart())
+		{
+			const int32 Generator = AddNode(EPythonAstNodeType::GeneratorExp, Start);
+			AddChild(Generator, First);
+			return (ParseComprehensionClauses(Generator) && ExpectOp(TEXT(")"))) ? Generator : INDEX_NONE;
+		}
+
+		if (!IsOp(TEXT(",")))
+		{
+			// Plain parentheses do not get a node
+			return ExpectOp(TEXT(")")) ? First : INDEX_NONE;
+		}
+
+		const int32 Tuple = AddNode(EPythonAstNodeType::Tuple, Start);
+		AddChild(Tuple, First);
+		while (AcceptOp(TEXT(",")) && !IsOp(TEXT(")")))
+		{
+			const int32 Next = ParseStarNamedExpression();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Tuple, Next);
+		}
+		return ExpectOp(TEXT(")")) ? Tuple : INDEX_NONE;
+	}
+
+	int32 FParser::ParseListDisplay()
+	{
+		const FPythonToken Start = Peek();
+		++Pos;
+
+		const int32 Node = AddNode(EPythonAstNodeType::List, Start);
+		if (AcceptOp(TEXT("]")))
+		{
+			return Node;
+		}
+
+		const int32 First = ParseStarNamedExpression();
+		if (First == INDEX_NONE)
+		{
+			return INDEX_NONE;
+		}
+		AddChild(Node, First);
+
+		if (IsComprehensionStart())
+		{
+			Ast.Nodes[Node].Type = EPythonAstNodeType::ListComp;
+			return (ParseComprehensionClauses(Node) && ExpectOp(TEXT("]"))) ? Node : INDEX_NONE;
+		}
+
+		while (AcceptOp(TEXT(",")) && !IsOp(TEXT("]")))
+		{
+			const int32 Next = ParseStarNamedExpression();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Node, Next);
+		}
+		return ExpectOp(TEXT("]")) ? Node : INDEX_NONE;
+	}
+
+	int32 FParser::ParseBraceDisplay()
+	{
+		const FPythonToken Start = Peek();
+		++Pos;
+
+		if (AcceptOp(TEXT("}")))
+		{
+			return AddNode(EPythonAstNodeType::Dict, Start);
+		}
+
+		// A leading '**' or a ':' after the first item makes it a dict, otherwise it is a set
+		int32 FirstKey = INDEX_NONE;
+		if (!IsOp(TEXT("**")))
+		{
+			FirstKey = ParseStarNamedExpression();
+			if (FirstKey == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+
+			if (!IsOp(TEXT(":")))
+			{
+				const int32 Set = AddNode(EPythonAstNodeType::Set, Start);
+				AddChild(Set, FirstKey);
+
+				if (IsComprehensionStart())
+				{
+					Ast.Nodes[Set].Type = EPythonAstNodeType::SetComp;
+					return (ParseComprehensionClauses(Set) && ExpectOp(TEXT("}"))) ? Set : INDEX_NONE;
+				}
+
+				while (AcceptOp(TEXT(",")) && !IsOp(TEXT("}")))
+				{
+					const int32 Next = ParseStarNamedExpression();
+					if (Next == INDEX_NONE)
+					{
+						return INDEX_NONE;
+					}
+					AddChild(Set, Next);
+				}
+				return ExpectOp(TEXT("}")) ? Set : INDEX_NONE;
+			}
+		}
+
+		const int32 Dict = AddNode(EPythonAstNodeType::Dict, Start);
+		bool bFirstItem = true;
+		do
+		{
+			if (IsOp(TEXT("}")))
+			{
+				break;
+			}
+
+			if (AcceptOp(TEXT("**")))
+			{
+				const int32 Unpacked = ParseBinary(0);
+				if (Unpacked == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+				AddChild(Dict, Unpacked);
+			}
+			else
+			{
+				const int32 Key = (bFirstItem && FirstKey != INDEX_NONE) ? FirstKey : ParseExpression();
+				if (Key == INDEX_NONE || !ExpectOp(TEXT(":")))
+				{
+					return INDEX_NONE;
+				}
+
+				const int32 Value = ParseExpression();
+				if (Value == INDEX_NONE)
+				{
+					return INDEX_NONE;
+				}
+				AddChild(Dict, Key);
+				AddChild(Dict, Value);
+
+				if (bFirstItem && IsComprehensionStart())
+				{
+					Ast.Nodes[Dict].Type = EPythonAstNodeType::DictComp;
+					return (ParseComprehensionClauses(Dict) && ExpectOp(TEXT("}"))) ? Dict : INDEX_NONE;
+				}
+			}
+			bFirstItem = false;
+		}
+		while (AcceptOp(TEXT(",")));
+
+		return ExpectOp(TEXT("}")) ? Dict : INDEX_NONE;
+	}
+
+	int32 FParser::ParseYield()
+	{
+		const FPythonToken Token = Peek();
+		if (FunctionDepth == 0)
+		{
+			Fail(Token, TEXT("'yield' outside function"));
+			return INDEX_NONE;
+		}
+		++Pos;
+
+		if (AcceptKeyword(TEXT("from")))
+		{
+			const int32 Value = ParseExpression();
+			if (Value == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			const int32 Node = AddNode(EPythonAstNodeType::YieldFrom, Token);
+			AddChild(Node, Value);
+			return Node;
+		}
+
+		const int32 Node = AddNode(EPythonAstNodeType::Yield, Token);
+		if (IsExpressionStart(Peek()))
+		{
+			const int32 Value = ParseStarExpressions();
+			if (Value == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Node, Value);
+		}
+		return Node;
+	}
+
+	int32 FParser::ParseSlices()
+	{
+		const FPythonToken Start = Peek();
+		const int32 First = ParseSlice();
+		if (First == INDEX_NONE || !IsOp(TEXT(",")))
+		{
+			return First;
+		}
+
+		const int32 Tuple = AddNode(EPythonAstNodeType::Tuple, Start);
+		AddChild(Tuple, First);
+		while (AcceptOp(TEXT(",")) && !IsOp(TEXT("]")))
+		{
+			const int32 Next = ParseSlice();
+			if (Next == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Tuple, Next);
+		}
+		return Tuple;
+	}
+
+	int32 FParser::ParseSlice()
+	{
+		const FPythonToken Start = Peek();
+
+		int32 Lower = INDEX_NONE;
+		if (!IsOp(TEXT(":")))
+		{
+			Lower = ParseStarNamedExpression();
+			if (Lower == INDEX_NONE || !IsOp(TEXT(":")))
+			{
+				return Lower;
+			}
+		}
+		++Pos;
+
+		const int32 Slice = AddNode(EPythonAstNodeType::Slice, Start);
+		AddChild(Slice, Lower);
+
+		auto IsSliceEnd = [this]() { return IsOp(TEXT("]")) || IsOp(TEXT(",")); };
+
+		if (!IsOp(TEXT(":")) && !IsSliceEnd())
+		{
+			const int32 Upper = ParseExpression();
+			if (Upper == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Slice, Upper);
+		}
+
+		if (AcceptOp(TEXT(":")) && !IsSliceEnd())
+		{
+			const int32 Step = ParseExpression();
+			if (Step == INDEX_NONE)
+			{
+				return INDEX_NONE;
+			}
+			AddChild(Slice, Step);
+		}
+		return Slice;
+	}
+
+	bool FParser::ParseCallArguments(int32 Node, const TCHAR* Closing)
+	{
+		bool bSeenKeyword = false;
+
+		while (!IsOp(Closing))
+		{
+			const FPythonToken Token = Peek();
+
+			if (AcceptOp(TEXT("**")))
+			{
+				const int32 Value = ParseExpression();
+				if (Value == INDEX_NONE)
+				{
+					return false;
+				}
+				const int32 Keyword = AddNode(EPythonAstNodeType::Keyword, Token);
+				AddChild(Keyword, Value);
+				AddChild(Node, Keyword);
+				bSeenKeyword = true;
+			}
+			else if (IsOp(TEXT("*")))
+			{
+				const int32 Starred = ParseStarred();
+				if (Starred == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Node, Starred);
+			}
+			else if (Token.Type == EPythonTokenType::Name && IsOp(TEXT("="), 1))
+			{
+				FString Name;
+				if (!ExpectName(Name))
+				{
+					return false;
+				}
+				++Pos;
+
+				const int32 Value = ParseExpression();
+				if (Value == INDEX_NONE)
+				{
+					return false;
+				}
+				const int32 Keyword = AddNode(EPythonAstNodeType::Keyword, Token, Name);
+				AddChild(Keyword, Value);
+				AddChild(Node, Keyword);
+				bSeenKeyword = true;
+			}
+			else
+			{
+				if (bSeenKeyword)
+				{
+					return Fail(Token, TEXT("positional argument follows keyword argument"));
+				}
+
+				int32 Argument = ParseNamedExpression();
+				if (Argument == INDEX_NONE)
+				{
+					return false;
+				}
+
+				// A generator expression may be passed without its own parentheses
+				if (IsComprehensionStart())
+				{
+					const int32 Generator = AddNode(EPythonAstNodeType::GeneratorExp, Token);
+					AddChild(Generator, Argument);
+					if (!ParseComprehensionClauses(Generator))
+					{
+						return false;
+					}
+					Argument = Generator;
+				}
+				AddChild(Node, Argument);
+			}
+
+			if (!AcceptOp(TEXT(",")))
+			{
+				break;
+			}
+		}
+		return true;
+	}
+
+	bool FParser::ParseComprehensionClauses(int32 Node)
+	{
+		while (IsComprehensionStart())
+		{
+			const FPythonToken Token = Peek();
+			AcceptKeyword(TEXT("async"));
+			++Pos;
+
+			const int32 Comprehension = AddNode(EPythonAstNodeType::Comprehension, Token);
+			AddChild(Node, Comprehension);
+
+			const int32 Target = ParseStarTargets();
+			if (Target == INDEX_NONE || !CheckAssignable(Target, TEXT("assign to")) || !ExpectKeyword(TEXT("in")))
+			{
+				return false;
+			}
+			AddChild(Comprehension, Target);
+
+			const int32 Iterable = ParseDisjunction();
+			if (Iterable == INDEX_NONE)
+			{
+				return false;
+			}
+			AddChild(Comprehension, Iterable);
+
+			while (AcceptKeyword(TEXT("if")))
+			{
+				const int32 Condition = ParseDisjunction();
+				if (Condition == INDEX_NONE)
+				{
+					return false;
+				}
+				AddChild(Comprehension, Condition);
+			}
+		}
+		return true;
+	}
+
+	int32 FParser::ParseStrings()
+	{
+		// Adjacent literals are concatenated into one node, which is a JoinedStr if any part is an f-string
+		const FPythonToken Start = Peek();
+		const int32 Node = AddNode(EPythonAstNodeType::Constant, Start);
+
+		while (Peek().Type == EPythonTokenType::String)
+		{
+			const FPythonToken Token = Peek();
+			++Pos;
+
+			const FStringView Text = GetText(Token);
+			bool bFormat = false;
+			for (int32 Index = 0; Text[Index] != TEXT('\'') && Text[Index] != TEXT('"'); ++Index)
+			{
+				bFormat |= FChar::ToLower(Text[Index]) == TEXT('f');
+			}
+
+			if (bFormat)
+			{
+				Ast.Nodes[Node].Type = EPythonAstNodeType::JoinedStr;
+				if (!ParseFormatString(Node, Token))
+				{
+					return INDEX_NONE;
+				}
+			}
+		}
+		return Node;
+	}
+
+	bool FParser::ParseFormatString(int32 Node, const FPythonToken& Token)
+	{
+		const FStringView Text = GetText(Token);
+
+		int32 PrefixLength = 0;
+		bool bRaw = false;
+		while (Text[PrefixLength] != TEXT('\'') && Text[PrefixLength] != TEXT('"'))
+		{
+			bRaw |= FChar::ToLower(Text[PrefixLength]) == TEXT('r');
+			++PrefixLength;
+		}
+
+		const TCHAR Quote = Text[PrefixLength];
+		const bool bTripleQuoted = Text.Len() - PrefixLength >= 6 && Text[PrefixLength + 1] == Quote && Text[PrefixLength + 2] == Quote;
+		const int32 QuoteLength = bTripleQuoted ? 3 : 1;
+
+		int32 Index = Token.Offset + PrefixLength + QuoteLength;
+		const int32 End = Token.Offset + Token.Length - QuoteLength;
+		return ParseFormatStringText(Node, Token, Index, End, bRaw, false);
+	}
+
+	bool FParser::ParseFormatStringText(int32 Node, const FPythonToken& Token, int32& Index, int32 End, bool bRaw, bool bInFormatSpec)
+	{
+		while (Index < End)
+		{
+			const TCHAR Char = Source[Index];
+			if (Char == TEXT('{'))
+			{
+				if (!bInFormatSpec && Index + 1 < End && Source[Index + 1] == TEXT('{'))
+				{
+					Index += 2;
+				}
+				else if (!ParseFormatStringField(Node, Token, Index, End, bRaw))
+				{
+					return false;
+				}
+			}
+			else if (Char == TEXT('}'))
+			{
+				if (bInFormatSpec)
+				{
+					// Closes the field that owns this format spec
+					return true;
+				}
+				if (Index + 1 >= End || Source[Index + 1] != TEXT('}'))
+				{
+					return FailAtOffset(Token, Index, TEXT("f-string: single '}' is not allowed"));
+				}
+				Index += 2;
+			}
+			else if (Char == TEXT('\\') && !bRaw)
+			{
+				// Skip the escaped character, including named escapes such as \N{BULLET} whose braces are not fields
+				if (Index + 2 < End && Source[Index + 1] == TEXT('N') && Source[Index + 2] == TEXT('{'))
+				{
+					Index += 3;
+					while (Index < End && Source[Index] != TEXT('}'))
+					{
+						++Index;
+					}
+					++Index;
+				}
+				else
+				{
+					Index += (Index + 1 < End && Source[Index + 1] != TEXT('{') && Source[Index + 1] != TEXT('}')) ? 2 : 1;
+				}
+			}
+			else
+			{
+				++Index;
+			}
+		}
+		return true;
+	}
+
+	bool FParser::ParseFormatStringField(int32 Node, const FPythonToken& Token, int32& Index, int32 End, bool bRaw)
+	{
+		const int32 FieldStart = Index;
+		const int32 ExpressionStart = Index + 1;
+
+		// Find the end of the expression: a top-level '}', '!' conversion, ':' format spec or '=' self-documenting marker
+		int32 Cursor = ExpressionStart;
+		int32 Nesting = 0;
+		TCHAR Quote = 0;
+		for (; Cursor < End; ++Cursor)
+		{
+			const TCHAR Char = Source[Cursor];
+			if (Quote != 0)
+			{
+				if (Char == Quote)
+				{
+					Quote = 0;
+				}
+			}
+			else if (Char == TEXT('\'') || Char == TEXT('"'))
+			{
+				Quote = Char;
+			}
+			else if (Char == TEXT('(') || Char == TEXT('[') || Char == TEXT('{'))
+			{
+				++Nesting;
+			}
+			else if (Char == TEXT(')') || Char == TEXT(']') || Char == TEXT('}'))
+			{
+				if (Nesting == 0 && Char == TEXT('}'))
+				{
+					break;
+				}
+				Nesting = FMath::Max(Nesting - 1, 0);
+			}
+			else if (Nesting == 0)
+			{
+				const TCHAR Next = Cursor + 1 < End ? Source[Cursor + 1] : TEXT('\0');
+				const TCHAR Previous = Source[Cursor - 1];
+				if ((Char == TEXT('!') && Next != TEXT('=')) || Char == TEXT(':') ||
+					(Char == TEXT('=') && Next != TEXT('=') && Previous != TEXT('=') && Previous != TEXT('!') && Previous != TEXT('<') && Previous != TEXT('>')))
+				{
+					break;
+				}
+			}
+		}
+
+		if (Cursor >= End)
+		{
+			return FailAtOffset(Token, FieldStart, TEXT("f-string: expecting '}'"));
+		}
+		if (FString(Source.Mid(ExpressionStart, Cursor - ExpressionStart)).TrimStartAndEnd().IsEmpty())
+		{
+			return FailAtOffset(Token, FieldStart, TEXT("f-string: empty expression not allowed"));
+		}
+		if (!ParseFormatStringExpression(Node, Token, ExpressionStart, Cursor))
+		{
+			return false;
+		}
+
+		if (Source[Cursor] == TEXT('='))
+		{
+			++Cursor;
+			while (Cursor < End && FChar::IsWhitespace(Source[Cursor]))
+			{
+				++Cursor;
+			}
+		}
+
+		if (Cursor < End && Source[Cursor] == TEXT('!'))
+		{
+			++Cursor;
+			if (Cursor >= End || (Source[Cursor] != TEXT('r') && Source[Cursor] != TEXT('s') && Source[Cursor] != TEXT('a')))
+			{
+				return FailAtOffset(Token, Cursor, TEXT("f-string: invalid conversion character"));
+			}
+			++Cursor;
+		}
+
+		if (Cursor < End && Source[Cursor] == TEXT(':'))
+		{
+			++Cursor;
+			if (!ParseFormatStringText(Node, Token, Cursor, End, bRaw, true))
+			{
+				return false;
+			}
+		}
+
+		if (Cursor >= End || Source[Cursor] != TEXT('}'))
+		{
+			return FailAtOffset(Token, FieldStart, TEXT("f-string: expecting '}'"));
+		}
+
+		Index = Cursor + 1;
+		return true;
+	}
+
+	bool FParser::ParseFormatStringExpression(int32 Node, const FPythonToken& Token, int32 Start, int32 End)
+	{
+		int32 Line = 0;
+		int32 LineStart = 0;
+		GetLineStart(Token, Start, Line, LineStart);
+
+		TArray<FPythonToken> FieldTokens;
+		FTokenizer Tokenizer(Source, Start, End, Line, LineStart, /*bInExpressionOnly*/ true);
+		if (!Tokenizer.Run(FieldTokens, Error))
+		{
+			bFailed = true;
+			return false;
+		}
+
+		// Parse the field with its own token stream, sharing the tree
+		TArray<FPythonToken> SavedTokens = MoveTemp(Tokens);
+		const int32 SavedPos = Pos;
+		Tokens = MoveTemp(FieldTokens);
+		Pos = 0;
+
+		int32 Expression = ParseStarExpressions();
+		if (Expression != INDEX_NONE && Peek().Type != EPythonTokenType::EndOfFile)
+		{
+			Fail(Peek(), TEXT("f-string: invalid syntax"));
+			Expression = INDEX_NONE;
+		}
+
+		Tokens = MoveTemp(SavedTokens);
+		Pos = SavedPos;
+
+		AddChild(Node, Expression);
+		return Expression != INDEX_NONE;
+	}
+}
+
+bool FUnrealCopilotPythonParser::Tokenize(FStringView Source, TArray<FPythonToken>& OutTokens, FPythonSyntaxError& OutError)
+{
+	using namespace UnrealCopilotPythonParser;
+
+	// Skip a byte order mark
+	const int32 Start = (Source.Len() > 0 && Source[0] == 0xFEFF) ? 1 : 0;
+
+	FTokenizer Tokenizer(Source, Start, Source.Len(), 1, Start, /*bInExpressionOnly*/ false);
+	return Tokenizer.Run(OutTokens, OutError);
+}
+
+bool FUnrealCopilotPythonParser::Parse(FStringView Source, FPythonAst& OutAst, FPythonSyntaxError& OutError)
+{
+	using namespace UnrealCopilotPythonParser;
+
+	OutAst.Nodes.Reset();
+
+	TArray<FPythonToken> Tokens;
+	if (!Tokenize(Source, Tokens, OutError))
+	{
+		return false;
+	}
+
+	FParser Parser(Source, OutAst, OutError);
+	return Parser.ParseModule(MoveTemp(Tokens));
+}
+
+FPythonSafetyPolicy FPythonSafetyPolicy::MakeDefault()
+{
+	static const TCHAR* const ForbiddenNames[] = {
+		TEXT("eval"), TEXT("exec"), TEXT("compile"), TEXT("__import__"), TEXT("open"), TEXT("input"), TEXT("breakpoint"),
+		TEXT("globals"), TEXT("locals"), TEXT("vars"), TEXT("getattr"), TEXT("setattr"), TEXT("delattr"), TEXT("hasattr"),
+		TEXT("__builtins__"), TEXT("__loader__"), TEXT("__spec__")
+	};
+
+	static const TCHAR* const ForbiddenAttributes[] = {
+		TEXT("__class__"), TEXT("__base__"), TEXT("__bases__"), TEXT("__mro__"), TEXT("__subclasses__"), TEXT("__globals__"),
+		TEXT("__builtins__"), TEXT("__code__"), TEXT("__closure__"), TEXT("__dict__"), TEXT("__getattribute__"), TEXT("__reduce__"),
+		TEXT("__reduce_ex__"), TEXT("__loader__"), TEXT("__spec__"), TEXT("__import__"),
+		TEXT("f_globals"), TEXT("f_locals"), TEXT("f_builtins"), TEXT("f_back"), TEXT("gi_frame"), TEXT("gi_code"),
+		TEXT("cr_frame"), TEXT("tb_frame"), TEXT("co_code")
+	};
+
+	FPythonSafetyPolicy Policy;
+	for (const TCHAR* Name : ForbiddenNames)
+	{
+		Policy.ForbiddenNames.Add(Name);
+	}
+	for (const TCHAR* Attribute : ForbiddenAttributes)
+	{
+		Policy.ForbiddenAttributes.Add(Attribute);
+	}
+	return Policy;
+}
+
+void FUnrealCopilotPythonParser::CheckSafety(const FPythonAst& Ast, const FPythonSafetyPolicy& Policy, TArray<FPythonSafetyViolation>& OutViolations)
+{
+	OutViolations.Reset();
+
+	auto AddViolation = [&OutViolations](const FPythonAstNode& Node, const FString& Message)
+	{
+		FPythonSafetyViolation& Violation = OutViolations.AddDefaulted_GetRef();
+		Violation.Message = Message;
+		Violation.Line = Node.Line;
+		Violation.Column = Node.Column;
+	};
+
+	for (const FPythonAstNode& Node : Ast.Nodes)
+	{
+		switch (Node.Type)
+		{
+		case EPythonAstNodeType::Import:
+		case EPythonAstNodeType::ImportFrom:
+		{
+			if (Node.Name.StartsWith(TEXT(".")))
+			{
+				AddViolation(Node, TEXT("Relative imports are not allowed"));
+				break;
+			}
+
+			FString RootModule;
+			if (!Node.Name.Split(TEXT("."), &RootModule, nullptr))
+			{
+				RootModule = Node.Name;
+			}
+			if (Policy.AllowedImports.Num() > 0 && !Policy.AllowedImports.Contains(RootModule))
+			{
+				AddViolation(Node, FString::Printf(TEXT("Import of module '%s' is not allowed"), *Node.Name));
+			}
+			break;
+		}
+
+		case EPythonAstNodeType::Alias:
+			// "from builtins import eval" would bypass the name check
+			if (Node.Parent != INDEX_NONE && Ast.Nodes[Node.Parent].Type == EPythonAstNodeType::ImportFrom && Policy.ForbiddenNames.Contains(Node.Name))
+			{
+				AddViolation(Node, FString::Printf(TEXT("Use of '%s' is not allowed"), *Node.Name));
+			}
+			break;
+
+		case EPythonAstNodeType::Name:
+			if (Policy.ForbiddenNames.Contains(Node.Name))
+			{
+				AddViolation(Node, FString::Printf(TEXT("Use of '%s' is not allowed"), *Node.Name));
+			}
+			break;
+
+		case EPythonAstNodeType::Attribute:
+			if (Policy.ForbiddenAttributes.Contains(Node.Name))
+			{
+				AddViolation(Node, FString::Printf(TEXT("Access to attribute '%s' is not allowed"), *Node.Name));
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	// Nodes are created as their construct completes, so order by position
+	OutViolations.StableSort([](const FPythonSafetyViolation& A, const FPythonSafetyViolation& B)
+	{
+		return A.Line < B.Line || (A.Line == B.Line && A.Column < B.Column);
+	});
+}
@@ -0,0 +1,324 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotSelectionSummarizer.h"
+#include "GameFramework/Actor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Async/ParallelFor.h"
+
+namespace UnrealCopilotSelectionSummarizer
+{
+	/** Partial aggregate built by one parallel task and merged afterwards */
+	struct FSelectionAggregate
+	{
+		int32 NumActors = 0;
+		int32 NumInstances = 0;
+		FBox Bounds = FBox(ForceInit);
+		TMap<FName, int32> ClassCounts;
+		TMap<FName, int32> FolderCounts;
+		TMap<FString, int32> NamePatternCounts;
+
+		/** Lowest actor indices seen per class, used to build a representative sample */
+		TMap<FName, TArray<int32>> ClassSamples;
+	};
+
+	static FString FormatVector(const FVector& Vector)
+	{
+		return FString::Printf(TEXT("(%.0f, %.0f, %.0f)"), Vector.X, Vector.Y, Vector.Z);
+	}
+
+	/** Keep the MaxCount lowest indices so the sample is independent of how work was split across tasks */
+	static void AddSampleIndex(TArray<int32>& Samples, int32 Index, int32 MaxCount)
+	{
+		Samples.Add(Index);
+		if (Samples.Num() > MaxCount)
+		{
+			int32 MaxPosition = 0;
+			for (int32 Position = 1; Position < Samples.Num(); ++Position)
+			{
+				if (Samples[Position] > Samples[MaxPosition])
+				{
+					MaxPosition = Position;
+				}
+			}
+			Samples.RemoveAtSwap(MaxPosition);
+		}
+	}
+
+	static FString GroupKeyToString(const FName& Key)
+	{
+		return Key.IsNone() ? FString(TEXT("(none)")) : Key.ToString();
+	}
+
+	static FString GroupKeyToString(const FString& Key)
+	{
+		return Key.IsEmpty() ? FString(TEXT("(none)")) : Key;
+	}
+
+	/** Format the largest groups of a count map as "Key xCount" entries */
+	template <typename KeyType>
+	static FString FormatTopGroups(const TMap<KeyType, int32>& Counts, int32 MaxGroups)
+	{
+		TArray<TPair<KeyType, int32>> Sorted = Counts.Array();
+		Sorted.Sort([](const TPair<KeyType, int32>& A, const TPair<KeyType, int32>& B) { return A.Value > B.Value; });
+
+		FString Result;
+		int32 Remaining = 0;
+		for (int32 Index = 0; Index < Sorted.Num(); ++Index)
+		{
+			if (Index < MaxGroups)
+			{
+				if (!Result.IsEmpty())
+				{
+					Result += TEXT(", ");
+				}
+				Result += FString::Printf(TEXT("%s x%d"), *GroupKeyToString(Sorted[Index].Key), Sorted[Index].Value);
+			}
+			else
+			{
+				Remaining += Sorted[Index].Value;
+			}
+		}
+
+		if (Remaining > 0)
+		{
+			Result += FString::Printf(TEXT(", %d more in %d other groups"), Remaining, Sorted.Num() - MaxGroups);
+		}
+		return Result;
+	}
+}
+
+FString FUnrealCopilotSelectionSummarizer::Summarize(TConstArrayView<AActor*> Actors, const FSelectionSummaryOptions& Options, TArray<FString>* OutSampleNames)
+{
+	if (OutSampleNames)
+	{
+		OutSampleNames->Reset();
+	}
+
+	if (Actors.Num() == 0)
+	{
+		return FString();
+	}
+
+	if (Actors.Num() <= Options.MaxDetailedActors)
+	{
+		return DescribeActorsInDetail(Actors, Options, OutSampleNames);
+	}
+
+	return DescribeActorsAggregated(Actors, Options, OutSampleNames);
+}
+
+FString FUnrealCopilotSelectionSummarizer::GetNamePattern(const FString& Name)
+{
+	int32 End = Name.Len();
+	while (End > 0 && FChar::IsDigit(Name[End - 1]))
+	{
+		--End;
+	}
+
+	if (End == Name.Len() || End == 0)
+	{
+		return Name;
+	}
+	return Name.Left(End) + TEXT("*");
+}
+
+FString FUnrealCopilotSelectionSummarizer::DescribeActorsInDetail(TConstArrayView<AActor*> Actors, const FSelectionSummaryOptions& Options, TArray<FString>* OutSampleNames)
+{
+	TArray<FString> Lines;
+	Lines.SetNum(Actors.Num());
+
+	ParallelFor(Actors.Num(), [&Actors, &Lines, &Options](int32 Index)
+	{
+		const AActor* Actor = Actors[Index];
+		if (!IsValid(Actor))
+		{
+			return;
+		}
+
+		const FTransform& Transform = Actor->GetActorTransform();
+		const FRotator Rotation = Transform.Rotator();
+		FString Line = FString::Printf(TEXT("\n- %s (%s) Location=%s Rotation=(P=%.0f, Y=%.0f, R=%.0f) Scale=(%.2f, %.2f, %.2f)"),
+			*Actor->GetName(),
+			*Actor->GetClass()->GetName(),
+			*UnrealCopilotSelectionSummarizer::FormatVector(Transform.GetLocation()),
+			Rotation.Pitch, Rotation.Yaw, Rotation.Roll,
+			Transform.GetScale3D().X, Transform.GetScale3D().Y, Transform.GetScale3D().Z);
+
+		TInlineComponentArray<UActorComponent*> Components(Actor);
+		if (Components.Num() > 0)
+		{
+			Line += TEXT(" Components: ");
+			for (int32 ComponentIndex = 0; ComponentIndex < FMath::Min(Components.Num(), Options.MaxComponentsPerActor); ++ComponentIndex)
+			{
+				const UActorComponent* Component = Components[ComponentIndex];
+				if (ComponentIndex > 0)
+				{
+					Line += TEXT(", ");
+				}
+				Line += Component->GetClass()->GetName();
+
+				if (const UInstancedStaticMeshComponent* InstancedComponent = Cast<UInstancedStaticMeshComponent>(Component))
+				{
+					Line += FString::Printf(TEXT("[%d instances]"), InstancedComponent->GetInstanceCount());
+				}
+				else if (const UStaticMeshComponent* MeshComponent = Cast<UStaticMeshComponent>(Component))
+				{
+					if (const UStaticMesh* Mesh = MeshComponent->GetStaticMesh())
+					{
+						Line += FString::Printf(TEXT("[%s]"), *Mesh->GetName());
+					}
+				}
+			}
+
+			if (Components.Num() > Options.MaxComponentsPerActor)
+			{
+				Line += FString::Printf(TEXT(", +%d more"), Components.Num() - Options.MaxComponentsPerActor);
+			}
+		}
+
+		Lines[Index] = MoveTemp(Line);
+	});
+
+	FString Summary;
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		Summary += Lines[Index];
+		if (OutSampleNames && IsValid(Actors[Index]))
+		{
+			OutSampleNames->Add(Actors[Index]->GetName());
+		}
+	}
+	return Summary;
+}
+
+FString FUnrealCopilotSelectionSummarizer::DescribeActorsAggregated(TConstArrayView<AActor*> Actors, const FSelectionSummaryOptions& Options, TArray<FString>* OutSampleNames)
+{
+	using UnrealCopilotSelectionSummarizer::FSelectionAggregate;
+
+	// Gather per-actor data in parallel into per-task partial aggregates
+	TArray<FSelectionAggregate> Partials;
+	ParallelForWithTaskContext(Partials, Actors.Num(), [&Actors, &Options](FSelectionAggregate& Partial, int32 Index)
+	{
+		const AActor* Actor = Actors[Index];
+		if (!IsValid(Actor))
+		{
+			return;
+		}
+
+		const FName ClassName = Actor->GetClass()->GetFName();
+		Partial.NumActors++;
+		Partial.ClassCounts.FindOrAdd(ClassName)++;
+		// The full name keeps the numeric suffix FName stores separately, so "SM_Rock_12" becomes "SM_Rock_*" as documented
+		Partial.NamePatternCounts.FindOrAdd(GetNamePattern(Actor->GetName()))++;
+		UnrealCopilotSelectionSummarizer::AddSampleIndex(Partial.ClassSamples.FindOrAdd(ClassName), Index, Options.MaxSampleActors);
+
+#if WITH_EDITOR
+		Partial.FolderCounts.FindOrAdd(Actor->GetFolderPath())++;
+#endif
+
+		const FBox ActorBounds = Actor->GetComponentsBoundingBox(/*bNonColliding*/ true);
+		if (ActorBounds.IsValid)
+		{
+			Partial.Bounds += ActorBounds;
+		}
+		else
+		{
+			Partial.Bounds += Actor->GetActorLocation();
+		}
+
+		Actor->ForEachComponent<UInstancedStaticMeshComponent>(false, [&Partial](const UInstancedStaticMeshComponent* InstancedComponent)
+		{
+			Partial.NumInstances += InstancedComponent->GetInstanceCount();
+		});
+	});
+
+	// Merge partial aggregates
+	FSelectionAggregate Total;
+	for (FSelectionAggregate& Partial : Partials)
+	{
+		Total.NumActors += Partial.NumActors;
+		Total.NumInstances += Partial.NumInstances;
+		if (Partial.Bounds.IsValid)
+		{
+			Total.Bounds += Partial.Bounds;
+		}
+		for (const TPair<FName, int32>& Pair : Partial.ClassCounts)
+		{
+			Total.ClassCounts.FindOrAdd(Pair.Key) += Pair.Value;
+		}
+		for (const TPair<FName, int32>& Pair : Partial.FolderCounts)
+		{
+			Total.FolderCounts.FindOrAdd(Pair.Key) += Pair.Value;
+		}
+		for (const TPair<FString, int32>& Pair : Partial.NamePatternCounts)
+		{
+			Total.NamePatternCounts.FindOrAdd(Pair.Key) += Pair.Value;
+		}
+		for (TPair<FName, TArray<int32>>& Pair : Partial.ClassSamples)
+		{
+			TArray<int32>& Samples = Total.ClassSamples.FindOrAdd(Pair.Key);
+			for (int32 Index : Pair.Value)
+			{
+				UnrealCopilotSelectionSummarizer::AddSampleIndex(Samples, Index, Options.MaxSampleActors);
+			}
+		}
+	}
+
+	FString Summary = FString::Printf(TEXT("\n%d actors selected (aggregated):"), Total.NumActors);
+	Summary += TEXT("\nClasses: ") + UnrealCopilotSelectionSummarizer::FormatTopGroups(Total.ClassCounts, Options.MaxGroups);
+	if (Total.Bounds.IsValid)
+	{
+		Summary += FString::Printf(TEXT("\nBounds: Min=%s Max=%s Size=%s"),
+			*UnrealCopilotSelectionSummarizer::FormatVector(Total.Bounds.Min),
+			*UnrealCopilotSelectionSummarizer::FormatVector(Total.Bounds.Max),
+			*UnrealCopilotSelectionSummarizer::FormatVector(Total.Bounds.GetSize()));
+	}
+	if (Total.FolderCounts.Num() > 0)
+	{
+		Summary += TEXT("\nFolders: ") + UnrealCopilotSelectionSummarizer::FormatTopGroups(Total.FolderCounts, Options.MaxGroups);
+	}
+	Summary += TEXT("\nName patterns: ") + UnrealCopilotSelectionSummarizer::FormatTopGroups(Total.NamePatternCounts, Options.MaxGroups);
+	if (Total.NumInstances > 0)
+	{
+		Summary += FString::Printf(TEXT("\nInstanced mesh instances: %d"), Total.NumInstances);
+	}
+
+	// Representative sample: round-robin across classes, largest classes first
+	TArray<TPair<FName, int32>> ClassesBySize = Total.ClassCounts.Array();
+	ClassesBySize.Sort([](const TPair<FName, int32>& A, const TPair<FName, int32>& B) { return A.Value > B.Value; });
+	for (TPair<FName, TArray<int32>>& Pair : Total.ClassSamples)
+	{
+		Pair.Value.Sort();
+	}
+
+	TArray<int32> SampleIndices;
+	for (int32 Round = 0; SampleIndices.Num() < Options.MaxSampleActors && Round < Options.MaxSampleActors; ++Round)
+	{
+		for (const TPair<FName, int32>& ClassPair : ClassesBySize)
+		{
+			const TArray<int32>& Samples = Total.ClassSamples.FindChecked(ClassPair.Key);
+			if (Samples.IsValidIndex(Round) && SampleIndices.Num() < Options.MaxSampleActors)
+			{
+				SampleIndices.Add(Samples[Round]);
+			}
+		}
+	}
+
+	Summary += TEXT("\nRepresentative sample:");
+	for (int32 Index : SampleIndices)
+	{
+		const AActor* Actor = Actors[Index];
+		Summary += FString::Printf(TEXT("\n- %s (%s) at %s"),
+			*Actor->GetName(),
+			*Actor->GetClass()->GetName(),
+			*UnrealCopilotSelectionSummarizer::FormatVector(Actor->GetActorLocation()));
+		if (OutSampleNames)
+		{
+			OutSampleNames->Add(Actor->GetName());
+		}
+	}
+
+	return Summary;
+}
@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "UnrealCopilotSettings.h"
+#include "UnrealCopilotPatternScanner.h"
+#include "UnrealCopilotCodeCache.h"
 #include "Misc/ConfigCacheIni.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/Paths.h"
@@ -37,6 +39,25 @@ UUnrealCopilotSettings::UUnrealCopilotSettings()
 	BlockedOperations.Add(TEXT("file("));
 	BlockedOperations.Add(TEXT("input("));
 	BlockedOperations.Add(TEXT("raw_input("));
+
+	// Set default importable modules: the editor API and side-effect free standard library modules
+	const TCHAR* DefaultAllowedImports[] = {
+		TEXT("unreal"), TEXT("math"), TEXT("random"), TEXT("json"), TEXT("re"), TEXT("collections"), TEXT("itertools"),
+		TEXT("functools"), TEXT("typing"), TEXT("dataclasses"), TEXT("enum"), TEXT("time"), TEXT("datetime"),
+		TEXT("string"), TEXT("copy"), TEXT("statistics"), TEXT("textwrap")
+	};
+	for (const TCHAR* Module : DefaultAllowedImports)
+	{
+		AllowedPythonImports.Add(Module);
+	}
+
+	// Set default preloaded modules: the ones generated scripts import most
+	PreloadedPythonModules.Add(TEXT("unreal"));
+	PreloadedPythonModules.Add(TEXT("math"));
+	PreloadedPythonModules.Add(TEXT("random"));
+	PreloadedPythonModules.Add(TEXT("typing"));
+	PreloadedPythonModules.Add(TEXT("dataclasses"));
+	PreloadedPythonModules.Add(TEXT("statistics"));
 }
 
 FName UUnrealCopilotSettings::GetCategoryName() const
@@ -101,6 +122,12 @@ FString UUnrealCopilotSettings::GetModelNameForAPI() const
 	}
 }
 
+bool UUnrealCopilotSettings::ShouldStreamResponses() const
+{
+	// Tool call deltas and Responses API events are not handled by the stream reader
+	return bStreamResponses && OpenAIModel != EOpenAIModel::GPT5 && !bEnableToolCalling;
+}
+
 bool UUnrealCopilotSettings::ValidateSettings(FString& OutErrorMessage) const
 {
 	if (CurrentProvider == ELLMProvider::OpenAI)
@@ -159,6 +186,19 @@ void UUnrealCopilotSettings::PostEditChangeProperty(FPropertyChangedEvent& Prope
 			EncryptedAPIKey = EncryptString(OpenAIAPIKey);
 		}
 	}
+
+	// Recompile the safety scanners from the edited block list
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(UUnrealCopilotSettings, BlockedOperations))
+	{
+		FUnrealCopilotSafetyScanners::Invalidate();
+	}
+
+	// Cached safety verdicts were reached under the old rules
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(UUnrealCopilotSettings, BlockedOperations)
+		|| PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(UUnrealCopilotSettings, AllowedPythonImports))
+	{
+		FUnrealCopilotCodeCache::InvalidateVerdicts(EPythonVerdictKind::Safety);
+	}
 }
 #endif
 
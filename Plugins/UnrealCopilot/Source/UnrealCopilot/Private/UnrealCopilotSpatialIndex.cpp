@@ -0,0 +1,340 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotSpatialIndex.h"
+#include "ConvexVolume.h"
+
+namespace UnrealCopilotSpatialIndex
+{
+	/** Keeps the closest hits seen so far in a max-heap keyed on distance */
+	class FNearestHitCollector
+	{
+	public:
+		FNearestHitCollector(int32 InMaxResults, double InMaxDistanceSquared)
+			: MaxResults(InMaxResults)
+			, MaxDistanceSquared(InMaxDistanceSquared)
+		{
+			Heap.Reserve(MaxResults + 1);
+		}
+
+		void Add(FObjectKey Key, double DistanceSquared)
+		{
+			if (DistanceSquared > MaxDistanceSquared)
+			{
+				return;
+			}
+
+			if (Heap.Num() < MaxResults)
+			{
+				Heap.HeapPush(FSpatialIndexHit{ Key, DistanceSquared }, FarthestFirst);
+			}
+			else if (DistanceSquared < Heap.HeapTop().DistanceSquared)
+			{
+				Heap.HeapPopDiscard(FarthestFirst);
+				Heap.HeapPush(FSpatialIndexHit{ Key, DistanceSquared }, FarthestFirst);
+			}
+		}
+
+		/** Squared distance a new hit must beat to be kept */
+		double GetWorstDistanceSquared() const
+		{
+			return Heap.Num() < MaxResults ? MaxDistanceSquared : Heap.HeapTop().DistanceSquared;
+		}
+
+		void Finish(TArray<FSpatialIndexHit>& OutHits)
+		{
+			Heap.Sort([](const FSpatialIndexHit& A, const FSpatialIndexHit& B)
+			{
+				return A.DistanceSquared < B.DistanceSquared;
+			});
+			OutHits = MoveTemp(Heap);
+		}
+
+	private:
+		static bool FarthestFirst(const FSpatialIndexHit& A, const FSpatialIndexHit& B)
+		{
+			return A.DistanceSquared > B.DistanceSquared;
+		}
+
+		TArray<FSpatialIndexHit> Heap;
+		int32 MaxResults;
+		double MaxDistanceSquared;
+	};
+
+	static int32 GetChebyshevDistance(const FIntVector& A, const FIntVector& B)
+	{
+		return FMath::Max3(FMath::Abs(A.X - B.X), FMath::Abs(A.Y - B.Y), FMath::Abs(A.Z - B.Z));
+	}
+
+	/** Number of cells on the surface of a cube of cells with the given radius */
+	static int64 GetRingCellCount(int32 Ring)
+	{
+		if (Ring == 0)
+		{
+			return 1;
+		}
+		const int64 Outer = 2 * (int64)Ring + 1;
+		const int64 Inner = 2 * (int64)Ring - 1;
+		return Outer * Outer * Outer - Inner * Inner * Inner;
+	}
+}
+
+FUnrealCopilotSpatialIndex::FUnrealCopilotSpatialIndex(double InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0))
+{
+}
+
+void FUnrealCopilotSpatialIndex::AddOrUpdate(FObjectKey Key, const FBox& Bounds)
+{
+	if (!Bounds.IsValid)
+	{
+		Remove(Key);
+		return;
+	}
+
+	const FIntVector NewCell = GetCell(Bounds.GetCenter());
+	const bool bNewOversized = IsOversized(Bounds);
+
+	if (const int32* ExistingIndex = KeyToElement.Find(Key))
+	{
+		FElement& Element = Elements[*ExistingIndex];
+
+		// Moves within the same cell only need the bounds refreshed
+		if (Element.bOversized == bNewOversized && (bNewOversized || Element.Cell == NewCell))
+		{
+			Element.Bounds = Bounds;
+			return;
+		}
+
+		UnlinkElement(*ExistingIndex);
+		Element.Bounds = Bounds;
+		Element.Cell = NewCell;
+		Element.bOversized = bNewOversized;
+		LinkElement(*ExistingIndex);
+		return;
+	}
+
+	FElement Element;
+	Element.Key = Key;
+	Element.Bounds = Bounds;
+	Element.Cell = NewCell;
+	Element.bOversized = bNewOversized;
+
+	const int32 ElementIndex = Elements.Add(Element);
+	KeyToElement.Add(Key, ElementIndex);
+	LinkElement(ElementIndex);
+}
+
+bool FUnrealCopilotSpatialIndex::Remove(FObjectKey Key)
+{
+	int32 ElementIndex = INDEX_NONE;
+	if (!KeyToElement.RemoveAndCopyValue(Key, ElementIndex))
+	{
+		return false;
+	}
+
+	UnlinkElement(ElementIndex);
+	Elements.RemoveAt(ElementIndex);
+	return true;
+}
+
+void FUnrealCopilotSpatialIndex::Reset()
+{
+	Elements.Empty();
+	KeyToElement.Empty();
+	Cells.Empty();
+	OversizedElements.Empty();
+}
+
+void FUnrealCopilotSpatialIndex::FindNearest(const FVector& Origin, int32 MaxResults, double MaxDistance, TArray<FSpatialIndexHit>& OutHits) const
+{
+	using namespace UnrealCopilotSpatialIndex;
+
+	OutHits.Reset();
+	if (MaxResults <= 0 || Elements.Num() == 0)
+	{
+		return;
+	}
+
+	FNearestHitCollector Collector(MaxResults, MaxDistance > 0.0 ? FMath::Square(MaxDistance) : TNumericLimits<double>::Max());
+	auto ConsiderElement = [this, &Origin, &Collector](int32 ElementIndex)
+	{
+		const FElement& Element = Elements[ElementIndex];
+		Collector.Add(Element.Key, Element.Bounds.ComputeSquaredDistanceToPoint(Origin));
+	};
+
+	for (int32 ElementIndex : OversizedElements)
+	{
+		ConsiderElement(ElementIndex);
+	}
+
+	// Visit rings of cells outward from the origin cell until no unvisited cell can hold a closer object
+	const FIntVector OriginCell = GetCell(Origin);
+	const int32 MaxRing = MaxDistance > 0.0 ? FMath::CeilToInt32(MaxDistance / CellSize) + 2 : MAX_int32;
+	int32 VisitedCells = 0;
+
+	for (int32 Ring = 0; Ring <= MaxRing && VisitedCells < Cells.Num(); ++Ring)
+	{
+		// An object in ring N has its center at least N-1 cells away and extends at most one cell toward the origin
+		if (Ring >= 2 && Collector.GetWorstDistanceSquared() <= FMath::Square((Ring - 2) * CellSize))
+		{
+			break;
+		}
+
+		// Once a ring has more cells than the grid holds, scanning the occupied cells directly is cheaper
+		if (GetRingCellCount(Ring) > Cells.Num())
+		{
+			for (const TPair<FIntVector, TArray<int32>>& Pair : Cells)
+			{
+				const int32 CellRing = GetChebyshevDistance(Pair.Key, OriginCell);
+				if (CellRing >= Ring && CellRing <= MaxRing)
+				{
+					for (int32 ElementIndex : Pair.Value)
+					{
+						ConsiderElement(ElementIndex);
+					}
+				}
+			}
+			break;
+		}
+
+		for (int32 X = -Ring; X <= Ring; ++X)
+		{
+			for (int32 Y = -Ring; Y <= Ring; ++Y)
+			{
+				const bool bOnXYSurface = FMath::Abs(X) == Ring || FMath::Abs(Y) == Ring;
+				const int32 ZStep = (bOnXYSurface || Ring == 0) ? 1 : 2 * Ring;
+				for (int32 Z = -Ring; Z <= Ring; Z += ZStep)
+				{
+					if (const TArray<int32>* CellElements = Cells.Find(OriginCell + FIntVector(X, Y, Z)))
+					{
+						++VisitedCells;
+						for (int32 ElementIndex : *CellElements)
+						{
+							ConsiderElement(ElementIndex);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	Collector.Finish(OutHits);
+}
+
+void FUnrealCopilotSpatialIndex::FindInFrustum(const FConvexVolume& Frustum, const FVector& Origin, int32 MaxResults, double MaxDistance, TArray<FSpatialIndexHit>& OutHits) const
+{
+	using namespace UnrealCopilotSpatialIndex;
+
+	OutHits.Reset();
+	if (MaxResults <= 0 || Elements.Num() == 0)
+	{
+		return;
+	}
+
+	FNearestHitCollector Collector(MaxResults, MaxDistance > 0.0 ? FMath::Square(MaxDistance) : TNumericLimits<double>::Max());
+	auto ConsiderElement = [this, &Frustum, &Origin, &Collector](int32 ElementIndex)
+	{
+		const FElement& Element = Elements[ElementIndex];
+		const double DistanceSquared = Element.Bounds.ComputeSquaredDistanceToPoint(Origin);
+		if (DistanceSquared < Collector.GetWorstDistanceSquared() &&
+			Frustum.IntersectBox(Element.Bounds.GetCenter(), Element.Bounds.GetExtent()))
+		{
+			Collector.Add(Element.Key, DistanceSquared);
+		}
+	};
+
+	// Loose cells extend one cell past their nominal bounds on every side
+	const FVector LooseCellExtent(CellSize * 1.5);
+	auto ConsiderCell = [this, &Frustum, &LooseCellExtent, &ConsiderElement](const FIntVector& Cell, const TArray<int32>& CellElements)
+	{
+		const FVector CellCenter = (FVector(Cell) + FVector(0.5)) * CellSize;
+		if (Frustum.IntersectBox(CellCenter, LooseCellExtent))
+		{
+			for (int32 ElementIndex : CellElements)
+			{
+				ConsiderElement(ElementIndex);
+			}
+		}
+	};
+
+	for (int32 ElementIndex : OversizedElements)
+	{
+		ConsiderElement(ElementIndex);
+	}
+
+	// With a distance limit, walk the cells in range when that is fewer than the occupied cells
+	const int32 MaxRing = MaxDistance > 0.0 ? FMath::CeilToInt32(MaxDistance / CellSize) + 1 : MAX_int32;
+	const int64 RangeCellCount = MaxRing < 1024 ? FMath::Cube(2 * (int64)MaxRing + 1) : MAX_int64;
+	if (RangeCellCount < Cells.Num())
+	{
+		const FIntVector OriginCell = GetCell(Origin);
+		for (int32 X = -MaxRing; X <= MaxRing; ++X)
+		{
+			for (int32 Y = -MaxRing; Y <= MaxRing; ++Y)
+			{
+				for (int32 Z = -MaxRing; Z <= MaxRing; ++Z)
+				{
+					const FIntVector Cell = OriginCell + FIntVector(X, Y, Z);
+					if (const TArray<int32>* CellElements = Cells.Find(Cell))
+					{
+						ConsiderCell(Cell, *CellElements);
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		for (const TPair<FIntVector, TArray<int32>>& Pair : Cells)
+		{
+			ConsiderCell(Pair.Key, Pair.Value);
+		}
+	}
+
+	Collector.Finish(OutHits);
+}
+
+FIntVector FUnrealCopilotSpatialIndex::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(Location.X / CellSize),
+		FMath::FloorToInt32(Location.Y / CellSize),
+		FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+bool FUnrealCopilotSpatialIndex::IsOversized(const FBox& Bounds) const
+{
+	return Bounds.GetExtent().GetMax() > CellSize;
+}
+
+void FUnrealCopilotSpatialIndex::LinkElement(int32 ElementIndex)
+{
+	const FElement& Element = Elements[ElementIndex];
+	if (Element.bOversized)
+	{
+		OversizedElements.Add(ElementIndex);
+	}
+	else
+	{
+		Cells.FindOrAdd(Element.Cell).Add(ElementIndex);
+	}
+}
+
+void FUnrealCopilotSpatialIndex::UnlinkElement(int32 ElementIndex)
+{
+	const FElement& Element = Elements[ElementIndex];
+	if (Element.bOversized)
+	{
+		OversizedElements.RemoveSingleSwap(ElementIndex);
+		return;
+	}
+
+	if (TArray<int32>* CellElements = Cells.Find(Element.Cell))
+	{
+		CellElements->RemoveSingleSwap(ElementIndex);
+		if (CellElements->Num() == 0)
+		{
+			Cells.Remove(Element.Cell);
+		}
+	}
+}
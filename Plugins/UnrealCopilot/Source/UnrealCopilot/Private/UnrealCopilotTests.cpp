@@ -1,10 +1,38 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "UnrealCopilot.h"
+#include "UnrealCopilotWorkflowClassifier.h"
+#include "UnrealCopilotSpatialIndex.h"
+#include "UnrealCopilotEditorTools.h"
+#include "UnrealCopilotPromptCompressor.h"
+#include "UnrealCopilotPromptProcessor.h"
+#include "UnrealCopilotCodeBlockExtractor.h"
+#include "UnrealCopilotPatternScanner.h"
+#include "UnrealCopilotPythonParser.h"
+#include "UnrealCopilotOutputCapture.h"
+#include "UnrealCopilotCodeCache.h"
+#include "UnrealCopilotHistoryStore.h"
+#include "UnrealCopilotHistorySearchIndex.h"
+#include "UnrealCopilotBatchCommandlet.h"
+#include "UnrealCopilotWorkerPoolCommandlet.h"
+#include "UnrealCopilotSettings.h"
+#include "UnrealCopilotSelectionSummarizer.h"
+#include "UnrealCopilotLevelCensusSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/CommandLine.h"
+#include "Containers/Ticker.h"
+#include "IPythonScriptPlugin.h"
+#include "Engine/World.h"
+#include "Engine/StaticMeshActor.h"
+#include "Animation/SkeletalMeshActor.h"
 
 #if WITH_DEV_AUTOMATION_TESTS
 #include "Misc/AutomationTest.h"
 #include "Tests/AutomationCommon.h"
+#include "Tests/AutomationEditorCommon.h"
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotPythonExecutionTest, "UnrealCopilot.PythonExecution.BasicTests", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
 
@@ -48,4 +76,1351 @@ bool FUnrealCopilotPythonExecutionTest::RunTest(const FString& Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotWorkflowClassifierTest, "UnrealCopilot.Prompt.WorkflowClassifier", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotWorkflowClassifierTest::RunTest(const FString& Parameters)
+{
+	FUnrealCopilotWorkflowClassifier Classifier;
+
+	// Test 1: Bundled training set covers the common workflows
+	TestEqual("Material Prompt", Classifier.Classify(TEXT("Create a red material instance with high roughness")).WorkflowType, EUnrealCopilotWorkflowType::MaterialCreation);
+	TestEqual("Level Prompt", Classifier.Classify(TEXT("Spawn 50 cubes in a grid and move them to a folder")).WorkflowType, EUnrealCopilotWorkflowType::LevelEditing);
+	TestEqual("Asset Prompt", Classifier.Classify(TEXT("Rename all textures in /Game/Props with a T_ prefix")).WorkflowType, EUnrealCopilotWorkflowType::AssetManagement);
+	TestEqual("VFX Prompt", Classifier.Classify(TEXT("Spawn a Niagara smoke effect")).WorkflowType, EUnrealCopilotWorkflowType::VFX);
+
+	// Test 2: Unknown vocabulary falls back to General with no confidence
+	FWorkflowClassification Unknown = Classifier.Classify(TEXT("zzqx qqzx"));
+	TestEqual("Unknown Prompt Type", Unknown.WorkflowType, EUnrealCopilotWorkflowType::General);
+	TestEqual("Unknown Prompt Confidence", Unknown.Confidence, 0.0f);
+
+	// Test 3: Code labelling rules used for learning from history
+	TestEqual("Infer From Code", FUnrealCopilotWorkflowClassifier::InferWorkflowFromCode(TEXT("unreal.MaterialEditingLibrary.recompile_material(m)")), EUnrealCopilotWorkflowType::MaterialCreation);
+
+	// Test 4: Online training shifts the decision for new vocabulary
+	for (int32 Index = 0; Index < 5; ++Index)
+	{
+		Classifier.AddTrainingExample(TEXT("tweak the foliage wind sway"), EUnrealCopilotWorkflowType::VFX);
+	}
+	TestEqual("Online Training", Classifier.Classify(TEXT("foliage wind sway")).WorkflowType, EUnrealCopilotWorkflowType::VFX);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotSpatialIndexTest, "UnrealCopilot.Prompt.SpatialIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotSpatialIndexTest::RunTest(const FString& Parameters)
+{
+	// Any distinct objects work as keys
+	const FObjectKey A(UObject::StaticClass());
+	const FObjectKey B(UClass::StaticClass());
+	const FObjectKey C(UPackage::StaticClass());
+	const FObjectKey D(UStruct::StaticClass());
+	const FObjectKey Large(UFunction::StaticClass());
+
+	auto PointBox = [](double X) { return FBox(FVector(X, 0, 0), FVector(X, 0, 0)); };
+
+	FUnrealCopilotSpatialIndex Index(10000.0);
+	Index.AddOrUpdate(A, PointBox(0.0));
+	Index.AddOrUpdate(B, PointBox(100.0));
+	Index.AddOrUpdate(C, PointBox(20000.0));
+	Index.AddOrUpdate(D, PointBox(50000.0));
+	Index.AddOrUpdate(Large, FBox(FVector(5000, -50000, -10), FVector(300000, 50000, 10)));
+	TestEqual("Indexed Count", Index.Num(), 5);
+
+	// Test 1: Nearest objects are ranked by distance to their bounds, including oversized ones
+	TArray<FSpatialIndexHit> Hits;
+	Index.FindNearest(FVector::ZeroVector, 3, 0.0, Hits);
+	if (TestEqual("Nearest Count", Hits.Num(), 3))
+	{
+		TestTrue("Nearest Order", Hits[0].Key == A && Hits[1].Key == B && Hits[2].Key == Large);
+	}
+
+	// Test 2: Moving an object to another cell updates query results
+	Index.AddOrUpdate(D, PointBox(50.0));
+	Index.FindNearest(FVector::ZeroVector, 2, 0.0, Hits);
+	TestTrue("Moved Object Found", Hits.Num() == 2 && Hits[0].Key == A && Hits[1].Key == D);
+
+	// Test 3: Removed objects are no longer returned
+	TestTrue("Remove", Index.Remove(A));
+	Index.FindNearest(FVector::ZeroVector, 2, 0.0, Hits);
+	TestTrue("Removed Object Gone", Hits.Num() == 2 && Hits[0].Key == D && Hits[1].Key == B);
+
+	// Test 4: Distance limit
+	Index.FindNearest(FVector::ZeroVector, 10, 1000.0, Hits);
+	TestEqual("Distance Limit", Hits.Num(), 2);
+
+	// Test 5: Queries far from the origin cell
+	Index.FindNearest(FVector(60000, 0, 0), 2, 0.0, Hits);
+	TestTrue("Far Query", Hits.Num() == 2 && Hits[0].Key == Large && Hits[1].Key == C);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotSelectionSummaryTest, "UnrealCopilot.Prompt.SelectionSummary", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotSelectionSummaryTest::RunTest(const FString& Parameters)
+{
+	// Test 1: Numeric suffixes are replaced by a wildcard
+	TestEqual("Numbered Name", FUnrealCopilotSelectionSummarizer::GetNamePattern(TEXT("SM_Rock_12")), FString(TEXT("SM_Rock_*")));
+	TestEqual("Plain Name", FUnrealCopilotSelectionSummarizer::GetNamePattern(TEXT("Floor")), FString(TEXT("Floor")));
+	TestEqual("Digits Only", FUnrealCopilotSelectionSummarizer::GetNamePattern(TEXT("123")), FString(TEXT("123")));
+
+	UWorld* World = FAutomationEditorCommonUtils::CreateNewMap();
+	if (!TestNotNull("Test World", World))
+	{
+		return false;
+	}
+
+	auto SpawnNamedActor = [World](UClass* Class, const TCHAR* Name, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = FName(Name);
+		return World->SpawnActor<AActor>(Class, Location, Rotation, SpawnParameters);
+	};
+
+	TArray<AActor*> Actors;
+	Actors.Add(SpawnNamedActor(AStaticMeshActor::StaticClass(), TEXT("SM_Rock_1"), FVector(100, 200, 300), FRotator(0, 90, 0)));
+	Actors.Add(SpawnNamedActor(ASkeletalMeshActor::StaticClass(), TEXT("SK_Tree_7"), FVector(500, 500, 0)));
+	Actors.Add(SpawnNamedActor(AStaticMeshActor::StaticClass(), TEXT("SM_Rock_2"), FVector(0, 0, 0)));
+	Actors.Add(SpawnNamedActor(ASkeletalMeshActor::StaticClass(), TEXT("SK_Tree_8"), FVector(600, 400, 0)));
+	Actors.Add(SpawnNamedActor(AStaticMeshActor::StaticClass(), TEXT("SM_Rock_3"), FVector(1000, 1000, 100)));
+	if (!TestFalse("Actors Spawned", Actors.Contains(nullptr)))
+	{
+		return false;
+	}
+	for (AActor* Actor : Actors)
+	{
+		if (Actor->IsA<AStaticMeshActor>())
+		{
+			Actor->SetFolderPath(TEXT("Props/Rocks"));
+		}
+	}
+
+	// Test 2: Selections up to the detail threshold are described actor by actor
+	FSelectionSummaryOptions Options;
+	Options.MaxDetailedActors = 2;
+	Options.MaxSampleActors = 3;
+
+	TArray<FString> SampleNames;
+	const FString Detailed = FUnrealCopilotSelectionSummarizer::Summarize(MakeArrayView(Actors.GetData(), 2), Options, &SampleNames);
+	TestTrue("Detailed Location", Detailed.Contains(TEXT("- SM_Rock_1 (StaticMeshActor) Location=(100, 200, 300)")));
+	TestTrue("Detailed Rotation", Detailed.Contains(TEXT("Y=90")));
+	TestTrue("Detailed Scale", Detailed.Contains(TEXT("Scale=(1.00, 1.00, 1.00)")));
+	TestTrue("Detailed Components", Detailed.Contains(TEXT("Components: StaticMeshComponent")));
+	TestTrue("Every Actor Detailed", Detailed.Contains(TEXT("- SK_Tree_7 (SkeletalMeshActor) Location=(500, 500, 0)")));
+	TestTrue("Detailed Names", SampleNames == TArray<FString>({ TEXT("SM_Rock_1"), TEXT("SK_Tree_7") }));
+
+	// Test 3: Larger selections are aggregated into counts, bounds, folders, name patterns and a sample
+	const FString Aggregated = FUnrealCopilotSelectionSummarizer::Summarize(Actors, Options, &SampleNames);
+	TestTrue("Aggregate Header", Aggregated.Contains(TEXT("5 actors selected (aggregated):")));
+	TestTrue("Class Counts", Aggregated.Contains(TEXT("Classes: StaticMeshActor x3, SkeletalMeshActor x2")));
+	TestTrue("Bounds", Aggregated.Contains(TEXT("Bounds: Min=(0, 0, 0) Max=(1000, 1000, 300) Size=(1000, 1000, 300)")));
+	TestTrue("Folders", Aggregated.Contains(TEXT("Folders: Props/Rocks x3, (none) x2")));
+	TestTrue("Name Patterns", Aggregated.Contains(TEXT("Name patterns: SM_Rock_* x3, SK_Tree_* x2")));
+	TestFalse("No Per-Actor Transforms", Aggregated.Contains(TEXT("Rotation=")));
+
+	// The sample takes the first actors of each class in turn, largest class first
+	TestEqual("Sample Size", SampleNames.Num(), Options.MaxSampleActors);
+	TestTrue("Sample Names", SampleNames == TArray<FString>({ TEXT("SM_Rock_1"), TEXT("SK_Tree_7"), TEXT("SM_Rock_2") }));
+	TestTrue("Sample Listed", Aggregated.Contains(TEXT("- SM_Rock_2 (StaticMeshActor) at (0, 0, 0)")));
+
+	for (AActor* Actor : Actors)
+	{
+		World->EditorDestroyActor(Actor, false);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotLevelCensusTest, "UnrealCopilot.Prompt.LevelCensus", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotLevelCensusTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = FAutomationEditorCommonUtils::CreateNewMap();
+	UUnrealCopilotLevelCensusSubsystem* Census = UUnrealCopilotLevelCensusSubsystem::Get();
+	if (!TestNotNull("Test World", World) || !TestNotNull("Census", Census))
+	{
+		return false;
+	}
+
+	// Opening the map resets the census; reading the summary scans it once, and every later change arrives as an event.
+	// The counts are read without EnsureCensusBuilt, so they only change if the events updated them.
+	Census->GetLevelSummary();
+	const int32 BaseActors = Census->GetTotalActorCount();
+	auto CountMeshActors = [Census]()
+	{
+		const int32* Count = Census->GetClassCounts().Find(AStaticMeshActor::StaticClass()->GetFName());
+		return Count ? *Count : 0;
+	};
+
+	// The actors lie far along X, beyond the map's default actors, so they define the maximum of the level bounds
+	AActor* Near = World->SpawnActor<AStaticMeshActor>(FVector(100000, 0, 0), FRotator::ZeroRotator);
+	AActor* Middle = World->SpawnActor<AStaticMeshActor>(FVector(110000, 0, 0), FRotator::ZeroRotator);
+	AActor* Far = World->SpawnActor<AStaticMeshActor>(FVector(130000, 0, 0), FRotator::ZeroRotator);
+	if (!TestTrue("Actors Spawned", Near && Middle && Far))
+	{
+		return false;
+	}
+
+	// Test 1: Spawned actors are counted and extend the bounds
+	TestEqual("Spawned Counted", Census->GetTotalActorCount(), BaseActors + 3);
+	TestEqual("Class Counted", CountMeshActors(), 3);
+	TestTrue("Bounds Grown", Census->GetLevelSummary().Contains(TEXT("Max=(130000,")));
+
+	// Test 2: Moving the outermost actor further out grows the bounds
+	Far->SetActorLocation(FVector(150000, 0, 0));
+	Far->PostEditMove(true);
+	TestTrue("Bounds Follow Move", Census->GetLevelSummary().Contains(TEXT("Max=(150000,")));
+	TestEqual("Move Keeps Count", Census->GetTotalActorCount(), BaseActors + 3);
+
+	// Test 3: Folder changes move the actor between folders
+	Near->SetFolderPath(TEXT("CopilotCensus/Rocks"));
+	FString Summary = Census->GetLevelSummary();
+	TestTrue("Folder Counted", Summary.Contains(TEXT("- CopilotCensus x1 (Rocks x1)")));
+
+	Near->SetFolderPath(TEXT("CopilotCensus/Trees"));
+	Summary = Census->GetLevelSummary();
+	TestTrue("Refoldered", Summary.Contains(TEXT("- CopilotCensus x1 (Trees x1)")));
+	TestFalse("Old Folder Gone", Summary.Contains(TEXT("Rocks")));
+
+	// Test 4: Removing the actor on the boundary shrinks the bounds to the remaining actors
+	World->EditorDestroyActor(Far, false);
+	TestEqual("Destroyed Uncounted", Census->GetTotalActorCount(), BaseActors + 2);
+	TestEqual("Class Uncounted", CountMeshActors(), 2);
+	TestTrue("Bounds Shrunk", Census->GetLevelSummary().Contains(TEXT("Max=(110000,")));
+
+	// Test 5: Removing the last actor of a folder drops the folder
+	World->EditorDestroyActor(Near, false);
+	TestFalse("Empty Folder Dropped", Census->GetLevelSummary().Contains(TEXT("CopilotCensus")));
+
+	World->EditorDestroyActor(Middle, false);
+	TestEqual("All Removed", Census->GetTotalActorCount(), BaseActors);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotEditorToolsTest, "UnrealCopilot.LLM.EditorTools", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotEditorToolsTest::RunTest(const FString& Parameters)
+{
+	FUnrealCopilotEditorTools& EditorTools = FUnrealCopilotEditorTools::Get();
+
+	// Test 1: Built-in tools are registered and described for both API formats
+	TestNotNull("Asset Search Tool", EditorTools.FindTool(TEXT("search_assets")));
+	TestNotNull("Actor Lookup Tool", EditorTools.FindTool(TEXT("find_actors")));
+	TestNotNull("API Signature Tool", EditorTools.FindTool(TEXT("get_api_signature")));
+	TestNotNull("Level Census Tool", EditorTools.FindTool(TEXT("get_level_census")));
+	TestEqual("Tool JSON Formats Match", EditorTools.CreateChatCompletionsToolsJson().Num(), EditorTools.CreateResponsesToolsJson().Num());
+
+	// Test 2: Results come back in call order, with errors for bad calls
+	TArray<FUnrealCopilotToolCall> Calls;
+	Calls.Add({ TEXT("call_1"), TEXT("get_api_signature"), TEXT("{\"name\": \"unreal.EditorAssetLibrary.does_asset_exist\"}") });
+	Calls.Add({ TEXT("call_2"), TEXT("no_such_tool"), TEXT("{}") });
+	Calls.Add({ TEXT("call_3"), TEXT("search_assets"), TEXT("not json") });
+
+	TArray<FUnrealCopilotToolResult> Results = EditorTools.ExecuteToolCalls(Calls);
+	if (TestEqual("Result Count", Results.Num(), 3))
+	{
+		TestEqual("Result Order", Results[0].CallId, FString(TEXT("call_1")));
+		TestTrue("API Signature", Results[0].bSuccess && Results[0].Output.Contains(TEXT("does_asset_exist(")));
+		TestFalse("Unknown Tool", Results[1].bSuccess);
+		TestFalse("Invalid Arguments", Results[2].bSuccess);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotPromptCompressionTest, "UnrealCopilot.Prompt.Compression", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotPromptCompressionTest::RunTest(const FString& Parameters)
+{
+	// Test 1: Comments and blank lines are stripped, string literals are kept
+	const FString Code = TEXT("import unreal  # editor API\n\n# spawn\nname = \"a # b\"\ndoc = '''x\n\n# y'''\n");
+	TestEqual("Strip Python Code", FUnrealCopilotPromptCompressor::StripPythonCode(Code), FString(TEXT("import unreal\nname = \"a # b\"\ndoc = '''x\n\n# y'''")));
+
+	// Test 2: Lines repeated in a later segment are sent once; short lines are kept
+	{
+		FString Segments[] = { TEXT("Level has 12 lights\nok"), TEXT("Level has 12 lights\nok\nUser Request: add one") };
+		FPromptCompressionStats Stats = FUnrealCopilotPromptCompressor::Compress(Segments, FPromptCompressionOptions());
+		TestEqual("Deduplicated Segment", Segments[1], FString(TEXT("ok\nUser Request: add one")));
+		TestEqual("Duplicate Lines", Stats.DuplicateLines, 1);
+	}
+
+	// Test 3: Repeated asset directories are aliased with a legend
+	{
+		FString Segments[] = { TEXT("Assets:\n- /Game/Environment/Rocks/SM_Rock_01\n- /Game/Environment/Rocks/SM_Rock_02\n- /Game/Environment/Rocks/SM_Rock_03\n- /Game/Environment/Rocks/SM_Rock_04") };
+		FPromptCompressionStats Stats = FUnrealCopilotPromptCompressor::Compress(Segments, FPromptCompressionOptions());
+		TestEqual("Path Aliases", Stats.FactoredPathPrefixes, 1);
+		TestTrue("Aliased Path", Segments[0].Contains(TEXT("- ~1/SM_Rock_03")));
+		TestTrue("Alias Legend", Segments[0].Contains(TEXT("~1=/Game/Environment/Rocks")));
+		TestFalse("Full Path Removed", Segments[0].Contains(TEXT("/Game/Environment/Rocks/SM_Rock_01")));
+	}
+
+	// Test 4: Over budget, the oldest history goes first and the request is kept
+	{
+		FPromptCompressionOptions Options;
+		Options.TokenBudget = 32;
+		Options.SectionPolicies = { { TEXT("User Request:"), 1.0f, false }, { TEXT("Previous Conversation:"), 0.3f, true } };
+
+		FString Segments[] = { TEXT("Task\nPrevious Conversation:\nUser: one one one\nAssistant: two two two\nUser: three three\nUser Request: keep me") };
+		FPromptCompressionStats Stats = FUnrealCopilotPromptCompressor::Compress(Segments, Options);
+		TestEqual("Dropped Lines", Stats.DroppedLines, 2);
+		TestFalse("Oldest Dropped", Segments[0].Contains(TEXT("one one one")));
+		TestTrue("Recent Kept", Segments[0].Contains(TEXT("three three")));
+		TestTrue("Request Kept", Segments[0].Contains(TEXT("User Request: keep me")));
+		TestTrue("Omission Marker", Segments[0].Contains(TEXT("(2 lines omitted)")));
+		TestTrue("Within Budget", Stats.CompressedTokens <= Options.TokenBudget);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotStructuredOutputTest, "UnrealCopilot.LLM.StructuredOutput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotStructuredOutputTest::RunTest(const FString& Parameters)
+{
+	UUnrealCopilotPromptProcessor* PromptProcessor = NewObject<UUnrealCopilotPromptProcessor>();
+	FUnrealCopilotCodeResponse Response;
+
+	// Test 1: Fields are read directly from the JSON object
+	const FString Content = TEXT("{\"code\": \"import unreal\\nunreal.log('hi')\", \"explanation\": \"Logs a message.\", \"touched_assets\": [\"/Game/Maps/Main\"]}");
+	if (TestTrue("Parse Structured Response", PromptProcessor->ParseStructuredCodeResponse(Content, Response)))
+	{
+		TestEqual("Code", Response.Code, FString(TEXT("import unreal\nunreal.log('hi')")));
+		TestEqual("Explanation", Response.Explanation, FString(TEXT("Logs a message.")));
+		TestTrue("Touched Assets", Response.TouchedAssets.Num() == 1 && Response.TouchedAssets[0] == TEXT("/Game/Maps/Main"));
+	}
+
+	// Test 2: Fenced JSON and fenced code inside the field are unwrapped
+	const FString FencedContent = TEXT("```json\n{\"code\": \"```python\\nimport unreal\\n```\", \"explanation\": \"\", \"touched_assets\": []}\n```");
+	if (TestTrue("Parse Fenced Response", PromptProcessor->ParseStructuredCodeResponse(FencedContent, Response)))
+	{
+		TestEqual("Unfenced Code", Response.Code, FString(TEXT("import unreal")));
+		TestEqual("No Touched Assets", Response.TouchedAssets.Num(), 0);
+	}
+
+	// Test 3: Free text and objects without code are rejected so the caller can fall back
+	TestFalse("Free Text", PromptProcessor->ParseStructuredCodeResponse(TEXT("```python\nimport unreal\n```"), Response));
+	TestFalse("Missing Code", PromptProcessor->ParseStructuredCodeResponse(TEXT("{\"explanation\": \"none\"}"), Response));
+
+	// Test 4: The strict schema requires every property
+	TSharedPtr<FJsonObject> Schema = UUnrealCopilotPromptProcessor::CreateCodeResponseSchema();
+	TestEqual("Required Properties", Schema->GetArrayField(TEXT("required")).Num(), Schema->GetObjectField(TEXT("properties"))->Values.Num());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotCodeBlockExtractorTest, "UnrealCopilot.LLM.CodeBlockExtractor", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotCodeBlockExtractorTest::RunTest(const FString& Parameters)
+{
+	const FString Response = TEXT("Intro\n```python\nimport unreal\n```\nThen:\n```json\n{}\n```\n```\nprint(1)\n```\n```py\nx = 1\ny = 2```");
+
+	// Test 1: Every block is found and non-Python blocks are skipped by the selections
+	FUnrealCopilotCodeBlockExtractor Extractor;
+	Extractor.AppendText(Response);
+	Extractor.Finish();
+	TestEqual("Block Count", Extractor.GetBlocks().Num(), 4);
+	TestEqual("First Block", Extractor.GetCode(EUnrealCopilotCodeBlockSelection::First), FString(TEXT("import unreal")));
+	TestEqual("Last Block", Extractor.GetCode(EUnrealCopilotCodeBlockSelection::Last), FString(TEXT("x = 1\ny = 2")));
+	TestEqual("Longest Block", Extractor.GetCode(EUnrealCopilotCodeBlockSelection::Longest), FString(TEXT("import unreal")));
+	TestEqual("Concatenated Blocks", Extractor.GetCode(EUnrealCopilotCodeBlockSelection::Concatenate), FString(TEXT("import unreal\n\nprint(1)\n\nx = 1\ny = 2")));
+
+	// Test 2: Feeding one character at a time gives the same result
+	FUnrealCopilotCodeBlockExtractor ChunkedExtractor;
+	for (int32 Index = 0; Index < Response.Len(); ++Index)
+	{
+		ChunkedExtractor.AppendText(FStringView(*Response + Index, 1));
+	}
+	ChunkedExtractor.Finish();
+	TestEqual("Chunked Extraction", ChunkedExtractor.GetCode(EUnrealCopilotCodeBlockSelection::Concatenate), Extractor.GetCode(EUnrealCopilotCodeBlockSelection::Concatenate));
+
+	// Test 3: The preview includes the partial line of an open block, and unterminated blocks are kept
+	FUnrealCopilotCodeBlockExtractor StreamExtractor;
+	StreamExtractor.AppendText(TEXT("Sure:\n```python\nimport unreal\nunreal.log("));
+	TestEqual("Complete Lines", StreamExtractor.GetCode(EUnrealCopilotCodeBlockSelection::First), FString(TEXT("import unreal")));
+	TestEqual("Preview", StreamExtractor.GetPreviewCode(EUnrealCopilotCodeBlockSelection::First), FString(TEXT("import unreal\nunreal.log(")));
+	StreamExtractor.Finish();
+	TestEqual("Unterminated Block", StreamExtractor.GetCode(EUnrealCopilotCodeBlockSelection::First), FString(TEXT("import unreal\nunreal.log(")));
+	TestFalse("Block Open", StreamExtractor.GetBlocks()[0].bClosed);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotPatternScannerTest, "UnrealCopilot.LLM.PatternScanner", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotPatternScannerTest::RunTest(const FString& Parameters)
+{
+	TArray<FPatternScanHit> Hits;
+
+	// Test 1: Overlapping patterns are all reported in one pass
+	const FUnrealCopilotPatternScanner OverlapScanner({ { TEXT("a.b"), TEXT("A") }, { TEXT(".b("), TEXT("B") }, { TEXT("b("), TEXT("C") } }, true);
+	OverlapScanner.Scan(TEXT("a.b("), EPatternScanMode::PlainText, Hits);
+	if (TestEqual("Overlapping Hits", Hits.Num(), 3))
+	{
+		TestEqual("First Offset", Hits[0].Offset, 0);
+		TestEqual("Second Offset", Hits[1].Offset, 1);
+		TestEqual("Third Offset", Hits[2].Offset, 2);
+	}
+
+	// Test 2: Python comments and strings are skipped, f-string contents and identifier boundaries are respected
+	const FUnrealCopilotPatternScanner CodeScanner({ { TEXT("os."), TEXT("Blocked") }, { TEXT("eval("), TEXT("Unsafe") } }, true);
+	const FString Code = TEXT("import unreal\npos.x = 1  # os.remove\ns = \"eval(x)\"\nt = '''os.\n'''\nf\"{eval(y)}\"\nos.getcwd()");
+	CodeScanner.Scan(Code, EPatternScanMode::PythonCode, Hits);
+	if (TestEqual("Code Hits", Hits.Num(), 2))
+	{
+		TestEqual("F-String Hit", CodeScanner.DescribeHits({ Hits[0] }), FString(TEXT("Unsafe: eval( (line 6, column 4)")));
+		TestEqual("Code Hit Line", Hits[1].Line, 7);
+		TestEqual("Code Hit Column", Hits[1].Column, 1);
+	}
+
+	// Test 3: Plain text scanning sees everything
+	CodeScanner.Scan(Code, EPatternScanMode::PlainText, Hits);
+	TestEqual("Plain Text Hits", Hits.Num(), 5);
+
+	// Test 4: Case-insensitive matching, hit limit and duplicate patterns
+	const FUnrealCopilotPatternScanner PromptScanner({ { TEXT("rm -rf"), TEXT("Prohibited") }, { TEXT("DROP TABLE"), TEXT("Prohibited") }, { TEXT("drop table"), TEXT("Duplicate") } }, false);
+	TestEqual("Duplicate Rules", PromptScanner.NumRules(), 2);
+	PromptScanner.Scan(TEXT("please Drop Table users; RM -RF /"), EPatternScanMode::PlainText, Hits);
+	if (TestEqual("Prompt Hits", Hits.Num(), 2))
+	{
+		TestEqual("Prompt Hit Offset", Hits[0].Offset, 7);
+	}
+	PromptScanner.Scan(TEXT("please Drop Table users; RM -RF /"), EPatternScanMode::PlainText, Hits, 1);
+	TestEqual("Hit Limit", Hits.Num(), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotPythonParserTest, "UnrealCopilot.Python.Parser", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotPythonParserTest::RunTest(const FString& Parameters)
+{
+	FPythonAst Ast;
+	FPythonSyntaxError Error;
+
+	// Test 1: A script using most of the grammar parses
+	const FString ValidCode = TEXT(
+		"import unreal, math as m\n"
+		"from typing import (List,\n"
+		"    Optional)\n"
+		"\n"
+		"@unreal.uclass()\n"
+		"class Helper(unreal.Object, metaclass=type):\n"
+		"    count: int = 0\n"
+		"\n"
+		"    def scale(self, values: List[float], /, factor=2.0, *args, key=None, **kwargs) -> Optional[list]:\n"
+		"        \"\"\"Scale values.\"\"\"\n"
+		"        result = [v * factor for v in values if v > 0]\n"
+		"        total = sum(x ** 2 for x in result)\n"
+		"        if (n := len(result)) > 3 and not total:\n"
+		"            return None\n"
+		"        elif n == 0:\n"
+		"            pass\n"
+		"        else:\n"
+		"            result[1:-1:2] = {k: v for k, v in kwargs.items()}, {*args}\n"
+		"        return result\n"
+		"\n"
+		"for i, (a, *rest) in enumerate([(1, 2, 3)]):\n"
+		"    while True:\n"
+		"        break\n"
+		"    else:\n"
+		"        continue\n"
+		"try:\n"
+		"    value = lambda x, y=1: x if x else -y\n"
+		"except (ValueError, TypeError) as e:\n"
+		"    raise RuntimeError('bad') from e\n"
+		"finally:\n"
+		"    unreal.log(f\"done {i!r:>{10}} {{ok}} {value(1)=}\")\n"
+		"with unreal.ScopedEditorTransaction('x') as t, open_thing():\n"
+		"    match t:\n"
+		"        case {'a': 1} | [1, *_]:\n"
+		"            pass\n"
+		"        case Point(x=0) as p if p:\n"
+		"            pass\n"
+		"match = 1; x = y = match\n"
+	);
+	if (!TestTrue("Valid Code", FUnrealCopilotPythonParser::Parse(ValidCode, Ast, Error)))
+	{
+		AddInfo(Error.ToString());
+	}
+	TestTrue("Module Root", Ast.Nodes.Num() > 0 && Ast.Nodes[0].Type == EPythonAstNodeType::Module);
+
+	// Test 2: The first syntax error is reported with its position
+	struct FErrorCase
+	{
+		const TCHAR* Code;
+		const TCHAR* Message;
+		int32 Line;
+		int32 Column;
+	};
+	const FErrorCase ErrorCases[] = {
+		{ TEXT("x = (1,\n"), TEXT("'(' was never closed"), 1, 5 },
+		{ TEXT("if x\n    pass\n"), TEXT("expected ':'"), 1, 5 },
+		{ TEXT("f() = 1"), TEXT("cannot assign to function call"), 1, 1 },
+		{ TEXT("def f():\nreturn 1"), TEXT("expected an indented block"), 2, 1 },
+		{ TEXT("return 5"), TEXT("'return' outside function"), 1, 1 }
+	};
+	for (const FErrorCase& ErrorCase : ErrorCases)
+	{
+		TestFalse(FString::Printf(TEXT("Invalid: %s"), ErrorCase.Code), FUnrealCopilotPythonParser::Parse(ErrorCase.Code, Ast, Error));
+		TestEqual(FString::Printf(TEXT("Message: %s"), ErrorCase.Code), Error.Message, FString(ErrorCase.Message));
+		TestEqual(FString::Printf(TEXT("Line: %s"), ErrorCase.Code), Error.Line, ErrorCase.Line);
+		TestEqual(FString::Printf(TEXT("Column: %s"), ErrorCase.Code), Error.Column, ErrorCase.Column);
+	}
+
+	// Test 3: Safety rules apply to code, including f-string fields, but not to string contents
+	FPythonSafetyPolicy Policy = FPythonSafetyPolicy::MakeDefault();
+	Policy.AllowedImports = { TEXT("unreal"), TEXT("math") };
+
+	auto CountViolations = [&Policy](const TCHAR* Code)
+	{
+		FPythonAst CodeAst;
+		FPythonSyntaxError CodeError;
+		TArray<FPythonSafetyViolation> Violations;
+		if (!FUnrealCopilotPythonParser::Parse(Code, CodeAst, CodeError))
+		{
+			return -1;
+		}
+		FUnrealCopilotPythonParser::CheckSafety(CodeAst, Policy, Violations);
+		return Violations.Num();
+	};
+
+	TestEqual("Disallowed Import", CountViolations(TEXT("import os")), 1);
+	TestEqual("Allowed Imports", CountViolations(TEXT("import unreal, math")), 0);
+	TestEqual("Introspection Attributes", CountViolations(TEXT("x.__class__.__bases__")), 2);
+	TestEqual("F-String Field", CountViolations(TEXT("s = '1'\nprint(f'{eval(s)}')")), 1);
+	TestEqual("String Contents", CountViolations(TEXT("print('eval(')")), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotOutputCaptureTest, "UnrealCopilot.Python.OutputCapture", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotOutputCaptureTest::RunTest(const FString& Parameters)
+{
+	const FName PythonCategory(TEXT("LogPython"));
+
+	// Test 1: The ring buffer keeps the newest lines in order
+	FPythonOutputRingBuffer Buffer(3);
+	for (int32 Index = 1; Index <= 5; ++Index)
+	{
+		Buffer.Add({ EPythonOutputStream::Stdout, FString::FromInt(Index) });
+	}
+	TestEqual("Ring Buffer Size", Buffer.Num(), 3);
+	TestEqual("Ring Buffer Dropped", Buffer.GetDroppedCount(), 2);
+	TestEqual("Ring Buffer Order", Buffer.Join(EPythonOutputStream::Stdout), FString(TEXT("3\n4\n5")));
+
+	// Test 2: Python output is split into lines and streams; other categories are ignored
+	FUnrealCopilotOutputCapture Capture(100);
+	TArray<FString> Streamed;
+	Capture.OnLineCaptured.AddLambda([&Streamed](const FPythonOutputLine& Line)
+	{
+		Streamed.Add(Line.Text);
+	});
+
+	Capture.Serialize(TEXT("first\nsecond\n"), ELogVerbosity::Log, PythonCategory);
+	Capture.Serialize(TEXT("Traceback (most recent call last):"), ELogVerbosity::Error, PythonCategory);
+	Capture.Serialize(TEXT("unrelated"), ELogVerbosity::Log, FName(TEXT("LogTemp")));
+	TestEqual("Stdout", Capture.GetText(EPythonOutputStream::Stdout), FString(TEXT("first\nsecond")));
+	TestEqual("Stderr", Capture.GetText(EPythonOutputStream::Stderr), FString(TEXT("Traceback (most recent call last):")));
+	TestEqual("Streamed Lines", Streamed.Num(), 3);
+
+	// Test 3: Error reports are parsed, not captured as output
+	FPythonErrorReport Report;
+	TestFalse("No Report Yet", Capture.GetErrorReport(Report));
+	Capture.Serialize(TEXT("__unreal_copilot_error__ {\"type\": \"NameError\", \"message\": \"name 'x' is not defined\", \"line\": 3, \"stack_trace\": \"a||b\"}"), ELogVerbosity::Error, PythonCategory);
+	TestTrue("Report Parsed", Capture.GetErrorReport(Report));
+	TestEqual("Report Type", Report.Type, FString(TEXT("NameError")));
+	TestEqual("Report Line", Report.Line, 3);
+	TestEqual("Report Stack Trace", Report.StackTrace, FString(TEXT("a||b")));
+	TestEqual("Report Not Streamed", Streamed.Num(), 3);
+
+	Capture.Reset(100);
+	TestFalse("Report Cleared", Capture.GetErrorReport(Report));
+	TestTrue("Output Cleared", Capture.GetText(EPythonOutputStream::Stdout).IsEmpty());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotCodeCacheTest, "UnrealCopilot.Python.CodeCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotCodeCacheTest::RunTest(const FString& Parameters)
+{
+	// Test 1: Line endings and trailing whitespace do not change the identity of a script
+	const FString Unix = FUnrealCopilotCodeCache::NormalizeSource(TEXT("x = 1\nprint(x)\n"));
+	const FString Windows = FUnrealCopilotCodeCache::NormalizeSource(TEXT("x = 1\r\nprint(x)\r\n\r\n"));
+	TestEqual("Normalized Source", Unix, FString(TEXT("x = 1\nprint(x)")));
+	TestEqual("Line Endings", Windows, Unix);
+	TestEqual("Same Hash", FUnrealCopilotCodeCache::HashSource(Windows), FUnrealCopilotCodeCache::HashSource(Unix));
+	TestNotEqual("Indentation Matters", FUnrealCopilotCodeCache::HashSource(FUnrealCopilotCodeCache::NormalizeSource(TEXT(" x = 1"))),
+		FUnrealCopilotCodeCache::HashSource(FUnrealCopilotCodeCache::NormalizeSource(TEXT("x = 1"))));
+
+	// Test 2: Verdicts are found after being added and dropped when invalidated
+	const FString Hash = FUnrealCopilotCodeCache::HashSource(TEXT("UnrealCopilot.Python.CodeCache test script"));
+	const FPythonCodeCacheStats Before = FUnrealCopilotCodeCache::GetVerdictStats();
+
+	FPythonCodeVerdict Verdict;
+	TestFalse("Unknown Script", FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind::Safety, Hash, Verdict));
+
+	FPythonCodeVerdict Rejected;
+	Rejected.ErrorMessage = TEXT("blocked");
+	FUnrealCopilotCodeCache::AddVerdict(EPythonVerdictKind::Safety, Hash, Rejected);
+	TestTrue("Known Script", FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind::Safety, Hash, Verdict));
+	TestFalse("Cached Verdict", Verdict.bValid);
+	TestEqual("Cached Message", Verdict.ErrorMessage, Rejected.ErrorMessage);
+	TestFalse("Kinds Are Separate", FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind::Syntax, Hash, Verdict));
+
+	const FPythonCodeCacheStats After = FUnrealCopilotCodeCache::GetVerdictStats();
+	TestEqual("Hits", After.Hits - Before.Hits, 1);
+	TestEqual("Misses", After.Misses - Before.Misses, 2);
+
+	FUnrealCopilotCodeCache::InvalidateVerdicts(EPythonVerdictKind::Safety);
+	TestFalse("Invalidated", FUnrealCopilotCodeCache::FindVerdict(EPythonVerdictKind::Safety, Hash, Verdict));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotWarmEnvironmentTest, "UnrealCopilot.Python.WarmEnvironment", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotWarmEnvironmentTest::RunTest(const FString& Parameters)
+{
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		AddWarning(TEXT("Python is not available; skipping the warm environment test"));
+		return true;
+	}
+
+	UUnrealCopilotExecutionManager* ExecutionManager = UUnrealCopilotExecutionManager::GetInstance();
+
+	// Test 1: The environment warms up once and reports how long it took
+	TestTrue("Warm Up", ExecutionManager->WarmUpPythonEnvironment());
+	TestTrue("Is Warm", ExecutionManager->IsPythonEnvironmentWarm());
+	AddInfo(FString::Printf(TEXT("Warm-up took %.2f ms"), ExecutionManager->GetPythonWarmUpSeconds() * 1000.0f));
+
+	// Test 2: A session keeps variables between scripts until it is reset
+	const int32 SessionId = ExecutionManager->CreateExecutionSession();
+	TestTrue("Session Assign", ExecutionManager->ExecutePythonCode(TEXT("counter = 41"), false, SessionId).bSuccess);
+	const FPythonExecutionResult Persisted = ExecutionManager->ExecutePythonCode(TEXT("print(counter + 1)"), false, SessionId);
+	TestTrue("Session Variable Kept", Persisted.bSuccess && Persisted.Output.Contains(TEXT("42")));
+	TestFalse("Fresh Namespace Without Session", ExecutionManager->ExecutePythonCode(TEXT("print(counter)")).bSuccess);
+
+	ExecutionManager->ResetExecutionSession(SessionId);
+	TestFalse("Session Reset", ExecutionManager->ExecutePythonCode(TEXT("print(counter)"), false, SessionId).bSuccess);
+	ExecutionManager->ResetExecutionSession(SessionId);
+
+	// Test 3: The warm-up loads the preloaded modules, so the first script importing them finds them in sys.modules
+	FString ModuleList;
+	for (const FString& Module : UUnrealCopilotSettings::Get()->PreloadedPythonModules)
+	{
+		ModuleList += FString::Printf(TEXT("'%s', "), *Module);
+	}
+
+	const int32 ImportSessionId = ExecutionManager->CreateExecutionSession();
+	const FPythonExecutionResult Before = ExecutionManager->ExecutePythonCode(FString::Printf(
+		TEXT("import sys\npreloaded = [%s]\nloaded = {name: id(sys.modules.get(name)) for name in preloaded}\n")
+		TEXT("print('missing', sorted(name for name in preloaded if name not in sys.modules))"), *ModuleList), false, ImportSessionId);
+	TestTrue("Preloaded Before First Run", Before.bSuccess && Before.Output.Contains(TEXT("missing []")));
+
+	const FPythonExecutionResult After = ExecutionManager->ExecutePythonCode(
+		TEXT("import importlib\nfor name in preloaded:\n    importlib.import_module(name)\n")
+		TEXT("print('reloaded', sorted(name for name in preloaded if id(sys.modules[name]) != loaded[name]))"), false, ImportSessionId);
+	TestTrue("Not Reimported By First Run", After.bSuccess && After.Output.Contains(TEXT("reloaded []")));
+	ExecutionManager->ResetExecutionSession(ImportSessionId);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotHistoryStoreTest, "UnrealCopilot.History.Store", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotHistoryStoreTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("UnrealCopilotHistoryStore");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists*/ false, /*Tree*/ true);
+
+	const FPythonExecutionHistoryEntry First(TEXT("for i in range(3):\n    print(i)"), true, TEXT("0\n1\n2"));
+	const FPythonExecutionHistoryEntry Second(TEXT("prit('x')"), false, TEXT("NameError: name 'prit' is not defined"));
+	const FString LongCode = FString::ChrN(4096, TEXT('#')) + TEXT("\nprint('compressed')");
+
+	{
+		// Test 1: A new store is empty
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		TestFalse("New Store", Store.Open());
+		TestEqual("Empty", Store.Num(), 0);
+
+		// Test 2: Added entries read back in order
+		Store.Append(First);
+		Store.Append(Second);
+		Store.Append(FPythonExecutionHistoryEntry(LongCode, true, FString()));
+		TestEqual("Entry Count", Store.Num(), 3);
+
+		FPythonExecutionHistoryEntry Entry;
+		TestTrue("Get Entry", Store.GetEntry(0, Entry));
+		TestEqual("Code Round Trip", Entry.Code, First.Code);
+		TestEqual("Summary Round Trip", Entry.ResultSummary, First.ResultSummary);
+		TestFalse("Out Of Range", Store.GetEntry(3, Entry));
+
+		// Test 3: Pages only return existing entries
+		TArray<FPythonExecutionHistoryEntry> Page;
+		TestEqual("Page Count", Store.GetPage(1, 10, Page), 2);
+		if (Page.Num() == 2)
+		{
+			TestFalse("Failure Round Trip", Page[0].bWasSuccessful);
+			TestEqual("Compressed Code Round Trip", Page[1].Code, LongCode);
+		}
+
+		// Test 4: Trimming drops the oldest entries
+		Store.Trim(2);
+		TestEqual("Trimmed Count", Store.Num(), 2);
+		TestTrue("Get Trimmed Entry", Store.GetEntry(0, Entry));
+		TestEqual("Oldest Kept Entry", Entry.Code, Second.Code);
+	}
+
+	{
+		// Test 5: Entries and trims persist, read from disk rather than the cache
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		TestTrue("Existing Store", Store.Open());
+		TestEqual("Reopened Count", Store.Num(), 2);
+
+		FPythonExecutionHistoryEntry Entry;
+		TestTrue("Get Reopened Entry", Store.GetEntry(0, Entry));
+		TestEqual("Reopened Code", Entry.Code, Second.Code);
+		TestEqual("Reopened Summary", Entry.ResultSummary, Second.ResultSummary);
+		TestEqual("Reopened Timestamp", Entry.Timestamp, Second.Timestamp);
+		TestTrue("Get Reopened Compressed Entry", Store.GetEntry(1, Entry));
+		TestEqual("Reopened Compressed Code", Entry.Code, LongCode);
+
+		// Test 6: Entries added after reopening follow the mapped ones
+		Store.Append(First);
+		TestEqual("Appended Count", Store.Num(), 3);
+		TestTrue("Get Appended Entry", Store.GetEntry(2, Entry));
+		TestEqual("Appended Code", Entry.Code, First.Code);
+
+		// Test 7: Clearing empties the store and deletes the cleared entries from disk
+		Store.Clear();
+		TestEqual("Cleared Count", Store.Num(), 0);
+		TestTrue("Cleared Blobs Deleted", IFileManager::Get().FileSize(*(Directory / TEXT("History.blob"))) <= 0);
+	}
+
+	{
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		Store.Open();
+		TestEqual("Cleared Count After Reopen", Store.Num(), 0);
+		Store.Append(First);
+	}
+
+	// Test 8: Copies left by a compaction interrupted before its commit marker are deleted
+	const FString IndexPath = Directory / TEXT("History.idx");
+	const FString BlobPath = Directory / TEXT("History.blob");
+	const FString CodeTablePath = Directory / TEXT("History.codes");
+	const FString CommitPath = Directory / TEXT("History.compact");
+	FFileHelper::SaveStringToFile(TEXT("partial"), *(IndexPath + TEXT(".tmp")));
+	{
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		Store.Open();
+		TestFalse("Uncommitted Copy Deleted", FPaths::FileExists(IndexPath + TEXT(".tmp")));
+		TestEqual("Uncommitted Copy Ignored", Store.Num(), 1);
+	}
+
+	// Test 9: Copies committed by the marker replace the files, even if the originals were damaged
+	IFileManager::Get().Copy(*(IndexPath + TEXT(".tmp")), *IndexPath);
+	IFileManager::Get().Copy(*(BlobPath + TEXT(".tmp")), *BlobPath);
+	IFileManager::Get().Copy(*(CodeTablePath + TEXT(".tmp")), *CodeTablePath);
+	FFileHelper::SaveStringToFile(FString(), *CommitPath);
+	FFileHelper::SaveStringToFile(TEXT("damaged"), *IndexPath);
+	FFileHelper::SaveStringToFile(TEXT("damaged"), *CodeTablePath);
+	{
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		Store.Open();
+		TestFalse("Commit Marker Deleted", FPaths::FileExists(CommitPath));
+		TestFalse("Committed Copy Moved", FPaths::FileExists(IndexPath + TEXT(".tmp")));
+		TestFalse("Committed Code Table Moved", FPaths::FileExists(CodeTablePath + TEXT(".tmp")));
+
+		FPythonExecutionHistoryEntry Entry;
+		TestTrue("Get Recovered Entry", Store.GetEntry(0, Entry));
+		TestEqual("Recovered Code", Entry.Code, First.Code);
+
+		// The recovered code table still lets the same code share its blob
+		const int64 RecoveredBlobSize = IFileManager::Get().FileSize(*BlobPath);
+		Store.Append(FPythonExecutionHistoryEntry(First.Code, true, FString()));
+		Store.Flush();
+		TestEqual("Recovered Code Shared", IFileManager::Get().FileSize(*BlobPath), RecoveredBlobSize);
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists*/ false, /*Tree*/ true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotHistoryDeduplicationTest, "UnrealCopilot.History.Deduplication", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotHistoryDeduplicationTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = FPaths::AutomationTransientDir() / TEXT("UnrealCopilotHistoryDeduplication");
+	const FString BlobPath = Directory / TEXT("History.blob");
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists*/ false, /*Tree*/ true);
+
+	FString Script;
+	for (int32 Line = 0; Line < 64; ++Line)
+	{
+		Script += FString::Printf(TEXT("actor_%d = unreal.EditorLevelLibrary.spawn_actor_from_class(unreal.PointLight, unreal.Vector(%d, 0, 0))\n"), Line, Line * 100);
+	}
+
+	int64 SingleRunSize = 0;
+	{
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		Store.Open();
+
+		// Test 1: Running the same script again adds no code to the blob file
+		Store.Append(FPythonExecutionHistoryEntry(Script, true, FString()));
+		Store.Flush();
+		SingleRunSize = IFileManager::Get().FileSize(*BlobPath);
+		TestTrue("Code Stored", SingleRunSize > 0);
+
+		for (int32 Run = 0; Run < 99; ++Run)
+		{
+			Store.Append(FPythonExecutionHistoryEntry(Script, true, FString()));
+		}
+		Store.Flush();
+		TestEqual("Repeated Runs Share Code", IFileManager::Get().FileSize(*BlobPath), SingleRunSize);
+		TestEqual("Every Run Recorded", Store.Num(), 100);
+
+		// Test 2: Different code is stored separately
+		Store.Append(FPythonExecutionHistoryEntry(TEXT("print('other')"), true, FString()));
+		Store.Flush();
+		TestTrue("Distinct Code Stored", IFileManager::Get().FileSize(*BlobPath) > SingleRunSize);
+
+		FPythonExecutionHistoryEntry Entry;
+		TestTrue("Get Shared Entry", Store.GetEntry(50, Entry));
+		TestEqual("Shared Code", Entry.Code, Script);
+		TestTrue("Get Distinct Entry", Store.GetEntry(100, Entry));
+		TestEqual("Distinct Code", Entry.Code, FString(TEXT("print('other')")));
+	}
+
+	{
+		// Test 3: Code stored in an earlier session is shared too
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		TestTrue("Existing Store", Store.Open());
+		const int64 ReopenedSize = IFileManager::Get().FileSize(*BlobPath);
+		Store.Append(FPythonExecutionHistoryEntry(Script, false, FString()));
+		Store.Flush();
+		TestEqual("Code Shared Across Sessions", IFileManager::Get().FileSize(*BlobPath), ReopenedSize);
+
+		FPythonExecutionHistoryEntry Entry;
+		TestTrue("Get Reopened Shared Entry", Store.GetEntry(0, Entry));
+		TestEqual("Reopened Shared Code", Entry.Code, Script);
+
+		// Test 4: Trimming earlier runs of a script keeps its code for the runs still kept
+		Store.Trim(1);
+		TestTrue("Get Kept Entry", Store.GetEntry(0, Entry));
+		TestEqual("Kept Code", Entry.Code, Script);
+		TestFalse("Kept Outcome", Entry.bWasSuccessful);
+	}
+
+	// Test 5: Compacting keeps the code of an entry stored right after an entry with no code and no summary, whose
+	// offset points at the same place in the blob file
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists*/ false, /*Tree*/ true);
+	const FString CodeAfterEmpty = TEXT("print('after empty')");
+	{
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		Store.Open();
+		for (int32 Run = 0; Run < 2048; ++Run)
+		{
+			Store.Append(FPythonExecutionHistoryEntry(Script, true, FString()));
+		}
+		Store.Append(FPythonExecutionHistoryEntry(FString(), true, FString()));
+		Store.Append(FPythonExecutionHistoryEntry(CodeAfterEmpty, true, FString()));
+		Store.Trim(2);
+	}
+
+	{
+		// Mostly trimmed records, so opening compacts the store
+		FUnrealCopilotHistoryStore Store(Directory, TEXT("History"));
+		TestTrue("Compacted Store", Store.Open());
+		TestTrue("Blobs Compacted", IFileManager::Get().FileSize(*BlobPath) < SingleRunSize);
+
+		FPythonExecutionHistoryEntry Entry;
+		TestTrue("Get Empty Entry", Store.GetEntry(0, Entry));
+		TestTrue("Empty Code Kept", Entry.Code.IsEmpty());
+		TestTrue("Get Entry After Empty", Store.GetEntry(1, Entry));
+		TestEqual("Code After Empty Kept", Entry.Code, CodeAfterEmpty);
+	}
+
+	IFileManager::Get().DeleteDirectory(*Directory, /*RequireExists*/ false, /*Tree*/ true);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotHistorySearchTest, "UnrealCopilot.History.Search", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotHistorySearchTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> Codes = {
+		TEXT("import unreal\nunreal.log('hello world')"),
+		TEXT("print('spawn actors')"),
+		TEXT("import unreal\nunreal.log('hello world')")
+	};
+	const TArray<FString> Summaries = { TEXT("printed hello"), TEXT("Spawned 10 actors"), TEXT("printed hello") };
+	const FString Prompt = TEXT("Create ten cubes");
+	const FString Response = TEXT("for i in range(10): spawn_actor(cube)");
+
+	FUnrealCopilotHistorySearchIndex Index;
+	for (int32 Number = 0; Number < Codes.Num(); ++Number)
+	{
+		Index.Add(EHistorySearchSource::Execution, Number, Codes[Number], Summaries[Number]);
+	}
+	Index.Add(EHistorySearchSource::Prompt, 0, Prompt, Response);
+
+	const auto ReadText = [&](EHistorySearchSource Source, int64 Number, bool bPrimary) -> FString
+	{
+		if (Source == EHistorySearchSource::Prompt)
+		{
+			return bPrimary ? Prompt : Response;
+		}
+		return bPrimary ? Codes[Number] : Summaries[Number];
+	};
+
+	// Test 1: Substring search ignores case and returns repeated code once, as its newest run
+	TArray<FHistorySearchResult> Results;
+	TestTrue("Substring Search Complete", Index.Search(TEXT("HELLO World"), false, 10, ReadText, Results));
+	if (TestEqual("Substring Results", Results.Num(), 1))
+	{
+		TestEqual("Newest Run", Results[0].Index, 2);
+		TestEqual("Runs Counted", Results[0].Occurrences, 2);
+		TestEqual("Snippet Is Matching Line", Results[0].Snippet, FString(TEXT("unreal.log('hello world')")));
+	}
+
+	// Test 2: Matches in code outrank matches in summaries and responses
+	Index.Search(TEXT("spawn"), false, 10, ReadText, Results);
+	if (TestEqual("Ranked Results", Results.Num(), 2))
+	{
+		TestTrue("Code Match First", Results[0].Source == EHistorySearchSource::Execution && Results[0].Index == 1);
+		TestTrue("Response Match Second", Results[1].Source == EHistorySearchSource::Prompt && Results[1].Index == 0);
+		TestTrue("Code Scores Higher", Results[0].Score > Results[1].Score);
+	}
+
+	// Test 3: Regular expressions, with and without required literals
+	Index.Search(TEXT("unreal\\.log\\(.*\\)"), true, 10, ReadText, Results);
+	TestTrue("Regex Match", Results.Num() == 1 && Results[0].Index == 2);
+	Index.Search(TEXT("cubes|nothing"), true, 10, ReadText, Results);
+	TestTrue("Alternation Match", Results.Num() == 1 && Results[0].Source == EHistorySearchSource::Prompt);
+	Index.Search(TEXT("not in history"), false, 10, ReadText, Results);
+	TestEqual("No Match", Results.Num(), 0);
+
+	// Test 4: Required literals of regular expressions
+	TArray<FString> Literals;
+	FUnrealCopilotHistorySearchIndex::ExtractRequiredLiterals(TEXT("Unreal\\.log\\(.*\\)"), Literals);
+	TestTrue("Escaped Literal", Literals.Num() == 1 && Literals[0] == TEXT("unreal.log("));
+	FUnrealCopilotHistorySearchIndex::ExtractRequiredLiterals(TEXT("spawn_actors?"), Literals);
+	TestTrue("Optional Character Dropped", Literals.Num() == 1 && Literals[0] == TEXT("spawn_actor"));
+	FUnrealCopilotHistorySearchIndex::ExtractRequiredLiterals(TEXT("(import )?unreal"), Literals);
+	TestTrue("Group Skipped", Literals.Num() == 1 && Literals[0] == TEXT("unreal"));
+	FUnrealCopilotHistorySearchIndex::ExtractRequiredLiterals(TEXT("print|log"), Literals);
+	TestEqual("Alternation Requires Nothing", Literals.Num(), 0);
+
+	// Test 5: Queries without a trigram are not worth searching
+	TestTrue("Substring Has Trigrams", FUnrealCopilotHistorySearchIndex::HasTrigrams(TEXT("log"), false));
+	TestFalse("Short Substring", FUnrealCopilotHistorySearchIndex::HasTrigrams(TEXT("lo"), false));
+	TestTrue("Regex Literal Has Trigrams", FUnrealCopilotHistorySearchIndex::HasTrigrams(TEXT("spawn_actors?"), true));
+	TestFalse("Pure Regex", FUnrealCopilotHistorySearchIndex::HasTrigrams(TEXT(".*\\d+"), true));
+
+	// Test 6: Trimmed entries are no longer returned and indices start at the oldest kept entry
+	Index.RemoveBefore(EHistorySearchSource::Execution, 2);
+	Index.Search(TEXT("hello world"), false, 10, ReadText, Results);
+	if (TestEqual("Kept Results", Results.Num(), 1))
+	{
+		TestEqual("Kept Index", Results[0].Index, 0);
+		TestEqual("Kept Runs Counted", Results[0].Occurrences, 1);
+	}
+	Index.Search(TEXT("actors"), false, 10, ReadText, Results);
+	TestEqual("Trimmed Entry Skipped", Results.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotHistoryLoadTest, "UnrealCopilot.History.AsyncLoad", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotHistoryLoadTest::RunTest(const FString& Parameters)
+{
+	// Test 1: The class default object never loads a history
+	const UUnrealCopilotExecutionManager* DefaultManager = GetDefault<UUnrealCopilotExecutionManager>();
+	TestFalse("Default Object Loads Nothing", DefaultManager->GetHistoryLoadedFuture().IsValid());
+	TestFalse("Default Object History Not Loaded", DefaultManager->IsHistoryLoaded());
+	TestEqual("Default Object History Empty", DefaultManager->GetHistoryCount(), 0);
+
+	// Test 2: Creating a manager leaves the history alone until something uses it
+	const UUnrealCopilotExecutionManager* UnusedManager = NewObject<UUnrealCopilotExecutionManager>();
+	TestFalse("Creation Loads Nothing", UnusedManager->GetHistoryLoadedFuture().IsValid());
+	TestFalse("Unused History Not Loaded", UnusedManager->IsHistoryLoaded());
+
+	// Test 3: The instance loads its history in the background once asked and reports when it is ready
+	UUnrealCopilotExecutionManager* Manager = UUnrealCopilotExecutionManager::GetInstance();
+	Manager->BeginLoadHistory();
+	TSharedFuture<void> HistoryLoaded = Manager->GetHistoryLoadedFuture();
+	if (TestTrue("Load Started", HistoryLoaded.IsValid() || Manager->IsHistoryLoaded()))
+	{
+		if (HistoryLoaded.IsValid())
+		{
+			HistoryLoaded.Wait();
+		}
+		TestTrue("History Loaded", Manager->IsHistoryLoaded());
+	}
+
+	// Test 4: Entries are added without waiting and are visible to the next read
+	Manager->AddToHistory(TEXT("print('added')"), true, TEXT("added"));
+	TestEqual("Entry Added", Manager->GetHistoryEntry(Manager->GetHistoryCount() - 1).Code, FString(TEXT("print('added')")));
+
+	// Test 5: A manager created in a process started with -NoHistory never opens the project's history, even when the
+	// project already has entries
+	Manager->AddToHistory(TEXT("print('shared')"), true, TEXT("shared"));
+	Manager->SaveHistoryToDisk();
+	const FString OriginalCommandLine = FCommandLine::Get();
+	FCommandLine::Set(*(OriginalCommandLine + TEXT(" -NoHistory")));
+	{
+		UUnrealCopilotExecutionManager* WorkerManager = NewObject<UUnrealCopilotExecutionManager>();
+		TestTrue("History Disabled By Flag", UUnrealCopilotExecutionManager::IsHistoryDisabled());
+		WorkerManager->LoadHistoryFromDisk();
+		TestEqual("Store Not Opened", WorkerManager->GetHistoryCount(), 0);
+		TestEqual("Prompt Store Not Opened", WorkerManager->GetPromptHistoryCount(), 0);
+		WorkerManager->AddToHistory(TEXT("print('worker')"), true, TEXT("worker"));
+		TestEqual("Entries Not Recorded", WorkerManager->GetHistoryCount(), 0);
+	}
+	FCommandLine::Set(*OriginalCommandLine);
+	TestFalse("Flag Restored", UUnrealCopilotExecutionManager::IsHistoryDisabled());
+	TestTrue("Project History Kept", Manager->GetHistoryCount() > 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotExecutionQueueTest, "UnrealCopilot.Python.ExecutionQueue", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotExecutionQueueTest::RunTest(const FString& Parameters)
+{
+	UUnrealCopilotExecutionManager* ExecutionManager = UUnrealCopilotExecutionManager::GetInstance();
+	ExecutionManager->CancelExecution();
+
+	// Test 1: Queued scripts get identifiers
+	const FPythonExecutionResult BatchResult = ExecutionManager->ExecutePythonCode(TEXT("batch_value = 1"), true, 0, EPythonExecutionPriority::Batch);
+	TestTrue("Batch Script Queued", BatchResult.bQueued && BatchResult.ExecutionId > 0);
+
+	const FPythonExecutionResult InteractiveResult = UUnrealCopilotBlueprintLibrary::ExecutePythonCodeEnhanced(TEXT("interactive_value = 2"), true, EPythonExecutionPriority::Interactive);
+	TestTrue("Interactive Script Queued", InteractiveResult.bQueued && InteractiveResult.ExecutionId > 0);
+	TestTrue("Distinct Identifiers", InteractiveResult.ExecutionId != BatchResult.ExecutionId);
+
+	// Test 2: A synchronous call made meanwhile fails rather than returning before its script ran
+	const FPythonExecutionResult BusyResult = ExecutionManager->ExecutePythonCode(TEXT("busy_value = 3"));
+	TestTrue("Busy Call Refused", !BusyResult.bSuccess && !BusyResult.bQueued && BusyResult.ErrorType == EPythonExecutionError::SystemError);
+
+	// Test 3: Queue depth is reported per priority
+	const FPythonExecutionQueueStats Stats = ExecutionManager->GetExecutionQueueStats();
+	TestEqual("Interactive Depth", Stats.QueuedInteractive, 1);
+	TestEqual("Batch Depth", Stats.QueuedBatch, 1);
+	TestTrue("Wait Measured", Stats.OldestWaitSeconds >= 0.0f);
+
+	// Test 4: Invalid scripts are rejected before they are queued
+	const FPythonExecutionResult InvalidResult = ExecutionManager->ExecutePythonCode(TEXT("def broken(:"), true, 0, EPythonExecutionPriority::Batch);
+	TestFalse("Invalid Script Not Queued", InvalidResult.bQueued);
+	TestEqual("Depth Unchanged", ExecutionManager->GetQueuedExecutionCount(), 2);
+
+	ExecutionManager->CancelExecution();
+	TestEqual("Queue Cleared", ExecutionManager->GetQueuedExecutionCount(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotExecutionCancelTest, "UnrealCopilot.Python.ExecutionCancel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotExecutionCancelTest::RunTest(const FString& Parameters)
+{
+	UUnrealCopilotExecutionManager* ExecutionManager = UUnrealCopilotExecutionManager::GetInstance();
+	ExecutionManager->CancelExecution();
+
+	// Test 1: Cancelling reports every queued script as failed rather than dropping it silently
+	TArray<FPythonExecutionResult> Completed;
+	const FDelegateHandle CompletedHandle = ExecutionManager->OnExecutionCompleted.AddLambda([&Completed](const FPythonExecutionResult& Result)
+	{
+		Completed.Add(Result);
+	});
+
+	const int32 FirstId = ExecutionManager->ExecutePythonCode(TEXT("first_value = 1"), true).ExecutionId;
+	const int32 SecondId = ExecutionManager->ExecutePythonCode(TEXT("second_value = 2"), true, 0, EPythonExecutionPriority::Batch).ExecutionId;
+	ExecutionManager->CancelExecution();
+	ExecutionManager->OnExecutionCompleted.Remove(CompletedHandle);
+
+	TestEqual("Queue Cleared", ExecutionManager->GetQueuedExecutionCount(), 0);
+	TestEqual("Every Script Reported", Completed.Num(), 2);
+	for (const int32 ExecutionId : { FirstId, SecondId })
+	{
+		const FPythonExecutionResult* Result = Completed.FindByPredicate([ExecutionId](const FPythonExecutionResult& Candidate) { return Candidate.ExecutionId == ExecutionId; });
+		TestTrue(FString::Printf(TEXT("Script %d Cancelled"), ExecutionId), Result && !Result->bSuccess && Result->ErrorType == EPythonExecutionError::SystemError);
+	}
+
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		AddWarning(TEXT("Python is not available; skipping the interrupted job test"));
+		return true;
+	}
+
+	// Test 2: A KeyboardInterrupt raised between the steps of a job still removes the job
+	const FPythonExecutionResult Interrupted = ExecutionManager->ExecutePythonCode(
+		TEXT("import unreal_copilot_runtime as runtime\n")
+		TEXT("class _Interrupting:\n")
+		TEXT("    @staticmethod\n")
+		TEXT("    def perf_counter():\n")
+		TEXT("        raise KeyboardInterrupt\n")
+		TEXT("runtime.start_job(-1, 'x = 1\\nx += 1')\n")
+		TEXT("saved_time = runtime.time\n")
+		TEXT("runtime.time = _Interrupting\n")
+		TEXT("try:\n")
+		TEXT("    runtime.step_job(-1, 1.0)\n")
+		TEXT("except KeyboardInterrupt:\n")
+		TEXT("    print('interrupted')\n")
+		TEXT("finally:\n")
+		TEXT("    runtime.time = saved_time\n")
+		TEXT("print('leaked', -1 in runtime._jobs)"));
+	TestTrue("Interrupt Propagated", Interrupted.bSuccess && Interrupted.Output.Contains(TEXT("interrupted")));
+	TestTrue("Interrupted Job Removed", Interrupted.Output.Contains(TEXT("leaked False")));
+
+	// Test 3: Cancelling a script between its time slices stops its job and reports it with what it printed
+	const int32 ActiveId = ExecutionManager->ExecutePythonCode(TEXT("print('started')\nwhile True:\n    pass"), true).ExecutionId;
+	for (int32 TickIndex = 0; TickIndex < 3; ++TickIndex)
+	{
+		FTSTicker::GetCoreTicker().Tick(0.01f);
+	}
+	TestTrue("Script Still Running", ExecutionManager->GetCurrentExecutionState() == EPythonExecutionState::Executing);
+
+	Completed.Reset();
+	const FDelegateHandle ActiveHandle = ExecutionManager->OnExecutionCompleted.AddLambda([&Completed](const FPythonExecutionResult& Result)
+	{
+		Completed.Add(Result);
+	});
+	ExecutionManager->CancelExecution();
+	ExecutionManager->OnExecutionCompleted.Remove(ActiveHandle);
+
+	if (TestEqual("Active Script Reported", Completed.Num(), 1))
+	{
+		TestEqual("Active Script Id", Completed[0].ExecutionId, ActiveId);
+		TestTrue("Active Script Cancelled", !Completed[0].bSuccess && Completed[0].ErrorType == EPythonExecutionError::SystemError);
+		TestTrue("Partial Output Kept", Completed[0].Output.Contains(TEXT("started")));
+	}
+	TestTrue("Back To Idle", ExecutionManager->GetCurrentExecutionState() == EPythonExecutionState::Idle);
+
+	const FPythonExecutionResult AfterCancel = ExecutionManager->ExecutePythonCode(TEXT("import unreal_copilot_runtime as runtime\nprint('jobs', len(runtime._jobs))"));
+	TestTrue("Cancelled Job Removed", AfterCancel.bSuccess && AfterCancel.Output.Contains(TEXT("jobs 0")));
+
+	return true;
+}
+
+namespace UnrealCopilotTests
+{
+	/** Tick the core ticker, which runs asynchronous scripts, until one finishes or the deadline passes */
+	bool TickUntilCompleted(UUnrealCopilotExecutionManager* ExecutionManager, int32 ExecutionId, double TimeoutSeconds, FPythonExecutionResult& OutResult)
+	{
+		bool bCompleted = false;
+		const FDelegateHandle CompletedHandle = ExecutionManager->OnExecutionCompleted.AddLambda([ExecutionId, &bCompleted, &OutResult](const FPythonExecutionResult& Result)
+		{
+			if (Result.ExecutionId == ExecutionId)
+			{
+				OutResult = Result;
+				bCompleted = true;
+			}
+		});
+
+		const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+		while (!bCompleted && FPlatformTime::Seconds() < Deadline)
+		{
+			FTSTicker::GetCoreTicker().Tick(0.01f);
+		}
+		ExecutionManager->OnExecutionCompleted.Remove(CompletedHandle);
+		return bCompleted;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotExecutionTimeoutTest, "UnrealCopilot.Python.ExecutionTimeout", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotExecutionTimeoutTest::RunTest(const FString& Parameters)
+{
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		AddWarning(TEXT("Python is not available; skipping the timeout tests"));
+		return true;
+	}
+
+	UUnrealCopilotExecutionManager* ExecutionManager = UUnrealCopilotExecutionManager::GetInstance();
+	ExecutionManager->CancelExecution();
+	const float SavedTimeout = ExecutionManager->GetExecutionTimeout();
+	ExecutionManager->SetExecutionTimeout(1.0f);
+
+	const FString RunawayScript = TEXT("print('before')\nwhile True:\n    pass");
+
+	// Test 1: A synchronous runaway script is interrupted, keeping what it printed
+	const FPythonExecutionResult SyncResult = ExecutionManager->ExecutePythonCode(RunawayScript);
+	TestTrue("Sync Timed Out", !SyncResult.bSuccess && SyncResult.ErrorType == EPythonExecutionError::TimeoutError);
+	TestTrue("Sync Output Kept", SyncResult.Output.Contains(TEXT("before")));
+
+	// Test 2: The interrupt does not linger into the next script
+	const FPythonExecutionResult AfterSync = ExecutionManager->ExecutePythonCode(TEXT("print('after sync')"));
+	TestTrue("Next Sync Script Runs", AfterSync.bSuccess && AfterSync.Output.Contains(TEXT("after sync")));
+
+	// Test 3: An asynchronous runaway script yields between loop iterations, and the timeout is caught between slices
+	const FPythonExecutionResult Queued = ExecutionManager->ExecutePythonCode(RunawayScript, true);
+	FPythonExecutionResult AsyncResult;
+	if (TestTrue("Async Script Finished", Queued.bQueued && UnrealCopilotTests::TickUntilCompleted(ExecutionManager, Queued.ExecutionId, 10.0, AsyncResult)))
+	{
+		TestTrue("Async Timed Out", !AsyncResult.bSuccess && AsyncResult.ErrorType == EPythonExecutionError::TimeoutError);
+		TestTrue("Async Output Kept", AsyncResult.Output.Contains(TEXT("before")));
+	}
+	else
+	{
+		ExecutionManager->CancelExecution();
+	}
+
+	// Test 4: The runtime dropped the timed out job, and both kinds of script run normally afterwards
+	const FPythonExecutionResult AfterAsync = ExecutionManager->ExecutePythonCode(TEXT("import unreal_copilot_runtime as runtime\nprint('jobs', len(runtime._jobs))"));
+	TestTrue("Next Script Runs", AfterAsync.bSuccess && AfterAsync.Output.Contains(TEXT("jobs 0")));
+
+	const FPythonExecutionResult NextQueued = ExecutionManager->ExecutePythonCode(TEXT("print('after async')"), true);
+	FPythonExecutionResult NextResult;
+	if (TestTrue("Next Async Script Finished", NextQueued.bQueued && UnrealCopilotTests::TickUntilCompleted(ExecutionManager, NextQueued.ExecutionId, 10.0, NextResult)))
+	{
+		TestTrue("Next Async Script Runs", NextResult.bSuccess && NextResult.Output.Contains(TEXT("after async")));
+	}
+
+	ExecutionManager->SetExecutionTimeout(SavedTimeout);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotBatchManifestTest, "UnrealCopilot.Batch.Manifest", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotBatchManifestTest::RunTest(const FString& Parameters)
+{
+	const FString ManifestDirectory = FPaths::ProjectSavedDir() / TEXT("UnrealCopilot") / TEXT("Tests") / TEXT("Batch");
+	FFileHelper::SaveStringToFile(TEXT("print('from file')"), *(ManifestDirectory / TEXT("FromFile.py")));
+
+	// Test 1: Items are read in order, with ids, script files and the default execute flag
+	const FString Manifest = TEXT("{\"execute\": true, \"items\": [")
+		TEXT("{\"id\": \"cubes\", \"prompt\": \"Spawn three cubes\"},")
+		TEXT("{\"prompt\": \"List the selected actors\", \"execute\": false},")
+		TEXT("{\"id\": \"inline\", \"script\": \"print('inline')\"},")
+		TEXT("{\"id\": \"file\", \"scriptFile\": \"FromFile.py\"},")
+		TEXT("{\"id\": \"missing\", \"scriptFile\": \"Missing.py\"}]}");
+
+	TArray<FUnrealCopilotBatchItem> Items;
+	FString Error;
+	if (!TestTrue("Manifest Parsed", UUnrealCopilotBatchCommandlet::ParseManifest(Manifest, ManifestDirectory, Items, Error)) || !TestEqual("Item Count", Items.Num(), 5))
+	{
+		return false;
+	}
+	TestTrue("Prompt Uses Default Execute", Items[0].IsPrompt() && Items[0].bExecute);
+	TestEqual("Generated Id", Items[1].Id, FString(TEXT("item1")));
+	TestFalse("Prompt Execute Overridden", Items[1].bExecute);
+	TestTrue("Inline Script Executes", !Items[2].IsPrompt() && Items[2].bExecute);
+	TestEqual("Script File Read", Items[3].Script, FString(TEXT("print('from file')")));
+	TestFalse("Missing Script File Fails Item", Items[4].Error.IsEmpty());
+
+	// Test 2: Malformed manifests are refused
+	TestFalse("Not JSON", UUnrealCopilotBatchCommandlet::ParseManifest(TEXT("items"), ManifestDirectory, Items, Error));
+	TestFalse("No Items", UUnrealCopilotBatchCommandlet::ParseManifest(TEXT("{}"), ManifestDirectory, Items, Error));
+	TestFalse("Ambiguous Item", UUnrealCopilotBatchCommandlet::ParseManifest(TEXT("{\"items\": [{\"prompt\": \"a\", \"script\": \"b\"}]}"), ManifestDirectory, Items, Error));
+
+	// Test 3: The report counts an item as succeeded only if every step it asked for did
+	TArray<FUnrealCopilotBatchItem> Results;
+	FUnrealCopilotBatchItem& Generated = Results.AddDefaulted_GetRef();
+	Generated.Id = TEXT("generated");
+	Generated.Prompt = TEXT("Spawn a light");
+	Generated.bGenerated = true;
+	Generated.Generation.bSuccess = true;
+
+	FUnrealCopilotBatchItem& Failed = Results.AddDefaulted_GetRef();
+	Failed.Id = TEXT("failed");
+	Failed.Script = TEXT("raise Exception()");
+	Failed.bExecute = true;
+	Failed.bExecuted = true;
+
+	const TSharedRef<FJsonObject> Report = UUnrealCopilotBatchCommandlet::MakeReport(Results, 1.5);
+	TestEqual("Succeeded Count", Report->GetIntegerField(TEXT("succeeded")), 1);
+	TestEqual("Failed Count", Report->GetIntegerField(TEXT("failed")), 1);
+	TestEqual("Items Reported", Report->GetArrayField(TEXT("items")).Num(), 2);
+
+	IFileManager::Get().DeleteDirectory(*ManifestDirectory, false, true);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotWorkerPoolTest, "UnrealCopilot.Batch.WorkerPool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotWorkerPoolTest::RunTest(const FString& Parameters)
+{
+	// Test 1: Sorted paths are cut into contiguous ranges, the last one holding the remainder
+	TArray<FString> Paths;
+	for (int32 PathIndex = 0; PathIndex < 7; ++PathIndex)
+	{
+		Paths.Add(FString::Printf(TEXT("/Game/Props/SM_Crate%02d.SM_Crate%02d"), PathIndex, PathIndex));
+	}
+	const TArray<FUnrealCopilotShard> Shards = UUnrealCopilotWorkerPoolCommandlet::MakeShards(Paths, 3);
+	if (!TestEqual("Shard Count", Shards.Num(), 3))
+	{
+		return false;
+	}
+	TestEqual("Full Shard", Shards[1].Paths.Num(), 3);
+	TestEqual("Remainder Shard", Shards[2].Paths.Num(), 1);
+	TestEqual("Contiguous Range", Shards[1].Paths[0], Paths[3]);
+	TestEqual("Shard Numbered", Shards[2].Index, 2);
+
+	// Test 2: The shard script is told its index and paths before the script itself runs
+	const FString ShardScript = UUnrealCopilotWorkerPoolCommandlet::MakeShardScript(TEXT("print(len(copilot_shard_paths))"), Shards[2]);
+	TestTrue("Index Assigned", ShardScript.StartsWith(TEXT("copilot_shard_index = 2\n")));
+	TestTrue("Paths Assigned", ShardScript.Contains(TEXT("copilot_shard_paths = [\"/Game/Props/SM_Crate06.SM_Crate06\"]")));
+	TestTrue("Script Follows", ShardScript.EndsWith(TEXT("print(len(copilot_shard_paths))")));
+
+	// Test 3: Streamed results are found behind the log prefix, and other lines are ignored
+	const FString ResultLine = FString::Printf(TEXT("[2026.01.01-00.00.00:000][  0]LogUnrealCopilotBatch: Display: %s{\"id\":\"Shard0002\",\"success\":true}"),
+		UUnrealCopilotBatchCommandlet::StreamedResultPrefix);
+	TSharedPtr<FJsonObject> Result = UUnrealCopilotWorkerPoolCommandlet::ParseStreamedResult(ResultLine);
+	TestTrue("Result Parsed", Result.IsValid() && Result->GetStringField(TEXT("id")) == TEXT("Shard0002"));
+	TestFalse("Other Line Ignored", UUnrealCopilotWorkerPoolCommandlet::ParseStreamedResult(TEXT("LogInit: Display: Engine is initialized.")).IsValid());
+
+	// Test 4: The merged report counts a shard as succeeded only if its worker reported success
+	TArray<FUnrealCopilotShard> Finished = Shards;
+	Finished[0].Result = Result;
+	Finished[1].Attempts = 3;
+	Finished[1].Error = TEXT("Worker exited with code 3 without reporting a result");
+	Finished[2].Error = TEXT("Worker stopped after 60 s");
+	Finished[2].bTimedOut = true;
+	const TSharedRef<FJsonObject> Report = UUnrealCopilotWorkerPoolCommandlet::MakeReport(Finished, 10.0);
+	TestEqual("Succeeded Shards", Report->GetIntegerField(TEXT("succeeded")), 1);
+	TestEqual("Failed Shards", Report->GetIntegerField(TEXT("failed")), 2);
+	TestEqual("Retried Shards", Report->GetIntegerField(TEXT("retried")), 1);
+	TestEqual("Timed Out Shards", Report->GetIntegerField(TEXT("timedOut")), 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUnrealCopilotSystemExitTest, "UnrealCopilot.Python.SystemExit", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FUnrealCopilotSystemExitTest::RunTest(const FString& Parameters)
+{
+	IPythonScriptPlugin* PythonPlugin = IPythonScriptPlugin::Get();
+	if (!PythonPlugin || !PythonPlugin->IsPythonAvailable())
+	{
+		AddWarning(TEXT("Python is not available; skipping the system exit test"));
+		return true;
+	}
+
+	UUnrealCopilotExecutionManager* ExecutionManager = UUnrealCopilotExecutionManager::GetInstance();
+
+	// Test 1: Exiting from a synchronous script fails the script instead of closing the editor
+	const FPythonExecutionResult Raised = ExecutionManager->ExecutePythonCode(TEXT("raise SystemExit(3)"));
+	TestFalse("SystemExit Fails Script", Raised.bSuccess);
+	TestTrue("SystemExit Reported", Raised.ErrorMessage.Contains(TEXT("SystemExit")));
+	TestTrue("SystemExit Is Runtime Error", Raised.ErrorType == EPythonExecutionError::RuntimeError);
+
+	const FPythonExecutionResult Exited = ExecutionManager->ExecutePythonCode(TEXT("import sys\nsys.exit('done')"));
+	TestFalse("sys.exit Fails Script", Exited.bSuccess);
+
+	// Test 2: Scripts keep running afterwards
+	TestTrue("Still Running", ExecutionManager->ExecutePythonCode(TEXT("print('alive')")).bSuccess);
+
+	return true;
+}
+
 #endif //WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,447 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotWorkerPoolCommandlet.h"
+#include "UnrealCopilotBatchCommandlet.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetRegistry/ARFilter.h"
+#include "Engine/World.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Algo/Count.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogUnrealCopilotWorkerPool, Log, All);
+
+namespace UnrealCopilotWorkerPool
+{
+	/** Most workers; each is a full editor process, so memory runs out long before cores do */
+	static constexpr int32 MaxWorkers = 32;
+
+	/** Shards per worker when sharding assets without -ShardSize, so faster workers can take on more of the work */
+	static constexpr int32 ShardsPerWorker = 4;
+
+	/** Retries per shard when the command line does not say */
+	static constexpr int32 DefaultRetries = 2;
+
+	/** Time between checks of the workers */
+	static constexpr float PollSeconds = 0.05f;
+
+	static int32 GetDefaultWorkerCount()
+	{
+		return FMath::Clamp(FPlatformMisc::NumberOfCores() / 2, 1, MaxWorkers);
+	}
+
+	/** Whether a streamed item report says its script was interrupted for running too long */
+	static bool IsTimeoutResult(const FJsonObject& Result)
+	{
+		const TSharedPtr<FJsonObject>* Execution = nullptr;
+		FString ErrorType;
+		return Result.TryGetObjectField(TEXT("execution"), Execution)
+			&& (*Execution)->TryGetStringField(TEXT("errorType"), ErrorType)
+			&& ErrorType == TEXT("TimeoutError");
+	}
+}
+
+bool FUnrealCopilotShard::Succeeded() const
+{
+	bool bSuccess = false;
+	return Result.IsValid() && Result->TryGetBoolField(TEXT("success"), bSuccess) && bSuccess;
+}
+
+UUnrealCopilotWorkerPoolCommandlet::UUnrealCopilotWorkerPoolCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("Run a Python script over many maps or assets in parallel headless editor processes");
+	HelpUsage = TEXT("-run=UnrealCopilotWorkerPool -Script=<path> [-Maps] [-Path=<path>+<path>] [-Class=<class path>] [-Workers=<count>] [-ShardSize=<count>] [-Retries=<count>] [-ShardTimeout=<seconds>] [-ScriptTimeout=<seconds>] [-Output=<path>]");
+	HelpParamNames = { TEXT("Script"), TEXT("Maps"), TEXT("Path"), TEXT("Class"), TEXT("Workers"), TEXT("ShardSize"), TEXT("Retries"), TEXT("ShardTimeout"), TEXT("ScriptTimeout"), TEXT("Output") };
+	HelpParamDescriptions = {
+		TEXT("Python script to run; it receives copilot_shard_index and copilot_shard_paths"),
+		TEXT("Shard maps instead of assets; each map is its own shard unless -ShardSize says otherwise"),
+		TEXT("Content folders to search, separated by '+' (default /Game)"),
+		TEXT("Only shard assets of this class or its subclasses"),
+		TEXT("Worker processes to run at once (default half the cores)"),
+		TEXT("Most maps or assets per shard"),
+		TEXT("Times a shard whose worker crashed or timed out is run again (default 2)"),
+		TEXT("Seconds a worker may run before it is stopped (default no limit)"),
+		TEXT("Seconds a shard's script may run before it is interrupted (default the shard timeout)"),
+		TEXT("Where to write the merged results; defaults to the run's folder under Saved/UnrealCopilot/WorkerPool")
+	};
+}
+
+int32 UUnrealCopilotWorkerPoolCommandlet::Main(const FString& Params)
+{
+	using namespace UnrealCopilotWorkerPool;
+
+	FString ScriptPath;
+	if (!FParse::Value(*Params, TEXT("Script="), ScriptPath))
+	{
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("Usage: %s"), *HelpUsage);
+		return 1;
+	}
+	if (!FFileHelper::LoadFileToString(Script, *ScriptPath))
+	{
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("Could not read script %s"), *ScriptPath);
+		return 1;
+	}
+
+	TArray<FString> Paths;
+	GatherPaths(Params, Paths);
+	if (Paths.Num() == 0)
+	{
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("No maps or assets match the command line"));
+		return 1;
+	}
+
+	int32 WorkerCount = GetDefaultWorkerCount();
+	FParse::Value(*Params, TEXT("Workers="), WorkerCount);
+	WorkerCount = FMath::Clamp(WorkerCount, 1, MaxWorkers);
+
+	int32 ShardSize = FParse::Param(*Params, TEXT("Maps")) ? 1 : FMath::DivideAndRoundUp(Paths.Num(), WorkerCount * ShardsPerWorker);
+	FParse::Value(*Params, TEXT("ShardSize="), ShardSize);
+
+	int32 Retries = DefaultRetries;
+	FParse::Value(*Params, TEXT("Retries="), Retries);
+	MaxAttempts = 1 + FMath::Max(Retries, 0);
+	FParse::Value(*Params, TEXT("ShardTimeout="), ShardTimeoutSeconds);
+	ScriptTimeoutSeconds = ShardTimeoutSeconds;
+	FParse::Value(*Params, TEXT("ScriptTimeout="), ScriptTimeoutSeconds);
+
+	WorkDirectory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("UnrealCopilot") / TEXT("WorkerPool") / FDateTime::Now().ToString());
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = WorkDirectory / TEXT("Results.json");
+	}
+
+	Shards = MakeShards(Paths, ShardSize);
+	for (const FUnrealCopilotShard& Shard : Shards)
+	{
+		PendingShards.Add(Shard.Index);
+	}
+	WorkerCount = FMath::Min(WorkerCount, Shards.Num());
+
+	UE_LOG(LogUnrealCopilotWorkerPool, Display, TEXT("Running %s over %d paths in %d shards with %d workers; worker files are in %s"),
+		*FPaths::GetCleanFilename(ScriptPath), Paths.Num(), Shards.Num(), WorkerCount, *WorkDirectory);
+
+	const double StartTime = FPlatformTime::Seconds();
+	while (PendingShards.Num() > 0 || Workers.Num() > 0)
+	{
+		if (IsEngineExitRequested())
+		{
+			for (FWorker& Worker : Workers)
+			{
+				FPlatformProcess::TerminateProc(Worker.Process, true);
+				FinishWorker(Worker, -1, TEXT("Stopped because the coordinator is exiting"), false);
+			}
+			Workers.Reset();
+			PendingShards.Reset();
+			break;
+		}
+
+		while (Workers.Num() < WorkerCount && PendingShards.Num() > 0)
+		{
+			const int32 ShardIndex = PendingShards[0];
+			PendingShards.RemoveAt(0);
+			LaunchWorker(ShardIndex);
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		for (int32 WorkerIndex = Workers.Num() - 1; WorkerIndex >= 0; --WorkerIndex)
+		{
+			FWorker& Worker = Workers[WorkerIndex];
+			ReadWorkerOutput(Worker);
+
+			if (!FPlatformProcess::IsProcRunning(Worker.Process))
+			{
+				// Output written just before exiting may still be in the pipe
+				ReadWorkerOutput(Worker);
+
+				int32 ExitCode = 0;
+				FPlatformProcess::GetProcReturnCode(Worker.Process, &ExitCode);
+				FinishWorker(Worker, ExitCode, FString::Printf(TEXT("Worker exited with code %d without reporting a result"), ExitCode), false);
+				Workers.RemoveAtSwap(WorkerIndex);
+			}
+			else if (ShardTimeoutSeconds > 0.0 && Now - Worker.StartTime > ShardTimeoutSeconds)
+			{
+				FPlatformProcess::TerminateProc(Worker.Process, true);
+				FinishWorker(Worker, -1, FString::Printf(TEXT("Worker stopped after %.0f s"), ShardTimeoutSeconds), true);
+				Workers.RemoveAtSwap(WorkerIndex);
+			}
+		}
+
+		FPlatformProcess::Sleep(PollSeconds);
+	}
+
+	const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+	FString ReportString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+	FJsonSerializer::Serialize(MakeReport(Shards, TotalSeconds), Writer);
+	if (!FFileHelper::SaveStringToFile(ReportString, *OutputPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("Could not write results to %s"), *OutputPath);
+		return 1;
+	}
+
+	const int32 SucceededCount = Algo::CountIf(Shards, [](const FUnrealCopilotShard& Shard) { return Shard.Succeeded(); });
+	UE_LOG(LogUnrealCopilotWorkerPool, Display, TEXT("%d of %d shards succeeded in %.1f s; results written to %s"),
+		SucceededCount, Shards.Num(), TotalSeconds, *OutputPath);
+	return SucceededCount == Shards.Num() ? 0 : 1;
+}
+
+TArray<FUnrealCopilotShard> UUnrealCopilotWorkerPoolCommandlet::MakeShards(const TArray<FString>& Paths, int32 ShardSize)
+{
+	ShardSize = FMath::Max(ShardSize, 1);
+
+	TArray<FUnrealCopilotShard> Result;
+	for (int32 First = 0; First < Paths.Num(); First += ShardSize)
+	{
+		FUnrealCopilotShard& Shard = Result.AddDefaulted_GetRef();
+		Shard.Index = Result.Num() - 1;
+		Shard.Paths.Append(&Paths[First], FMath::Min(ShardSize, Paths.Num() - First));
+	}
+	return Result;
+}
+
+FString UUnrealCopilotWorkerPoolCommandlet::MakeShardScript(const FString& Script, const FUnrealCopilotShard& Shard)
+{
+	TArray<FString> QuotedPaths;
+	for (const FString& Path : Shard.Paths)
+	{
+		QuotedPaths.Add(FString::Printf(TEXT("\"%s\""), *Path.ReplaceCharWithEscapedChar()));
+	}
+
+	return FString::Printf(TEXT("copilot_shard_index = %d\ncopilot_shard_paths = [%s]\n\n%s"),
+		Shard.Index, *FString::Join(QuotedPaths, TEXT(", ")), *Script);
+}
+
+TSharedPtr<FJsonObject> UUnrealCopilotWorkerPoolCommandlet::ParseStreamedResult(const FString& Line)
+{
+	const int32 PrefixIndex = Line.Find(UUnrealCopilotBatchCommandlet::StreamedResultPrefix, ESearchCase::CaseSensitive);
+	if (PrefixIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FJsonObject> Result;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line.Mid(PrefixIndex + FCString::Strlen(UUnrealCopilotBatchCommandlet::StreamedResultPrefix)));
+	if (!FJsonSerializer::Deserialize(Reader, Result))
+	{
+		return nullptr;
+	}
+	return Result;
+}
+
+TSharedRef<FJsonObject> UUnrealCopilotWorkerPoolCommandlet::MakeReport(const TArray<FUnrealCopilotShard>& Shards, double TotalSeconds)
+{
+	int32 SucceededCount = 0;
+	int32 RetriedCount = 0;
+	int32 TimedOutCount = 0;
+	TArray<TSharedPtr<FJsonValue>> ShardValues;
+	for (const FUnrealCopilotShard& Shard : Shards)
+	{
+		SucceededCount += Shard.Succeeded();
+		RetriedCount += Shard.Attempts > 1;
+		TimedOutCount += Shard.bTimedOut;
+
+		TSharedRef<FJsonObject> ShardJson = MakeShared<FJsonObject>();
+		ShardJson->SetNumberField(TEXT("index"), Shard.Index);
+		ShardJson->SetNumberField(TEXT("count"), Shard.Paths.Num());
+		ShardJson->SetStringField(TEXT("first"), Shard.Paths.Num() > 0 ? Shard.Paths[0] : FString());
+		ShardJson->SetStringField(TEXT("last"), Shard.Paths.Num() > 0 ? Shard.Paths.Last() : FString());
+		ShardJson->SetBoolField(TEXT("success"), Shard.Succeeded());
+		ShardJson->SetBoolField(TEXT("timedOut"), Shard.bTimedOut);
+		ShardJson->SetNumberField(TEXT("attempts"), Shard.Attempts);
+		ShardJson->SetNumberField(TEXT("exitCode"), Shard.ExitCode);
+		ShardJson->SetNumberField(TEXT("seconds"), Shard.Seconds);
+		if (!Shard.Error.IsEmpty())
+		{
+			ShardJson->SetStringField(TEXT("error"), Shard.Error);
+		}
+		if (Shard.Result.IsValid())
+		{
+			ShardJson->SetObjectField(TEXT("result"), Shard.Result);
+		}
+		ShardValues.Add(MakeShared<FJsonValueObject>(ShardJson));
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("totalSeconds"), TotalSeconds);
+	Report->SetNumberField(TEXT("succeeded"), SucceededCount);
+	Report->SetNumberField(TEXT("failed"), Shards.Num() - SucceededCount);
+	Report->SetNumberField(TEXT("retried"), RetriedCount);
+	Report->SetNumberField(TEXT("timedOut"), TimedOutCount);
+	Report->SetArrayField(TEXT("shards"), ShardValues);
+	return Report;
+}
+
+void UUnrealCopilotWorkerPoolCommandlet::GatherPaths(const FString& Params, TArray<FString>& OutPaths)
+{
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	AssetRegistry.SearchAllAssets(true);
+
+	FString PathList = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Path="), PathList);
+	TArray<FString> PackagePaths;
+	PathList.ParseIntoArray(PackagePaths, TEXT("+"));
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& PackagePath : PackagePaths)
+	{
+		Filter.PackagePaths.Add(FName(*PackagePath));
+	}
+
+	const bool bMaps = FParse::Param(*Params, TEXT("Maps"));
+	FString ClassPath;
+	if (bMaps)
+	{
+		Filter.ClassPaths.Add(UWorld::StaticClass()->GetClassPathName());
+	}
+	else if (FParse::Value(*Params, TEXT("Class="), ClassPath))
+	{
+		Filter.ClassPaths.Add(FTopLevelAssetPath(ClassPath));
+		Filter.bRecursiveClasses = true;
+	}
+
+	AssetRegistry.EnumerateAssets(Filter, [&OutPaths, bMaps](const FAssetData& AssetData)
+	{
+		OutPaths.Add(bMaps ? AssetData.PackageName.ToString() : AssetData.GetObjectPathString());
+		return true;
+	});
+
+	// Sorting keeps each shard to a contiguous range of folders, and the shards the same from one run to the next
+	OutPaths.Sort();
+}
+
+bool UUnrealCopilotWorkerPoolCommandlet::LaunchWorker(int32 ShardIndex)
+{
+	FUnrealCopilotShard& Shard = Shards[ShardIndex];
+	++Shard.Attempts;
+	Shard.Result.Reset();
+	Shard.Error.Reset();
+	Shard.bTimedOut = false;
+
+	const FString ShardName = FString::Printf(TEXT("Shard%04d"), Shard.Index);
+	const FString ManifestPath = WorkDirectory / ShardName + TEXT(".json");
+	const FString ResultsPath = WorkDirectory / ShardName + TEXT(".results.json");
+	const FString LogPath = WorkDirectory / FString::Printf(TEXT("%s.%d.log"), *ShardName, Shard.Attempts);
+
+	TSharedRef<FJsonObject> Item = MakeShared<FJsonObject>();
+	Item->SetStringField(TEXT("id"), ShardName);
+	Item->SetStringField(TEXT("script"), MakeShardScript(Script, Shard));
+	TArray<TSharedPtr<FJsonValue>> Items;
+	Items.Add(MakeShared<FJsonValueObject>(Item));
+	TSharedRef<FJsonObject> Manifest = MakeShared<FJsonObject>();
+	Manifest->SetArrayField(TEXT("items"), Items);
+
+	FString ManifestString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ManifestString);
+	FJsonSerializer::Serialize(Manifest, Writer);
+	if (!FFileHelper::SaveStringToFile(ManifestString, *ManifestPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		Shard.Error = FString::Printf(TEXT("Could not write manifest %s"), *ManifestPath);
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("%s"), *Shard.Error);
+		return false;
+	}
+
+	FWorker Worker;
+	Worker.ShardIndex = ShardIndex;
+	if (!FPlatformProcess::CreatePipe(Worker.ReadPipe, Worker.WritePipe))
+	{
+		Shard.Error = TEXT("Could not create a pipe for the worker's output");
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("%s"), *Shard.Error);
+		return false;
+	}
+
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString WorkerParams = FString::Printf(
+		TEXT("\"%s\" -run=UnrealCopilotBatch -Manifest=\"%s\" -Output=\"%s\" -StreamResults -NoHistory -ScriptTimeout=%.0f -abslog=\"%s\" -unattended -nullrhi -nosplash -nopause -stdout -FullStdOutLogOutput"),
+		*ProjectPath, *ManifestPath, *ResultsPath, ScriptTimeoutSeconds, *LogPath);
+
+	Worker.Process = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *WorkerParams, false, true, true, nullptr, 0, nullptr, Worker.WritePipe);
+	if (!Worker.Process.IsValid())
+	{
+		FPlatformProcess::ClosePipe(Worker.ReadPipe, Worker.WritePipe);
+		Shard.Error = TEXT("Could not launch a worker");
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("%s for shard %d"), *Shard.Error, Shard.Index);
+		return false;
+	}
+
+	Worker.StartTime = FPlatformTime::Seconds();
+	UE_LOG(LogUnrealCopilotWorkerPool, Display, TEXT("Shard %d (%d paths from %s), attempt %d, started"),
+		Shard.Index, Shard.Paths.Num(), *Shard.Paths[0], Shard.Attempts);
+	Workers.Add(MoveTemp(Worker));
+	return true;
+}
+
+void UUnrealCopilotWorkerPoolCommandlet::ReadWorkerOutput(FWorker& Worker)
+{
+	Worker.PendingOutput += FPlatformProcess::ReadPipe(Worker.ReadPipe);
+
+	int32 LineEnd = INDEX_NONE;
+	while (Worker.PendingOutput.FindChar(TEXT('\n'), LineEnd))
+	{
+		const FString Line = Worker.PendingOutput.Left(LineEnd).TrimEnd();
+		Worker.PendingOutput.RightChopInline(LineEnd + 1);
+
+		if (TSharedPtr<FJsonObject> Result = ParseStreamedResult(Line))
+		{
+			Shards[Worker.ShardIndex].Result = Result;
+		}
+		else
+		{
+			UE_LOG(LogUnrealCopilotWorkerPool, Verbose, TEXT("[Shard %d] %s"), Shards[Worker.ShardIndex].Index, *Line);
+		}
+	}
+}
+
+void UUnrealCopilotWorkerPoolCommandlet::FinishWorker(FWorker& Worker, int32 ExitCode, const FString& Error, bool bTimedOut)
+{
+	using namespace UnrealCopilotWorkerPool;
+
+	FUnrealCopilotShard& Shard = Shards[Worker.ShardIndex];
+	Shard.ExitCode = ExitCode;
+	Shard.Seconds = FPlatformTime::Seconds() - Worker.StartTime;
+	Shard.bTimedOut = bTimedOut;
+
+	FPlatformProcess::CloseProc(Worker.Process);
+	FPlatformProcess::ClosePipe(Worker.ReadPipe, Worker.WritePipe);
+	Worker.ReadPipe = nullptr;
+	Worker.WritePipe = nullptr;
+
+	// A worker that reported a result is done with the shard, even if it then failed to shut down cleanly
+	if (Shard.Result.IsValid())
+	{
+		if (IsTimeoutResult(*Shard.Result))
+		{
+			Shard.bTimedOut = true;
+			Shard.Error = FString::Printf(TEXT("Script timed out after %.0f s"), ScriptTimeoutSeconds);
+			UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("Shard %d: %s"), Shard.Index, *Shard.Error);
+			return;
+		}
+
+		UE_LOG(LogUnrealCopilotWorkerPool, Display, TEXT("Shard %d %s in %.1f s"), Shard.Index, Shard.Succeeded() ? TEXT("succeeded") : TEXT("failed"), Shard.Seconds);
+		return;
+	}
+
+	Shard.Error = Error;
+	if (Shard.Attempts < MaxAttempts && !IsEngineExitRequested())
+	{
+		UE_LOG(LogUnrealCopilotWorkerPool, Warning, TEXT("Shard %d: %s; retrying"), Shard.Index, *Error);
+		PendingShards.Add(Worker.ShardIndex);
+	}
+	else
+	{
+		UE_LOG(LogUnrealCopilotWorkerPool, Error, TEXT("Shard %d: %s; giving up after %d attempts"), Shard.Index, *Error, Shard.Attempts);
+	}
+}
@@ -0,0 +1,299 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "UnrealCopilotWorkflowClassifier.h"
+#include "UnrealCopilotExecutionManager.h"
+#include "Misc/Crc.h"
+
+namespace UnrealCopilotWorkflowClassifier
+{
+	struct FLabelledExample
+	{
+		const TCHAR* Text;
+		EUnrealCopilotWorkflowType WorkflowType;
+	};
+
+	/** Bundled labelled prompts used to seed the model */
+	static const FLabelledExample BundledTrainingSet[] =
+	{
+		{ TEXT("create a material with a scrolling texture"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("make a new material instance and set the base color parameter"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("add a texture sample node to the material graph and connect it to base color"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("set roughness and metallic scalar parameters on all material instances"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("create an emissive glowing material"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("replace the material on the selected meshes"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("recompile the master material and its shader"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("build a layered landscape material with normal maps"), EUnrealCopilotWorkflowType::MaterialCreation },
+
+		{ TEXT("add 10 cubes to the level in a circle"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("spawn a point light above the selected actor"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("move all selected actors up by 100 units"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("rotate the actors in the scene randomly and scale them"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("delete every actor in the level with the tag temp"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("place trees along a spline in the world"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("align the selected actors to the floor and snap to grid"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("group actors into an outliner folder by class"), EUnrealCopilotWorkflowType::LevelEditing },
+
+		{ TEXT("list all static meshes in the project"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("rename assets in the content browser folder with a prefix"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("find unused textures and move them to an archive directory"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("duplicate the asset and save it to a new path"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("fix up redirectors in the game folder"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("import fbx files and set the texture compression settings"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("report assets that are missing references or dependencies"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("batch set lod settings on every static mesh asset"), EUnrealCopilotWorkflowType::AssetManagement },
+
+		{ TEXT("play an animation sequence on the selected skeletal mesh"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("create a level sequence and add the selected actor as a possessable"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("retarget animations to the new skeleton"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("add keyframes to the camera in the sequencer track"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("set the anim blueprint on all characters"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("list animation montages and their length"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("add notifies to the walk cycle animation"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("bake the control rig to the skeletal animation"), EUnrealCopilotWorkflowType::Animation },
+
+		{ TEXT("spawn a niagara fire particle system at the selected actor"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("create a smoke effect emitter"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("set the spawn rate user parameter on the niagara component"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("add sparks and explosion vfx to the level"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("replace cascade particle systems with niagara systems"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("make a rain weather effect with particles"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("change the color of the magic particle effect"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("add a dissolve visual effect to the character"), EUnrealCopilotWorkflowType::VFX },
+
+		{ TEXT("print hello world"), EUnrealCopilotWorkflowType::General },
+		{ TEXT("what version of the engine is running"), EUnrealCopilotWorkflowType::General },
+		{ TEXT("show me how to use the python api"), EUnrealCopilotWorkflowType::General },
+		{ TEXT("write a helper function that logs a message"), EUnrealCopilotWorkflowType::General },
+		{ TEXT("get the project directory and editor settings"), EUnrealCopilotWorkflowType::General },
+		{ TEXT("run a console command"), EUnrealCopilotWorkflowType::General },
+	};
+
+	struct FCodeRule
+	{
+		const TCHAR* Pattern;
+		EUnrealCopilotWorkflowType WorkflowType;
+	};
+
+	/** API references used to label scripts, checked in priority order */
+	static const FCodeRule CodeRules[] =
+	{
+		{ TEXT("Niagara"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("ParticleSystem"), EUnrealCopilotWorkflowType::VFX },
+		{ TEXT("AnimSequence"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("AnimationLibrary"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("LevelSequence"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("MovieScene"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("AnimBlueprint"), EUnrealCopilotWorkflowType::Animation },
+		{ TEXT("MaterialEditingLibrary"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("MaterialInstance"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("MaterialExpression"), EUnrealCopilotWorkflowType::MaterialCreation },
+		{ TEXT("EditorActorSubsystem"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("EditorLevelLibrary"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("spawn_actor"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("set_actor_location"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("get_selected_level_actors"), EUnrealCopilotWorkflowType::LevelEditing },
+		{ TEXT("EditorAssetLibrary"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("AssetRegistry"), EUnrealCopilotWorkflowType::AssetManagement },
+		{ TEXT("AssetTools"), EUnrealCopilotWorkflowType::AssetManagement },
+	};
+
+	/** Words that carry no workflow signal */
+	static bool IsStopWord(const FString& Word)
+	{
+		static const TSet<FString> StopWords = {
+			TEXT("a"), TEXT("an"), TEXT("the"), TEXT("to"), TEXT("of"), TEXT("in"), TEXT("on"), TEXT("and"),
+			TEXT("or"), TEXT("for"), TEXT("with"), TEXT("it"), TEXT("is"), TEXT("be"), TEXT("this"), TEXT("that"),
+			TEXT("me"), TEXT("my"), TEXT("i"), TEXT("please"), TEXT("from"), TEXT("into"), TEXT("by"), TEXT("at"),
+			TEXT("as"), TEXT("all"), TEXT("import"), TEXT("unreal"), TEXT("self"), TEXT("def"), TEXT("get")
+		};
+		return StopWords.Contains(Word);
+	}
+
+	/** Strip simple English plural suffixes so "materials" and "material" share a feature */
+	static void StemWord(FString& Word)
+	{
+		if (Word.Len() > 4 && (Word.EndsWith(TEXT("shes")) || Word.EndsWith(TEXT("ches")) || Word.EndsWith(TEXT("xes"))))
+		{
+			Word.LeftChopInline(2);
+		}
+		else if (Word.Len() > 3 && Word.EndsWith(TEXT("s")) && !Word.EndsWith(TEXT("ss")))
+		{
+			Word.LeftChopInline(1);
+		}
+	}
+}
+
+FUnrealCopilotWorkflowClassifier::FUnrealCopilotWorkflowClassifier()
+{
+	LoadBundledTrainingSet();
+}
+
+FWorkflowClassification FUnrealCopilotWorkflowClassifier::Classify(const FString& Text) const
+{
+	FWorkflowClassification Result;
+
+	TArray<uint32> Features;
+	ExtractFeatures(Text, Features);
+
+	const int32 VocabularySize = FMath::Max(FeatureCounts.Num(), 1);
+	double LogScores[NumWorkflowTypes];
+	for (int32 ClassIndex = 0; ClassIndex < NumWorkflowTypes; ++ClassIndex)
+	{
+		// Laplace-smoothed class prior
+		LogScores[ClassIndex] = FMath::Loge((ClassDocumentCounts[ClassIndex] + 1.0) / (TotalDocuments + NumWorkflowTypes));
+	}
+
+	int32 KnownFeatures = 0;
+	for (uint32 Feature : Features)
+	{
+		const FFeatureCounts* Counts = FeatureCounts.Find(Feature);
+		if (!Counts)
+		{
+			continue; // Features never seen in training carry no information
+		}
+
+		++KnownFeatures;
+		for (int32 ClassIndex = 0; ClassIndex < NumWorkflowTypes; ++ClassIndex)
+		{
+			LogScores[ClassIndex] += FMath::Loge((Counts->Counts[ClassIndex] + 1.0) / (ClassFeatureTotals[ClassIndex] + VocabularySize));
+		}
+	}
+
+	if (KnownFeatures == 0)
+	{
+		return Result;
+	}
+
+	// Softmax over log scores to get a posterior for the winning class
+	int32 BestClass = 0;
+	for (int32 ClassIndex = 1; ClassIndex < NumWorkflowTypes; ++ClassIndex)
+	{
+		if (LogScores[ClassIndex] > LogScores[BestClass])
+		{
+			BestClass = ClassIndex;
+		}
+	}
+
+	double Normalizer = 0.0;
+	for (int32 ClassIndex = 0; ClassIndex < NumWorkflowTypes; ++ClassIndex)
+	{
+		Normalizer += FMath::Exp(LogScores[ClassIndex] - LogScores[BestClass]);
+	}
+
+	Result.WorkflowType = static_cast<EUnrealCopilotWorkflowType>(BestClass);
+	Result.Confidence = static_cast<float>(1.0 / Normalizer);
+	return Result;
+}
+
+void FUnrealCopilotWorkflowClassifier::AddTrainingExample(const FString& Text, EUnrealCopilotWorkflowType WorkflowType)
+{
+	const int32 ClassIndex = static_cast<int32>(WorkflowType);
+	if (ClassIndex < 0 || ClassIndex >= NumWorkflowTypes)
+	{
+		return;
+	}
+
+	TArray<uint32> Features;
+	ExtractFeatures(Text, Features);
+	if (Features.Num() == 0)
+	{
+		return;
+	}
+
+	for (uint32 Feature : Features)
+	{
+		FeatureCounts.FindOrAdd(Feature).Counts[ClassIndex]++;
+	}
+
+	ClassFeatureTotals[ClassIndex] += Features.Num();
+	ClassDocumentCounts[ClassIndex]++;
+	TotalDocuments++;
+}
+
+int32 FUnrealCopilotWorkflowClassifier::TrainFromExecutionHistory(const TArray<FPythonExecutionHistoryEntry>& History)
+{
+	int32 NumUsed = 0;
+	for (const FPythonExecutionHistoryEntry& Entry : History)
+	{
+		if (!Entry.bWasSuccessful)
+		{
+			continue;
+		}
+
+		const EUnrealCopilotWorkflowType WorkflowType = InferWorkflowFromCode(Entry.Code);
+		if (WorkflowType != EUnrealCopilotWorkflowType::General)
+		{
+			AddTrainingExample(Entry.Code, WorkflowType);
+			++NumUsed;
+		}
+	}
+	return NumUsed;
+}
+
+EUnrealCopilotWorkflowType FUnrealCopilotWorkflowClassifier::InferWorkflowFromCode(const FString& PythonCode)
+{
+	for (const UnrealCopilotWorkflowClassifier::FCodeRule& Rule : UnrealCopilotWorkflowClassifier::CodeRules)
+	{
+		if (PythonCode.Contains(Rule.Pattern))
+		{
+			return Rule.WorkflowType;
+		}
+	}
+	return EUnrealCopilotWorkflowType::General;
+}
+
+void FUnrealCopilotWorkflowClassifier::ExtractFeatures(const FString& Text, TArray<uint32>& OutFeatures)
+{
+	OutFeatures.Reset();
+
+	// Split on non-alphanumerics and on camelCase boundaries so code identifiers share features with prose
+	TArray<FString, TInlineAllocator<64>> Words;
+	FString Current;
+	TCHAR Previous = 0;
+	for (TCHAR Char : Text)
+	{
+		const bool bIsAlnum = FChar::IsAlnum(Char);
+		const bool bCamelBoundary = bIsAlnum && FChar::IsUpper(Char) && FChar::IsLower(Previous);
+		if ((!bIsAlnum || bCamelBoundary) && !Current.IsEmpty())
+		{
+			Words.Add(MoveTemp(Current));
+			Current.Reset();
+		}
+		if (bIsAlnum)
+		{
+			Current.AppendChar(FChar::ToLower(Char));
+		}
+		Previous = Char;
+	}
+	if (!Current.IsEmpty())
+	{
+		Words.Add(MoveTemp(Current));
+	}
+
+	uint32 PreviousHash = 0;
+	for (FString& Word : Words)
+	{
+		if (Word.Len() < 2 || UnrealCopilotWorkflowClassifier::IsStopWord(Word))
+		{
+			continue;
+		}
+
+		UnrealCopilotWorkflowClassifier::StemWord(Word);
+		const uint32 WordHash = FCrc::StrCrc32(*Word);
+		OutFeatures.Add(WordHash);
+
+		if (PreviousHash != 0)
+		{
+			OutFeatures.Add(HashCombine(PreviousHash, WordHash) ^ 0x9E3779B9u);
+		}
+		PreviousHash = WordHash;
+	}
+}
+
+void FUnrealCopilotWorkflowClassifier::LoadBundledTrainingSet()
+{
+	for (const UnrealCopilotWorkflowClassifier::FLabelledExample& Example : UnrealCopilotWorkflowClassifier::BundledTrainingSet)
+	{
+		AddTrainingExample(Example.Text, Example.WorkflowType);
+	}
+}
@@ -18,6 +18,13 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	/** Warm the Python environment if enabled in the settings */
+	static void OnPythonInitialized();
+
+	/** Registered when Python initializes after this module starts */
+	FDelegateHandle PythonInitializedHandle;
 };
 
 /**
@@ -42,10 +49,13 @@ public:
 	/**
 	 * Execute Python code with enhanced error handling and timeout support
 	 * @param PythonCode - The Python code string to execute
+	 * @param bAsync - Whether to queue the code; its final result is then broadcast through OnExecutionCompleted
+	 * @param Priority - Queue priority of asynchronous code; interactive scripts run ahead of batch ones
 	 * @return Detailed execution result with error information
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot", CallInEditor)
-	static FPythonExecutionResult ExecutePythonCodeEnhanced(const FString& PythonCode);
+	static FPythonExecutionResult ExecutePythonCodeEnhanced(const FString& PythonCode, bool bAsync = false,
+		EPythonExecutionPriority Priority = EPythonExecutionPriority::Interactive);
 
 	/**
 	 * Validate Python syntax without executing
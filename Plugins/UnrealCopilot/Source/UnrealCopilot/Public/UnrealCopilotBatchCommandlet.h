@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UnrealCopilotExecutionManager.h"
+#include "UnrealCopilotLLMManager.h"
+#include "UnrealCopilotBatchCommandlet.generated.h"
+
+class FJsonObject;
+
+/**
+ * One prompt or script of a batch manifest, and what became of it
+ */
+struct UNREALCOPILOT_API FUnrealCopilotBatchItem
+{
+	/** Name the item is reported under */
+	FString Id;
+
+	/** Prompt to generate code from; empty for script items */
+	FString Prompt;
+
+	/** Script to run; for prompt items, the generated code */
+	FString Script;
+
+	/** Whether the script is run; always true for script items, opt-in for prompt items */
+	bool bExecute = false;
+
+	/** Error that failed the item before generation or execution, such as an unreadable script file */
+	FString Error;
+
+	/** Whether code generation finished, and its result */
+	bool bGenerated = false;
+	FCodeGenerationResult Generation;
+
+	/** Whether the script ran, and its result */
+	bool bExecuted = false;
+	FPythonExecutionResult Execution;
+
+	/** When the item started and finished, in seconds since the batch started */
+	double StartSeconds = 0.0;
+	double EndSeconds = 0.0;
+
+	bool IsPrompt() const { return !Prompt.IsEmpty(); }
+
+	/** Whether every step the item asked for succeeded */
+	bool Succeeded() const;
+};
+
+/**
+ * Runs a manifest of prompts and scripts without the editor UI, for bulk work on build machines:
+ *
+ *   UnrealEditor-Cmd.exe Project.uproject -run=UnrealCopilotBatch -Manifest=Batch.json [-Output=Results.json]
+ *       [-Concurrency=4] [-StreamResults] [-NoHistory]
+ *       [-ScriptTimeout=0] -unattended -nullrhi
+ *
+ * The manifest is a JSON object with an "items" array. Each item has an "id" and either a "prompt", a "script", or
+ * a "scriptFile" relative to the manifest; prompt items also run the generated code if "execute" is true. A top-level
+ * "execute" sets the default for prompt items.
+ *
+ * Prompts are sent to the LLM concurrently, each through its own LLM manager and within the configured request rate.
+ * Scripts run one at a time on the game thread through the execution manager, between network updates, so responses
+ * keep arriving while a script runs. Results, errors and timings are written as JSON; the commandlet returns 0 only if
+ * every item succeeded. With -StreamResults, each item's result is also logged as a single line starting with
+ * StreamedResultPrefix as soon as the item finishes, for a coordinator reading the worker's output. With -NoHistory,
+ * the batch does not open the project's history, which other processes may have open. -ScriptTimeout replaces the
+ * interactive execution timeout, 0 letting scripts run to completion.
+ */
+UCLASS()
+class UNREALCOPILOT_API UUnrealCopilotBatchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealCopilotBatchCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+
+	/**
+	 * Read the items of a manifest
+	 * @param ManifestJson - Manifest contents
+	 * @param ManifestDirectory - Folder script files are relative to
+	 * @param OutItems - Items in manifest order; items whose script file cannot be read carry an error
+	 * @param OutError - Why the manifest could not be read
+	 * @return False if the manifest is not valid
+	 */
+	static bool ParseManifest(const FString& ManifestJson, const FString& ManifestDirectory, TArray<FUnrealCopilotBatchItem>& OutItems, FString& OutError);
+
+	/**
+	 * Build the JSON report of a batch
+	 * @param Items - Items with their results
+	 * @param TotalSeconds - Time the batch took
+	 */
+	static TSharedRef<FJsonObject> MakeReport(const TArray<FUnrealCopilotBatchItem>& Items, double TotalSeconds);
+
+	/** Build the JSON report of one item */
+	static TSharedRef<FJsonObject> MakeItemReport(const FUnrealCopilotBatchItem& Item);
+
+	/** Start of the output lines carrying streamed item results, followed by the item report as condensed JSON */
+	static const TCHAR* const StreamedResultPrefix;
+
+private:
+	/** Send prompts to idle LLM managers while the request rate allows */
+	void DispatchPrompts();
+
+	/** Run the next script waiting to execute */
+	void ExecuteNextScript();
+
+	/** Record that an item is done, streaming its result if asked to */
+	void FinishItem(int32 ItemIndex);
+
+	/** Record a finished generation, queuing its code if the item runs it */
+	void OnGenerationComplete(const FCodeGenerationResult& Result, int32 ManagerIndex, int32 ItemIndex);
+
+	/** Get the time since the batch started */
+	double GetBatchSeconds() const;
+
+private:
+	/** LLM managers, one per concurrent request */
+	UPROPERTY()
+	TArray<TObjectPtr<UUnrealCopilotLLMManager>> LLMManagers;
+
+	/** Item each LLM manager is generating code for, or INDEX_NONE if idle */
+	TArray<int32> ActiveItems;
+
+	/** Manifest items with their results */
+	TArray<FUnrealCopilotBatchItem> Items;
+
+	/** Prompt items waiting for an LLM manager, in manifest order */
+	TArray<int32> PendingPrompts;
+
+	/** Items whose script is waiting to run, in the order they became ready */
+	TArray<int32> PendingScripts;
+
+	/** Requests sent by the batch, shared by all LLM managers so they stay within the request rate together */
+	FAPIUsageTracker UsageTracker;
+
+	/** When the batch started */
+	double BatchStartTime = 0.0;
+
+	/** Whether item results are logged as they finish */
+	bool bStreamResults = false;
+};
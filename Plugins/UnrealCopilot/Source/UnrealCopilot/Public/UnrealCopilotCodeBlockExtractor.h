@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealCopilotCodeBlockExtractor.generated.h"
+
+/**
+ * Which fenced code blocks of a multi-block response make up the generated script
+ */
+UENUM(BlueprintType)
+enum class EUnrealCopilotCodeBlockSelection : uint8
+{
+	/** All Python blocks joined in order */
+	Concatenate UMETA(DisplayName = "Concatenate All Blocks"),
+	/** Only the first Python block */
+	First UMETA(DisplayName = "First Block"),
+	/** Only the last Python block, usually the final revision */
+	Last UMETA(DisplayName = "Last Block"),
+	/** The longest Python block */
+	Longest UMETA(DisplayName = "Longest Block")
+};
+
+/**
+ * A fenced code block found in a response
+ */
+struct FUnrealCopilotCodeBlock
+{
+	/** Language tag after the opening fence, lower case (may be empty) */
+	FString Language;
+
+	/** Block contents without the fences */
+	FString Code;
+
+	/** Whether the closing fence has been seen */
+	bool bClosed = false;
+};
+
+/**
+ * Single-pass extractor of fenced code blocks that accepts text in chunks.
+ * Each character is examined once, so feeding a streamed response token by token costs the same as parsing it whole.
+ */
+class UNREALCOPILOT_API FUnrealCopilotCodeBlockExtractor
+{
+public:
+	/**
+	 * Feed the next chunk of response text
+	 * @param Chunk - Text following everything appended so far
+	 */
+	void AppendText(FStringView Chunk);
+
+	/** Flush the final partial line; call once the response is complete */
+	void Finish();
+
+	/** Forget all text and blocks */
+	void Reset();
+
+	/** Get every block found so far, in order; the last one may still be open */
+	const TArray<FUnrealCopilotCodeBlock>& GetBlocks() const { return Blocks; }
+
+	/** Whether any fence has been seen */
+	bool HasBlocks() const { return Blocks.Num() > 0; }
+
+	/**
+	 * Get the script made from the Python blocks found so far, including an unterminated last block
+	 * @param Selection - How to combine multiple blocks
+	 * @return Selected code, or an empty string if no Python block was found
+	 */
+	FString GetCode(EUnrealCopilotCodeBlockSelection Selection) const;
+
+	/**
+	 * Get the code for a live preview while text is still arriving, including the partial line of an open block
+	 * @param Selection - How to combine multiple blocks
+	 * @return Preview code
+	 */
+	FString GetPreviewCode(EUnrealCopilotCodeBlockSelection Selection) const;
+
+	/**
+	 * Whether a block language tag denotes Python (untagged blocks count as Python)
+	 * @param Language - Lower-case language tag
+	 * @return True for Python blocks
+	 */
+	static bool IsPythonLanguage(const FString& Language);
+
+private:
+	/** Process one complete line */
+	void ProcessLine(FStringView Line);
+
+	/**
+	 * Match a fence line
+	 * @param Line - Line to test
+	 * @param OutFenceLength - Number of backticks
+	 * @param OutInfo - Text after the backticks, trimmed
+	 * @return True if the line starts with a fence
+	 */
+	static bool ParseFence(FStringView Line, int32& OutFenceLength, FStringView& OutInfo);
+
+	/** Combine Python blocks according to the selection, optionally appending the pending line to the open block */
+	FString SelectCode(EUnrealCopilotCodeBlockSelection Selection, bool bIncludePendingLine) const;
+
+private:
+	/** Blocks found so far */
+	TArray<FUnrealCopilotCodeBlock> Blocks;
+
+	/** Text after the last newline, not yet processed */
+	FString PendingLine;
+
+	/** Backtick count of the open block's fence, or 0 outside a block */
+	int32 OpenFenceLength = 0;
+};
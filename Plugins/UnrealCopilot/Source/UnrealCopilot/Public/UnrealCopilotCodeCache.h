@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Kinds of validation whose verdicts are cached
+ */
+enum class EPythonVerdictKind : uint8
+{
+	/** Syntax check before execution */
+	Syntax,
+
+	/** Syntax, safety policy and blocked operation checks on generated code; depends on settings */
+	Safety
+};
+
+/**
+ * Cached outcome of validating a script
+ */
+struct FPythonCodeVerdict
+{
+	bool bValid = false;
+
+	FString ErrorMessage;
+
+	/** 1-based line of the error, or -1 */
+	int32 ErrorLine = -1;
+};
+
+/**
+ * Hit and miss counters of a cache
+ */
+struct FPythonCodeCacheStats
+{
+	int32 Hits = 0;
+
+	int32 Misses = 0;
+
+	/** Entries currently held */
+	int32 Entries = 0;
+
+	/** Most entries the cache keeps */
+	int32 Capacity = 0;
+
+	/** Fraction of lookups that hit, from 0 to 1 */
+	float GetHitRate() const
+	{
+		const int32 Lookups = Hits + Misses;
+		return Lookups > 0 ? static_cast<float>(Hits) / Lookups : 0.0f;
+	}
+};
+
+/**
+ * Identifies scripts by a hash of their normalized source and caches validation verdicts per hash.
+ * Compiled code objects are cached under the same hash by the runtime module. All functions are thread safe.
+ */
+class UNREALCOPILOT_API FUnrealCopilotCodeCache
+{
+public:
+	/**
+	 * Normalize a script without changing its meaning: line endings become "\n", and a byte order mark and
+	 * trailing whitespace at the end of the script are removed
+	 */
+	static FString NormalizeSource(FStringView Source);
+
+	/**
+	 * Hash a normalized script
+	 * @return SHA-1 of the UTF-8 source as a hex string
+	 */
+	static FString HashSource(FStringView NormalizedSource);
+
+	/**
+	 * Look up a verdict, counting a hit or miss
+	 * @return True if the script was validated before
+	 */
+	static bool FindVerdict(EPythonVerdictKind Kind, const FString& SourceHash, FPythonCodeVerdict& OutVerdict);
+
+	/** Remember the verdict for a script */
+	static void AddVerdict(EPythonVerdictKind Kind, const FString& SourceHash, const FPythonCodeVerdict& Verdict);
+
+	/** Forget verdicts of one kind, e.g. after the settings they depend on change */
+	static void InvalidateVerdicts(EPythonVerdictKind Kind);
+
+	/** Set how many verdicts of each kind are kept; changing it clears the cache */
+	static void SetCapacity(int32 Capacity);
+
+	/** Get the counters of the verdict cache */
+	static FPythonCodeCacheStats GetVerdictStats();
+};
@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * A tool invocation requested by the model
+ */
+struct FUnrealCopilotToolCall
+{
+	/** Provider-assigned call identifier, echoed back with the result */
+	FString CallId;
+
+	/** Name of the tool to run */
+	FString Name;
+
+	/** Tool arguments as a JSON object string */
+	FString Arguments;
+};
+
+/**
+ * Output of a tool invocation
+ */
+struct FUnrealCopilotToolResult
+{
+	/** Call identifier from the matching FUnrealCopilotToolCall */
+	FString CallId;
+
+	/** Text returned to the model */
+	FString Output;
+
+	/** Whether the tool ran successfully */
+	bool bSuccess = false;
+};
+
+/**
+ * Definition of a read-only editor query exposed to the model as a tool
+ */
+struct FUnrealCopilotToolDefinition
+{
+	/** Tool name as seen by the model */
+	FString Name;
+
+	/** Description telling the model when to use the tool */
+	FString Description;
+
+	/** JSON schema of the tool arguments */
+	TSharedPtr<FJsonObject> Parameters;
+
+	/** Whether the handler may run on a worker thread; otherwise it runs on the game thread */
+	bool bThreadSafe = false;
+
+	/** Runs the query and returns its result text */
+	TFunction<FString(const FJsonObject& Arguments)> Handler;
+};
+
+/**
+ * Registry of editor tools available to the model in tool-calling mode.
+ * Built-in tools cover asset search, actor lookup, API signature lookup, and the level census.
+ */
+class UNREALCOPILOT_API FUnrealCopilotEditorTools
+{
+public:
+	/** Get the tool registry */
+	static FUnrealCopilotEditorTools& Get();
+
+	/**
+	 * Register a tool, replacing any existing tool with the same name (game thread only)
+	 * @param Definition - Tool to register
+	 */
+	void RegisterTool(const FUnrealCopilotToolDefinition& Definition);
+
+	/**
+	 * Find a registered tool by name
+	 * @param Name - Tool name
+	 * @return Tool definition, or nullptr if not registered
+	 */
+	const FUnrealCopilotToolDefinition* FindTool(const FString& Name) const;
+
+	/** Create the "tools" array for a Chat Completions request */
+	TArray<TSharedPtr<FJsonValue>> CreateChatCompletionsToolsJson() const;
+
+	/** Create the "tools" array for a Responses API request */
+	TArray<TSharedPtr<FJsonValue>> CreateResponsesToolsJson() const;
+
+	/**
+	 * Run a batch of tool calls requested in one model turn (game thread only).
+	 * Thread-safe tools run in parallel on worker threads while the others run on the game thread.
+	 * @param Calls - Tool calls to run
+	 * @return One result per call, in the same order
+	 */
+	TArray<FUnrealCopilotToolResult> ExecuteToolCalls(const TArray<FUnrealCopilotToolCall>& Calls) const;
+
+private:
+	FUnrealCopilotEditorTools();
+
+	/** Register the built-in editor queries */
+	void RegisterBuiltinTools();
+
+	/** Parse the arguments of a call and run its tool */
+	static FUnrealCopilotToolResult ExecuteToolCall(const FUnrealCopilotToolDefinition* Tool, const FUnrealCopilotToolCall& Call);
+
+private:
+	/** Registered tools */
+	TArray<FUnrealCopilotToolDefinition> Tools;
+};
@@ -6,10 +6,18 @@
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
 #include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "UnrealCopilotExecutionWatchdog.h"
+#include "UnrealCopilotOutputCapture.h"
+#include "UnrealCopilotCodeCache.h"
+#include "UnrealCopilotHistorySearchIndex.h"
 #include "UnrealCopilotExecutionManager.generated.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogUnrealCopilotExecution, Log, All);
 
+class FUnrealCopilotHistoryStore;
+
 /**
  * Enumeration for different types of Python execution errors
  */
@@ -38,6 +46,19 @@ enum class EPythonExecutionState : uint8
 	Timeout UMETA(DisplayName = "Timeout")
 };
 
+/**
+ * Priority of a queued Python execution
+ */
+UENUM(BlueprintType)
+enum class EPythonExecutionPriority : uint8
+{
+	/** Scripts a user is waiting on; they run first */
+	Interactive UMETA(DisplayName = "Interactive"),
+
+	/** Background work that runs in the frame time interactive scripts leave */
+	Batch UMETA(DisplayName = "Batch")
+};
+
 /**
  * Structure containing detailed results from Python execution
  */
@@ -74,6 +95,14 @@ struct UNREALCOPILOT_API FPythonExecutionResult
 	UPROPERTY(BlueprintReadOnly, Category = "Execution Result")
 	EPythonExecutionError ErrorType = EPythonExecutionError::None;
 
+	/** Whether the script was queued rather than run; its result is broadcast through OnExecutionCompleted */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Result")
+	bool bQueued = false;
+
+	/** Identifier of a queued script, repeated in the result broadcast when it finishes; 0 for scripts run immediately */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Result")
+	int32 ExecutionId = 0;
+
 	FPythonExecutionResult()
 	{
 		Reset();
@@ -88,9 +117,91 @@ struct UNREALCOPILOT_API FPythonExecutionResult
 		ErrorLineNumber = -1;
 		ExecutionTimeSeconds = 0.0f;
 		ErrorType = EPythonExecutionError::None;
+		bQueued = false;
+		ExecutionId = 0;
 	}
 };
 
+/**
+ * Progress of an asynchronous execution, reported after each time slice
+ */
+USTRUCT(BlueprintType)
+struct UNREALCOPILOT_API FPythonExecutionProgress
+{
+	GENERATED_BODY()
+
+	/** Top-level statements of the script that have finished */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Progress")
+	int32 StatementsCompleted = 0;
+
+	/** Top-level statements in the script */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Progress")
+	int32 TotalStatements = 0;
+
+	/** Statements and loop iterations run so far */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Progress")
+	int32 StepsCompleted = 0;
+
+	/** Time since the script started in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Progress")
+	float ElapsedSeconds = 0.0f;
+
+	/** Scripts waiting behind this one */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Progress")
+	int32 QueuedExecutions = 0;
+
+	/** Get the completed fraction of top-level statements */
+	float GetFraction() const
+	{
+		return TotalStatements > 0 ? (float)StatementsCompleted / TotalStatements : 0.0f;
+	}
+};
+
+/**
+ * Depth of the execution queue and how long scripts waited in it
+ */
+USTRUCT(BlueprintType)
+struct UNREALCOPILOT_API FPythonExecutionQueueStats
+{
+	GENERATED_BODY()
+
+	/** Interactive scripts waiting to run */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	int32 QueuedInteractive = 0;
+
+	/** Batch scripts waiting to run */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	int32 QueuedBatch = 0;
+
+	/** Time the longest waiting script has been queued in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	float OldestWaitSeconds = 0.0f;
+
+	/** Scripts of each priority started since the editor launched */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	int32 StartedInteractive = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	int32 StartedBatch = 0;
+
+	/** Mean and longest time started scripts of each priority waited in the queue in seconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	float AverageInteractiveWaitSeconds = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	float MaxInteractiveWaitSeconds = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	float AverageBatchWaitSeconds = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	float MaxBatchWaitSeconds = 0.0f;
+
+	/** Time queued scripts ran during the last editor frame in milliseconds */
+	UPROPERTY(BlueprintReadOnly, Category = "Execution Queue")
+	float LastFrameExecutionMs = 0.0f;
+};
+
 /**
  * Structure for storing execution history entries
  */
@@ -136,6 +247,16 @@ DECLARE_MULTICAST_DELEGATE_OneParam(FOnExecutionStateChanged, EPythonExecutionSt
  */
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnExecutionCompleted, const FPythonExecutionResult&);
 
+/**
+ * Delegate for asynchronous execution progress
+ */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnExecutionProgress, const FPythonExecutionProgress&);
+
+/**
+ * Delegate for the history finishing loading
+ */
+DECLARE_MULTICAST_DELEGATE(FOnHistoryLoaded);
+
 /**
  * Manager class for handling Python execution with enhanced features
  */
@@ -149,19 +270,27 @@ public:
 	virtual ~UUnrealCopilotExecutionManager();
 
 	/**
-	 * Get the singleton instance of the execution manager
+	 * Get the singleton instance of the execution manager. Creating it leaves the history on disk alone; the history
+	 * is loaded in the background by BeginLoadHistory or the first history call.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
 	static UUnrealCopilotExecutionManager* GetInstance();
 
 	/**
-	 * Execute Python code with enhanced error handling and timeout support
+	 * Execute Python code with enhanced error handling and timeout support.
+	 * Asynchronous scripts are queued and run on the game thread in time slices within a per-frame budget, so the
+	 * editor stays responsive; the returned result then only reports validation and queuing, and the final result is
+	 * broadcast through OnExecutionCompleted. A synchronous call made while queued scripts are running fails with a
+	 * system error, since its caller expects the script to have run when it returns.
 	 * @param PythonCode - The Python code to execute
 	 * @param bAsync - Whether to execute asynchronously (default: false)
+	 * @param SessionId - Session from CreateExecutionSession whose variables the script shares; 0 runs it in a fresh namespace
+	 * @param Priority - Queue priority if the script is queued; interactive scripts run ahead of batch ones
 	 * @return Execution result with detailed information
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
-	FPythonExecutionResult ExecutePythonCode(const FString& PythonCode, bool bAsync = false);
+	FPythonExecutionResult ExecutePythonCode(const FString& PythonCode, bool bAsync = false, int32 SessionId = 0,
+		EPythonExecutionPriority Priority = EPythonExecutionPriority::Interactive);
 
 	/**
 	 * Validate Python syntax without executing the code
@@ -172,7 +301,8 @@ public:
 	bool ValidatePythonSyntax(const FString& PythonCode, FString& OutErrorMessage);
 
 	/**
-	 * Cancel currently executing Python code (if async)
+	 * Cancel currently executing Python code (if async) and any queued scripts; a failed result is broadcast through
+	 * OnExecutionCompleted for each of them
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
 	void CancelExecution();
@@ -184,27 +314,103 @@ public:
 	EPythonExecutionState GetCurrentExecutionState() const { return CurrentState; }
 
 	/**
-	 * Add entry to execution history
+	 * Get the number of asynchronous scripts waiting to run
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
-	void AddToHistory(const FString& Code, bool bSuccess, const FString& Summary);
+	int32 GetQueuedExecutionCount() const { return PendingAsyncExecutions.Num(); }
 
 	/**
-	 * Get execution history (C++ only - not Blueprint exposed due to TArray limitation)
+	 * Get the depth of the execution queue and the time scripts waited in it
 	 */
-	const TArray<FPythonExecutionHistoryEntry>& GetExecutionHistory() const { return ExecutionHistory; }
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	FPythonExecutionQueueStats GetExecutionQueueStats() const;
+
+	/**
+	 * Import the runtime module and the preloaded modules so the first script does not pay for them.
+	 * Called when Python initializes if enabled in the settings, and otherwise before the first execution.
+	 * @return True if the environment is warm
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	bool WarmUpPythonEnvironment();
+
+	/**
+	 * Check whether the Python environment has been warmed up
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	bool IsPythonEnvironmentWarm() const { return bPythonEnvironmentWarm; }
+
+	/**
+	 * Get the time the warm-up took in seconds, or 0 if it has not run
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	float GetPythonWarmUpSeconds() const { return PythonWarmUpSeconds; }
+
+	/**
+	 * Create a session whose scripts share one namespace, so variables and imports persist between executions
+	 * @return Session identifier to pass to ExecutePythonCode
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	int32 CreateExecutionSession() { return NextSessionId++; }
+
+	/**
+	 * Drop the variables of a session; its next script starts from a fresh namespace
+	 * @param SessionId - Session from CreateExecutionSession
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	void ResetExecutionSession(int32 SessionId);
+
+	/**
+	 * Get the counters of the compiled code and validation caches (C++ only)
+	 * @param OutCompiledCode - Code objects cached by the runtime module
+	 * @param OutValidation - Cached validation verdicts
+	 */
+	void GetCodeCacheStats(FPythonCodeCacheStats& OutCompiledCode, FPythonCodeCacheStats& OutValidation) const;
+
+	/**
+	 * Start loading the history on a worker thread if it is not loaded or loading yet, as the history panel does when
+	 * it opens. History reads wait for the load to finish; added entries are buffered until it does.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	void BeginLoadHistory();
+
+	/**
+	 * Whether the history has finished loading, so history calls return without waiting
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	bool IsHistoryLoaded() const;
+
+	/**
+	 * Get a future that is ready once the history has finished loading; invalid until the load starts (C++ only - not
+	 * Blueprint exposed)
+	 */
+	TSharedFuture<void> GetHistoryLoadedFuture() const { return HistoryLoadedFuture; }
+
+	/**
+	 * Add entry to execution history; never waits for the history to load
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	void AddToHistory(const FString& Code, bool bSuccess, const FString& Summary);
 
 	/**
 	 * Get number of history entries
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
-	int32 GetHistoryCount() const { return ExecutionHistory.Num(); }
+	int32 GetHistoryCount() const;
 
 	/**
-	 * Get specific history entry by index (C++ only - not Blueprint exposed)
+	 * Get specific history entry by index, 0 being the oldest (C++ only - not Blueprint exposed)
 	 */
 	FPythonExecutionHistoryEntry GetHistoryEntry(int32 Index) const;
 
+	/**
+	 * Get consecutive history entries; only the requested entries are read from disk (C++ only - not Blueprint exposed)
+	 * @param FirstIndex - Index of the first entry, 0 being the oldest
+	 * @param MaxCount - Most entries to return
+	 * @param OutEntries - Receives the entries, oldest first
+	 * @return Number of entries returned
+	 */
+	int32 GetHistoryPage(int32 FirstIndex, int32 MaxCount, TArray<FPythonExecutionHistoryEntry>& OutEntries) const;
+
 	/**
 	 * Clear execution history
 	 */
@@ -212,10 +418,44 @@ public:
 	void ClearHistory();
 
 	/**
-	 * Set execution timeout in seconds
+	 * Add a prompt sent to the LLM to the prompt history
+	 * @param Prompt - The user's prompt
+	 * @param bSuccess - Whether code was generated
+	 * @param Response - Generated code, or the error
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	void AddPromptToHistory(const FString& Prompt, bool bSuccess, const FString& Response);
+
+	/**
+	 * Get number of prompt history entries
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
-	void SetExecutionTimeout(float TimeoutSeconds) { ExecutionTimeoutSeconds = FMath::Max(1.0f, TimeoutSeconds); }
+	int32 GetPromptHistoryCount() const;
+
+	/**
+	 * Get a prompt history entry by index, 0 being the oldest; Code holds the prompt and ResultSummary the response
+	 * (C++ only - not Blueprint exposed)
+	 */
+	FPythonExecutionHistoryEntry GetPromptHistoryEntry(int32 Index) const;
+
+	/**
+	 * Search the code and summaries of the execution history and the prompts and responses of the prompt history,
+	 * ignoring case. The search index is built when the history loads and kept up to date as entries are added; queries
+	 * without a trigram to look up, such as ones shorter than three characters, return nothing.
+	 * (C++ only - not Blueprint exposed)
+	 * @param Query - Substring to find, or regular expression if bRegex
+	 * @param bRegex - Whether the query is a regular expression
+	 * @param MaxResults - Most results to return
+	 * @param OutResults - Best results first
+	 * @return False if only the most recent matches were searched
+	 */
+	bool SearchHistory(const FString& Query, bool bRegex, int32 MaxResults, TArray<FHistorySearchResult>& OutResults);
+
+	/**
+	 * Set execution timeout in seconds; 0 or less lets scripts run until they finish or are cancelled
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	void SetExecutionTimeout(float TimeoutSeconds) { ExecutionTimeoutSeconds = TimeoutSeconds > 0.0f ? FMath::Max(1.0f, TimeoutSeconds) : 0.0f; }
 
 	/**
 	 * Get execution timeout in seconds
@@ -224,17 +464,29 @@ public:
 	float GetExecutionTimeout() const { return ExecutionTimeoutSeconds; }
 
 	/**
-	 * Save history to persistent storage
+	 * Block until every recorded execution is on disk. Executions are written in the background as they happen,
+	 * so this is only needed to force the history onto disk.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
 	void SaveHistoryToDisk();
 
 	/**
-	 * Load history from persistent storage
+	 * Reload history from persistent storage, waiting for it
 	 */
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
 	void LoadHistoryFromDisk();
 
+	/**
+	 * Keep this process away from the history on disk, closing it if it is open. The store does not guard against
+	 * several processes opening it, so processes running alongside an editor on the same project, such as batch
+	 * workers, pass -NoHistory on their command line, which takes effect before the manager is first created, or call
+	 * this. History calls then do nothing. (C++ only - not Blueprint exposed)
+	 */
+	static void DisableHistory();
+
+	/** Whether DisableHistory was called or the command line has -NoHistory */
+	static bool IsHistoryDisabled();
+
 public:
 	/** Delegate called when execution state changes */
 	FOnExecutionStateChanged OnExecutionStateChanged;
@@ -242,12 +494,67 @@ public:
 	/** Delegate called when execution completes */
 	FOnExecutionCompleted OnExecutionCompleted;
 
+	/** Delegate called after each time slice of an asynchronous execution */
+	FOnExecutionProgress OnExecutionProgress;
+
+	/** Delegate called on the game thread for each line a running script prints */
+	FOnPythonOutputLine OnExecutionOutput;
+
+	/** Delegate called on the game thread once the history has finished loading */
+	FOnHistoryLoaded OnHistoryLoaded;
+
 private:
 	/** Set the current execution state */
 	void SetExecutionState(EPythonExecutionState NewState);
 
-	/** Execute Python code synchronously with enhanced error capture */
-	FPythonExecutionResult ExecutePythonCodeSynchronous(const FString& PythonCode);
+	/** Execute normalized Python code synchronously with enhanced error capture */
+	FPythonExecutionResult ExecutePythonCodeSynchronous(const FString& PythonCode, const FString& CodeHash, int32 SessionId);
+
+	/**
+	 * Check the syntax of a normalized script, reusing the cached verdict for its hash
+	 * @return True if the syntax is valid
+	 */
+	bool CheckSyntax(const FString& NormalizedCode, const FString& CodeHash, FString& OutErrorMessage, int32& OutErrorLine) const;
+
+	/** Resize the code caches if the setting changed */
+	void ApplyCodeCacheSettings();
+
+	/**
+	 * Queue a validated, normalized script for asynchronous execution, behind the scripts of the same or higher priority
+	 * @return Identifier of the queued script
+	 */
+	int32 QueueAsyncExecution(const FString& PythonCode, const FString& CodeHash, int32 SessionId, EPythonExecutionPriority Priority);
+
+	/** Run time slices of queued scripts until the frame budget is spent; ticker callback */
+	bool TickAsyncExecution(float DeltaTime);
+
+	/** Run one time slice of the active script, finishing it if it completed or was interrupted */
+	void StepActiveAsyncExecution(double TimeSliceSeconds);
+
+	/** Hand the next queued script to the runtime module; false if it could not start */
+	bool StartNextAsyncExecution();
+
+	/** Stop the active asynchronous script in the runtime module */
+	void CancelActiveAsyncExecution();
+
+	/** Record and broadcast the result of an asynchronous script, then move on to the next one */
+	void FinishAsyncExecution(FPythonExecutionResult& Result);
+
+	/** Get the watchdog thread, starting it on first use */
+	FUnrealCopilotExecutionWatchdog& GetWatchdog();
+
+	/** Fill a failed result for a script the watchdog interrupted */
+	void MakeInterruptedResult(EExecutionInterruptReason Reason, const FString& PartialOutput, double ElapsedSeconds, FPythonExecutionResult& OutResult) const;
+
+	/** Get the captured standard output of the current execution, noting dropped lines */
+	FString GetCapturedOutput() const;
+
+	/**
+	 * Fill a result from the output and error report captured during the current execution
+	 * @param bCommandSucceeded - Whether the Python command itself succeeded
+	 * @param CommandError - Command result to report if the command failed without printing anything
+	 */
+	void FillResultFromCapture(bool bCommandSucceeded, const FString& CommandError, FPythonExecutionResult& OutResult);
 
 	/** Parse Python error message to extract line number and error type */
 	void ParsePythonError(const FString& ErrorMessage, FPythonExecutionResult& Result);
@@ -255,30 +562,92 @@ private:
 	/** Format stack trace for better readability */
 	FString FormatStackTrace(const FString& RawStackTrace);
 
-	/** Get history file path */
-	FString GetHistoryFilePath() const;
+	/** Get the folder holding the history store */
+	FString GetHistoryDirectory() const;
+
+	/** Get the path of the single JSON file earlier versions saved the history to */
+	FString GetLegacyHistoryFilePath() const;
+
+	/** Get the path of the JSON lines journal earlier versions saved the history to */
+	FString GetLegacyHistoryJournalPath() const;
+
+	/**
+	 * Read a history saved by an earlier version
+	 * @return False if there was none
+	 */
+	bool LoadLegacyHistory(TArray<FPythonExecutionHistoryEntry>& OutEntries) const;
+
+	/** Block until a load in progress finishes; callers may hold the execution lock since loading never takes it */
+	void WaitForHistory() const;
+
+	/** Start loading the history if needed and block until it is loaded, for history reads */
+	void LoadHistoryIfNeeded() const;
+
+	/**
+	 * Open both history stores, migrating a history saved by an earlier version, and index them for search; closes them
+	 * if history is disabled. Entries buffered meanwhile are added last.
+	 */
+	void ReadHistoryFromDisk();
+
+	/** Open both history stores and index them for search */
+	void OpenHistoryStores();
+
+	/** Add an entry to a history, buffering it while the history is loading; callers hold the execution lock */
+	void AppendHistoryEntry(EHistorySearchSource Source, const FPythonExecutionHistoryEntry& Entry);
+
+	/** Add an entry to an open history store and the search index */
+	void AppendToHistoryStore(EHistorySearchSource Source, const FPythonExecutionHistoryEntry& Entry);
 
 	/** Trim history if it exceeds maximum entries */
 	void TrimHistoryIfNeeded();
 
+	/** Index both histories for search; added entries are indexed as they are added */
+	void BuildHistorySearchIndex();
+
+	/** Get the history store of a search source */
+	FUnrealCopilotHistoryStore* GetHistoryStore(EHistorySearchSource Source) const;
+
 private:
 	/** Singleton instance */
 	static UUnrealCopilotExecutionManager* Instance;
 
+	/** Whether this process leaves the history on disk alone */
+	static bool bHistoryDisabled;
+
 	/** Current execution state */
 	EPythonExecutionState CurrentState;
 
-	/** Execution timeout in seconds */
-	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "1.0", ClampMax = "300.0"))
+	/** Execution timeout in seconds, or 0 for none */
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "0.0", ClampMax = "300.0"))
 	float ExecutionTimeoutSeconds;
 
 	/** Maximum number of history entries to keep */
-	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "10", ClampMax = "500"))
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "10", ClampMax = "1000000"))
 	int32 MaxHistoryEntries;
 
-	/** Execution history */
-	UPROPERTY()
-	TArray<FPythonExecutionHistoryEntry> ExecutionHistory;
+	/** Execution history on disk; entries are read on demand */
+	TUniquePtr<FUnrealCopilotHistoryStore> HistoryStore;
+
+	/** Prompts sent to the LLM, stored like executions with the prompt as code and the response as summary */
+	TUniquePtr<FUnrealCopilotHistoryStore> PromptHistoryStore;
+
+	/** Entries trimmed from each history since it was loaded; entry numbers in the search index count from load */
+	int64 TrimmedHistoryEntries[2] = { 0, 0 };
+
+	/** Trigram index over both histories; built when they are loaded */
+	TUniquePtr<FUnrealCopilotHistorySearchIndex> HistorySearchIndex;
+
+	/** Ready once the history stores are open; invalid until the first load starts, and always for the class default object */
+	TSharedFuture<void> HistoryLoadedFuture;
+
+	/** Guards the buffered entries and bHistoryOpen, which the loading thread sets once it is done with the stores */
+	mutable FCriticalSection PendingHistoryCriticalSection;
+
+	/** Entries added while the history was loading, in order */
+	TArray<TPair<EHistorySearchSource, FPythonExecutionHistoryEntry>> PendingHistoryEntries;
+
+	/** Whether the stores are loaded, so entries go straight to them */
+	bool bHistoryOpen = false;
 
 	/** Start time of current execution */
 	double ExecutionStartTime;
@@ -286,6 +655,79 @@ private:
 	/** Flag indicating if execution was cancelled */
 	bool bExecutionCancelled;
 
+	/** A script queued or running asynchronously */
+	struct FAsyncExecution
+	{
+		/** Job identifier in the runtime module */
+		int32 JobId = 0;
+
+		/** Normalized script source */
+		FString Code;
+
+		/** Hash of the source, keying the compiled code cache */
+		FString CodeHash;
+
+		/** Session whose namespace the script runs in, or 0 */
+		int32 SessionId = 0;
+
+		/** Queue priority */
+		EPythonExecutionPriority Priority = EPythonExecutionPriority::Interactive;
+
+		/** When the script was queued */
+		double QueueTime = 0.0;
+
+		/** When the script started running */
+		double StartTime = 0.0;
+
+		/** Progress after the last time slice */
+		FPythonExecutionProgress Progress;
+	};
+
+	/** Scripts waiting to run asynchronously, interactive ones first, then oldest first */
+	TArray<FAsyncExecution> PendingAsyncExecutions;
+
+	/** Time scripts of a priority waited in the queue before starting */
+	struct FQueueWaitStats
+	{
+		int32 Started = 0;
+		double TotalWaitSeconds = 0.0;
+		double MaxWaitSeconds = 0.0;
+	};
+	FQueueWaitStats QueueWaitStats[2];
+
+	/** Time queued scripts ran during the last tick */
+	double LastFrameExecutionSeconds = 0.0;
+
+	/** Script currently running asynchronously */
+	TOptional<FAsyncExecution> ActiveAsyncExecution;
+
+	/** Identifier for the next asynchronous job */
+	int32 NextAsyncJobId = 1;
+
+	/** Ticker running asynchronous scripts, registered while any are queued or running */
+	FTSTicker::FDelegateHandle AsyncTickerHandle;
+
+	/** Interrupts scripts that run past the timeout or are cancelled; created on the first execution */
+	TUniquePtr<FUnrealCopilotExecutionWatchdog> Watchdog;
+
+	/** Output of the current execution, synchronous or asynchronous */
+	FUnrealCopilotOutputCapture OutputCapture;
+
+	/** Code cache size last applied to the caches */
+	int32 AppliedCodeCacheSize = INDEX_NONE;
+
+	/** Whether a warm-up ran while Python was available; a failed warm-up is not retried */
+	bool bPythonWarmUpAttempted = false;
+
+	/** Whether the runtime module and preloaded modules are imported */
+	bool bPythonEnvironmentWarm = false;
+
+	/** Time the warm-up took in seconds */
+	float PythonWarmUpSeconds = 0.0f;
+
+	/** Identifier for the next execution session; 0 means no session */
+	int32 NextSessionId = 1;
+
 	/** Critical section for thread safety */
 	mutable FCriticalSection ExecutionCriticalSection;
 };
\ No newline at end of file
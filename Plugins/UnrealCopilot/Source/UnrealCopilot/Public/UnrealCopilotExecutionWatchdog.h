@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+/**
+ * Why a script was interrupted
+ */
+enum class EExecutionInterruptReason : uint8
+{
+	None,
+	Timeout,
+	Cancelled
+};
+
+/**
+ * Background thread enforcing the execution timeout while a script runs on the game thread.
+ * On timeout or cancellation it raises KeyboardInterrupt in the interpreter, which ordinary "except Exception"
+ * handlers do not catch, and keeps raising it until the script gives control back.
+ * Interrupts are only injected between EnterPython and LeavePython, so no other Python code is affected.
+ */
+class UNREALCOPILOT_API FUnrealCopilotExecutionWatchdog : public FRunnable
+{
+public:
+	FUnrealCopilotExecutionWatchdog();
+	virtual ~FUnrealCopilotExecutionWatchdog();
+
+	/**
+	 * Start watching an execution
+	 * @param TimeoutSeconds - Time from now after which the execution is interrupted, or 0 to only interrupt on cancel
+	 */
+	void Arm(double TimeoutSeconds);
+
+	/**
+	 * Stop watching the execution
+	 * @return Why the execution was interrupted, if it was
+	 */
+	EExecutionInterruptReason Disarm();
+
+	/** Mark the start of interpreter work for the armed execution; call on the game thread */
+	void EnterPython();
+
+	/** Mark the end of interpreter work for the armed execution; call on the game thread */
+	void LeavePython();
+
+	/** Interrupt the armed execution as soon as possible (thread safe) */
+	void RequestCancel();
+
+	/** Get why the armed execution was interrupted, if it was (thread safe) */
+	EExecutionInterruptReason GetInterruptReason() const;
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable Interface
+
+private:
+	/** Raise KeyboardInterrupt in the game thread's interpreter state if it is running the armed execution */
+	void InjectInterrupt();
+
+	/** Drop an interrupt that was raised too late to be delivered; call on the game thread */
+	void ClearPendingInterrupt();
+
+private:
+	FRunnableThread* Thread = nullptr;
+
+	/** Wakes the thread when an execution is armed, cancelled or the watchdog stops */
+	FEvent* WakeEvent = nullptr;
+
+	/** Guards the execution state below */
+	mutable FCriticalSection StateLock;
+
+	bool bArmed = false;
+	bool bInsidePython = false;
+	bool bInterruptInjected = false;
+	double Deadline = 0.0;
+	EExecutionInterruptReason InterruptReason = EExecutionInterruptReason::None;
+
+	/** Interpreter thread identifier of the game thread */
+	uint64 PythonThreadId = 0;
+
+	std::atomic<bool> bStopping { false };
+};
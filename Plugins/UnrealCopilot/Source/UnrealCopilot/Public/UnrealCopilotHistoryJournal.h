@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+/**
+ * Background writer of the history store. Index records are appended to a journal file, code records to the code
+ * table and the blobs they refer to to the blob file; the store merges the journal into its index the next time it opens.
+ * Writes are queued by the caller and done by a background thread, which syncs the files once per batch, so
+ * recording an execution costs the same however long the history is and never waits for the disk.
+ */
+class UNREALCOPILOT_API FUnrealCopilotHistoryJournal : public FRunnable
+{
+public:
+	/**
+	 * @param InJournalPath - File index records are appended to
+	 * @param InCodeTablePath - File code records are appended to
+	 * @param InBlobPath - File blobs are appended to
+	 * @param InBlobFileSize - Current size of the blob file
+	 */
+	FUnrealCopilotHistoryJournal(const FString& InJournalPath, const FString& InCodeTablePath, const FString& InBlobPath, int64 InBlobFileSize);
+
+	/** Writes the records still queued before returning */
+	virtual ~FUnrealCopilotHistoryJournal();
+
+	/**
+	 * Queue an index record and what it refers to; the blob is written first, then the code record
+	 * @param IndexRecord - Fixed-size record for the journal
+	 * @param CodeRecord - Fixed-size record for the code table; may be empty
+	 * @param BlobData - Bytes for the end of the blob file; may be empty
+	 */
+	void Append(TArray<uint8>&& IndexRecord, TArray<uint8>&& CodeRecord, TArray<uint8>&& BlobData);
+
+	/** Block until every queued record is written and synced */
+	void Flush();
+
+	/** Get the size the blob file has on disk, including only blobs already written (thread safe) */
+	int64 GetWrittenBlobSize() const { return WrittenBlobSize; }
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable Interface
+
+private:
+	/** A queued write */
+	struct FCommand
+	{
+		TArray<uint8> IndexRecord;
+		TArray<uint8> CodeRecord;
+		TArray<uint8> BlobData;
+	};
+
+	/** Write every queued command, then sync the files */
+	void WritePending();
+
+	/** Open a file for appending if it is not open */
+	bool OpenForAppend(TUniquePtr<IFileHandle>& Handle, const FString& FilePath);
+
+private:
+	FString JournalPath;
+	FString CodeTablePath;
+	FString BlobPath;
+
+	FRunnableThread* Thread = nullptr;
+
+	/** Wakes the writer when a batch is full, a flush is requested or the journal closes */
+	FEvent* WakeEvent = nullptr;
+
+	/** Signaled by the writer after each batch it wrote */
+	FEvent* BatchWrittenEvent = nullptr;
+
+	/** Commands waiting for the writer */
+	TQueue<FCommand, EQueueMode::Mpsc> PendingCommands;
+
+	/** Files being appended to; only used by the writer thread, or by the destructor once the writer has stopped */
+	TUniquePtr<IFileHandle> JournalHandle;
+	TUniquePtr<IFileHandle> CodeTableHandle;
+	TUniquePtr<IFileHandle> BlobHandle;
+
+	std::atomic<int64> QueuedCount { 0 };
+	std::atomic<int64> WrittenCount { 0 };
+	std::atomic<int64> WrittenBlobSize { 0 };
+	std::atomic<bool> bStopping { false };
+
+	/** Guards starting the writer thread */
+	FCriticalSection ThreadLock;
+};
@@ -0,0 +1,159 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+
+/**
+ * History a search result comes from
+ */
+enum class EHistorySearchSource : uint8
+{
+	/** Executed scripts and their result summaries */
+	Execution,
+
+	/** Prompts sent to the LLM and the code it answered with */
+	Prompt
+};
+
+/**
+ * A history entry matching a search
+ */
+struct FHistorySearchResult
+{
+	/** History the entry belongs to */
+	EHistorySearchSource Source = EHistorySearchSource::Execution;
+
+	/** Index of the entry in its history, 0 being the oldest kept entry */
+	int32 Index = INDEX_NONE;
+
+	/** Relevance; matches in code or prompts weigh more than matches in summaries, and repeated matches add to it */
+	float Score = 0.0f;
+
+	/** Number of kept entries with the same code or prompt; the result is the newest of them */
+	int32 Occurrences = 0;
+
+	/** Line around the first match */
+	FString Snippet;
+};
+
+/**
+ * Trigram index over the code, summaries and prompts of the history, answering substring and regular expression
+ * searches without reading every entry.
+ *
+ * Each distinct text is indexed once, however many entries share it, and every three-character sequence of it
+ * (lowercased) maps to a delta-encoded list of the texts containing it. A search intersects the lists of the
+ * trigrams the query requires, then reads only the candidate texts to confirm the match. Texts are read back through
+ * a callback, so the index holds no text itself.
+ *
+ * Trimmed entries are skipped by number; their texts stay indexed until the index is rebuilt.
+ * Not thread safe; the execution manager serializes access.
+ */
+class UNREALCOPILOT_API FUnrealCopilotHistorySearchIndex
+{
+public:
+	/**
+	 * Reads a text of an indexed entry
+	 * @param Source - History of the entry
+	 * @param Number - Number the entry was added with
+	 * @param bPrimary - True for the code or prompt, false for the summary or response
+	 */
+	using FReadText = TFunctionRef<FString(EHistorySearchSource Source, int64 Number, bool bPrimary)>;
+
+	/**
+	 * Index an entry
+	 * @param Source - History of the entry
+	 * @param Number - Position of the entry in its history since it was loaded; must increase within a source
+	 * @param PrimaryText - Code or prompt
+	 * @param SecondaryText - Result summary or response; only its start is indexed
+	 */
+	void Add(EHistorySearchSource Source, int64 Number, const FString& PrimaryText, const FString& SecondaryText);
+
+	/**
+	 * Stop returning the entries of a source numbered below FirstKeptNumber
+	 * @param FirstKeptNumber - Number of the oldest kept entry, which becomes index 0 in results
+	 */
+	void RemoveBefore(EHistorySearchSource Source, int64 FirstKeptNumber);
+
+	/** Remove all entries */
+	void Reset();
+
+	/** Get the number of indexed entries, including trimmed ones */
+	int32 Num() const { return Entries.Num(); }
+
+	/** Get the memory used by the index */
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Find the entries containing a substring or matching a regular expression, ignoring case
+	 * @param Query - Substring, or regular expression if bRegex
+	 * @param bRegex - Whether the query is a regular expression
+	 * @param MaxResults - Most results to return
+	 * @param ReadText - Reads the candidate texts
+	 * @param OutResults - Best results first; entries sharing their code or prompt are returned once
+	 * @return False if the search stopped at the most texts it reads, in which case older matches may be missing
+	 */
+	bool Search(const FString& Query, bool bRegex, int32 MaxResults, FReadText ReadText, TArray<FHistorySearchResult>& OutResults) const;
+
+	/**
+	 * Get the literal runs every match of a regular expression contains, lowercased; empty if none is required
+	 * (for example with alternation), in which case a search reads the newest texts instead
+	 */
+	static void ExtractRequiredLiterals(const FString& Pattern, TArray<FString>& OutLiterals);
+
+	/**
+	 * Whether a query has a trigram to look up; a query without one, such as a short substring or a regular expression
+	 * with no required literal, matches every text and is not worth searching
+	 */
+	static bool HasTrigrams(const FString& Query, bool bRegex);
+
+private:
+	/** An indexed entry */
+	struct FIndexedEntry
+	{
+		int64 Number = 0;
+		int32 PrimaryTextId = INDEX_NONE;
+		int32 SecondaryTextId = INDEX_NONE;
+		EHistorySearchSource Source = EHistorySearchSource::Execution;
+	};
+
+	/** A distinct indexed text */
+	struct FIndexedText
+	{
+		/** Entries containing the text, oldest first */
+		TArray<int32> EntryIds;
+
+		/** Whether the text is a code or prompt rather than a summary or response */
+		bool bPrimary = true;
+	};
+
+	/** Texts containing a trigram, as ascending text ids delta-encoded as variable-length integers */
+	struct FPostingList
+	{
+		TArray<uint8> Bytes;
+		int32 LastTextId = INDEX_NONE;
+	};
+
+	/** Get the id of a text, indexing it if new */
+	int32 AddText(EHistorySearchSource Source, bool bPrimary, const FString& Text);
+
+	/** Whether an entry has not been trimmed */
+	bool IsEntryKept(const FIndexedEntry& Entry) const;
+
+	/** Decode the text ids of a posting list */
+	static void DecodePostings(const FPostingList& Postings, TArray<int32>& OutTextIds);
+
+private:
+	TArray<FIndexedEntry> Entries;
+	TArray<FIndexedText> Texts;
+
+	/** Text ids by hash of the source, field and text */
+	TMap<FSHAHash, int32> TextIds;
+
+	/** Posting lists by trigram */
+	TMap<uint32, FPostingList> Postings;
+
+	/** Number of the oldest kept entry of each source */
+	int64 FirstKeptNumbers[2] = { 0, 0 };
+};
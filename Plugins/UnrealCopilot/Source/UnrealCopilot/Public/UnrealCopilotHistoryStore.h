@@ -0,0 +1,242 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "Misc/SecureHash.h"
+#include "UnrealCopilotExecutionManager.h"
+
+class FUnrealCopilotHistoryJournal;
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Binary execution history that scales to hundreds of thousands of entries.
+ *
+ * The index file holds one fixed-size record per entry (timestamp, outcome and where its text is stored) and is
+ * memory mapped, so opening the store does not read it and any entry is found by position. Code and result summaries
+ * are compressed into a blob file and only read and decompressed when an entry is requested, through a small cache.
+ * Code is stored once per distinct script: the code table maps the hash of each stored script to its blob, and entries
+ * running the same script refer to the same blob. Blobs no kept entry refers to are dropped when the store compacts.
+ * Entries added in a session are written by FUnrealCopilotHistoryJournal and merged into the index on the next open;
+ * trimmed entries are skipped by position and their space is reclaimed when they outnumber the kept ones.
+ * Compacting writes new copies of the files and a commit marker once the copies are on disk; an open that finds the
+ * marker finishes replacing the files, and one that finds copies without it deletes them.
+ *
+ * Not thread safe; the execution manager serializes access.
+ */
+class UNREALCOPILOT_API FUnrealCopilotHistoryStore
+{
+public:
+	/**
+	 * @param InDirectory - Folder holding the store files
+	 * @param InBaseName - Name the store files start with
+	 */
+	FUnrealCopilotHistoryStore(const FString& InDirectory, const FString& InBaseName);
+
+	/** Writes queued entries before returning */
+	~FUnrealCopilotHistoryStore();
+
+	/**
+	 * Merge the journal of the previous session into the index, compact the files if most entries were trimmed,
+	 * and map the index
+	 * @return False if the store did not exist on disk
+	 */
+	bool Open();
+
+	/** Get the number of kept entries */
+	int32 Num() const;
+
+	/** Add an entry; it is written in the background */
+	void Append(const FPythonExecutionHistoryEntry& Entry);
+
+	/**
+	 * Get an entry, reading its code and summary from disk unless cached
+	 * @param Index - Entry position, 0 being the oldest kept entry
+	 * @return False if the index is out of range
+	 */
+	bool GetEntry(int32 Index, FPythonExecutionHistoryEntry& OutEntry) const;
+
+	/**
+	 * Get consecutive entries, only reading the ones requested
+	 * @param FirstIndex - Position of the first entry, 0 being the oldest kept entry
+	 * @param MaxCount - Most entries to return
+	 * @return Number of entries returned
+	 */
+	int32 GetPage(int32 FirstIndex, int32 MaxCount, TArray<FPythonExecutionHistoryEntry>& OutEntries) const;
+
+	/** Drop the oldest entries so at most MaxEntries are kept */
+	void Trim(int32 MaxEntries);
+
+	/** Drop all entries, deleting their files */
+	void Clear();
+
+	/** Block until every added entry is on disk */
+	void Flush();
+
+private:
+	/** Fixed-size record of the index and journal files */
+	struct FIndexRecord
+	{
+		/** Entry timestamp in ticks, or the new first kept record for trim records */
+		int64 Value;
+
+		/** Where the code and summary start in the blob file; entries running the same code share its blob */
+		int64 CodeOffset;
+		int64 SummaryOffset;
+
+		/** Stored and original sizes of the UTF-8 text; equal sizes mean the text is stored uncompressed */
+		uint32 CodeStoredSize;
+		uint32 CodeSize;
+		uint32 SummaryStoredSize;
+		uint32 SummarySize;
+
+		/** An entry, or a trim recorded by the journal */
+		uint8 Kind;
+
+		uint8 bSuccess;
+		uint8 Padding[6];
+	};
+	static_assert(sizeof(FIndexRecord) == 48, "History index records must keep their on-disk size");
+
+	/** Record of the code table file */
+	struct FCodeRecord
+	{
+		/** SHA1 of the UTF-8 code */
+		uint8 Hash[20];
+
+		/** Stored and original sizes of the code */
+		uint32 StoredSize;
+		uint32 Size;
+
+		uint32 Padding;
+
+		/** Where the code starts in the blob file */
+		int64 Offset;
+	};
+	static_assert(sizeof(FCodeRecord) == 40, "History code records must keep their on-disk size");
+
+	/** Header at the start of the index file */
+	struct FIndexHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 RecordSize;
+		uint32 Reserved;
+
+		/** Position of the first kept record; earlier ones were trimmed */
+		int64 FirstKeptRecord;
+	};
+
+	/** Append the journal records to the index and update its header, then delete the journal */
+	void MergeJournal();
+
+	/** Read the code table, dropping records whose blobs did not reach the disk */
+	void LoadCodeTable();
+
+	/** Count the kept entries referring to each code blob, and the blob bytes no kept entry refers to */
+	void CountReferences();
+
+	/** Whether enough of the files is trimmed entries or unreferenced blobs for compacting to pay off */
+	bool ShouldCompact() const;
+
+	/**
+	 * Rewrite the index, code table and blob files without the trimmed entries and unreferenced blobs
+	 * @return False if the compacted copies were committed but could not all replace the store files
+	 */
+	bool Compact();
+
+	/** Get the files compacting rewrites, in the order their copies replace them */
+	TArray<FString> GetCompactedFilePaths() const;
+
+	/**
+	 * Replace the store files with the compacted copies, then delete the commit marker
+	 * @return False if a file could not be replaced; the marker is kept so the next open tries again
+	 */
+	bool FinishCompaction() const;
+
+	/**
+	 * Finish a compaction interrupted after its copies were committed, or delete the copies of one interrupted before
+	 * @return False if the store files could not be recovered
+	 */
+	bool RecoverCompaction() const;
+
+	/** Map the index file, or read it if the platform cannot map files */
+	void MapIndex();
+
+	/** Release the mapping of the index file */
+	void UnmapIndex();
+
+	/** Get a record by absolute position in the index */
+	const FIndexRecord& GetRecord(int64 Position) const;
+
+	/** Read a stored text from the blob file */
+	FString ReadText(int64 Offset, uint32 StoredSize, uint32 Size) const;
+
+	/** Record a trim in the journal */
+	void AppendTrimRecord();
+
+	/** Release the blobs of an entry being trimmed */
+	void ReleaseReferences(const FIndexRecord& Record);
+
+	/** Get the number of complete records in the index file */
+	int64 ReadRecordCount() const;
+
+	/** Read the header of the index file; false if it does not exist or is not an index */
+	bool ReadHeader(FIndexHeader& OutHeader) const;
+
+	/** Write the header of the index file */
+	bool WriteHeader(const FIndexHeader& Header) const;
+
+private:
+	FString IndexPath;
+	FString JournalPath;
+	FString CodeTablePath;
+	FString BlobPath;
+
+	/** Written once the compacted copies are on disk; while it exists they replace the store files */
+	FString CompactCommitPath;
+
+	/** Mapped index file and the region covering its records */
+	TUniquePtr<IMappedFileHandle> MappedIndexFile;
+	TUniquePtr<IMappedFileRegion> MappedIndexRegion;
+
+	/** Index contents on platforms that cannot map files */
+	TArray<uint8> IndexFallback;
+
+	/** Records of the mapped index */
+	const FIndexRecord* IndexRecords = nullptr;
+	int64 IndexRecordCount = 0;
+
+	/** Records added since the index was mapped */
+	TArray<FIndexRecord> AddedRecords;
+
+	/** Position of the first kept record */
+	int64 FirstKeptRecord = 0;
+
+	/** Size of the blob file including queued blobs, where the next blob goes */
+	int64 BlobFileSize = 0;
+
+	/** Stored code by hash of its text, so running the same code again adds no blob */
+	TMap<FSHAHash, FCodeRecord> CodeBlobs;
+
+	/** Number of kept entries referring to each code blob, by offset; blobs without references are not listed */
+	TMap<int64, int32> CodeReferences;
+
+	/** Bytes of the blob file no kept entry refers to */
+	int64 UnreferencedBlobBytes = 0;
+
+	/** Writes added entries in the background */
+	TUniquePtr<FUnrealCopilotHistoryJournal> Journal;
+
+	/** Reads blobs on demand */
+	mutable TUniquePtr<IFileHandle> BlobReader;
+
+	/** Recently read or added code by blob offset */
+	mutable TLruCache<int64, FString> CodeCache;
+
+	/** Recently read or added summaries by record position */
+	mutable TLruCache<int64, FString> SummaryCache;
+};
@@ -7,6 +7,8 @@
 #include "Http.h"
 #include "Dom/JsonObject.h"
 #include "UnrealCopilotPromptProcessor.h"
+#include "UnrealCopilotCodeBlockExtractor.h"
+#include "UnrealCopilotEditorTools.h"
 #include "UnrealCopilotSettings.h"
 #include "UnrealCopilotLLMManager.generated.h"
 
@@ -43,6 +45,14 @@ struct UNREALCOPILOT_API FCodeGenerationResult
 	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
 	FString ErrorMessage;
 
+	/** Model's description of the script (structured output only) */
+	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
+	FString Explanation;
+
+	/** Asset paths the model says the script creates or modifies (structured output only) */
+	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
+	TArray<FString> TouchedAssets;
+
 	/** Raw LLM response for debugging */
 	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
 	FString RawResponse;
@@ -55,6 +65,14 @@ struct UNREALCOPILOT_API FCodeGenerationResult
 	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
 	int32 TokensUsed = 0;
 
+	/** Estimated prompt tokens before local compression */
+	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
+	int32 PromptTokensBeforeCompression = 0;
+
+	/** Estimated prompt tokens sent */
+	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
+	int32 PromptTokens = 0;
+
 	/** API response code */
 	UPROPERTY(BlueprintReadOnly, Category = "Generation Result")
 	int32 ResponseCode = 0;
@@ -69,9 +87,13 @@ struct UNREALCOPILOT_API FCodeGenerationResult
 		bSuccess = false;
 		GeneratedCode.Empty();
 		ErrorMessage.Empty();
+		Explanation.Empty();
+		TouchedAssets.Empty();
 		RawResponse.Empty();
 		GenerationTimeSeconds = 0.0f;
 		TokensUsed = 0;
+		PromptTokensBeforeCompression = 0;
+		PromptTokens = 0;
 		ResponseCode = 0;
 	}
 };
@@ -86,6 +108,73 @@ DECLARE_DELEGATE_OneParam(FOnCodeGenerationComplete, const FCodeGenerationResult
  */
 DECLARE_DELEGATE_OneParam(FOnGenerationStateChanged, ECodeGenerationState);
 
+/**
+ * State of one generation request, kept across tool-calling round trips
+ */
+struct FUnrealCopilotLLMConversation
+{
+	/** Request payload; tool calls and their results are appended to its conversation array each round */
+	TSharedPtr<FJsonObject> Payload;
+
+	/** Whether the payload targets the Responses API ("input") rather than Chat Completions ("messages") */
+	bool bResponsesAPI = false;
+
+	/** Whether editor tools are offered to the model */
+	bool bToolsEnabled = false;
+
+	/** Number of tool-calling round trips so far */
+	int32 ToolRound = 0;
+
+	/** Tokens used by earlier round trips */
+	int32 TokensUsed = 0;
+
+	/** Estimated prompt tokens before and after local compression */
+	int32 PromptTokensBeforeCompression = 0;
+	int32 PromptTokens = 0;
+
+	/** Whether the response arrives as a stream of server-sent events */
+	bool bStreaming = false;
+
+	/** Guards ReceivedBody, which the HTTP thread appends to while the game thread consumes it */
+	FCriticalSection StreamCriticalSection;
+
+	/** Streamed response body received so far; a request that streams its body does not keep it */
+	TArray<uint8> ReceivedBody;
+
+	/** Bytes of the streamed response body consumed so far */
+	int32 StreamedBytes = 0;
+
+	/** Whether any stream event has been received */
+	bool bReceivedStreamEvent = false;
+
+	/** Message text received so far in a streamed response */
+	FString StreamedText;
+
+	/** Code blocks of the streamed text, updated as it arrives */
+	FUnrealCopilotCodeBlockExtractor StreamExtractor;
+
+	/** Prompt as the user typed it, recorded in the prompt history when the request completes */
+	FString UserPrompt;
+
+	/** Completion delegate for the request */
+	FOnCodeGenerationComplete OnComplete;
+};
+
+/**
+ * Tool calls requested by one model response
+ */
+struct FUnrealCopilotToolRound
+{
+	/** Calls to run */
+	TArray<FUnrealCopilotToolCall> Calls;
+
+	/** Response items echoed back into the conversation ahead of the tool results */
+	TArray<TSharedPtr<FJsonValue>> EchoItems;
+
+	/** Tokens used by the response */
+	int32 TokensUsed = 0;
+};
+
 /**
  * Structure for tracking API usage
  */
@@ -217,22 +306,106 @@ public:
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnGenerationStateChangedMulticast, ECodeGenerationState);
 	FOnGenerationStateChangedMulticast OnGenerationStateChanged;
 
+	/** Delegate called with the partial code while a streamed response arrives */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnCodePreviewUpdatedMulticast, const FString&);
+	FOnCodePreviewUpdatedMulticast OnCodePreviewUpdated;
+
 private:
+	/**
+	 * Run the syntax, safety policy and blocked operation checks on generated code
+	 * @param PythonCode - Code to check
+	 * @param OutErrorMessage - Every problem found
+	 * @return True if code is safe to execute
+	 */
+	static bool CheckGeneratedCodeSafety(const FString& PythonCode, FString& OutErrorMessage);
+
 	/**
 	 * Send request to OpenAI API
+	 * @param UserPrompt - The prompt as the user typed it
 	 * @param ProcessedPrompt - The processed prompt to send
+	 * @param Context - Context gathered for this prompt
 	 * @param OnComplete - Completion delegate
 	 */
-	void SendOpenAIRequest(const FString& ProcessedPrompt, const FOnCodeGenerationComplete& OnComplete);
+	void SendOpenAIRequest(const FString& UserPrompt, const FString& ProcessedPrompt, const FPromptContext& Context, const FOnCodeGenerationComplete& OnComplete);
+
+	/**
+	 * Send the current state of a conversation to OpenAI
+	 * @param Conversation - Request state holding the payload and completion delegate
+	 */
+	void SendConversationRequest(const TSharedRef<FUnrealCopilotLLMConversation>& Conversation);
 
 	/**
 	 * Handle HTTP response from OpenAI
 	 * @param Request - The HTTP request
 	 * @param Response - The HTTP response
 	 * @param bWasSuccessful - Whether the request was successful
-	 * @param OnComplete - Completion delegate
+	 * @param Conversation - Request state the response belongs to
+	 */
+	void OnOpenAIResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, TSharedRef<FUnrealCopilotLLMConversation> Conversation);
+
+	/**
+	 * Handle progress of a streamed request by consuming the events received since the last update (game thread)
+	 * @param Request - The HTTP request
+	 * @param BytesSent - Bytes of the request sent so far
+	 * @param BytesReceived - Bytes of the response received so far
+	 * @param Conversation - Request state the response belongs to
+	 */
+	void OnOpenAIStreamProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived, TSharedRef<FUnrealCopilotLLMConversation> Conversation);
+
+	/**
+	 * Consume the complete server-sent event lines received since the last call
+	 * @param Conversation - Streamed request state
+	 * @param bFinal - Whether the body is complete, so a trailing line without newline is consumed too
+	 * @return True if message text was added
+	 */
+	bool ConsumeStreamedResponse(FUnrealCopilotLLMConversation& Conversation, bool bFinal);
+
+	/**
+	 * Build the result of a completed streamed response
+	 * @param Conversation - Streamed request state
+	 * @param OutResult - The parsed result
+	 */
+	void ParseStreamedResponse(FUnrealCopilotLLMConversation& Conversation, FCodeGenerationResult& OutResult);
+
+	/**
+	 * Decode, parse, and validate a response (worker thread)
+	 * @param Response - The HTTP response
+	 * @param Conversation - Request state the response belongs to
+	 * @param Result - Result to fill in
+	 * @return Tool calls to run before the next round, or nullptr if the result is final
+	 */
+	TSharedPtr<FUnrealCopilotToolRound> ProcessResponse(FHttpResponsePtr Response, FUnrealCopilotLLMConversation& Conversation, FCodeGenerationResult& Result);
+
+	/**
+	 * Continue with the processed response on the game thread
+	 * @param Conversation - Request state the response belongs to
+	 * @param Result - Final result, unless tools were requested
+	 * @param ToolRound - Tool calls requested by the model, if any
 	 */
-	void OnOpenAIResponse(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful, FOnCodeGenerationComplete OnComplete);
+	void OnResponseProcessed(const TSharedRef<FUnrealCopilotLLMConversation>& Conversation, const FCodeGenerationResult& Result, TSharedPtr<FUnrealCopilotToolRound> ToolRound);
+
+	/**
+	 * Finish a conversation and broadcast its result
+	 * @param Conversation - Finished request state
+	 * @param Result - Final result
+	 */
+	void CompleteGeneration(const TSharedRef<FUnrealCopilotLLMConversation>& Conversation, const FCodeGenerationResult& Result);
+
+	/**
+	 * Read the tool calls requested in a response (worker thread safe)
+	 * @param ResponseJSON - The JSON response from OpenAI
+	 * @param bResponsesAPI - Whether the response comes from the Responses API
+	 * @param OutToolRound - Requested calls and the response items to echo back
+	 * @return True if the response requested tools
+	 */
+	static bool ParseToolCalls(const FString& ResponseJSON, bool bResponsesAPI, FUnrealCopilotToolRound& OutToolRound);
+
+	/**
+	 * Run the tools requested in a response and send their results back to the model
+	 * @param ToolRound - Tool calls parsed from the response
+	 * @param Conversation - Request state to continue
+	 */
+	void ContinueWithToolCalls(const FUnrealCopilotToolRound& ToolRound, const TSharedRef<FUnrealCopilotLLMConversation>& Conversation);
 
 	/**
 	 * Parse OpenAI response and extract code
@@ -244,6 +417,13 @@ private:
 	/** Parse GPT-5 Responses API response (different format than Chat Completions) */
 	void ParseGPT5ResponsesAPI(const FString& ResponseJSON, FCodeGenerationResult& OutResult);
 
+	/**
+	 * Fill the code fields of a result from the model's message text, reading the structured response when enabled
+	 * @param Content - Message text returned by the model
+	 * @param OutResult - Result receiving the code, explanation, and touched assets
+	 */
+	void ExtractCodeFromContent(const FString& Content, FCodeGenerationResult& OutResult);
+
 	/**
 	 * Build system prompt for current context
 	 * @return Complete system prompt
@@ -284,6 +464,9 @@ private:
 	/** Current HTTP request */
 	FHttpRequestPtr CurrentRequest;
 
+	/** Conversation the current request belongs to */
+	TSharedPtr<FUnrealCopilotLLMConversation> CurrentConversation;
+
 	/** Generation start time */
 	double GenerationStartTime;
 
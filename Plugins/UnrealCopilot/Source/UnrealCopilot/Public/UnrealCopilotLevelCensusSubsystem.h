@@ -0,0 +1,192 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "UnrealCopilotSpatialIndex.h"
+#include "UnrealCopilotLevelCensusSubsystem.generated.h"
+
+class AActor;
+class ULevel;
+class UWorld;
+
+/**
+ * Census data tracked for a single actor
+ */
+struct FActorCensusRecord
+{
+	/** Actor class name */
+	FName ClassName;
+
+	/** Outliner folder path */
+	FName FolderPath;
+
+	/** Short name of the level (streaming or persistent) that owns the actor */
+	FName LevelName;
+
+	/** Data layers the actor belongs to */
+	TArray<FName, TInlineAllocator<2>> DataLayers;
+
+	/** World-space bounds of the actor */
+	FBox Bounds = FBox(ForceInit);
+};
+
+/**
+ * Editor subsystem that maintains a census of the editor world: actor counts by class, folder hierarchy,
+ * overall bounds, and streaming level and data layer membership, plus a spatial index of actor bounds
+ * for queries around the editor camera.
+ * The census is updated incrementally from actor added, deleted, and moved events; the world is only
+ * scanned when a map is opened. The prompt summary is cached so reading it costs nothing per request.
+ */
+UCLASS()
+class UNREALCOPILOT_API UUnrealCopilotLevelCensusSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Get the census subsystem instance
+	 * @return Census subsystem, or nullptr outside the editor
+	 */
+	static UUnrealCopilotLevelCensusSubsystem* Get();
+
+	/**
+	 * Get a compact summary of the level for the system prompt
+	 * @return Cached level summary text
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	FString GetLevelSummary();
+
+	/**
+	 * Get the number of actors tracked by the census
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	int32 GetTotalActorCount() const;
+
+	/**
+	 * Get actor counts by class name
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	TMap<FName, int32> GetClassCounts() const;
+
+	/**
+	 * Find the actors closest to a point
+	 * @param Origin - Query point
+	 * @param MaxResults - Maximum number of actors to return
+	 * @param MaxDistance - Ignore actors farther than this (0 for unlimited)
+	 * @param OutHits - Hits sorted by increasing distance
+	 */
+	void FindNearestActors(const FVector& Origin, int32 MaxResults, double MaxDistance, TArray<FSpatialIndexHit>& OutHits);
+
+	/**
+	 * Find the actors near the active level viewport camera
+	 * @param MaxResults - Maximum number of actors to return
+	 * @param MaxDistance - Ignore actors farther than this from the camera (0 for unlimited)
+	 * @param bInViewFrustumOnly - Only return actors inside the camera's view frustum
+	 * @return Actors sorted by increasing distance from the camera
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	TArray<AActor*> GetActorsNearViewport(int32 MaxResults = 15, float MaxDistance = 50000.0f, bool bInViewFrustumOnly = false);
+
+	/**
+	 * Describe the actors near the active level viewport camera for the system prompt
+	 * @param MaxResults - Maximum number of actors to list
+	 * @param MaxDistance - Ignore actors farther than this from the camera (0 for unlimited)
+	 * @param bInViewFrustumOnly - Only list actors inside the camera's view frustum
+	 * @return Camera location and nearby actor list, or empty when no level viewport is available
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	FString GetNearbyActorsSummary(int32 MaxResults = 15, float MaxDistance = 50000.0f, bool bInViewFrustumOnly = false);
+
+	/**
+	 * Discard the census and rebuild it from the current editor world
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	void RebuildCensus();
+
+private:
+	/** Actor event handlers */
+	void OnActorAdded(AActor* Actor);
+	void OnActorDeleted(AActor* Actor);
+	void OnActorMoved(AActor* Actor);
+	void OnActorFolderChanged(const AActor* Actor, FName OldPath);
+
+	/** Level and map event handlers */
+	void OnMapChange(uint32 MapChangeFlags);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	/** Query the spatial index around the active level viewport camera (game thread only) */
+	bool FindActorsNearViewport(int32 MaxResults, double MaxDistance, bool bInViewFrustumOnly, FVector& OutCameraLocation, TArray<FSpatialIndexHit>& OutHits);
+
+	/** Whether an actor belongs to the editor world and should be counted */
+	bool ShouldTrackActor(const AActor* Actor) const;
+
+	/** Build the census record for an actor */
+	static FActorCensusRecord MakeRecord(const AActor* Actor);
+
+	/** Add or remove a record's contribution to the aggregate counts (lock must be held) */
+	void AddRecordCounts(const FActorCensusRecord& Record);
+	void RemoveRecordCounts(const FActorCensusRecord& Record);
+
+	/** Track or refresh an actor (lock must be held) */
+	void AddOrUpdateActor(const AActor* Actor);
+
+	/** Stop tracking an actor (lock must be held) */
+	void RemoveActor(const AActor* Actor);
+
+	/** Scan the editor world if the census has not been built for the current map (game thread only) */
+	void EnsureCensusBuilt();
+
+	/** Recompute the union of actor bounds from the records (lock must be held) */
+	void RecomputeBounds();
+
+	/** Rebuild the cached summary text (lock must be held) */
+	void RebuildSummary();
+
+private:
+	/** Census record per tracked actor */
+	TMap<FObjectKey, FActorCensusRecord> Records;
+
+	/** Aggregate counts */
+	TMap<FName, int32> ClassCounts;
+	TMap<FName, int32> FolderCounts;
+	TMap<FName, int32> LevelCounts;
+	TMap<FName, int32> DataLayerCounts;
+
+	/** Spatial index of actor bounds */
+	FUnrealCopilotSpatialIndex SpatialIndex;
+
+	/** Union of all actor bounds (recomputed lazily after deletes and moves) */
+	FBox LevelBounds = FBox(ForceInit);
+
+	/** Cached summary text */
+	FString CachedSummary;
+
+	/** Whether the bounds need to be recomputed from the records */
+	bool bBoundsDirty = false;
+
+	/** Whether the cached summary is out of date */
+	bool bSummaryDirty = true;
+
+	/** Whether the census has been built for the current map */
+	bool bCensusBuilt = false;
+
+	/** Delegate handles for cleanup */
+	FDelegateHandle ActorAddedHandle;
+	FDelegateHandle ActorDeletedHandle;
+	FDelegateHandle ActorMovedHandle;
+	FDelegateHandle ActorFolderChangedHandle;
+	FDelegateHandle MapChangeHandle;
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	/** Guards census state; queries may come from worker threads */
+	mutable FCriticalSection CensusCriticalSection;
+};
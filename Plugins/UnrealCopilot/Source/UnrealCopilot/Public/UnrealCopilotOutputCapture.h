@@ -0,0 +1,138 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/OutputDevice.h"
+
+/**
+ * Stream a line of interpreter output was written to
+ */
+enum class EPythonOutputStream : uint8
+{
+	Stdout,
+	Stderr
+};
+
+/**
+ * A line printed by a running script
+ */
+struct FPythonOutputLine
+{
+	EPythonOutputStream Stream = EPythonOutputStream::Stdout;
+
+	FString Text;
+};
+
+/**
+ * Exception that ended a script, as reported by the runtime module
+ */
+struct FPythonErrorReport
+{
+	/** Exception class name */
+	FString Type;
+
+	FString Message;
+
+	/** 1-based line in the script, or -1 if the error was raised outside it */
+	int32 Line = -1;
+
+	/** Traceback lines joined with "||" */
+	FString StackTrace;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPythonOutputLine, const FPythonOutputLine&);
+
+/**
+ * Fixed-capacity buffer keeping the most recent output lines
+ */
+class UNREALCOPILOT_API FPythonOutputRingBuffer
+{
+public:
+	explicit FPythonOutputRingBuffer(int32 InCapacity = 1);
+
+	/** Drop all lines and change the capacity */
+	void Reset(int32 InCapacity);
+
+	/** Add a line, overwriting the oldest one when full */
+	void Add(FPythonOutputLine&& Line);
+
+	/** Number of lines held */
+	int32 Num() const { return Lines.Num(); }
+
+	/** Number of lines overwritten since the last reset */
+	int32 GetDroppedCount() const { return DroppedCount; }
+
+	/** Get a line, oldest first */
+	const FPythonOutputLine& operator[](int32 Index) const;
+
+	/** Join the lines of one stream with newlines, oldest first */
+	FString Join(EPythonOutputStream Stream) const;
+
+private:
+	TArray<FPythonOutputLine> Lines;
+
+	/** Index of the oldest line once the buffer is full */
+	int32 Head = 0;
+
+	int32 Capacity = 1;
+
+	int32 DroppedCount = 0;
+};
+
+/**
+ * Output device capturing what scripts print. The Python Script Plugin logs stdout and stderr to LogPython while a
+ * command runs, so registering with the log for the duration of a command sees each line as it is written.
+ * Error reports printed by unreal_copilot_runtime.report_exception are parsed instead of being captured as output.
+ */
+class UNREALCOPILOT_API FUnrealCopilotOutputCapture : public FOutputDevice
+{
+public:
+	/** Registers a capture with the log for the lifetime of the scope */
+	class FScope
+	{
+	public:
+		explicit FScope(FUnrealCopilotOutputCapture& InCapture);
+		~FScope();
+
+	private:
+		FUnrealCopilotOutputCapture& Capture;
+	};
+
+	explicit FUnrealCopilotOutputCapture(int32 InMaxLines = 2000);
+	virtual ~FUnrealCopilotOutputCapture();
+
+	/**
+	 * Forget the previous execution's output
+	 * @param InMaxLines - Lines to keep; older lines are dropped
+	 */
+	void Reset(int32 InMaxLines);
+
+	/** Get the captured lines of one stream joined with newlines */
+	FString GetText(EPythonOutputStream Stream) const;
+
+	/** Get the number of lines dropped because the buffer was full */
+	int32 GetDroppedLineCount() const;
+
+	/**
+	 * Get the error reported by the script
+	 * @return False if the script reported no error
+	 */
+	bool GetErrorReport(FPythonErrorReport& OutReport) const;
+
+	/** Called for each captured line. Lines printed off the game thread are kept but not broadcast. */
+	FOnPythonOutputLine OnLineCaptured;
+
+	//~ Begin FOutputDevice Interface
+	virtual void Serialize(const TCHAR* V, ELogVerbosity::Type Verbosity, const FName& Category) override;
+	virtual bool CanBeUsedOnAnyThread() const override { return true; }
+	//~ End FOutputDevice Interface
+
+private:
+	/** Guards the captured state */
+	mutable FCriticalSection CaptureLock;
+
+	FPythonOutputRingBuffer Lines;
+
+	TOptional<FPythonErrorReport> ErrorReport;
+};
@@ -0,0 +1,131 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * How scanned text is interpreted
+ */
+enum class EPatternScanMode : uint8
+{
+	/** Every character is scanned */
+	PlainText,
+	/** Python source; comments and string literals are skipped (f-string contents are still scanned) */
+	PythonCode
+};
+
+/**
+ * A pattern to scan for and the reason it is reported
+ */
+struct FPatternScanRule
+{
+	/** Text to find */
+	FString Pattern;
+
+	/** Why a match is rejected, shown to the user */
+	FString Reason;
+};
+
+/**
+ * A pattern match
+ */
+struct FPatternScanHit
+{
+	/** Index of the matched rule */
+	int32 RuleIndex = INDEX_NONE;
+
+	/** Character offset of the match */
+	int32 Offset = 0;
+
+	/** 1-based line of the match */
+	int32 Line = 1;
+
+	/** 1-based column of the match */
+	int32 Column = 1;
+};
+
+/**
+ * Multi-pattern matcher (Aho-Corasick automaton) compiled once from a rule list.
+ * Scanning is a single linear pass regardless of the number of patterns.
+ * Patterns starting with an identifier character only match at an identifier boundary, so "os." does not match "pos.x".
+ */
+class UNREALCOPILOT_API FUnrealCopilotPatternScanner
+{
+public:
+	/**
+	 * Compile the automaton
+	 * @param InRules - Rules to match; empty and duplicate patterns are ignored
+	 * @param bInCaseSensitive - Whether matching is case sensitive
+	 */
+	FUnrealCopilotPatternScanner(const TArray<FPatternScanRule>& InRules, bool bInCaseSensitive);
+
+	/**
+	 * Find pattern matches in text
+	 * @param Text - Text to scan
+	 * @param Mode - Whether to skip Python comments and string literals
+	 * @param OutHits - Matches in text order
+	 * @param MaxHits - Stop after this many matches
+	 */
+	void Scan(FStringView Text, EPatternScanMode Mode, TArray<FPatternScanHit>& OutHits, int32 MaxHits = MAX_int32) const;
+
+	/** Get a rule by index */
+	const FPatternScanRule& GetRule(int32 RuleIndex) const { return Rules[RuleIndex]; }
+
+	/** Get the number of compiled rules */
+	int32 NumRules() const { return Rules.Num(); }
+
+	/**
+	 * Describe hits as "<reason>: <pattern> (line L, column C)" lines
+	 * @param Hits - Hits from Scan
+	 * @return One line per hit
+	 */
+	FString DescribeHits(const TArray<FPatternScanHit>& Hits) const;
+
+private:
+	struct FNode
+	{
+		/** Transitions by character */
+		TMap<TCHAR, int32> Next;
+
+		/** Longest proper suffix that is also a prefix of some pattern */
+		int32 Fail = 0;
+
+		/** Rule whose pattern ends at this node, or INDEX_NONE */
+		int32 RuleIndex = INDEX_NONE;
+
+		/** Nearest node on the fail chain that ends a pattern, or INDEX_NONE */
+		int32 OutputLink = INDEX_NONE;
+	};
+
+	/** Follow the automaton from a state on one character */
+	int32 Step(int32 State, TCHAR Char) const;
+
+	/** Fold a character for case-insensitive matching */
+	TCHAR Fold(TCHAR Char) const { return bCaseSensitive ? Char : FChar::ToUpper(Char); }
+
+private:
+	/** Compiled rules, indexed by FPatternScanHit::RuleIndex */
+	TArray<FPatternScanRule> Rules;
+
+	/** Automaton nodes; node 0 is the root */
+	TArray<FNode> Nodes;
+
+	bool bCaseSensitive = true;
+};
+
+/**
+ * Shared scanners compiled from the safety settings, rebuilt only when the settings change
+ */
+class UNREALCOPILOT_API FUnrealCopilotSafetyScanners
+{
+public:
+	/** Get the scanner for generated code's configured blocked operations (thread safe); structural rules are checked on the syntax tree */
+	static TSharedRef<const FUnrealCopilotPatternScanner> GetCodeScanner();
+
+	/** Get the scanner for user prompts (thread safe) */
+	static TSharedRef<const FUnrealCopilotPatternScanner> GetPromptScanner();
+
+	/** Drop the compiled scanners so the next use rebuilds them from the current settings */
+	static void Invalidate();
+};
@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * How lines of a prompt section are weighted when dropping content to meet a token budget
+ */
+struct FPromptSectionPolicy
+{
+	/** Sections start at a line beginning with this header */
+	FString HeaderPrefix;
+
+	/** Relative importance of the section; sections at 1.0 or above are never trimmed */
+	float Importance = 1.0f;
+
+	/** Whether later lines matter more than earlier ones (e.g. conversation history) */
+	bool bPreferRecent = false;
+};
+
+/**
+ * Options for the prompt compressor
+ */
+struct FPromptCompressionOptions
+{
+	/** Replace repeated asset path directories with short aliases and a legend */
+	bool bFactorPathPrefixes = true;
+
+	/** Strip comments and blank lines from fenced code blocks */
+	bool bStripCode = true;
+
+	/** Drop text lines that already appeared earlier in the prompt */
+	bool bDeduplicateLines = true;
+
+	/** Drop the least important lines until the prompt fits this many estimated tokens (0 disables) */
+	int32 TokenBudget = 0;
+
+	/** Minimum number of paths sharing a directory before it gets an alias */
+	int32 MinPathPrefixOccurrences = 3;
+
+	/** Section weighting used when trimming to the token budget */
+	TArray<FPromptSectionPolicy> SectionPolicies;
+};
+
+/**
+ * Statistics for one compression pass
+ */
+struct FPromptCompressionStats
+{
+	/** Estimated tokens before compression */
+	int32 OriginalTokens = 0;
+
+	/** Estimated tokens after compression */
+	int32 CompressedTokens = 0;
+
+	/** Duplicate lines removed */
+	int32 DuplicateLines = 0;
+
+	/** Comment and blank lines removed from code */
+	int32 StrippedCodeLines = 0;
+
+	/** Path directories replaced by aliases */
+	int32 FactoredPathPrefixes = 0;
+
+	/** Lines dropped to meet the token budget */
+	int32 DroppedLines = 0;
+
+	/** Time spent compressing in milliseconds */
+	double ElapsedMilliseconds = 0.0;
+};
+
+/**
+ * Deterministic local prompt compression applied before a request is sent.
+ * Segments (e.g. system and user message) are compressed together so content repeated across them is sent once.
+ */
+class UNREALCOPILOT_API FUnrealCopilotPromptCompressor
+{
+public:
+	/**
+	 * Compress prompt segments in place
+	 * @param Segments - Prompt parts in send order; later duplicates of earlier lines are removed
+	 * @param Options - Compression steps and token budget
+	 * @return Compression statistics
+	 */
+	static FPromptCompressionStats Compress(TArrayView<FString> Segments, const FPromptCompressionOptions& Options);
+
+	/**
+	 * Estimate the token count of text, approximating BPE tokenizers (alphanumeric runs of ~4 characters and punctuation)
+	 * @param Text - Text to measure
+	 * @return Estimated token count
+	 */
+	static int32 EstimateTokens(FStringView Text);
+
+	/**
+	 * Remove comments, trailing whitespace, and blank lines from Python code, leaving string literals intact
+	 * @param Code - Python source
+	 * @return Stripped source
+	 */
+	static FString StripPythonCode(FStringView Code);
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Dom/JsonObject.h"
+#include "UnrealCopilotPromptCompressor.h"
 #include "UnrealCopilotPromptProcessor.generated.h"
 
 /**
@@ -21,6 +22,51 @@ enum class EUnrealCopilotWorkflowType : uint8
 	VFX UMETA(DisplayName = "Visual Effects")
 };
 
+/**
+ * Context sources that can be packed into the system prompt, selected per workflow type
+ */
+enum class EPromptContextSource : uint32
+{
+	None = 0,
+	SelectedActors = 1 << 0,
+	AvailableAssets = 1 << 1,
+	LevelCensus = 1 << 2,
+	NearbyActors = 1 << 3,
+	All = SelectedActors | AvailableAssets | LevelCensus | NearbyActors
+};
+ENUM_CLASS_FLAGS(EPromptContextSource);
+
+/**
+ * How the model is asked to return code responses
+ */
+enum class EStructuredOutputFormat : uint8
+{
+	/** Free-form text; code is extracted from fenced blocks */
+	None,
+	/** JSON mode; the response is a JSON object following the instructions in the system prompt */
+	JsonObject,
+	/** Strict JSON schema enforced by the API */
+	JsonSchema
+};
+
+/**
+ * Code response returned by the model in structured-output mode
+ */
+struct FUnrealCopilotCodeResponse
+{
+	/** Python script to execute */
+	FString Code;
+
+	/** Short description of what the script does */
+	FString Explanation;
+
+	/** Asset paths the script creates or modifies */
+	TArray<FString> TouchedAssets;
+};
+
+class AActor;
+class FUnrealCopilotWorkflowClassifier;
+
 /**
  * Structure containing context information for prompt processing
  */
@@ -49,10 +95,34 @@ struct UNREALCOPILOT_API FPromptContext
 	UPROPERTY(BlueprintReadWrite, Category = "Context")
 	EUnrealCopilotWorkflowType WorkflowType = EUnrealCopilotWorkflowType::General;
 
-	/** Selected actors in the level */
+	/** Classifier confidence for the workflow type (0 when not classified) */
+	UPROPERTY(BlueprintReadWrite, Category = "Context")
+	float WorkflowConfidence = 0.0f;
+
+	/** Selected actors in the level (all names for small selections, a representative sample for large ones) */
 	UPROPERTY(BlueprintReadWrite, Category = "Context")
 	TArray<FString> SelectedActors;
 
+	/** Total number of selected actors */
+	UPROPERTY(BlueprintReadWrite, Category = "Context")
+	int32 SelectedActorCount = 0;
+
+	/** Detailed or aggregated description of the selection for the system prompt */
+	UPROPERTY(BlueprintReadWrite, Category = "Context")
+	FString SelectionSummary;
+
+	/** Compact census of the current level (actor counts by class, folders, bounds, and layers) */
+	UPROPERTY(BlueprintReadWrite, Category = "Context")
+	FString LevelSummary;
+
+	/** Actors nearest the level viewport camera (or inside its view), nearest first */
+	UPROPERTY(BlueprintReadWrite, Category = "Context")
+	FString NearbyActorsSummary;
+
+	/** Whether the model can pull editor context through tools, so heavy context is left out of the system prompt */
+	UPROPERTY(BlueprintReadWrite, Category = "Context")
+	bool bToolCallingEnabled = false;
+
 	FPromptContext()
 	{
 		ProjectName = TEXT("");
@@ -101,6 +171,30 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
 	FPromptContext GatherCurrentContext();
 
+	/**
+	 * Gather current project context and classify the prompt to pick its workflow type
+	 * @param UserPrompt - The user's prompt
+	 * @return Populated context structure with workflow type set
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	FPromptContext GatherContextForPrompt(const FString& UserPrompt);
+
+	/**
+	 * Classify a prompt into a workflow type using the local classifier
+	 * @param UserPrompt - The user's prompt
+	 * @param OutConfidence - Posterior probability of the returned workflow type
+	 * @return Most likely workflow type
+	 */
+	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
+	EUnrealCopilotWorkflowType ClassifyWorkflow(const FString& UserPrompt, float& OutConfidence);
+
+	/**
+	 * Get the context sources packed into the system prompt for a workflow type
+	 * @param WorkflowType - Type of workflow
+	 * @return Context sources to include
+	 */
+	static EPromptContextSource GetContextSourcesForWorkflow(EUnrealCopilotWorkflowType WorkflowType);
+
 	/**
 	 * Validate user input for safety and appropriateness
 	 * @param UserPrompt - The user's input
@@ -118,6 +212,20 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "UnrealCopilot")
 	FString ExtractPythonCode(const FString& LLMResponse);
 
+	/**
+	 * Get the structured-output format used for the configured model
+	 * @return Format requested from the API, or None when disabled or unsupported
+	 */
+	EStructuredOutputFormat GetStructuredOutputFormat() const;
+
+	/**
+	 * Parse a structured code response ({code, explanation, touched_assets})
+	 * @param Content - Message content returned by the model
+	 * @param OutResponse - Parsed response
+	 * @return True if the content is a JSON object with a code field
+	 */
+	bool ParseStructuredCodeResponse(const FString& Content, FUnrealCopilotCodeResponse& OutResponse);
+
 	/**
 	 * Add a conversation entry to history
 	 * @param UserPrompt - The user's prompt
@@ -142,8 +250,21 @@ public:
 	/** Create OpenAI API request payload in JSON format */
 	TSharedPtr<FJsonObject> CreateOpenAIRequestPayload(const FString& SystemPrompt, const FString& UserPrompt);
 
+	/** Create the JSON schema of structured code responses */
+	static TSharedPtr<FJsonObject> CreateCodeResponseSchema();
+
 	/** Create GPT-5 Responses API request payload (different format from Chat Completions) */
-	TSharedPtr<FJsonObject> CreateGPT5ResponsesPayload(const FString& UserPrompt);
+	TSharedPtr<FJsonObject> CreateGPT5ResponsesPayload(const FString& UserPrompt, const FPromptContext& Context);
+
+	/**
+	 * Compress the system and user prompt together according to the compression settings
+	 * @param SystemPrompt - System message, compressed in place
+	 * @param UserPrompt - User message, compressed in place; lines repeating the system message are removed
+	 */
+	void CompressPrompt(FString& SystemPrompt, FString& UserPrompt);
+
+	/** Get statistics of the last prompt compression */
+	const FPromptCompressionStats& GetLastCompressionStats() const { return LastCompressionStats; }
 
 public:
 	/** Delegate called when prompt processing is complete */
@@ -185,9 +306,15 @@ private:
 
 	/**
 	 * Get currently selected actors
-	 * @return Array of selected actor names
+	 * @return Array of selected actors
 	 */
-	TArray<FString> GetSelectedActors() const;
+	TArray<AActor*> GetSelectedActors() const;
+
+	/**
+	 * Get the workflow classifier, creating and training it on first use
+	 * @return Workflow classifier
+	 */
+	FUnrealCopilotWorkflowClassifier& GetWorkflowClassifier();
 
 private:
 	/** Conversation history for context */
@@ -207,4 +334,10 @@ private:
 
 	/** Context cache validity duration in seconds */
 	static constexpr double ContextCacheDuration = 5.0;
+
+	/** Local workflow classifier (created lazily) */
+	TSharedPtr<FUnrealCopilotWorkflowClassifier> WorkflowClassifier;
+
+	/** Statistics of the last prompt compression */
+	FPromptCompressionStats LastCompressionStats;
 };
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealCopilotPythonParser.h"
+#include "UnrealCopilotCodeCache.h"
+
+/**
+ * Outcome of a call into the runtime module
+ */
+enum class EPythonBridgeStatus : uint8
+{
+	/** The call completed; for scripts, without raising */
+	Succeeded,
+
+	/** The script does not compile */
+	SyntaxError,
+
+	/** The script raised, or the runtime module failed; details were printed to stderr */
+	Failed,
+
+	/** The call was stopped by KeyboardInterrupt, normally raised by the execution watchdog */
+	Interrupted,
+
+	/** Python is not initialized */
+	Unavailable
+};
+
+/**
+ * States of a time-sliced job in the runtime module
+ */
+enum class EPythonJobState : uint8
+{
+	Running,
+	Done,
+	Error
+};
+
+/**
+ * Result of running one time slice of a job
+ */
+struct FPythonJobStep
+{
+	EPythonJobState State = EPythonJobState::Error;
+
+	/** Top-level statements that have finished */
+	int32 StatementsCompleted = 0;
+
+	/** Top-level statements in the script */
+	int32 TotalStatements = 0;
+
+	/** Loop iterations and statements run so far */
+	int32 StepsCompleted = 0;
+};
+
+/**
+ * Native bridge to the resident unreal_copilot_runtime module. Scripts are passed as Python str objects through the
+ * C API, so they are never escaped into wrapper source, and each script is parsed once and run from the code object
+ * compiled from it. Must be called on the thread that runs the editor's Python commands.
+ */
+class UNREALCOPILOT_API FUnrealCopilotPythonBridge
+{
+public:
+	/**
+	 * Compile a script and run it
+	 * @param Source - Script text
+	 * @param CacheKey - Hash from FUnrealCopilotCodeCache identifying the compiled script; empty to bypass the cache
+	 * @param SessionId - Session whose namespace the script runs in; 0 for a fresh namespace
+	 * @param OutSyntaxError - Location and message if the script does not compile
+	 * @return Outcome of the script
+	 */
+	static EPythonBridgeStatus RunSource(const FString& Source, const FString& CacheKey, int32 SessionId, FPythonSyntaxError& OutSyntaxError);
+
+	/**
+	 * Prepare a script for time-sliced execution
+	 * @param JobId - Identifier used by the other job calls
+	 * @param Source - Script text
+	 * @param CacheKey - Hash from FUnrealCopilotCodeCache identifying the compiled script; empty to bypass the cache
+	 * @param SessionId - Session whose namespace the script runs in; 0 for a fresh namespace
+	 * @param OutTotalStatements - Top-level statements in the script
+	 * @return Succeeded if the job was created
+	 */
+	static EPythonBridgeStatus StartJob(int32 JobId, const FString& Source, const FString& CacheKey, int32 SessionId, int32& OutTotalStatements);
+
+	/**
+	 * Run a job until it finishes or its time budget is spent
+	 * @param JobId - Job from StartJob
+	 * @param BudgetSeconds - Time the slice may take
+	 * @param OutStep - Job state after the slice
+	 * @return Succeeded if the runtime module reported the step
+	 */
+	static EPythonBridgeStatus StepJob(int32 JobId, double BudgetSeconds, FPythonJobStep& OutStep);
+
+	/**
+	 * Stop a job, running its pending finally blocks
+	 * @param JobId - Job from StartJob
+	 */
+	static void CancelJob(int32 JobId);
+
+	/**
+	 * Set how many compiled scripts the runtime module keeps
+	 * @param Capacity - Most cached scripts; 0 disables the cache
+	 */
+	static void ConfigureCodeCache(int32 Capacity);
+
+	/**
+	 * Get the counters of the runtime module's compiled code cache
+	 * @return False if Python is not available
+	 */
+	static bool GetCodeCacheStats(FPythonCodeCacheStats& OutStats);
+
+	/**
+	 * Import the runtime module and preload modules scripts commonly import
+	 * @param ModuleNames - Modules to import
+	 * @param OutSeconds - Time the runtime module spent importing the modules
+	 * @param OutFailedModules - Modules that could not be imported
+	 * @return Succeeded if the runtime module was imported
+	 */
+	static EPythonBridgeStatus WarmUp(const TArray<FString>& ModuleNames, double& OutSeconds, TArray<FString>& OutFailedModules);
+
+	/**
+	 * Drop the variables of a session so its next script starts from a fresh namespace
+	 * @param SessionId - Session to reset
+	 */
+	static void ResetSession(int32 SessionId);
+};
@@ -0,0 +1,233 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Kinds of Python tokens
+ */
+enum class EPythonTokenType : uint8
+{
+	Name,
+	Number,
+	String,
+	Operator,
+	Newline,
+	Indent,
+	Dedent,
+	EndOfFile
+};
+
+/**
+ * A token referencing a range of the tokenized source
+ */
+struct FPythonToken
+{
+	EPythonTokenType Type = EPythonTokenType::EndOfFile;
+
+	/** Character offset in the source */
+	int32 Offset = 0;
+
+	/** Number of characters */
+	int32 Length = 0;
+
+	/** 1-based line */
+	int32 Line = 1;
+
+	/** 1-based column */
+	int32 Column = 1;
+};
+
+/**
+ * Location and description of the first syntax error in a script
+ */
+struct FPythonSyntaxError
+{
+	FString Message;
+
+	/** 1-based line */
+	int32 Line = 0;
+
+	/** 1-based column */
+	int32 Column = 0;
+
+	/** Format as "<message> (line L, column C)" */
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("%s (line %d, column %d)"), *Message, Line, Column);
+	}
+};
+
+/**
+ * Kinds of syntax tree nodes, named after Python's ast module
+ */
+enum class EPythonAstNodeType : uint8
+{
+	Module,
+
+	// Statements
+	FunctionDef,
+	ClassDef,
+	Arg,
+	Return,
+	Delete,
+	Assign,
+	AugAssign,
+	AnnAssign,
+	For,
+	While,
+	If,
+	With,
+	Match,
+	MatchCase,
+	Raise,
+	Try,
+	ExceptHandler,
+	Assert,
+	Import,
+	ImportFrom,
+	Alias,
+	Global,
+	Nonlocal,
+	Expr,
+	Pass,
+	Break,
+	Continue,
+
+	// Expressions
+	BoolOp,
+	NamedExpr,
+	BinOp,
+	UnaryOp,
+	Lambda,
+	IfExp,
+	Dict,
+	Set,
+	ListComp,
+	SetComp,
+	DictComp,
+	GeneratorExp,
+	Comprehension,
+	Await,
+	Yield,
+	YieldFrom,
+	Compare,
+	Call,
+	Keyword,
+	Constant,
+	JoinedStr,
+	Attribute,
+	Subscript,
+	Slice,
+	Starred,
+	Name,
+	List,
+	Tuple
+};
+
+/**
+ * A syntax tree node. Children are stored in source order.
+ */
+struct FPythonAstNode
+{
+	EPythonAstNodeType Type = EPythonAstNodeType::Module;
+
+	/**
+	 * Identifier or operator carried by the node: the name of a Name, Attribute, FunctionDef, ClassDef, Arg, Keyword or Alias,
+	 * the dotted module of an Import or ImportFrom (leading dots for relative imports), the operator of an operation
+	 */
+	FString Name;
+
+	/** 1-based line where the node starts (for Attribute, where the attribute name starts) */
+	int32 Line = 1;
+
+	/** 1-based column where the node starts (for Attribute, where the attribute name starts) */
+	int32 Column = 1;
+
+	/** Index of the parent node, or INDEX_NONE for the module */
+	int32 Parent = INDEX_NONE;
+
+	/** Indices of child nodes */
+	TArray<int32> Children;
+};
+
+/**
+ * Syntax tree of a parsed script. Node 0 is the Module; each imported module gets its own Import node.
+ */
+struct FPythonAst
+{
+	TArray<FPythonAstNode> Nodes;
+};
+
+/**
+ * What generated code may import and access
+ */
+struct UNREALCOPILOT_API FPythonSafetyPolicy
+{
+	/** Top-level modules that may be imported; empty allows any module */
+	TSet<FString> AllowedImports;
+
+	/** Builtins that may not be referenced, called or not */
+	TSet<FString> ForbiddenNames;
+
+	/** Attributes that may not be accessed on any object */
+	TSet<FString> ForbiddenAttributes;
+
+	/** Policy forbidding dynamic code execution, file access and introspection escapes, with no import restriction */
+	static FPythonSafetyPolicy MakeDefault();
+};
+
+/**
+ * A safety rule broken by a script
+ */
+struct FPythonSafetyViolation
+{
+	FString Message;
+
+	/** 1-based line */
+	int32 Line = 0;
+
+	/** 1-based column */
+	int32 Column = 0;
+
+	/** Format as "<message> (line L, column C)" */
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("%s (line %d, column %d)"), *Message, Line, Column);
+	}
+};
+
+/**
+ * Native tokenizer and parser for the Python 3.11 grammar used by the editor's interpreter.
+ * Does not touch the interpreter, so scripts can be checked on any thread; all functions are reentrant.
+ */
+class UNREALCOPILOT_API FUnrealCopilotPythonParser
+{
+public:
+	/**
+	 * Split a script into tokens, including Newline, Indent and Dedent tokens
+	 * @param Source - Script text
+	 * @param OutTokens - Tokens ending with EndOfFile
+	 * @param OutError - First error if tokenizing fails
+	 * @return True if the script was tokenized
+	 */
+	static bool Tokenize(FStringView Source, TArray<FPythonToken>& OutTokens, FPythonSyntaxError& OutError);
+
+	/**
+	 * Parse a script into a syntax tree, reporting the first syntax error
+	 * @param Source - Script text
+	 * @param OutAst - Syntax tree
+	 * @param OutError - First syntax error if parsing fails
+	 * @return True if the script is syntactically valid
+	 */
+	static bool Parse(FStringView Source, FPythonAst& OutAst, FPythonSyntaxError& OutError);
+
+	/**
+	 * Check a syntax tree against a safety policy. Expressions inside f-strings are checked; other string contents and comments are not.
+	 * @param Ast - Tree from Parse
+	 * @param Policy - Rules to enforce
+	 * @param OutViolations - Every violation, in source order
+	 */
+	static void CheckSafety(const FPythonAst& Ast, const FPythonSafetyPolicy& Policy, TArray<FPythonSafetyViolation>& OutViolations);
+};
@@ -0,0 +1,58 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+
+/**
+ * Options controlling how a set of actors is summarized for the prompt
+ */
+struct UNREALCOPILOT_API FSelectionSummaryOptions
+{
+	/** Selections up to this size are described actor by actor */
+	int32 MaxDetailedActors = 20;
+
+	/** Number of representative actors listed for aggregated selections */
+	int32 MaxSampleActors = 8;
+
+	/** Maximum number of classes, folders, and name patterns listed for aggregated selections */
+	int32 MaxGroups = 10;
+
+	/** Maximum number of components listed per actor in detailed mode */
+	int32 MaxComponentsPerActor = 6;
+};
+
+/**
+ * Builds compact prompt context for actor selections of any size.
+ * Small selections get exact per-actor detail (class, transform, components); large selections are
+ * aggregated into counts by class, folders, name patterns, overall bounds, and a representative sample.
+ * Per-actor data is gathered in parallel so summarizing stays cheap for tens of thousands of actors.
+ */
+class UNREALCOPILOT_API FUnrealCopilotSelectionSummarizer
+{
+public:
+	/**
+	 * Summarize a set of actors
+	 * @param Actors - Actors to summarize
+	 * @param Options - Summary size limits
+	 * @param OutSampleNames - Optional names of the actors described in the summary
+	 * @return Summary text ready for the system prompt
+	 */
+	static FString Summarize(TConstArrayView<AActor*> Actors, const FSelectionSummaryOptions& Options, TArray<FString>* OutSampleNames = nullptr);
+
+	/**
+	 * Reduce an object name to a pattern by replacing its numeric suffix (e.g. "SM_Rock_12" -> "SM_Rock_*")
+	 * @param Name - Object name
+	 * @return Name pattern
+	 */
+	static FString GetNamePattern(const FString& Name);
+
+private:
+	/** Describe every actor with class, transform, and components */
+	static FString DescribeActorsInDetail(TConstArrayView<AActor*> Actors, const FSelectionSummaryOptions& Options, TArray<FString>* OutSampleNames);
+
+	/** Describe actors through aggregate statistics and a representative sample */
+	static FString DescribeActorsAggregated(TConstArrayView<AActor*> Actors, const FSelectionSummaryOptions& Options, TArray<FString>* OutSampleNames);
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "UnrealCopilotCodeBlockExtractor.h"
 #include "UnrealCopilotSettings.generated.h"
 
 /**
@@ -78,6 +79,9 @@ public:
 	/** Get the model name string for API calls */
 	FString GetModelNameForAPI() const;
 
+	/** Whether requests are streamed with the current model and tool settings */
+	bool ShouldStreamResponses() const;
+
 	/** Validate current settings */
 	bool ValidateSettings(FString& OutErrorMessage) const;
 
@@ -115,6 +119,26 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "LLM Integration", meta = (ClampMin = "5.0", ClampMax = "300.0", DisplayName = "Request Timeout (seconds)", ToolTip = "API request timeout. GPT-5 typically requires 120-180 seconds due to longer processing time."))
 	float RequestTimeoutSeconds = 120.0f;
 
+	/** Let the model pull editor context through read-only tools instead of packing it all into the system prompt */
+	UPROPERTY(Config, EditAnywhere, Category = "LLM Integration", meta = (DisplayName = "Enable Tool Calling"))
+	bool bEnableToolCalling = false;
+
+	/** Maximum number of tool-calling round trips before the model must answer */
+	UPROPERTY(Config, EditAnywhere, Category = "LLM Integration", meta = (ClampMin = "1", ClampMax = "10", DisplayName = "Max Tool Rounds", EditCondition = "bEnableToolCalling"))
+	int32 MaxToolRounds = 4;
+
+	/** Ask the model for a JSON object with code, explanation, and touched assets instead of extracting code from free text */
+	UPROPERTY(Config, EditAnywhere, Category = "LLM Integration", meta = (DisplayName = "Use Structured Output"))
+	bool bUseStructuredOutput = true;
+
+	/** Stream Chat Completions responses so the code preview fills in as tokens arrive; takes precedence over structured output and is not used with GPT-5 or tool calling */
+	UPROPERTY(Config, EditAnywhere, Category = "LLM Integration", meta = (DisplayName = "Stream Responses"))
+	bool bStreamResponses = false;
+
+	/** Which Python blocks of a response with several code blocks form the generated script */
+	UPROPERTY(Config, EditAnywhere, Category = "LLM Integration", meta = (DisplayName = "Code Block Selection"))
+	EUnrealCopilotCodeBlockSelection CodeBlockSelection = EUnrealCopilotCodeBlockSelection::Concatenate;
+
 	/** Rate limiting: Max requests per minute */
 	UPROPERTY(Config, EditAnywhere, Category = "Rate Limiting", meta = (ClampMin = "1", ClampMax = "100", DisplayName = "Max Requests Per Minute"))
 	int32 MaxRequestsPerMinute = 20;
@@ -131,6 +155,38 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "Security", meta = (DisplayName = "Blocked Operations"))
 	TArray<FString> BlockedOperations;
 
+	/** Top-level modules generated code may import; empty allows any module */
+	UPROPERTY(Config, EditAnywhere, Category = "Security", meta = (DisplayName = "Allowed Python Imports"))
+	TArray<FString> AllowedPythonImports;
+
+	/** Longest an asynchronous script runs before the scheduler checks the frame budget again, in milliseconds */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (ClampMin = "1.0", ClampMax = "100.0", DisplayName = "Async Execution Time Slice (ms)"))
+	float AsyncExecutionTimeSliceMs = 10.0f;
+
+	/** Time queued scripts may run per editor frame in total, in milliseconds; batch scripts only get what interactive ones leave */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (ClampMin = "1.0", ClampMax = "100.0", DisplayName = "Script Frame Budget (ms)"))
+	float ScriptFrameBudgetMs = 10.0f;
+
+	/** Most recent lines of script output kept for the execution result; older lines are dropped */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (ClampMin = "100", ClampMax = "100000", DisplayName = "Max Captured Output Lines"))
+	int32 MaxCapturedOutputLines = 2000;
+
+	/** Compiled scripts and validation verdicts kept so scripts that run again skip parsing and validation */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (ClampMin = "1", ClampMax = "4096", DisplayName = "Code Cache Size"))
+	int32 CodeCacheSize = 128;
+
+	/** Warm the Python environment as soon as the interpreter is ready instead of on the first execution */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (DisplayName = "Warm Up Python On Startup"))
+	bool bWarmUpPythonOnStartup = true;
+
+	/** Modules imported while warming up, so scripts importing them do not pay for the first import */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (DisplayName = "Preloaded Python Modules"))
+	TArray<FString> PreloadedPythonModules;
+
+	/** Keep variables and imports of scripts run from the Copilot panel between runs until the session is reset */
+	UPROPERTY(Config, EditAnywhere, Category = "Python Execution", meta = (DisplayName = "Persistent Panel Session"))
+	bool bPersistentPanelSession = false;
+
 	/** Enable request/response logging */
 	UPROPERTY(Config, EditAnywhere, Category = "Debugging", meta = (DisplayName = "Enable API Logging"))
 	bool bEnableAPILogging = false;
@@ -139,6 +195,42 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (DisplayName = "System Prompt Template", MultiLine = true))
 	FString SystemPromptTemplate;
 
+	/** Classify prompts locally to pick the workflow type that narrows injected context */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (DisplayName = "Auto-Detect Workflow Type"))
+	bool bAutoDetectWorkflowType = true;
+
+	/** Minimum classifier confidence before a specific workflow is used instead of General */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (ClampMin = "0.0", ClampMax = "1.0", DisplayName = "Workflow Classification Threshold", EditCondition = "bAutoDetectWorkflowType"))
+	float WorkflowClassificationThreshold = 0.5f;
+
+	/** Selections up to this size are described actor by actor; larger ones are aggregated */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (ClampMin = "0", ClampMax = "200", DisplayName = "Max Detailed Selected Actors"))
+	int32 MaxDetailedSelectedActors = 20;
+
+	/** Number of representative actors listed when a large selection is aggregated */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (ClampMin = "0", ClampMax = "50", DisplayName = "Selection Sample Size"))
+	int32 SelectionSampleSize = 8;
+
+	/** Number of actors near the level viewport camera described in the prompt (0 disables) */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (ClampMin = "0", ClampMax = "100", DisplayName = "Nearby Actor Count"))
+	int32 NearbyActorCount = 15;
+
+	/** Actors farther than this from the camera are not considered nearby (cm) */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (ClampMin = "100.0", DisplayName = "Nearby Actor Max Distance", EditCondition = "NearbyActorCount > 0"))
+	float NearbyActorMaxDistance = 50000.0f;
+
+	/** Only describe nearby actors that are inside the camera's view frustum */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (DisplayName = "Nearby Actors In View Only", EditCondition = "NearbyActorCount > 0"))
+	bool bNearbyActorsInViewOnly = false;
+
+	/** Strip code comments, remove repeated lines, and alias repeated asset paths before sending a prompt */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (DisplayName = "Enable Prompt Compression"))
+	bool bEnablePromptCompression = true;
+
+	/** Drop the least important context lines until the prompt fits this many estimated tokens (0 disables) */
+	UPROPERTY(Config, EditAnywhere, Category = "Prompt Engineering", meta = (ClampMin = "0", DisplayName = "Prompt Token Budget", EditCondition = "bEnablePromptCompression"))
+	int32 PromptTokenBudget = 0;
+
 	/** GPT-5 reasoning effort (only used when model is GPT-5) */
 	UPROPERTY(Config, EditAnywhere, Category = "OpenAI Settings", meta=(DisplayName="GPT-5 Reasoning Effort", EditCondition="OpenAIModel == EOpenAIModel::GPT5"))
 	EGPT5ReasoningEffort GPT5ReasoningEffort = EGPT5ReasoningEffort::Medium;
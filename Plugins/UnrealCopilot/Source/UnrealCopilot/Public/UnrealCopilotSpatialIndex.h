@@ -0,0 +1,112 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+struct FConvexVolume;
+
+/**
+ * Result of a spatial index query
+ */
+struct FSpatialIndexHit
+{
+	/** Object the indexed bounds belong to */
+	FObjectKey Key;
+
+	/** Squared distance from the query origin to the object's bounds */
+	double DistanceSquared = 0.0;
+};
+
+/**
+ * Loose uniform grid over object bounds, used to answer "what is near here" queries on large levels.
+ * Each object lives in the cell containing its bounds center; cells are treated as one cell larger on every
+ * side, so objects up to a cell in half-extent need no reinsertion when their bounds grow. Larger objects
+ * (landscapes, volumes) are kept in a separate list that every query checks.
+ * Moving an object within its cell only updates its bounds.
+ */
+class UNREALCOPILOT_API FUnrealCopilotSpatialIndex
+{
+public:
+	/**
+	 * @param InCellSize - Grid cell size in world units
+	 */
+	explicit FUnrealCopilotSpatialIndex(double InCellSize = 10000.0);
+
+	/**
+	 * Insert an object or update its bounds
+	 * @param Key - Object to index
+	 * @param Bounds - World-space bounds of the object
+	 */
+	void AddOrUpdate(FObjectKey Key, const FBox& Bounds);
+
+	/**
+	 * Remove an object from the index
+	 * @param Key - Object to remove
+	 * @return True if the object was indexed
+	 */
+	bool Remove(FObjectKey Key);
+
+	/** Remove all objects */
+	void Reset();
+
+	/** Number of indexed objects */
+	int32 Num() const { return Elements.Num(); }
+
+	/**
+	 * Find the objects whose bounds are closest to a point
+	 * @param Origin - Query point
+	 * @param MaxResults - Maximum number of objects to return
+	 * @param MaxDistance - Ignore objects farther than this (0 for unlimited)
+	 * @param OutHits - Hits sorted by increasing distance
+	 */
+	void FindNearest(const FVector& Origin, int32 MaxResults, double MaxDistance, TArray<FSpatialIndexHit>& OutHits) const;
+
+	/**
+	 * Find the objects whose bounds intersect a convex volume (typically a view frustum), nearest first
+	 * @param Frustum - Volume to test against
+	 * @param Origin - Point used to rank and distance-limit the results (typically the camera location)
+	 * @param MaxResults - Maximum number of objects to return
+	 * @param MaxDistance - Ignore objects farther than this from Origin (0 for unlimited)
+	 * @param OutHits - Hits sorted by increasing distance
+	 */
+	void FindInFrustum(const FConvexVolume& Frustum, const FVector& Origin, int32 MaxResults, double MaxDistance, TArray<FSpatialIndexHit>& OutHits) const;
+
+private:
+	struct FElement
+	{
+		FObjectKey Key;
+		FBox Bounds = FBox(ForceInit);
+		FIntVector Cell = FIntVector::ZeroValue;
+		bool bOversized = false;
+	};
+
+	/** Get the grid cell containing a point */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Whether bounds are too large to be stored in a single loose cell */
+	bool IsOversized(const FBox& Bounds) const;
+
+	/** Link an element into its cell or the oversized list */
+	void LinkElement(int32 ElementIndex);
+
+	/** Unlink an element from its cell or the oversized list */
+	void UnlinkElement(int32 ElementIndex);
+
+private:
+	/** Indexed elements */
+	TSparseArray<FElement> Elements;
+
+	/** Element index per object */
+	TMap<FObjectKey, int32> KeyToElement;
+
+	/** Element indices per occupied cell */
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	/** Elements too large for the grid */
+	TArray<int32> OversizedElements;
+
+	/** Grid cell size in world units */
+	double CellSize;
+};
@@ -0,0 +1,163 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HAL/PlatformProcess.h"
+#include "UnrealCopilotWorkerPoolCommandlet.generated.h"
+
+class FJsonObject;
+
+/**
+ * A range of maps or assets a script is run over by one worker, and what became of it
+ */
+struct UNREALCOPILOT_API FUnrealCopilotShard
+{
+	/** Position of the shard in the run */
+	int32 Index = 0;
+
+	/** Package names of the maps, or object paths of the assets, in the shard */
+	TArray<FString> Paths;
+
+	/** Number of workers launched for the shard */
+	int32 Attempts = 0;
+
+	/** Item report streamed by the last worker, if it got that far */
+	TSharedPtr<FJsonObject> Result;
+
+	/** Exit code of the last worker */
+	int32 ExitCode = 0;
+
+	/** Why the last worker failed without a result, such as a crash or a timeout */
+	FString Error;
+
+	/** Time the last worker ran for */
+	double Seconds = 0.0;
+
+	/** Whether the last worker was stopped, or its script interrupted, for running too long */
+	bool bTimedOut = false;
+
+	/** Whether the worker reported a result saying the script succeeded */
+	bool Succeeded() const;
+};
+
+/**
+ * Runs one script over many maps or assets by spreading them across headless editor processes, so bulk passes use
+ * every core instead of one game thread:
+ *
+ *   UnrealEditor-Cmd.exe Project.uproject -run=UnrealCopilotWorkerPool -Script=Pass.py [-Maps] [-Path=/Game/Props+/Game/FX]
+ *       [-Class=/Script/Engine.StaticMesh] [-Workers=8] [-ShardSize=200] [-Retries=2] [-ShardTimeout=3600]
+ *       [-ScriptTimeout=3000] [-Output=Results.json]
+ *
+ * The maps (with -Maps) or assets under the paths are sorted and cut into contiguous ranges. Each range becomes a
+ * batch manifest whose script starts by setting copilot_shard_index and copilot_shard_paths, and runs in a worker
+ * launched with -run=UnrealCopilotBatch -StreamResults -NoHistory -nullrhi; workers leave the project's history
+ * alone, since its store cannot be shared between processes. Up to -Workers workers run at once, each taking the
+ * next range when one finishes. Results are read from the workers' output pipes as they are streamed.
+ *
+ * A worker that exits or times out without reporting a result (a crash, for example) has its range retried in a new
+ * process; a script that reports failure is not retried, since it would fail the same way again. Scripts run without
+ * the interactive execution timeout: -ScriptTimeout limits them, defaulting to -ShardTimeout, and shards stopped by
+ * either limit are reported as timed out rather than failed. The results of all ranges are merged into one JSON
+ * report, and the commandlet returns 0 only if every range succeeded.
+ */
+UCLASS()
+class UNREALCOPILOT_API UUnrealCopilotWorkerPoolCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUnrealCopilotWorkerPoolCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+
+	/**
+	 * Cut sorted paths into contiguous ranges
+	 * @param Paths - Paths to shard, in order
+	 * @param ShardSize - Most paths per shard
+	 * @return The shards, numbered in order
+	 */
+	static TArray<FUnrealCopilotShard> MakeShards(const TArray<FString>& Paths, int32 ShardSize);
+
+	/**
+	 * Get the script a worker runs for a shard
+	 * @param Script - Script to run over every shard
+	 * @param Shard - Shard whose paths the script is given
+	 * @return The script, preceded by assignments of copilot_shard_index and copilot_shard_paths
+	 */
+	static FString MakeShardScript(const FString& Script, const FUnrealCopilotShard& Shard);
+
+	/**
+	 * Get the item report in a line of worker output
+	 * @param Line - Line of output, which may carry a log prefix
+	 * @return The report, or null if the line does not carry one
+	 */
+	static TSharedPtr<FJsonObject> ParseStreamedResult(const FString& Line);
+
+	/**
+	 * Build the merged JSON report of a run
+	 * @param Shards - Shards with their results
+	 * @param TotalSeconds - Time the run took
+	 */
+	static TSharedRef<FJsonObject> MakeReport(const TArray<FUnrealCopilotShard>& Shards, double TotalSeconds);
+
+private:
+	/** A running worker process */
+	struct FWorker
+	{
+		FProcHandle Process;
+		void* ReadPipe = nullptr;
+		void* WritePipe = nullptr;
+		int32 ShardIndex = INDEX_NONE;
+		double StartTime = 0.0;
+
+		/** Output not yet split into lines */
+		FString PendingOutput;
+	};
+
+	/**
+	 * Find the maps or assets to shard
+	 * @param Params - Command line of the commandlet
+	 * @param OutPaths - Sorted package names or object paths
+	 */
+	static void GatherPaths(const FString& Params, TArray<FString>& OutPaths);
+
+	/** Write the manifest of a shard and launch a worker for it */
+	bool LaunchWorker(int32 ShardIndex);
+
+	/** Read the output of a worker, keeping the result it streams */
+	void ReadWorkerOutput(FWorker& Worker);
+
+	/**
+	 * Release a worker that exited, queuing its shard again if it failed without a result
+	 * @param ExitCode - Exit code of the worker
+	 * @param Error - Why the worker failed, if it did not report a result
+	 * @param bTimedOut - Whether the worker was stopped for exceeding the shard timeout
+	 */
+	void FinishWorker(FWorker& Worker, int32 ExitCode, const FString& Error, bool bTimedOut);
+
+private:
+	/** Script run over every shard */
+	FString Script;
+
+	/** Folder for shard manifests, results and logs */
+	FString WorkDirectory;
+
+	/** Workers launched per shard at most */
+	int32 MaxAttempts = 1;
+
+	/** Seconds a worker may run before it is stopped, or 0 for no limit */
+	double ShardTimeoutSeconds = 0.0;
+
+	/** Seconds a worker's script may run before it is interrupted, or 0 for no limit */
+	double ScriptTimeoutSeconds = 0.0;
+
+	TArray<FUnrealCopilotShard> Shards;
+
+	/** Shards waiting for a worker, in order */
+	TArray<int32> PendingShards;
+
+	TArray<FWorker> Workers;
+};
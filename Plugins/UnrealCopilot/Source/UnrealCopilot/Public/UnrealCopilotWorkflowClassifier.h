@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UnrealCopilotPromptProcessor.h"
+
+struct FPythonExecutionHistoryEntry;
+
+/**
+ * Result of classifying a prompt into a workflow type
+ */
+struct UNREALCOPILOT_API FWorkflowClassification
+{
+	/** Most likely workflow type */
+	EUnrealCopilotWorkflowType WorkflowType = EUnrealCopilotWorkflowType::General;
+
+	/** Posterior probability of the chosen workflow type (0.0 - 1.0) */
+	float Confidence = 0.0f;
+};
+
+/**
+ * Local multinomial naive Bayes classifier over word unigrams and bigrams.
+ * Maps a natural language prompt to a workflow type in microseconds without any network call.
+ * Seeded from a bundled labelled set and refined from execution history and conversation turns.
+ */
+class UNREALCOPILOT_API FUnrealCopilotWorkflowClassifier
+{
+public:
+	FUnrealCopilotWorkflowClassifier();
+
+	/**
+	 * Classify text into a workflow type
+	 * @param Text - Prompt (or code) to classify
+	 * @return Most likely workflow type and its confidence
+	 */
+	FWorkflowClassification Classify(const FString& Text) const;
+
+	/**
+	 * Add a labelled training example
+	 * @param Text - Example text
+	 * @param WorkflowType - Label for the example
+	 */
+	void AddTrainingExample(const FString& Text, EUnrealCopilotWorkflowType WorkflowType);
+
+	/**
+	 * Train from successful execution history entries, labelling each script by the editor APIs it references
+	 * @param History - Execution history to learn from
+	 * @return Number of entries used as training examples
+	 */
+	int32 TrainFromExecutionHistory(const TArray<FPythonExecutionHistoryEntry>& History);
+
+	/**
+	 * Infer a workflow label from Python code based on the Unreal APIs it uses
+	 * @param PythonCode - Code to inspect
+	 * @return Inferred workflow type, or General if no rule matched
+	 */
+	static EUnrealCopilotWorkflowType InferWorkflowFromCode(const FString& PythonCode);
+
+	/** Get number of training examples seen so far */
+	int32 GetNumTrainingExamples() const { return TotalDocuments; }
+
+private:
+	/** Number of workflow classes */
+	static constexpr int32 NumWorkflowTypes = static_cast<int32>(EUnrealCopilotWorkflowType::VFX) + 1;
+
+	/** Per-class occurrence counts of a single feature */
+	struct FFeatureCounts
+	{
+		int32 Counts[NumWorkflowTypes] = {};
+	};
+
+	/** Tokenize text and produce hashed unigram and bigram features */
+	static void ExtractFeatures(const FString& Text, TArray<uint32>& OutFeatures);
+
+	/** Seed the model from the bundled labelled examples */
+	void LoadBundledTrainingSet();
+
+private:
+	/** Feature hash -> per-class counts */
+	TMap<uint32, FFeatureCounts> FeatureCounts;
+
+	/** Total feature occurrences per class */
+	int32 ClassFeatureTotals[NumWorkflowTypes] = {};
+
+	/** Training documents per class */
+	int32 ClassDocumentCounts[NumWorkflowTypes] = {};
+
+	/** Total training documents */
+	int32 TotalDocuments = 0;
+};
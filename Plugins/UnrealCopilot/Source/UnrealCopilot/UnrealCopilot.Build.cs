@@ -39,12 +39,14 @@ public class UnrealCopilot : ModuleRules
 				"Slate",
 				"SlateCore",
 				"PythonScriptPlugin",
+				"Python3",
 				"Json",
 				"HTTP",
 				"DeveloperSettings",
 				"EditorSubsystem",
 				"UnrealEd",
 				"EditorScriptingUtilities",
+				"AssetRegistry",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -12,6 +12,8 @@
 #include "Widgets/Layout/SSplitter.h"
 #include "Widgets/Layout/SScrollBox.h"
 #include "Widgets/Input/SMultiLineEditableTextBox.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Views/STableRow.h"
 #include "Widgets/Images/SThrobber.h"
 #include "Styling/AppStyle.h"
 #include "Framework/Application/SlateApplication.h"
@@ -25,6 +27,12 @@ BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 #define LOCTEXT_NAMESPACE "SUnrealCopilotWidget"
 
+namespace UnrealCopilotWidget
+{
+	/** Pause in typing after which the history is searched */
+	static constexpr float HistorySearchDelaySeconds = 0.25f;
+}
+
 void SUnrealCopilotWidget::Construct(const FArguments& InArgs)
 {
 	// Initialize state
@@ -48,6 +56,27 @@ void SUnrealCopilotWidget::Construct(const FArguments& InArgs)
 		{
 			OnExecutionCompleted(Result);
 		});
+
+		ExecutionProgressHandle = ExecutionManager->OnExecutionProgress.AddLambda([this](const FPythonExecutionProgress& Progress)
+		{
+			OnExecutionProgress(Progress);
+		});
+
+		ExecutionOutputHandle = ExecutionManager->OnExecutionOutput.AddLambda([this](const FPythonOutputLine& Line)
+		{
+			OnExecutionOutput(Line);
+		});
+
+		// A search typed while the history was loading runs once it is ready
+		HistoryLoadedHandle = ExecutionManager->OnHistoryLoaded.AddLambda([this]()
+		{
+			RefreshHistorySearch();
+		});
+
+		// The history is only loaded once the panel that shows it opens
+		ExecutionManager->BeginLoadHistory();
+
+		ExecutionSessionId = ExecutionManager->CreateExecutionSession();
 	}
 
 	// Get LLM manager reference
@@ -64,6 +93,11 @@ void SUnrealCopilotWidget::Construct(const FArguments& InArgs)
 		{
 			OnCodeGenerationComplete(Result);
 		});
+
+		CodePreviewUpdatedHandle = LLMManager->OnCodePreviewUpdated.AddLambda([this](const FString& PreviewCode)
+		{
+			OnCodePreviewUpdated(PreviewCode);
+		});
 	}
 
 	// Build model selection options
@@ -268,6 +302,55 @@ void SUnrealCopilotWidget::Construct(const FArguments& InArgs)
 						]
 					]
 
+					// History search
+					+ SVerticalBox::Slot()
+					.AutoHeight()
+					.Padding(0.0f, 0.0f, 0.0f, 4.0f)
+					[
+						SNew(SHorizontalBox)
+
+						+ SHorizontalBox::Slot()
+						.FillWidth(1.0f)
+						[
+							SNew(SSearchBox)
+							.HintText(LOCTEXT("HistorySearchHint", "Search history and prompts (3 or more characters)"))
+							.OnTextChanged(this, &SUnrealCopilotWidget::OnHistorySearchTextChanged)
+						]
+
+						+ SHorizontalBox::Slot()
+						.AutoWidth()
+						.VAlign(VAlign_Center)
+						.Padding(8.0f, 0.0f, 0.0f, 0.0f)
+						[
+							SNew(SCheckBox)
+							.IsChecked_Lambda([this]() { return bHistorySearchRegex ? ECheckBoxState::Checked : ECheckBoxState::Unchecked; })
+							.OnCheckStateChanged(this, &SUnrealCopilotWidget::OnHistorySearchRegexChanged)
+							.ToolTipText(LOCTEXT("HistorySearchRegexTooltip", "Search with a regular expression"))
+							[
+								SNew(STextBlock)
+								.Text(LOCTEXT("HistorySearchRegex", "Regex"))
+							]
+						]
+					]
+
+					// History search results
+					+ SVerticalBox::Slot()
+					.AutoHeight()
+					.MaxHeight(160.0f)
+					.Padding(0.0f, 0.0f, 0.0f, 4.0f)
+					[
+						SNew(SBorder)
+						.BorderImage(FAppStyle::GetBrush("ToolPanel.GroupBorder"))
+						.Visibility(this, &SUnrealCopilotWidget::GetHistorySearchResultsVisibility)
+						[
+							SAssignNew(HistorySearchListView, SListView<TSharedPtr<FHistorySearchResult>>)
+							.ListItemsSource(&HistorySearchResults)
+							.SelectionMode(ESelectionMode::Single)
+							.OnGenerateRow(this, &SUnrealCopilotWidget::OnGenerateHistorySearchRow)
+							.OnSelectionChanged(this, &SUnrealCopilotWidget::OnHistorySearchResultSelected)
+						]
+					]
+
 					// Prompt text box
 					+ SVerticalBox::Slot()
 					.FillHeight(1.0f)
@@ -398,6 +481,20 @@ void SUnrealCopilotWidget::Construct(const FArguments& InArgs)
 							.ContentPadding(FMargin(16.0f, 8.0f))
 						]
 
+						// Reset Session button
+						+ SHorizontalBox::Slot()
+						.AutoWidth()
+						.Padding(8.0f, 0.0f, 0.0f, 0.0f)
+						[
+							SNew(SButton)
+							.Text(LOCTEXT("ResetSessionButton", "Reset Session"))
+							.ToolTipText(LOCTEXT("ResetSessionTooltip", "Clear the variables and imports kept from earlier runs"))
+							.OnClicked(this, &SUnrealCopilotWidget::OnResetSessionClicked)
+							.ButtonStyle(FAppStyle::Get(), "FlatButton.Default")
+							.ContentPadding(FMargin(16.0f, 8.0f))
+							.Visibility(this, &SUnrealCopilotWidget::GetResetSessionButtonVisibility)
+						]
+
 						+ SHorizontalBox::Slot()
 						.FillWidth(1.0f)
 					]
@@ -482,6 +579,21 @@ SUnrealCopilotWidget::~SUnrealCopilotWidget()
 		{
 			ExecutionManager->OnExecutionCompleted.Remove(ExecutionCompletedHandle);
 		}
+		if (ExecutionProgressHandle.IsValid())
+		{
+			ExecutionManager->OnExecutionProgress.Remove(ExecutionProgressHandle);
+		}
+		if (ExecutionOutputHandle.IsValid())
+		{
+			ExecutionManager->OnExecutionOutput.Remove(ExecutionOutputHandle);
+		}
+		if (HistoryLoadedHandle.IsValid())
+		{
+			ExecutionManager->OnHistoryLoaded.Remove(HistoryLoadedHandle);
+		}
+
+		// Free the namespace kept for this panel
+		ExecutionManager->ResetExecutionSession(ExecutionSessionId);
 	}
 
 	// Unbind LLM delegates
@@ -495,6 +607,10 @@ SUnrealCopilotWidget::~SUnrealCopilotWidget()
 		{
 			LLMManager->OnCodeGenerationComplete.Remove(GenerationCompletedHandle);
 		}
+		if (CodePreviewUpdatedHandle.IsValid())
+		{
+			LLMManager->OnCodePreviewUpdated.Remove(CodePreviewUpdatedHandle);
+		}
 	}
 }
 
@@ -561,6 +677,16 @@ void SUnrealCopilotWidget::OnGenerationStateChanged(ECodeGenerationState NewStat
 	// UI will automatically update through bound visibility functions
 }
 
+void SUnrealCopilotWidget::OnCodePreviewUpdated(const FString& PreviewCode)
+{
+	// Show the partial script while a streamed response is still arriving
+	LastGeneratedCode = PreviewCode;
+	if (GeneratedCodePreviewBox.IsValid())
+	{
+		GeneratedCodePreviewBox->SetText(FText::FromString(LastGeneratedCode));
+	}
+}
+
 void SUnrealCopilotWidget::OnCodeGenerationComplete(const FCodeGenerationResult& Result)
 {
 	if (Result.bSuccess)
@@ -573,9 +699,19 @@ void SUnrealCopilotWidget::OnCodeGenerationComplete(const FCodeGenerationResult&
 		}
 
 		// Update output with generation info
-		SetOutputText(FString::Printf(TEXT("[CODE GENERATED] (%.2fs, %d tokens)\n\nGenerated code is ready for review and execution.\nYou can edit the code in the preview window before executing."), 
+		FString OutputText = FString::Printf(TEXT("[CODE GENERATED] (%.2fs, %d tokens)"), 
 			Result.GenerationTimeSeconds, 
-			Result.TokensUsed));
+			Result.TokensUsed);
+		if (!Result.Explanation.IsEmpty())
+		{
+			OutputText += TEXT("\n\n") + Result.Explanation;
+		}
+		if (Result.TouchedAssets.Num() > 0)
+		{
+			OutputText += TEXT("\n\nAssets affected:\n- ") + FString::Join(Result.TouchedAssets, TEXT("\n- "));
+		}
+		OutputText += TEXT("\n\nGenerated code is ready for review and execution.\nYou can edit the code in the preview window before executing.");
+		SetOutputText(OutputText);
 
 		// Check if user confirmation is required
 		UUnrealCopilotSettings* Settings = UUnrealCopilotSettings::Get();
@@ -699,8 +835,9 @@ FReply SUnrealCopilotWidget::OnExecuteClicked()
 		PythonCode = PromptText.ToString();
 	}
 
-	// Execute using the enhanced execution manager
-	FPythonExecutionResult Result = ExecutionManager->ExecutePythonCode(PythonCode, false);
+	// Execute asynchronously so long scripts don't freeze the editor; the result arrives through OnExecutionCompleted
+	BeginLiveOutput();
+	ExecutionManager->ExecutePythonCode(PythonCode, true, GetActiveExecutionSessionId());
 
 	return FReply::Handled();
 }
@@ -760,6 +897,17 @@ FReply SUnrealCopilotWidget::OnCancelExecutionClicked()
 	return FReply::Handled();
 }
 
+FReply SUnrealCopilotWidget::OnResetSessionClicked()
+{
+	if (ExecutionManager.IsValid())
+	{
+		ExecutionManager->ResetExecutionSession(ExecutionSessionId);
+		SetOutputText(TEXT("Python session reset. Variables from earlier runs were cleared."));
+	}
+
+	return FReply::Handled();
+}
+
 FText SUnrealCopilotWidget::GetPromptText() const
 {
 	return PromptText;
@@ -806,6 +954,11 @@ void SUnrealCopilotWidget::OnExecutionCompleted(const FPythonExecutionResult& Re
 			Result.ExecutionTimeSeconds,
 			*Result.ErrorMessage);
 
+		if (!Result.Output.IsEmpty())
+		{
+			ResultText += FString::Printf(TEXT("\n\nOutput:\n%s"), *Result.Output);
+		}
+
 		if (!Result.StackTrace.IsEmpty())
 		{
 			ResultText += FString::Printf(TEXT("\n\nStack Trace:\n%s"), *Result.StackTrace);
@@ -818,20 +971,67 @@ void SUnrealCopilotWidget::OnExecutionCompleted(const FPythonExecutionResult& Re
 	}
 
 	SetOutputText(ResultText);
+	LiveExecutionOutput.Reset(1);
 
 	// Reset history navigation index
 	HistoryIndex = -1;
 }
 
+void SUnrealCopilotWidget::OnExecutionProgress(const FPythonExecutionProgress& Progress)
+{
+	ExecutionProgress = Progress;
+}
+
+void SUnrealCopilotWidget::OnExecutionOutput(const FPythonOutputLine& Line)
+{
+	// Show what the script prints while it runs; the completion result replaces it
+	LiveExecutionOutput.Add(FPythonOutputLine(Line));
+	if (!LiveOutputTimerHandle.IsValid())
+	{
+		LiveOutputTimerHandle = RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SUnrealCopilotWidget::OnLiveOutputTimer));
+	}
+}
+
+EActiveTimerReturnType SUnrealCopilotWidget::OnLiveOutputTimer(double InCurrentTime, float InDeltaTime)
+{
+	// The script finished or was cancelled since the update was requested, and its result is showing
+	if (LiveExecutionOutput.Num() == 0)
+	{
+		return EActiveTimerReturnType::Stop;
+	}
+
+	FString LiveText = TEXT("[RUNNING]");
+	if (LiveExecutionOutput.GetDroppedCount() > 0)
+	{
+		LiveText += FString::Printf(TEXT("\n... %d earlier lines not shown"), LiveExecutionOutput.GetDroppedCount());
+	}
+	for (int32 Index = 0; Index < LiveExecutionOutput.Num(); ++Index)
+	{
+		const FPythonOutputLine& Line = LiveExecutionOutput[Index];
+		LiveText += Line.Stream == EPythonOutputStream::Stderr ? TEXT("\n[stderr] ") : TEXT("\n");
+		LiveText += Line.Text;
+	}
+	SetOutputText(LiveText);
+	return EActiveTimerReturnType::Stop;
+}
+
+void SUnrealCopilotWidget::BeginLiveOutput()
+{
+	ExecutionProgress = FPythonExecutionProgress();
+	LiveExecutionOutput.Reset(UUnrealCopilotSettings::Get()->MaxCapturedOutputLines);
+	SetOutputText(TEXT("[RUNNING]"));
+}
+
 void SUnrealCopilotWidget::NavigateHistory(bool bUp)
 {
-	if (!ExecutionManager.IsValid())
+	// Keys pressed while the history is loading are ignored rather than stalling the editor
+	if (!ExecutionManager.IsValid() || !ExecutionManager->IsHistoryLoaded())
 	{
 		return;
 	}
 
-	const TArray<FPythonExecutionHistoryEntry>& History = ExecutionManager->GetExecutionHistory();
-	if (History.Num() == 0)
+	const int32 HistoryCount = ExecutionManager->GetHistoryCount();
+	if (HistoryCount == 0)
 	{
 		return;
 	}
@@ -841,7 +1041,7 @@ void SUnrealCopilotWidget::NavigateHistory(bool bUp)
 		// Navigate to previous (older) command
 		if (HistoryIndex == -1)
 		{
-			HistoryIndex = History.Num() - 1;
+			HistoryIndex = HistoryCount - 1;
 		}
 		else if (HistoryIndex > 0)
 		{
@@ -851,7 +1051,7 @@ void SUnrealCopilotWidget::NavigateHistory(bool bUp)
 	else
 	{
 		// Navigate to next (newer) command
-		if (HistoryIndex != -1 && HistoryIndex < History.Num() - 1)
+		if (HistoryIndex != -1 && HistoryIndex < HistoryCount - 1)
 		{
 			HistoryIndex++;
 		}
@@ -863,11 +1063,129 @@ void SUnrealCopilotWidget::NavigateHistory(bool bUp)
 		}
 	}
 
-	// Update prompt text with history entry
-	if (HistoryIndex >= 0 && HistoryIndex < History.Num())
+	// Update prompt text with history entry, read from disk unless recently used
+	if (HistoryIndex >= 0 && HistoryIndex < HistoryCount)
+	{
+		PromptText = FText::FromString(ExecutionManager->GetHistoryEntry(HistoryIndex).Code);
+	}
+}
+
+void SUnrealCopilotWidget::OnHistorySearchTextChanged(const FText& InText)
+{
+	HistorySearchText = InText.ToString();
+
+	// Each keystroke restarts the delay, so a word typed quickly is searched once
+	if (TSharedPtr<FActiveTimerHandle> PendingSearch = HistorySearchTimerHandle.Pin())
 	{
-		PromptText = FText::FromString(History[HistoryIndex].Code);
+		UnRegisterActiveTimer(PendingSearch.ToSharedRef());
 	}
+	HistorySearchTimerHandle = RegisterActiveTimer(UnrealCopilotWidget::HistorySearchDelaySeconds,
+		FWidgetActiveTimerDelegate::CreateSP(this, &SUnrealCopilotWidget::OnHistorySearchTimer));
+}
+
+EActiveTimerReturnType SUnrealCopilotWidget::OnHistorySearchTimer(double InCurrentTime, float InDeltaTime)
+{
+	RefreshHistorySearch();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SUnrealCopilotWidget::OnHistorySearchRegexChanged(ECheckBoxState CheckState)
+{
+	bHistorySearchRegex = CheckState == ECheckBoxState::Checked;
+	RefreshHistorySearch();
+}
+
+void SUnrealCopilotWidget::RefreshHistorySearch()
+{
+	HistorySearchResults.Reset();
+	bHistorySearchComplete = true;
+
+	// Text without a trigram would match every entry, so nothing is searched until it narrows the history down
+	if (ExecutionManager.IsValid() && ExecutionManager->IsHistoryLoaded() && FUnrealCopilotHistorySearchIndex::HasTrigrams(HistorySearchText, bHistorySearchRegex))
+	{
+		// Runs once typing pauses, and the index only reads the candidate entries, so the search stays cheap
+		TArray<FHistorySearchResult> Results;
+		bHistorySearchComplete = ExecutionManager->SearchHistory(HistorySearchText, bHistorySearchRegex, 50, Results);
+		for (FHistorySearchResult& Result : Results)
+		{
+			HistorySearchResults.Add(MakeShared<FHistorySearchResult>(MoveTemp(Result)));
+		}
+	}
+
+	if (HistorySearchListView.IsValid())
+	{
+		HistorySearchListView->RequestListRefresh();
+	}
+}
+
+TSharedRef<ITableRow> SUnrealCopilotWidget::OnGenerateHistorySearchRow(TSharedPtr<FHistorySearchResult> Result, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	const FText SourceText = Result->Source == EHistorySearchSource::Execution
+		? LOCTEXT("HistorySearchSourceCode", "Code")
+		: LOCTEXT("HistorySearchSourcePrompt", "Prompt");
+	const FText OccurrencesText = Result->Occurrences > 1
+		? FText::Format(LOCTEXT("HistorySearchOccurrences", "x{0}"), FText::AsNumber(Result->Occurrences))
+		: FText::GetEmpty();
+
+	return SNew(STableRow<TSharedPtr<FHistorySearchResult>>, OwnerTable)
+		.ToolTipText(bHistorySearchComplete ? FText::GetEmpty() : LOCTEXT("HistorySearchIncomplete", "Only the newest matches are listed; refine the search to find older ones"))
+		[
+			SNew(SHorizontalBox)
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(4.0f, 0.0f)
+			[
+				SNew(STextBlock)
+				.Text(SourceText)
+				.ColorAndOpacity(FLinearColor(0.6f, 0.6f, 0.6f, 1.0f))
+			]
+
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString(Result->Snippet))
+				.Font(FCoreStyle::GetDefaultFontStyle("Mono", 9))
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(4.0f, 0.0f)
+			[
+				SNew(STextBlock)
+				.Text(OccurrencesText)
+				.ColorAndOpacity(FLinearColor(0.6f, 0.6f, 0.6f, 1.0f))
+			]
+		];
+}
+
+void SUnrealCopilotWidget::OnHistorySearchResultSelected(TSharedPtr<FHistorySearchResult> Result, ESelectInfo::Type SelectInfo)
+{
+	if (!Result.IsValid() || !ExecutionManager.IsValid() || SelectInfo == ESelectInfo::Direct)
+	{
+		return;
+	}
+
+	// Scripts open in Code Mode to run again, prompts in Prompt Mode to regenerate
+	const bool bPrompt = Result->Source == EHistorySearchSource::Prompt;
+	const ECheckBoxState ModeState = bPrompt ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+	if (ModeToggleCheckBox.IsValid())
+	{
+		ModeToggleCheckBox->SetIsChecked(ModeState);
+	}
+	OnModeChanged(ModeState);
+
+	const FPythonExecutionHistoryEntry Entry = bPrompt
+		? ExecutionManager->GetPromptHistoryEntry(Result->Index)
+		: ExecutionManager->GetHistoryEntry(Result->Index);
+	PromptText = FText::FromString(Entry.Code);
+	HistoryIndex = bPrompt ? -1 : Result->Index;
+}
+
+EVisibility SUnrealCopilotWidget::GetHistorySearchResultsVisibility() const
+{
+	return FUnrealCopilotHistorySearchIndex::HasTrigrams(HistorySearchText, bHistorySearchRegex) ? EVisibility::Visible : EVisibility::Collapsed;
 }
 
 void SUnrealCopilotWidget::UpdateExecutionStateUI()
@@ -904,6 +1222,19 @@ FText SUnrealCopilotWidget::GetStatusText() const
 	case EPythonExecutionState::Validating:
 		return LOCTEXT("StatusValidating", "Validating...");
 	case EPythonExecutionState::Executing:
+		if (ExecutionProgress.TotalStatements > 0 && ExecutionProgress.QueuedExecutions > 0)
+		{
+			return FText::Format(LOCTEXT("StatusExecutingProgressQueued", "Executing... {0} ({1}s, {2} queued)"),
+				FText::AsPercent(ExecutionProgress.GetFraction()),
+				FText::AsNumber(FMath::RoundToInt(ExecutionProgress.ElapsedSeconds)),
+				FText::AsNumber(ExecutionProgress.QueuedExecutions));
+		}
+		if (ExecutionProgress.TotalStatements > 0)
+		{
+			return FText::Format(LOCTEXT("StatusExecutingProgress", "Executing... {0} ({1}s)"),
+				FText::AsPercent(ExecutionProgress.GetFraction()),
+				FText::AsNumber(FMath::RoundToInt(ExecutionProgress.ElapsedSeconds)));
+		}
 		return LOCTEXT("StatusExecuting", "Executing...");
 	case EPythonExecutionState::Completed:
 		return LOCTEXT("StatusCompleted", "Completed");
@@ -965,6 +1296,16 @@ EVisibility SUnrealCopilotWidget::GetCancelButtonVisibility() const
 			EVisibility::Visible : EVisibility::Collapsed;
 }
 
+EVisibility SUnrealCopilotWidget::GetResetSessionButtonVisibility() const
+{
+	return UUnrealCopilotSettings::Get()->bPersistentPanelSession ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+int32 SUnrealCopilotWidget::GetActiveExecutionSessionId() const
+{
+	return UUnrealCopilotSettings::Get()->bPersistentPanelSession ? ExecutionSessionId : 0;
+}
+
 EVisibility SUnrealCopilotWidget::GetPromptModeVisibility() const
 {
 	return CurrentUIMode == EUnrealCopilotUIMode::PromptMode ? EVisibility::Visible : EVisibility::Collapsed;
@@ -1062,9 +1403,9 @@ void SUnrealCopilotWidget::ExecuteGeneratedCode(const FString& Code)
 {
 	if (ExecutionManager.IsValid())
 	{
-		// Execute the generated code
-		FPythonExecutionResult Result = ExecutionManager->ExecutePythonCode(Code, false);
-		// Result will be handled by the OnExecutionCompleted delegate
+		// Execute the generated code; the result will be handled by the OnExecutionCompleted delegate
+		BeginLiveOutput();
+		ExecutionManager->ExecutePythonCode(Code, true, GetActiveExecutionSessionId());
 	}
 }
 
@@ -10,6 +10,7 @@
 #include "Widgets/Images/SThrobber.h"
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Views/SListView.h"
 #include "UnrealCopilotExecutionManager.h"
 #include "UnrealCopilotLLMManager.h"
 #include "UnrealCopilotSettings.h"
@@ -61,6 +62,9 @@ private:
 	/** Handle clicking the Cancel Execution button */
 	FReply OnCancelExecutionClicked();
 
+	/** Handle clicking the Reset Session button */
+	FReply OnResetSessionClicked();
+
 	/** Handle mode toggle change */
 	void OnModeChanged(ECheckBoxState CheckState);
 
@@ -85,15 +89,51 @@ private:
 	/** Handle execution completion */
 	void OnExecutionCompleted(const FPythonExecutionResult& Result);
 
+	/** Handle progress of an asynchronous execution */
+	void OnExecutionProgress(const FPythonExecutionProgress& Progress);
+
+	/** Handle a line printed by the running script */
+	void OnExecutionOutput(const FPythonOutputLine& Line);
+
+	/** Show the output of the running script, at most once per frame however many lines it printed */
+	EActiveTimerReturnType OnLiveOutputTimer(double InCurrentTime, float InDeltaTime);
+
+	/** Show that a script started and forget the output of the previous one */
+	void BeginLiveOutput();
+
 	/** Handle code generation state changes */
 	void OnGenerationStateChanged(ECodeGenerationState NewState);
 
+	/** Handle partial code from a streamed response */
+	void OnCodePreviewUpdated(const FString& PreviewCode);
+
 	/** Handle code generation completion */
 	void OnCodeGenerationComplete(const FCodeGenerationResult& Result);
 
 	/** Navigate history (Up = true for previous, false for next) */
 	void NavigateHistory(bool bUp);
 
+	/** Handle edits of the history search box */
+	void OnHistorySearchTextChanged(const FText& InText);
+
+	/** Run the history search once typing pauses */
+	EActiveTimerReturnType OnHistorySearchTimer(double InCurrentTime, float InDeltaTime);
+
+	/** Handle toggling regular expression search */
+	void OnHistorySearchRegexChanged(ECheckBoxState CheckState);
+
+	/** Search the execution and prompt history for the current search text */
+	void RefreshHistorySearch();
+
+	/** Generate the row of a history search result */
+	TSharedRef<ITableRow> OnGenerateHistorySearchRow(TSharedPtr<FHistorySearchResult> Result, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Load the code or prompt of the selected search result into the prompt box */
+	void OnHistorySearchResultSelected(TSharedPtr<FHistorySearchResult> Result, ESelectInfo::Type SelectInfo);
+
+	/** Get visibility for the history search results */
+	EVisibility GetHistorySearchResultsVisibility() const;
+
 	/** Update UI based on current execution state */
 	void UpdateExecutionStateUI();
 
@@ -115,6 +155,12 @@ private:
 	/** Get visibility for cancel button */
 	EVisibility GetCancelButtonVisibility() const;
 
+	/** Get visibility for reset session button */
+	EVisibility GetResetSessionButtonVisibility() const;
+
+	/** Get the session scripts from this panel run in, or 0 if the persistent session is disabled */
+	int32 GetActiveExecutionSessionId() const;
+
 	/** Get visibility for prompt mode UI elements */
 	EVisibility GetPromptModeVisibility() const;
 
@@ -191,6 +237,24 @@ private:
 	/** Throbber for showing execution progress */
 	TSharedPtr<SThrobber> ExecutionThrobber;
 
+	/** List of history search results */
+	TSharedPtr<SListView<TSharedPtr<FHistorySearchResult>>> HistorySearchListView;
+
+	/** Results of the current history search, best first */
+	TArray<TSharedPtr<FHistorySearchResult>> HistorySearchResults;
+
+	/** Text searched for in the history */
+	FString HistorySearchText;
+
+	/** Whether the search text is a regular expression */
+	bool bHistorySearchRegex = false;
+
+	/** Whether the last search read every candidate; older matches may be missing otherwise */
+	bool bHistorySearchComplete = true;
+
+	/** Search waiting for typing to pause */
+	TWeakPtr<FActiveTimerHandle> HistorySearchTimerHandle;
+
 	/** Current prompt text */
 	FText PromptText;
 
@@ -218,14 +282,30 @@ private:
 	/** Last execution time */
 	float LastExecutionTime;
 
+	/** Progress of the running asynchronous execution */
+	FPythonExecutionProgress ExecutionProgress;
+
+	/** Most recent lines printed by the running script, up to the captured output limit */
+	FPythonOutputRingBuffer LiveExecutionOutput;
+
+	/** Update of the output text waiting for the next frame */
+	TWeakPtr<FActiveTimerHandle> LiveOutputTimerHandle;
+
+	/** Session keeping the variables of this panel's scripts when the persistent session is enabled */
+	int32 ExecutionSessionId = 0;
+
 	/** Timer handle for auto-save */
 	FTimerHandle AutoSaveTimerHandle;
 
 	/** Delegate handles for cleanup */
 	FDelegateHandle ExecutionStateChangedHandle;
 	FDelegateHandle ExecutionCompletedHandle;
+	FDelegateHandle ExecutionProgressHandle;
+	FDelegateHandle ExecutionOutputHandle;
+	FDelegateHandle HistoryLoadedHandle;
 	FDelegateHandle GenerationStateChangedHandle;
 	FDelegateHandle GenerationCompletedHandle;
+	FDelegateHandle CodePreviewUpdatedHandle;
 
 	/** Model selection options */
 	TArray<TSharedPtr<FString>> ModelOptions;